@@ -0,0 +1,99 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Random reads over a big vector, where nearly every access is a
+ *    TLB miss on 4KB pages. Compare std::allocator against the huge
+ *    page allocator, first touch and interleaved, and show how much
+ *    of each vector the kernel actually backed with huge pages.
+ *
+ *       benchHuge                  : 1GB vector, 50M reads
+ *       benchHuge 4294967296 1e8   : bytes, reads
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "vector.h"
+#include "huge_allocator.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * HUGE PAGE KB
+ * How much anonymous memory is on huge pages right now
+ ***********************************************************************/
+long hugePageKB()
+{
+   std::ifstream fin("/proc/self/smaps_rollup");
+   std::string key;
+   long value;
+   while (fin >> key)
+      if (key == "AnonHugePages:" && fin >> value)
+         return value;
+   return -1;
+}
+
+/**********************************************************************
+ * TIME RANDOM
+ * Fill the vector, then read numReads elements at random
+ ***********************************************************************/
+template <class A>
+void timeRandom(const char * name, size_t num, size_t numReads)
+{
+   custom::vector<uint64_t, A> v;
+   v.resize(num);
+   for (size_t i = 0; i < num; i++)
+      v[i] = i;
+   long kb = hugePageKB();
+
+   uint64_t seed = 26;
+   uint64_t checksum = 0;
+   auto start = steady_clock::now();
+   for (size_t i = 0; i < numReads; i++)
+   {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      checksum += v[(seed >> 16) % num];
+   }
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   std::cout << std::setw(26) << name
+             << std::setw(14) << (double)numReads / seconds / 1.0e6
+             << std::setw(14) << seconds * 1.0e9 / numReads
+             << std::setw(16) << kb / 1024
+             << std::setw(22) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t numBytes = (argc > 1) ? (size_t)std::strtod(argv[1], nullptr) : (size_t)1 << 30;
+   size_t numReads = (argc > 2) ? (size_t)std::strtod(argv[2], nullptr) : 50000000;
+   size_t num = numBytes / sizeof(uint64_t);
+
+#ifdef CUSTOM_NUMA
+   std::cout << "libnuma: yes\n";
+#else
+   std::cout << "libnuma: no, interleave is first touch\n";
+#endif
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(26) << "allocator"
+             << std::setw(14) << "M reads/s"
+             << std::setw(14) << "ns/read"
+             << std::setw(16) << "huge pages MB"
+             << std::setw(22) << "checksum" << std::endl;
+
+   timeRandom<std::allocator<uint64_t>>("std::allocator", num, numReads);
+   timeRandom<custom::huge_allocator<uint64_t>>("huge, first touch", num, numReads);
+   timeRandom<custom::huge_allocator<uint64_t, custom::NUMA_INTERLEAVE>>("huge, interleave", num, numReads);
+
+   return 0;
+}
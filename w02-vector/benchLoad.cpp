@@ -0,0 +1,125 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Load a file of ints into a vector. resize zeroes every element
+ *    just before fread overwrites it; resize_uninitialized and
+ *    append_from let fread write straight into the spare capacity.
+ *    The file is written first, so it is read from the page cache.
+ *
+ *       benchLoad                           : 256MB in /tmp/benchLoad.bin
+ *       benchLoad 1073741824 /data/x.bin    : bytes, file
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include "vector.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, double seconds, size_t numBytes, long long checksum)
+{
+   std::cout << std::setw(30) << name
+             << std::setw(12) << seconds * 1000.0
+             << std::setw(12) << (double)numBytes / seconds / (1 << 30)
+             << std::setw(20) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * CHECKSUM
+ * Touch a few elements so the load cannot be skipped
+ ***********************************************************************/
+template <class Vector>
+long long checksum(Vector & v, size_t num)
+{
+   return (long long)v.size() + v[0] + v[num / 2] + v[num - 1];
+}
+
+/**********************************************************************
+ * TIME LOAD
+ * size the vector with prepare, then read the whole file into it
+ ***********************************************************************/
+template <class Vector, class Prepare>
+void timeLoad(const char * name, const char * fileName, size_t num, Prepare prepare)
+{
+   auto start = steady_clock::now();
+   Vector v;
+   prepare(v, num);
+   FILE * f = std::fopen(fileName, "rb");
+   size_t numRead = std::fread(&v[0], sizeof(int), num, f);
+   std::fclose(f);
+   double seconds = duration<double>(steady_clock::now() - start).count();
+   report(name, seconds, numRead * sizeof(int), checksum(v, num));
+}
+
+/**********************************************************************
+ * TIME APPEND FROM
+ * Let append_from hand fread the spare capacity, a chunk at a time
+ ***********************************************************************/
+void timeAppendFrom(const char * fileName, size_t num, size_t numChunk)
+{
+   auto start = steady_clock::now();
+   custom::vector<int> v;
+   v.reserve(num);
+   FILE * f = std::fopen(fileName, "rb");
+   while (v.append_from([f](int * pDest, size_t numMax)
+          {
+             return std::fread(pDest, sizeof(int), numMax, f);
+          }, numChunk) > 0)
+      ;
+   std::fclose(f);
+   double seconds = duration<double>(steady_clock::now() - start).count();
+   report("append_from 1MB chunks", seconds, v.size() * sizeof(int), checksum(v, num));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t numBytes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (size_t)256 << 20;
+   const char * fileName = (argc > 2) ? argv[2] : "/tmp/benchLoad.bin";
+   size_t num = numBytes / sizeof(int);
+
+   // write the file
+   {
+      std::vector<int> v(num);
+      for (size_t i = 0; i < num; i++)
+         v[i] = (int)i;
+      FILE * f = std::fopen(fileName, "wb");
+      if (!f || std::fwrite(v.data(), sizeof(int), num, f) != num)
+      {
+         std::cerr << "could not write " << fileName << std::endl;
+         return 1;
+      }
+      std::fclose(f);
+   }
+
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(30) << "load"
+             << std::setw(12) << "ms"
+             << std::setw(12) << "GB/s"
+             << std::setw(20) << "checksum" << std::endl;
+
+   timeLoad<std::vector<int>>("std::vector resize", fileName, num,
+      [](std::vector<int> & v, size_t n) { v.resize(n); });
+   timeLoad<custom::vector<int>>("resize", fileName, num,
+      [](custom::vector<int> & v, size_t n) { v.resize(n); });
+   timeLoad<custom::vector<int>>("resize_default_init", fileName, num,
+      [](custom::vector<int> & v, size_t n) { v.resize_default_init(n); });
+   timeLoad<custom::vector<int>>("resize_uninitialized", fileName, num,
+      [](custom::vector<int> & v, size_t n) { v.resize_uninitialized(n); });
+   timeAppendFrom(fileName, num, (1 << 20) / sizeof(int));
+
+   std::remove(fileName);
+   return 0;
+}
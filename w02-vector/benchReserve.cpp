@@ -0,0 +1,99 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Time resize and reserve on big vectors, where every element has
+ *    to move to the new buffer. Relocatable types (int, unique_ptr)
+ *    move with one memcpy; Moved, an int with a move constructor of
+ *    its own, shows what moving one element at a time costs.
+ *
+ *       benchReserve                    : 100M elements
+ *       benchReserve 10000000           : any number of elements
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <cstdlib>
+#include "vector.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * MOVED
+ * An int that is not trivially copyable, so it is never relocated
+ ***********************************************************************/
+struct Moved
+{
+   Moved() : value(0) {}
+   Moved(Moved && rhs) noexcept : value(rhs.value) {}
+   int value;
+};
+
+/**********************************************************************
+ * PLAIN ALLOCATOR
+ * Just std::allocator under another name, so the vector never maps
+ * its buffer and reserve has to relocate rather than mremap
+ ***********************************************************************/
+template <typename T>
+struct plain_allocator : public std::allocator<T>
+{
+   template <typename U>
+   struct rebind { typedef plain_allocator<U> other; };
+};
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, const char * op, double seconds, size_t num)
+{
+   std::cout << std::setw(26) << name
+             << std::setw(10) << op
+             << std::setw(12) << seconds * 1000.0
+             << std::setw(14) << (double)num / seconds / 1.0e6 << std::endl;
+}
+
+/**********************************************************************
+ * TIME GROW
+ * Resize from num/2 to num, then reserve twice num. The resize moves
+ * num/2 elements, the reserve moves num
+ ***********************************************************************/
+template <class Vector>
+void timeGrow(const char * name, size_t num)
+{
+   Vector v;
+   v.resize(num / 2);
+
+   auto start = steady_clock::now();
+   v.resize(num);
+   report(name, "resize", duration<double>(steady_clock::now() - start).count(), num / 2);
+
+   start = steady_clock::now();
+   v.reserve(num * 2);
+   report(name, "reserve", duration<double>(steady_clock::now() - start).count(), num);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t num = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(26) << "element"
+             << std::setw(10) << "op"
+             << std::setw(12) << "ms"
+             << std::setw(14) << "M moved/s" << std::endl;
+
+   timeGrow<custom::vector<Moved, plain_allocator<Moved>>>("Moved (one at a time)", num);
+   timeGrow<custom::vector<int,   plain_allocator<int>>>  ("int (memcpy)", num);
+   timeGrow<custom::vector<std::unique_ptr<int>, plain_allocator<std::unique_ptr<int>>>>
+                                                         ("unique_ptr (memcpy)", num);
+   timeGrow<custom::vector<int>>                         ("int (mremap)", num);
+
+   return 0;
+}
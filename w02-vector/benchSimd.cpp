@@ -0,0 +1,149 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    fill, find, count, minmax and sum over big vectors of int and
+ *    float: a plain loop over the vector iterator, then the simd.h
+ *    versions with the plain loops forced, then with AVX2 (when the
+ *    CPU has it).
+ *
+ *       benchSimd                  : 16M elements, 20 repetitions
+ *       benchSimd 1000000 100      : elements, repetitions
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "vector.h"
+#include "simd.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * type, const char * op, const char * how,
+            double seconds, size_t numBytes, double checksum)
+{
+   std::cout << std::setw(8)  << type
+             << std::setw(8)  << op
+             << std::setw(12) << how
+             << std::setw(12) << seconds * 1000.0
+             << std::setw(10) << (double)numBytes / seconds / (1 << 30)
+             << std::setw(20) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * TIME
+ * Run f reps times and report the total
+ ***********************************************************************/
+template <class F>
+void timeOp(const char * type, const char * op, const char * how,
+            size_t numBytes, int reps, F f)
+{
+   double checksum = 0.0;
+   auto start = steady_clock::now();
+   for (int r = 0; r < reps; r++)
+      checksum += f();
+   double seconds = duration<double>(steady_clock::now() - start).count();
+   report(type, op, how, seconds, numBytes * reps, checksum);
+}
+
+/**********************************************************************
+ * TIME TYPE
+ * Every operation three ways over a vector of T
+ ***********************************************************************/
+template <typename T>
+void timeType(const char * type, size_t num, int reps)
+{
+   typedef custom::vector<T> Vector;
+   Vector v(num, (T)0);
+   for (size_t i = 0; i < num; i++)
+      v[i] = (T)(i % 1000);
+   T needle = (T)1001;    // never there, so find reads it all
+   size_t numBytes = num * sizeof(T);
+
+   // plain loops over the iterator
+   timeOp(type, "fill", "iterator", numBytes, reps, [&]()
+   {
+      for (auto it = v.begin(); it != v.end(); ++it)
+         *it = (T)3;
+      return (double)v[num / 2];
+   });
+   timeOp(type, "find", "iterator", numBytes, reps, [&]()
+   {
+      size_t i = 0;
+      for (auto it = v.begin(); it != v.end() && !(*it == needle); ++it)
+         i++;
+      return (double)i;
+   });
+   timeOp(type, "count", "iterator", numBytes, reps, [&]()
+   {
+      size_t n = 0;
+      for (auto it = v.begin(); it != v.end(); ++it)
+         if (*it == (T)3)
+            n++;
+      return (double)n;
+   });
+   timeOp(type, "minmax", "iterator", numBytes, reps, [&]()
+   {
+      T lo = v[0], hi = v[0];
+      for (auto it = v.begin(); it != v.end(); ++it)
+      {
+         if (*it < lo) lo = *it;
+         if (hi < *it) hi = *it;
+      }
+      return (double)lo + (double)hi;
+   });
+   timeOp(type, "sum", "iterator", numBytes, reps, [&]()
+   {
+      typename custom::simd::sum_type<T>::type s = 0;
+      for (auto it = v.begin(); it != v.end(); ++it)
+         s += *it;
+      return (double)s;
+   });
+
+   // simd.h, first with the plain loops, then with AVX2
+   bool avx2 = custom::simd::avx2Enabled();
+   for (int pass = 0; pass < (avx2 ? 2 : 1); pass++)
+   {
+      const char * how = pass == 0 ? "simd.h loop" : "simd.h avx2";
+      custom::simd::avx2Enabled() = (pass == 1);
+      timeOp(type, "fill",   how, numBytes, reps, [&]() { custom::fill(v, (T)3); return (double)v[num / 2]; });
+      timeOp(type, "find",   how, numBytes, reps, [&]() { return custom::find(v, needle) == v.end() ? 1.0 : 0.0; });
+      timeOp(type, "count",  how, numBytes, reps, [&]() { return (double)custom::count(v, (T)3); });
+      timeOp(type, "minmax", how, numBytes, reps, [&]()
+      {
+         std::pair<T, T> m = custom::minmax(v);
+         return (double)m.first + (double)m.second;
+      });
+      timeOp(type, "sum",    how, numBytes, reps, [&]() { return (double)custom::sum(v); });
+   }
+   custom::simd::avx2Enabled() = avx2;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t num = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 16000000;
+   int reps   = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+   std::cout << "AVX2: " << (custom::simd::avx2Enabled() ? "yes" : "no") << std::endl;
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(8)  << "type"
+             << std::setw(8)  << "op"
+             << std::setw(12) << "how"
+             << std::setw(12) << "ms"
+             << std::setw(10) << "GB/s"
+             << std::setw(20) << "checksum" << std::endl;
+
+   timeType<int>  ("int",   num, reps);
+   timeType<float>("float", num, reps);
+
+   return 0;
+}
@@ -0,0 +1,121 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Build, read and drop many tiny vectors, the way most of ours are
+ *    used, in vector and in small_vector. A replaced operator new counts
+ *    the allocations; for Spy elements its own counter takes out the
+ *    ones Spy makes itself, leaving those of the container, and the Spy
+ *    counters show the element copies and moves.
+ *
+ *       benchSmallVector                : 1M vectors of 0 to 8 elements
+ *       benchSmallVector 100000 16      : vectors, largest size
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "vector.h"
+#include "small_vector.h"
+#include "spy.h"
+
+using namespace std::chrono;
+
+int Spy::counters[] = {};
+
+/**********************************************************************
+ * OPERATOR NEW
+ * Count every allocation
+ ***********************************************************************/
+static size_t numAllocs = 0;
+
+void * operator new(size_t size)
+{
+   void * p = std::malloc(size ? size : 1);
+   if (!p)
+      throw std::bad_alloc();
+   numAllocs++;
+   return p;
+}
+
+void operator delete(void * p) noexcept            { std::free(p); }
+void operator delete(void * p, size_t) noexcept    { std::free(p); }
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, double seconds, size_t numOps,
+            size_t numContainerAllocs, long long numMoves, long long checksum)
+{
+   std::cout << std::setw(26) << name
+             << std::setw(12) << (double)numOps / seconds / 1.0e6
+             << std::setw(14) << std::setprecision(3) << (double)numContainerAllocs / numOps
+             << std::setw(14) << (double)numMoves / numOps
+             << std::setw(14) << checksum << std::setprecision(1) << std::endl;
+}
+
+/**********************************************************************
+ * TIME TINY
+ * numVectors times: push a handful of elements, add them up,
+ * let the vector go. Every push_back is an operation
+ ***********************************************************************/
+template <class Vector, class Make, class Value>
+void timeTiny(const char * name, size_t numVectors, size_t sizeMax, Make make, Value value)
+{
+   size_t numOps = 0;
+   long long checksum = 0;
+   unsigned int seed = 1;
+
+   Spy::reset();
+   size_t numAllocsStart = numAllocs;
+   auto start = steady_clock::now();
+   for (size_t i = 0; i < numVectors; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      size_t num = (seed >> 16) % (sizeMax + 1);
+
+      Vector v;
+      for (size_t j = 0; j < num; j++)
+         v.push_back(make((int)j));
+      for (auto it = v.begin(); it != v.end(); ++it)
+         checksum += value(*it);
+      numOps += num;
+   }
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   size_t numContainerAllocs = numAllocs - numAllocsStart - Spy::numAlloc();
+   long long numMoves = Spy::numCopy() + Spy::numCopyMove();
+   report(name, seconds, numOps, numContainerAllocs, numMoves, checksum);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t numVectors = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+   size_t sizeMax    = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 8;
+
+   auto makeInt  = [](int i) { return i; };
+   auto valueInt = [](int & i) { return (long long)i; };
+   auto makeSpy  = [](int i) { return Spy(i); };
+   auto valueSpy = [](Spy & s) { return (long long)s.get(); };
+
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(26) << "container"
+             << std::setw(12) << "M push/s"
+             << std::setw(14) << "allocs/push"
+             << std::setw(14) << "moves/push"
+             << std::setw(14) << "checksum" << std::endl;
+
+   timeTiny<custom::vector<int>>         ("vector<int>",          numVectors, sizeMax, makeInt, valueInt);
+   timeTiny<custom::small_vector<int, 8>>("small_vector<int, 8>", numVectors, sizeMax, makeInt, valueInt);
+   timeTiny<custom::vector<Spy>>         ("vector<Spy>",          numVectors, sizeMax, makeSpy, valueSpy);
+   timeTiny<custom::small_vector<Spy, 8>>("small_vector<Spy, 8>", numVectors, sizeMax, makeSpy, valueSpy);
+
+   return 0;
+}
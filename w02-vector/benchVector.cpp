@@ -0,0 +1,97 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Append integers one push_back at a time until the vector holds
+ *    the requested number of bytes, under each growth policy, with
+ *    and without the mapped (mremap) buffers, against std::vector.
+ *
+ *       benchVector                     : 64MB, 512MB and 2GB
+ *       benchVector 1048576 4294967296  : any list of sizes in bytes
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include "vector.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * PLAIN ALLOCATOR
+ * Just std::allocator under another name, so the vector
+ * never maps its buffer
+ ***********************************************************************/
+template <typename T>
+struct plain_allocator : public std::allocator<T>
+{
+   template <typename U>
+   struct rebind { typedef plain_allocator<U> other; };
+};
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, double seconds, size_t num, long long checksum)
+{
+   std::cout << std::setw(26) << name
+             << std::setw(12) << seconds * 1000.0
+             << std::setw(14) << (double)num / seconds / 1.0e6
+             << std::setw(20) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * TIME APPEND
+ * Push num integers onto an empty vector
+ ***********************************************************************/
+template <class Vector>
+void timeAppend(const char * name, size_t num)
+{
+   auto start = steady_clock::now();
+   long long checksum = 0;
+   {
+      Vector v;
+      for (size_t i = 0; i < num; i++)
+         v.push_back((int)i);
+      checksum = (long long)v.size() + v[num / 2] + v.capacity();
+   }
+   report(name, duration<double>(steady_clock::now() - start).count(), num, checksum);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)64 << 20, (size_t)512 << 20, (size_t)2 << 30 };
+
+   std::cout << std::fixed << std::setprecision(1);
+   for (size_t bytes : sizes)
+   {
+      size_t num = bytes / sizeof(int);
+      std::cout << "\n" << bytes / (1 << 20) << " MB of ints\n";
+      std::cout << std::setw(26) << "vector"
+                << std::setw(12) << "ms"
+                << std::setw(14) << "M push/s"
+                << std::setw(20) << "checksum" << std::endl;
+
+      timeAppend<std::vector<int>>("std::vector", num);
+      timeAppend<custom::vector<int, plain_allocator<int>, custom::growth_double>>("double", num);
+      timeAppend<custom::vector<int, plain_allocator<int>, custom::growth_half>>("half", num);
+      timeAppend<custom::vector<int, plain_allocator<int>, custom::growth_paged>>("paged", num);
+      timeAppend<custom::vector<int, std::allocator<int>, custom::growth_double>>("double + mremap", num);
+      timeAppend<custom::vector<int, std::allocator<int>, custom::growth_half>>("half + mremap", num);
+      timeAppend<custom::vector<int, std::allocator<int>, custom::growth_paged>>("paged + mremap", num);
+   }
+
+   return 0;
+}
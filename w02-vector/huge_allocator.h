@@ -0,0 +1,173 @@
+/***********************************************************************
+ * Header:
+ *    HUGE ALLOCATOR
+ * Summary:
+ *    An allocator for big vectors: large buffers are aligned to
+ *    2MB and asked for transparent huge pages, and can be spread
+ *    over the NUMA nodes rather than left where they are first touched
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        huge_allocator         : Use as the A of vector<T, A>
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uintptr_t
+#include <new>          // for std::bad_alloc and operator new
+#include <utility>      // for std::forward
+#ifdef __linux__
+#include <sys/mman.h>   // for mmap, munmap, madvise
+#endif
+#ifdef CUSTOM_NUMA      // defined by the build when libnuma is there
+#include <numa.h>       // for numa_available, numa_interleave_memory
+#endif
+
+namespace custom
+{
+
+/*****************************************
+ * NUMA POLICY
+ * Where the pages of a big buffer live
+ ****************************************/
+enum numa_policy
+{
+   NUMA_FIRST_TOUCH,   // on the node of the thread that first writes each page
+   NUMA_INTERLEAVE     // round robin over every node
+};
+
+// the size of a huge page, and the smallest buffer that gets them
+static const size_t HUGE_PAGE_BYTES = (size_t)2 << 20;
+
+/*****************************************
+ * HUGE ALLOCATOR
+ * A buffer of a huge page or more comes from mmap,
+ * 2MB-aligned so the kernel can back it with huge
+ * pages, with madvise(MADV_HUGEPAGE) asking it to.
+ * With NUMA_INTERLEAVE its pages are spread across
+ * the nodes. Anything smaller comes from operator
+ * new. Every step degrades to what the system has:
+ * no THP, no libnuma or one node just mean ordinary
+ * pages where they fall.
+ ****************************************/
+template <typename T, numa_policy P = NUMA_FIRST_TOUCH>
+class huge_allocator
+{
+public:
+   typedef T value_type;
+   template <typename U>
+   struct rebind { typedef huge_allocator<U, P> other; };
+
+   huge_allocator() {}
+   template <typename U>
+   huge_allocator(const huge_allocator<U, P> &) {}
+
+   T * allocate(size_t num);
+   void deallocate(T * p, size_t num);
+
+   template <typename U, typename ... Args>
+   void construct(U * p, Args && ... args)
+   {
+      new ((void*)p) U(std::forward<Args>(args)...);
+   }
+   template <typename U>
+   void destroy(U * p)
+   {
+      p->~U();
+   }
+
+   // is a buffer of num elements one of ours, from mmap?
+   static bool isHuge(size_t num)
+   {
+#ifdef __linux__
+      return num * sizeof(T) >= HUGE_PAGE_BYTES;
+#else
+      return false;
+#endif
+   }
+
+private:
+   static size_t hugeBytes(size_t num)
+   {
+      return (num * sizeof(T) + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+   }
+};
+
+/*****************************************
+ * HUGE ALLOCATOR :: ALLOCATE
+ * Map a little extra so we can trim the front
+ * and back to a 2MB boundary, then ask for huge
+ * pages and the NUMA policy. Neither request is
+ * fatal if the kernel says no
+ ****************************************/
+template <typename T, numa_policy P>
+T * huge_allocator <T, P> ::allocate(size_t num)
+{
+   if (!isHuge(num))
+      return static_cast<T *>(::operator new(num * sizeof(T)));
+
+#ifdef __linux__
+   size_t numBytes = hugeBytes(num);
+   size_t numBytesMapped = numBytes + HUGE_PAGE_BYTES;
+   void * pMapped = mmap(nullptr, numBytesMapped, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (pMapped == MAP_FAILED)
+      throw std::bad_alloc();
+
+   // trim to the boundary
+   uintptr_t iMapped = (uintptr_t)pMapped;
+   uintptr_t iAligned = (iMapped + HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(HUGE_PAGE_BYTES - 1);
+   if (iAligned > iMapped)
+      munmap(pMapped, iAligned - iMapped);
+   size_t numBytesBack = iMapped + numBytesMapped - (iAligned + numBytes);
+   if (numBytesBack > 0)
+      munmap((void*)(iAligned + numBytes), numBytesBack);
+
+   void * p = (void*)iAligned;
+#ifdef MADV_HUGEPAGE
+   madvise(p, numBytes, MADV_HUGEPAGE);
+#endif
+#ifdef CUSTOM_NUMA
+   if (P == NUMA_INTERLEAVE && numa_available() >= 0 && numa_num_configured_nodes() > 1)
+      numa_interleave_memory(p, numBytes, numa_all_nodes_ptr);
+#endif
+   return static_cast<T *>(p);
+#else
+   return nullptr;
+#endif
+}
+
+/*****************************************
+ * HUGE ALLOCATOR :: DEALLOCATE
+ * Give back a buffer from allocate(num)
+ ****************************************/
+template <typename T, numa_policy P>
+void huge_allocator <T, P> ::deallocate(T * p, size_t num)
+{
+   if (p == nullptr)
+      return;
+#ifdef __linux__
+   if (isHuge(num))
+   {
+      munmap((void*)p, hugeBytes(num));
+      return;
+   }
+#endif
+   ::operator delete((void*)p);
+}
+
+template <typename T, typename U, numa_policy P>
+bool operator == (const huge_allocator<T, P> &, const huge_allocator<U, P> &) { return true; }
+template <typename T, typename U, numa_policy P>
+bool operator != (const huge_allocator<T, P> &, const huge_allocator<U, P> &) { return false; }
+
+} // namespace custom
@@ -0,0 +1,463 @@
+/***********************************************************************
+ * Header:
+ *    SIMD
+ * Summary:
+ *    Bulk algorithms over a whole vector: fill, find, count, min,
+ *    max, minmax and sum. For vectors of int and float they run
+ *    eight elements at a time with AVX2 when the CPU has it, and
+ *    fall back to a plain loop when it does not
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the definitions of:
+ *        fill, find, count      : Over every element of a vector
+ *        min, max, minmax, sum  : Reductions over a vector
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>      // for size_t
+#include <type_traits>  // for std::conditional
+#include <utility>      // for std::pair
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CUSTOM_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>     // for __cpuid and _xgetbv
+#define CUSTOM_AVX2
+#else
+// compile just these functions for AVX2, whatever the rest is built for
+#define CUSTOM_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace custom
+{
+
+namespace simd
+{
+
+/*****************************************
+ * AVX2 ENABLED
+ * Ask the CPU once. Tests turn it off to
+ * check the plain loops against the same input
+ ****************************************/
+inline bool & avx2Enabled()
+{
+   static bool enabled = []()
+   {
+#if defined(CUSTOM_SIMD_X86) && defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7)
+         return false;
+      __cpuid(info, 1);
+      bool osSaves = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+      __cpuidex(info, 7, 0);
+      return osSaves && (info[1] & (1 << 5)) != 0;
+#elif defined(CUSTOM_SIMD_X86)
+      return __builtin_cpu_supports("avx2") != 0;
+#else
+      return false;
+#endif
+   }();
+   return enabled;
+}
+
+// what sum adds up in: 64 bits for integers, T itself otherwise
+template <typename T>
+struct sum_type
+{
+   typedef typename std::conditional<std::is_integral<T>::value,
+      typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type,
+      T>::type type;
+};
+
+/*****************************************
+ * PLAIN LOOPS
+ * For every T, and for the tail the AVX2
+ * versions leave after the last full eight
+ ****************************************/
+template <typename T>
+void fillLoop(T * p, size_t num, T t)
+{
+   for (size_t i = 0; i < num; i++)
+      p[i] = t;
+}
+
+template <typename T>
+size_t findLoop(const T * p, size_t num, T t)
+{
+   for (size_t i = 0; i < num; i++)
+      if (p[i] == t)
+         return i;
+   return num;
+}
+
+template <typename T>
+size_t countLoop(const T * p, size_t num, T t)
+{
+   size_t count = 0;
+   for (size_t i = 0; i < num; i++)
+      if (p[i] == t)
+         count++;
+   return count;
+}
+
+template <typename T>
+std::pair<T, T> minmaxLoop(const T * p, size_t num, std::pair<T, T> m)
+{
+   for (size_t i = 0; i < num; i++)
+   {
+      if (p[i] < m.first)
+         m.first = p[i];
+      if (m.second < p[i])
+         m.second = p[i];
+   }
+   return m;
+}
+
+template <typename T>
+typename sum_type<T>::type sumLoop(const T * p, size_t num)
+{
+   typename sum_type<T>::type sum = 0;
+   for (size_t i = 0; i < num; i++)
+      sum += p[i];
+   return sum;
+}
+
+#ifdef CUSTOM_SIMD_X86
+
+/*****************************************
+ * AVX2 :: INT
+ * Eight ints at a time, then the plain loop
+ * for what is left
+ ****************************************/
+CUSTOM_AVX2 inline void fillAvx2(int * p, size_t num, int t)
+{
+   __m256i x = _mm256_set1_epi32(t);
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      _mm256_storeu_si256((__m256i *)(p + i), x);
+   fillLoop(p + i, num - i, t);
+}
+
+CUSTOM_AVX2 inline size_t findAvx2(const int * p, size_t num, int t)
+{
+   __m256i x = _mm256_set1_epi32(t);
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+   {
+      __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i)), x);
+      int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+      if (mask != 0)
+      {
+         size_t j = 0;
+         while (!(mask & (1 << j)))
+            j++;
+         return i + j;
+      }
+   }
+   return i + findLoop(p + i, num - i, t);
+}
+
+CUSTOM_AVX2 inline size_t countAvx2(const int * p, size_t num, int t)
+{
+   // a match is -1 in its lane, so subtracting counts it. Flush the
+   // lanes before they could overflow
+   __m256i x = _mm256_set1_epi32(t);
+   size_t count = 0;
+   size_t i = 0;
+   while (i + 8 <= num)
+   {
+      __m256i acc = _mm256_setzero_si256();
+      for (size_t n = 0; n < (1u << 30) && i + 8 <= num; n++, i += 8)
+         acc = _mm256_sub_epi32(acc,
+            _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i)), x));
+      alignas(32) unsigned int lanes[8];
+      _mm256_store_si256((__m256i *)lanes, acc);
+      for (int j = 0; j < 8; j++)
+         count += lanes[j];
+   }
+   return count + countLoop(p + i, num - i, t);
+}
+
+CUSTOM_AVX2 inline std::pair<int, int> minmaxAvx2(const int * p, size_t num)
+{
+   std::pair<int, int> m(p[0], p[0]);
+   size_t i = 0;
+   if (num >= 8)
+   {
+      __m256i lo = _mm256_loadu_si256((const __m256i *)p);
+      __m256i hi = lo;
+      for (i = 8; i + 8 <= num; i += 8)
+      {
+         __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+         lo = _mm256_min_epi32(lo, x);
+         hi = _mm256_max_epi32(hi, x);
+      }
+      alignas(32) int lanesLo[8];
+      alignas(32) int lanesHi[8];
+      _mm256_store_si256((__m256i *)lanesLo, lo);
+      _mm256_store_si256((__m256i *)lanesHi, hi);
+      m = minmaxLoop(lanesLo, 8, m);
+      m = minmaxLoop(lanesHi, 8, m);
+   }
+   return minmaxLoop(p + i, num - i, m);
+}
+
+CUSTOM_AVX2 inline long long sumAvx2(const int * p, size_t num)
+{
+   // widen to 64 bits as we go, so it adds up like the plain loop
+   __m256i acc = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+   {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+      acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+      acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+   }
+   alignas(32) long long lanes[4];
+   _mm256_store_si256((__m256i *)lanes, acc);
+   return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumLoop(p + i, num - i);
+}
+
+/*****************************************
+ * AVX2 :: FLOAT
+ * Same as int. min and max take the lanes'
+ * word for NaN, and sum adds in eight lanes,
+ * so the rounding is not the plain loop's
+ ****************************************/
+CUSTOM_AVX2 inline void fillAvx2(float * p, size_t num, float t)
+{
+   __m256 x = _mm256_set1_ps(t);
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      _mm256_storeu_ps(p + i, x);
+   fillLoop(p + i, num - i, t);
+}
+
+CUSTOM_AVX2 inline size_t findAvx2(const float * p, size_t num, float t)
+{
+   __m256 x = _mm256_set1_ps(t);
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+   {
+      int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + i), x, _CMP_EQ_OQ));
+      if (mask != 0)
+      {
+         size_t j = 0;
+         while (!(mask & (1 << j)))
+            j++;
+         return i + j;
+      }
+   }
+   return i + findLoop(p + i, num - i, t);
+}
+
+CUSTOM_AVX2 inline size_t countAvx2(const float * p, size_t num, float t)
+{
+   __m256 x = _mm256_set1_ps(t);
+   size_t count = 0;
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+   {
+      int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + i), x, _CMP_EQ_OQ));
+      for (; mask; mask &= mask - 1)
+         count++;
+   }
+   return count + countLoop(p + i, num - i, t);
+}
+
+CUSTOM_AVX2 inline std::pair<float, float> minmaxAvx2(const float * p, size_t num)
+{
+   std::pair<float, float> m(p[0], p[0]);
+   size_t i = 0;
+   if (num >= 8)
+   {
+      __m256 lo = _mm256_loadu_ps(p);
+      __m256 hi = lo;
+      for (i = 8; i + 8 <= num; i += 8)
+      {
+         __m256 x = _mm256_loadu_ps(p + i);
+         lo = _mm256_min_ps(lo, x);
+         hi = _mm256_max_ps(hi, x);
+      }
+      alignas(32) float lanesLo[8];
+      alignas(32) float lanesHi[8];
+      _mm256_store_ps(lanesLo, lo);
+      _mm256_store_ps(lanesHi, hi);
+      m = minmaxLoop(lanesLo, 8, m);
+      m = minmaxLoop(lanesHi, 8, m);
+   }
+   return minmaxLoop(p + i, num - i, m);
+}
+
+CUSTOM_AVX2 inline float sumAvx2(const float * p, size_t num)
+{
+   __m256 acc = _mm256_setzero_ps();
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      acc = _mm256_add_ps(acc, _mm256_loadu_ps(p + i));
+   alignas(32) float lanes[8];
+   _mm256_store_ps(lanes, acc);
+   return sumLoop(lanes, 8) + sumLoop(p + i, num - i);
+}
+
+#endif // CUSTOM_SIMD_X86
+
+// which element types have AVX2 versions
+template <typename T>
+struct has_avx2 : std::integral_constant<bool,
+#ifdef CUSTOM_SIMD_X86
+   std::is_same<T, int>::value || std::is_same<T, float>::value
+#else
+   false
+#endif
+> {};
+
+/*****************************************
+ * DISPATCH
+ * AVX2 for int and float on a CPU that has it,
+ * the plain loop for everything else
+ ****************************************/
+template <typename T>
+void fill(T * p, size_t num, T t)
+{
+#ifdef CUSTOM_SIMD_X86
+   if constexpr (has_avx2<T>::value)
+      if (avx2Enabled())
+         return fillAvx2(p, num, t);
+#endif
+   fillLoop(p, num, t);
+}
+
+template <typename T>
+size_t find(const T * p, size_t num, T t)
+{
+#ifdef CUSTOM_SIMD_X86
+   if constexpr (has_avx2<T>::value)
+      if (avx2Enabled())
+         return findAvx2(p, num, t);
+#endif
+   return findLoop(p, num, t);
+}
+
+template <typename T>
+size_t count(const T * p, size_t num, T t)
+{
+#ifdef CUSTOM_SIMD_X86
+   if constexpr (has_avx2<T>::value)
+      if (avx2Enabled())
+         return countAvx2(p, num, t);
+#endif
+   return countLoop(p, num, t);
+}
+
+template <typename T>
+std::pair<T, T> minmax(const T * p, size_t num)
+{
+#ifdef CUSTOM_SIMD_X86
+   if constexpr (has_avx2<T>::value)
+      if (avx2Enabled())
+         return minmaxAvx2(p, num);
+#endif
+   return minmaxLoop(p + 1, num - 1, std::pair<T, T>(p[0], p[0]));
+}
+
+template <typename T>
+typename sum_type<T>::type sum(const T * p, size_t num)
+{
+#ifdef CUSTOM_SIMD_X86
+   if constexpr (has_avx2<T>::value)
+      if (avx2Enabled())
+         return sumAvx2(p, num);
+#endif
+   return sumLoop(p, num);
+}
+
+} // namespace simd
+
+/*****************************************
+ * FILL
+ * Set every element of v to t
+ ****************************************/
+template <typename T, typename A, typename G>
+void fill(vector <T, A, G> & v, const T & t)
+{
+   static_assert(std::is_arithmetic<T>::value, "fill is for vectors of numbers");
+   if (!v.empty())
+      simd::fill(&v[0], v.size(), t);
+}
+
+/*****************************************
+ * FIND
+ * The first element equal to t, or end()
+ ****************************************/
+template <typename T, typename A, typename G>
+typename vector <T, A, G>::iterator find(vector <T, A, G> & v, const T & t)
+{
+   static_assert(std::is_arithmetic<T>::value, "find is for vectors of numbers");
+   if (v.empty())
+      return v.end();
+   return typename vector <T, A, G>::iterator(&v[0] + simd::find(&v[0], v.size(), t));
+}
+
+/*****************************************
+ * COUNT
+ * How many elements equal t
+ ****************************************/
+template <typename T, typename A, typename G>
+size_t count(const vector <T, A, G> & v, const T & t)
+{
+   static_assert(std::is_arithmetic<T>::value, "count is for vectors of numbers");
+   return v.empty() ? 0 : simd::count(&v[0], v.size(), t);
+}
+
+/*****************************************
+ * MIN, MAX, MINMAX
+ * The smallest and largest element. v must
+ * not be empty
+ ****************************************/
+template <typename T, typename A, typename G>
+std::pair<T, T> minmax(const vector <T, A, G> & v)
+{
+   static_assert(std::is_arithmetic<T>::value, "minmax is for vectors of numbers");
+   assert(!v.empty());
+   return simd::minmax(&v[0], v.size());
+}
+
+template <typename T, typename A, typename G>
+T min(const vector <T, A, G> & v)
+{
+   return minmax(v).first;
+}
+
+template <typename T, typename A, typename G>
+T max(const vector <T, A, G> & v)
+{
+   return minmax(v).second;
+}
+
+/*****************************************
+ * SUM
+ * Add up every element. Integers add up in
+ * 64 bits, so a vector of int does not overflow
+ ****************************************/
+template <typename T, typename A, typename G>
+typename simd::sum_type<T>::type sum(const vector <T, A, G> & v)
+{
+   static_assert(std::is_arithmetic<T>::value, "sum is for vectors of numbers");
+   return v.empty() ? 0 : simd::sum(&v[0], v.size());
+}
+
+} // namespace custom
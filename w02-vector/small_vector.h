@@ -0,0 +1,437 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first few elements inside itself and
+ *    only goes to the heap when it outgrows them
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A vector with N elements of inline room
+ *        small_vector::iterator : The same iterator as vector
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>           // for memcpy
+#include <new>               // for placement new
+#include <memory>            // for std::allocator
+#include <utility>           // for std::move
+#include <initializer_list>
+#include "vector.h"          // for vector::iterator and is_trivially_relocatable
+
+class TestSmallVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SMALL VECTOR
+ * Just like vector, but with room for N elements
+ * in the object itself. data points at that room
+ * until we need more, then at a buffer from the
+ * allocator. It never goes back on its own, only
+ * through shrink_to_fit.
+ ****************************************/
+template <typename T, size_t N = 8, typename A = std::allocator<T>>
+class small_vector
+{
+   friend class ::TestSmallVector; // give unit tests access to the privates
+
+   static_assert(N > 0, "a small_vector needs room for at least one element");
+
+public:
+
+   //
+   // Construct
+   //
+   small_vector(const A & a = A());
+   small_vector(size_t numElements,                const A & a = A());
+   small_vector(size_t numElements, const T & t,   const A & a = A());
+   small_vector(const std::initializer_list<T>& l, const A & a = A());
+   small_vector(const small_vector &  rhs);
+   small_vector(      small_vector && rhs);
+  ~small_vector();
+
+   //
+   // Assign. Inline elements cannot trade places by pointer,
+   // so swap goes through a third small_vector
+   //
+   void swap(small_vector& rhs)
+   {
+      small_vector temp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(temp);
+   }
+   small_vector & operator = (const small_vector & rhs);
+   small_vector & operator = (small_vector&& rhs);
+
+   //
+   // Iterator
+   //
+   typedef typename vector<T, A>::iterator iterator;
+   iterator begin()
+   {
+      return iterator(data);
+   }
+   iterator end()
+   {
+      return iterator(data + numElements);
+   }
+
+   //
+   // Access
+   //
+         T& operator [] (size_t index)       { return data[index];                   }
+   const T& operator [] (size_t index) const { return data[index];                   }
+         T& front()                          { return data[0];                       }
+   const T& front() const                    { return data[0];                       }
+         T& back()                           { return data[numElements - 1];         }
+   const T& back() const                     { return data[numElements - 1];         }
+
+   //
+   // Insert
+   //
+   void push_back(const T& t);
+   void push_back(T&& t);
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements);
+   void resize(size_t newElements, const T& t);
+
+   //
+   // Remove
+   //
+   void clear()
+   {
+      for (size_t i = 0; i < numElements; ++i)
+         alloc.destroy(&data[i]);
+      numElements = 0;
+   }
+   void pop_back()
+   {
+      if (numElements > 0)
+      {
+         alloc.destroy(&data[numElements - 1]);
+         numElements--;
+      }
+   }
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+   size_t  size()          const { return numElements;}
+   size_t  capacity()      const { return numCapacity;}
+   bool empty()            const { return numElements == 0;}
+   bool isInline()         const { return data == inlineData(); }
+
+private:
+
+   // the room inside the object
+         T * inlineData()       { return reinterpret_cast<      T *>(storage); }
+   const T * inlineData() const { return reinterpret_cast<const T *>(storage); }
+
+   // move the elements to the raw memory at pDest, leaving data raw
+   void relocate(T * pDest);
+
+   // give the heap buffer back, if there is one, and go inline
+   void release()
+   {
+      if (!isInline())
+         alloc.deallocate(data, numCapacity);
+      data = inlineData();
+      numCapacity = N;
+   }
+
+   A    alloc;                // use allocator for memory allocation
+   T *  data;                 // the inline room or a heap buffer
+   size_t  numCapacity;       // N when inline
+   size_t  numElements;       // the number of items currently used
+   alignas(T) unsigned char storage[N * sizeof(T)];   // room for N elements
+};
+
+/*****************************************
+ * SMALL VECTOR :: DEFAULT constructor
+ * Empty, using the inline room
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> ::small_vector(const A & a) : alloc(a)
+{
+   data = inlineData();
+   numCapacity = N;
+   numElements = 0;
+}
+
+/*****************************************
+ * SMALL VECTOR :: NON-DEFAULT constructors
+ * num default-constructed elements
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> ::small_vector(size_t num, const A & a) : small_vector(a)
+{
+   resize(num);
+}
+
+/*****************************************
+ * SMALL VECTOR :: NON-DEFAULT constructors
+ * num copies of t
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> ::small_vector(size_t num, const T & t, const A & a) : small_vector(a)
+{
+   resize(num, t);
+}
+
+/*****************************************
+ * SMALL VECTOR :: INITIALIZATION LIST constructors
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> ::small_vector(const std::initializer_list<T> & l, const A & a) : small_vector(a)
+{
+   reserve(l.size());
+   for (auto it = l.begin(); it != l.end(); ++it)
+      alloc.construct(&data[numElements++], *it);
+}
+
+/*****************************************
+ * SMALL VECTOR :: COPY CONSTRUCTOR
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> ::small_vector(const small_vector & rhs) : small_vector(rhs.alloc)
+{
+   reserve(rhs.numElements);
+   for (size_t i = 0; i < rhs.numElements; i++)
+      alloc.construct(&data[i], rhs.data[i]);
+   numElements = rhs.numElements;
+}
+
+/*****************************************
+ * SMALL VECTOR :: MOVE CONSTRUCTOR
+ * Steal a heap buffer. Inline elements have to
+ * be moved one at a time (or relocated)
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> ::small_vector(small_vector && rhs) : small_vector(rhs.alloc)
+{
+   if (rhs.isInline())
+   {
+      rhs.relocate(data);
+      numElements = rhs.numElements;
+   }
+   else
+   {
+      data = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      rhs.data = rhs.inlineData();
+      rhs.numCapacity = N;
+   }
+   rhs.numElements = 0;
+}
+
+/*****************************************
+ * SMALL VECTOR :: DESTRUCTOR
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: ~small_vector()
+{
+   clear();
+   release();
+}
+
+/*****************************************
+ * SMALL VECTOR :: RELOCATE
+ * Move every element to pDest and destroy the
+ * original, with one memcpy when T allows it
+ ****************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::relocate(T * pDest)
+{
+   if (is_trivially_relocatable<T>::value)
+   {
+      if (numElements > 0)
+         std::memcpy((void*)pDest, (const void*)data, numElements * sizeof(T));
+   }
+   else
+   {
+      for (size_t i = 0; i < numElements; i++)
+         new ((void*)(pDest + i)) T(std::move(data[i]));
+      for (size_t i = 0; i < numElements; i++)
+         alloc.destroy(&data[i]);
+   }
+}
+
+/***************************************
+ * SMALL VECTOR :: RESERVE
+ * Room for newCapacity. The inline room
+ * is always there, so only a bigger
+ * capacity goes to the heap
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::reserve(size_t newCapacity)
+{
+   if (newCapacity <= numCapacity)
+      return;
+
+   T * newData = alloc.allocate(newCapacity);
+   relocate(newData);
+   if (!isInline())
+      alloc.deallocate(data, numCapacity);
+
+   data = newData;
+   numCapacity = newCapacity;
+}
+
+/***************************************
+ * SMALL VECTOR :: RESIZE
+ * Grow with default-constructed elements
+ * or shrink from the back
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::resize(size_t newElements)
+{
+   if (newElements < numElements)
+   {
+      for (size_t i = newElements; i < numElements; i++)
+         alloc.destroy(&data[i]);
+   }
+   else if (newElements > numElements)
+   {
+      reserve(newElements);
+      for (size_t i = numElements; i < newElements; i++)
+         alloc.construct(&data[i]);
+   }
+   numElements = newElements;
+}
+
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::resize(size_t newElements, const T & t)
+{
+   if (newElements < numElements)
+   {
+      for (size_t i = newElements; i < numElements; i++)
+         alloc.destroy(&data[i]);
+   }
+   else if (newElements > numElements)
+   {
+      reserve(newElements);
+      for (size_t i = numElements; i < newElements; i++)
+         alloc.construct(&data[i], t);
+   }
+   numElements = newElements;
+}
+
+/***************************************
+ * SMALL VECTOR :: SHRINK TO FIT
+ * Go back inline if we fit, else down to
+ * a heap buffer of exactly numElements
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::shrink_to_fit()
+{
+   if (isInline() || numElements == numCapacity)
+      return;
+
+   T * dataOld = data;
+   size_t numCapacityOld = numCapacity;
+   T * dataNew = numElements <= N ? inlineData() : alloc.allocate(numElements);
+
+   relocate(dataNew);
+   alloc.deallocate(dataOld, numCapacityOld);
+
+   data = dataNew;
+   numCapacity = numElements <= N ? N : numElements;
+}
+
+/***************************************
+ * SMALL VECTOR :: PUSH BACK
+ * Add t to the end, doubling the capacity
+ * when we run out
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::push_back(const T & t)
+{
+   if (numElements == numCapacity)
+      reserve(numCapacity * 2);
+   alloc.construct(&data[numElements], t);
+   numElements++;
+}
+
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> ::push_back(T && t)
+{
+   if (numElements == numCapacity)
+      reserve(numCapacity * 2);
+   new ((void*)(&data[numElements++])) T(std::move(t));
+}
+
+/***************************************
+ * SMALL VECTOR :: ASSIGNMENT
+ * Copy rhs onto *this, reusing what room
+ * we already have
+ **************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> & small_vector <T, N, A> :: operator = (const small_vector & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   if (rhs.numElements > numCapacity)
+   {
+      clear();
+      release();
+      reserve(rhs.numElements);
+   }
+
+   size_t numCommon = numElements < rhs.numElements ? numElements : rhs.numElements;
+   for (size_t i = 0; i < numCommon; i++)
+      data[i] = rhs.data[i];
+   for (size_t i = numCommon; i < rhs.numElements; i++)
+      alloc.construct(&data[i], rhs.data[i]);
+   for (size_t i = rhs.numElements; i < numElements; i++)
+      alloc.destroy(&data[i]);
+
+   numElements = rhs.numElements;
+   return *this;
+}
+
+/***************************************
+ * SMALL VECTOR :: MOVE ASSIGNMENT
+ * Take rhs's heap buffer, or its inline
+ * elements one at a time. rhs is left empty
+ **************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> & small_vector <T, N, A> :: operator = (small_vector && rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   clear();
+   if (rhs.isInline())
+   {
+      // we always have room for N
+      rhs.relocate(data);
+      numElements = rhs.numElements;
+   }
+   else
+   {
+      release();
+      data = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      rhs.data = rhs.inlineData();
+      rhs.numCapacity = N;
+   }
+   rhs.numElements = 0;
+   return *this;
+}
+
+} // namespace custom
@@ -0,0 +1,136 @@
+/***********************************************************************
+ * Header:
+ *    TEST HUGE ALLOCATOR
+ * Summary:
+ *    Unit tests for the huge page allocator
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "huge_allocator.h"
+#include "vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cstdint>
+
+class TestHugeAllocator : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_small();
+      test_allocate_aligned();
+      test_allocate_interleave();
+
+      // Vector
+      test_vector_pushBack();
+      test_vector_spy();
+
+      report("HugeAllocator");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // small buffers come from operator new
+   void test_allocate_small()
+   {  // setup
+      custom::huge_allocator<int> alloc;
+      // exercise
+      int * p = alloc.allocate(100);
+      p[99] = 49;
+      // verify
+      assertUnit(!custom::huge_allocator<int>::isHuge(100));
+      assertUnit(p != nullptr);
+      assertUnit(p[99] == 49);
+      // teardown
+      alloc.deallocate(p, 100);
+   }
+
+   // big buffers start on a huge page boundary
+   void test_allocate_aligned()
+   {  // setup
+      custom::huge_allocator<char> alloc;
+      size_t num = custom::HUGE_PAGE_BYTES * 3 + 1;
+      // exercise
+      char * p = alloc.allocate(num);
+      p[0] = 'a';
+      p[num - 1] = 'z';
+      // verify
+#ifdef __linux__
+      assertUnit(custom::huge_allocator<char>::isHuge(num));
+      assertUnit((uintptr_t)p % custom::HUGE_PAGE_BYTES == 0);
+#endif
+      assertUnit(p[0] == 'a');
+      assertUnit(p[num - 1] == 'z');
+      // teardown
+      alloc.deallocate(p, num);
+   }
+
+   // interleaving works, or quietly does nothing, on any machine
+   void test_allocate_interleave()
+   {  // setup
+      custom::huge_allocator<long long, custom::NUMA_INTERLEAVE> alloc;
+      size_t num = custom::HUGE_PAGE_BYTES;   // 16MB of long long
+      // exercise
+      long long * p = alloc.allocate(num);
+      for (size_t i = 0; i < num; i += 4096)
+         p[i] = (long long)i;
+      // verify
+      assertUnit(p != nullptr);
+      assertUnit(p[4096 * 7] == 4096 * 7);
+      // teardown
+      alloc.deallocate(p, num);
+   }
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // a vector grows from heap buffers into huge ones
+   void test_vector_pushBack()
+   {  // setup
+      custom::vector<int, custom::huge_allocator<int>> v;
+      const int num = 1 << 20;   // 4MB of ints
+      // exercise
+      for (int i = 0; i < num; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.size() == (size_t)num);
+#ifdef __linux__
+      assertUnit((uintptr_t)&v[0] % custom::HUGE_PAGE_BYTES == 0);
+#endif
+      bool same = true;
+      for (int i = 0; i < num; i++)
+         same = same && v[i] == i;
+      assertUnit(same);
+   }  // teardown
+
+   // construct and destroy pass through to the element
+   void test_vector_spy()
+   {  // setup
+      Spy::reset();
+      {
+         custom::vector<Spy, custom::huge_allocator<Spy>> v;
+         v.push_back(Spy(26));
+         v.push_back(Spy(49));
+         // exercise
+         v.pop_back();
+         // verify
+         assertUnit(v.size() == 1);
+         assertUnit(v[0] == Spy(26));
+      }
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,277 @@
+/***********************************************************************
+ * Header:
+ *    TEST SIMD
+ * Summary:
+ *    Unit tests for the bulk vector algorithms. Each one runs twice:
+ *    with AVX2 (when the CPU has it) and with the plain loops
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "simd.h"
+#include "unitTest.h"
+
+#include <climits>
+#include <cstdlib>
+
+class TestSimd : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      bool avx2 = custom::simd::avx2Enabled();
+      for (int pass = 0; pass < 2; pass++)
+      {
+         custom::simd::avx2Enabled() = (pass == 0) && avx2;
+
+         // Fill
+         test_fill_int();
+         test_fill_float();
+         test_fill_empty();
+
+         // Find
+         test_find_inTail();
+         test_find_firstOfMany();
+         test_find_missing();
+         test_find_float();
+
+         // Count
+         test_count_int();
+         test_count_float();
+
+         // Reductions
+         test_minmax_int();
+         test_minmax_float();
+         test_minmax_one();
+         test_sum_intWide();
+         test_sum_float();
+         test_sum_double();
+      }
+      custom::simd::avx2Enabled() = avx2;
+
+      // both ways agree
+      test_paths_agree();
+
+      report("Simd");
+   }
+
+   /***************************************
+    * FILL
+    ***************************************/
+
+   // thirteen ints: one block of eight and a tail of five
+   void test_fill_int()
+   {  // setup
+      custom::vector<int> v(13, 0);
+      // exercise
+      custom::fill(v, 7);
+      // verify
+      bool all = true;
+      for (size_t i = 0; i < v.size(); i++)
+         all = all && v[i] == 7;
+      assertUnit(all);
+      assertUnit(v.size() == 13);
+   }  // teardown
+
+   void test_fill_float()
+   {  // setup
+      custom::vector<float> v(21, 0.0f);
+      // exercise
+      custom::fill(v, 2.5f);
+      // verify
+      assertUnit(v[0] == 2.5f);
+      assertUnit(v[15] == 2.5f);
+      assertUnit(v[20] == 2.5f);
+   }  // teardown
+
+   void test_fill_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      custom::fill(v, 7);
+      // verify
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // the match is after the last full block of eight
+   void test_find_inTail()
+   {  // setup
+      custom::vector<int> v(19, 0);
+      v[17] = 49;
+      // exercise
+      auto it = custom::find(v, 49);
+      // verify
+      assertUnit(it == custom::vector<int>::iterator(&v[17]));
+   }  // teardown
+
+   // several matches in one block: the first one wins
+   void test_find_firstOfMany()
+   {  // setup
+      custom::vector<int> v(32, 0);
+      v[11] = 49;
+      v[13] = 49;
+      v[30] = 49;
+      // exercise
+      auto it = custom::find(v, 49);
+      // verify
+      assertUnit(it == custom::vector<int>::iterator(&v[11]));
+   }  // teardown
+
+   void test_find_missing()
+   {  // setup
+      custom::vector<int> v(32, 0);
+      // exercise
+      auto it = custom::find(v, 49);
+      // verify
+      assertUnit(it == v.end());
+   }  // teardown
+
+   void test_find_float()
+   {  // setup
+      custom::vector<float> v(16, 1.0f);
+      v[9] = -0.5f;
+      // exercise
+      auto it = custom::find(v, -0.5f);
+      // verify
+      assertUnit(it == custom::vector<float>::iterator(&v[9]));
+   }  // teardown
+
+   /***************************************
+    * COUNT
+    ***************************************/
+
+   void test_count_int()
+   {  // setup
+      custom::vector<int> v(27, 0);
+      for (size_t i = 0; i < v.size(); i += 3)
+         v[i] = 5;
+      // exercise
+      size_t num = custom::count(v, 5);
+      // verify
+      assertUnit(num == 9);
+   }  // teardown
+
+   void test_count_float()
+   {  // setup
+      custom::vector<float> v(10, 1.5f);
+      v[3] = 0.0f;
+      // exercise
+      size_t num = custom::count(v, 1.5f);
+      // verify
+      assertUnit(num == 9);
+   }  // teardown
+
+   /***************************************
+    * MIN, MAX, SUM
+    ***************************************/
+
+   // the smallest is in a block, the largest in the tail
+   void test_minmax_int()
+   {  // setup
+      custom::vector<int> v(20, 0);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = (int)i - 5;
+      v[4] = INT_MIN;
+      v[18] = INT_MAX;
+      // exercise
+      std::pair<int, int> m = custom::minmax(v);
+      // verify
+      assertUnit(m.first == INT_MIN);
+      assertUnit(m.second == INT_MAX);
+      assertUnit(custom::min(v) == INT_MIN);
+      assertUnit(custom::max(v) == INT_MAX);
+   }  // teardown
+
+   void test_minmax_float()
+   {  // setup
+      custom::vector<float> v(17, 0.0f);
+      v[16] = -3.25f;
+      v[8] = 1.0e10f;
+      // exercise
+      std::pair<float, float> m = custom::minmax(v);
+      // verify
+      assertUnit(m.first == -3.25f);
+      assertUnit(m.second == 1.0e10f);
+   }  // teardown
+
+   void test_minmax_one()
+   {  // setup
+      custom::vector<int> v(1, 49);
+      // exercise
+      std::pair<int, int> m = custom::minmax(v);
+      // verify
+      assertUnit(m.first == 49);
+      assertUnit(m.second == 49);
+   }  // teardown
+
+   // a sum of ints adds up in 64 bits
+   void test_sum_intWide()
+   {  // setup
+      custom::vector<int> v(11, INT_MAX);
+      // exercise
+      long long s = custom::sum(v);
+      // verify
+      assertUnit(s == 11LL * INT_MAX);
+   }  // teardown
+
+   // small whole numbers add up exactly in any order
+   void test_sum_float()
+   {  // setup
+      custom::vector<float> v(100, 0.0f);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = (float)i;
+      // exercise
+      float s = custom::sum(v);
+      // verify
+      assertUnit(s == 4950.0f);
+   }  // teardown
+
+   // no AVX2 version for double: always the plain loop
+   void test_sum_double()
+   {  // setup
+      custom::vector<double> v(9, 0.5);
+      // exercise
+      double s = custom::sum(v);
+      // verify
+      assertUnit(s == 4.5);
+   }  // teardown
+
+   /***************************************
+    * BOTH PATHS
+    ***************************************/
+
+   // on random ints AVX2 and the plain loops give the same answers
+   void test_paths_agree()
+   {  // setup
+      custom::vector<int> v(1003, 0);
+      std::srand(26);
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] = std::rand() % 64 - 32;
+      bool avx2 = custom::simd::avx2Enabled();
+      // exercise
+      custom::simd::avx2Enabled() = false;
+      size_t countLoop = custom::count(v, 3);
+      std::pair<int, int> mLoop = custom::minmax(v);
+      long long sumLoop = custom::sum(v);
+      custom::simd::avx2Enabled() = avx2;
+      size_t countFast = custom::count(v, 3);
+      std::pair<int, int> mFast = custom::minmax(v);
+      long long sumFast = custom::sum(v);
+      // verify
+      assertUnit(countLoop == countFast);
+      assertUnit(mLoop == mFast);
+      assertUnit(sumLoop == sumFast);
+   }  // teardown
+};
+
+#endif // DEBUG
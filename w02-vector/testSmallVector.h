@@ -0,0 +1,303 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for the small vector
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+
+class TestSmallVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_inline();
+      test_constructCopy_heap();
+      test_constructMove_inline();
+      test_constructMove_heap();
+
+      // Assign
+      test_assign_inlineToHeap();
+      test_assignMove_heap();
+      test_swap_inlineHeap();
+
+      // Iterator
+      test_iterator_sum();
+
+      // Insert
+      test_pushback_inline();
+      test_pushback_spill();
+      test_pushback_spillInts();
+
+      // Remove
+      test_shrink_backInline();
+      test_shrink_stayHeap();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty small_vector uses its own room
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v;
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // copy a small_vector that fits inline
+   void test_constructCopy_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc = { Spy(26), Spy(49) };
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(Spy::numAlloc() == 2);
+      assertUnit(vDest.isInline());
+      assertUnit(vDest.numElements == 2);
+      assertUnit(vDest.data[0] == Spy(26));
+      assertUnit(vDest.data[1] == Spy(49));
+      assertUnit(vSrc.numElements == 2);
+   }  // teardown
+
+   // copy a small_vector that has spilled: the copy spills too
+   void test_constructCopy_heap()
+   {  // setup
+      custom::small_vector<int, 2> vSrc = { 26, 49, 67 };
+      // exercise
+      custom::small_vector<int, 2> vDest(vSrc);
+      // verify
+      assertUnit(!vDest.isInline());
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(vDest.numCapacity == 3);
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vDest.data[2] == 67);
+   }  // teardown
+
+   // moving inline elements moves each one
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc = { Spy(26), Spy(49) };
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(vDest.isInline());
+      assertUnit(vDest.numElements == 2);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+      assertUnit(vDest.data[1] == Spy(49));
+   }  // teardown
+
+   // moving a heap buffer just takes the pointer
+   void test_constructMove_heap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc = { Spy(26), Spy(49), Spy(67) };
+      Spy * pData = vSrc.data;
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 2> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(vDest.data == pData);
+      assertUnit(vDest.numCapacity == 3);
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numCapacity == 2);
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // copying a big one onto a small one spills
+   void test_assign_inlineToHeap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc = { Spy(26), Spy(49), Spy(67) };
+      custom::small_vector<Spy, 2> vDest = { Spy(11) };
+      Spy::reset();
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(!vDest.isInline());
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vDest.data[0] == Spy(26));
+      assertUnit(vDest.data[2] == Spy(67));
+   }  // teardown
+
+   // move-assign takes the heap buffer and frees ours
+   void test_assignMove_heap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc = { Spy(26), Spy(49), Spy(67) };
+      custom::small_vector<Spy, 2> vDest = { Spy(11), Spy(22), Spy(33) };
+      Spy * pData = vSrc.data;
+      Spy::reset();
+      // exercise
+      vDest = std::move(vSrc);
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(vDest.data == pData);
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   // swap one that is inline with one that spilled
+   void test_swap_inlineHeap()
+   {  // setup
+      custom::small_vector<int, 2> vLeft  = { 26 };
+      custom::small_vector<int, 2> vRight = { 11, 22, 33 };
+      int * pRight = vRight.data;
+      // exercise
+      vLeft.swap(vRight);
+      // verify
+      assertUnit(vLeft.data == pRight);
+      assertUnit(vLeft.numElements == 3);
+      assertUnit(vLeft.data[2] == 33);
+      assertUnit(vRight.isInline());
+      assertUnit(vRight.numElements == 1);
+      assertUnit(vRight.data[0] == 26);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk both the inline and the spilled elements
+   void test_iterator_sum()
+   {  // setup
+      custom::small_vector<int, 2> v = { 1, 2, 3, 4 };
+      int sum = 0;
+      // exercise
+      for (auto it = v.begin(); it != v.end(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(sum == 10);
+   }  // teardown
+
+   /***************************************
+    * PUSH BACK
+    ***************************************/
+
+   // up to N elements stay inline
+   void test_pushback_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      v.push_back(s);
+      v.push_back(s);
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 4);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+   }  // teardown
+
+   // element N + 1 moves everything to the heap at twice the room
+   void test_pushback_spill()
+   {  // setup
+      custom::small_vector<Spy, 4> v = { Spy(1), Spy(2), Spy(3), Spy(4) };
+      Spy::reset();
+      // exercise
+      v.push_back(Spy(5));
+      // verify
+      assertUnit(Spy::numCopyMove() == 5);   // four relocated, one pushed
+      assertUnit(Spy::numDestructor() == 5);
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == Spy(1));
+      assertUnit(v.data[4] == Spy(5));
+   }  // teardown
+
+   // ints spill with a memcpy and keep their values
+   void test_pushback_spillInts()
+   {  // setup
+      custom::small_vector<int, 2> v;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         v.push_back(i * i);
+      // verify
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 16);
+      assertUnit(v.numElements == 9);
+      assertUnit(v.data[1] == 1);
+      assertUnit(v.data[8] == 64);
+   }  // teardown
+
+   /***************************************
+    * SHRINK TO FIT
+    ***************************************/
+
+   // a spilled vector that fits again comes back inline
+   void test_shrink_backInline()
+   {  // setup
+      custom::small_vector<Spy, 2> v = { Spy(26), Spy(49), Spy(67) };
+      v.pop_back();
+      Spy::reset();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(v.isInline());
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.data[1] == Spy(49));
+   }  // teardown
+
+   // one that does not fit goes to an exact heap buffer
+   void test_shrink_stayHeap()
+   {  // setup
+      custom::small_vector<int, 2> v = { 26, 49, 67 };
+      v.push_back(89);
+      v.push_back(11);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(!v.isInline());
+      assertUnit(v.numCapacity == 5);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[4] == 11);
+   }  // teardown
+};
+
+#endif // DEBUG
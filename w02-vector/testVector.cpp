@@ -13,6 +13,9 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testVector.h"     // for the vector unit tests
+#include "testSmallVector.h" // for the small vector unit tests
+#include "testSimd.h"        // for the bulk algorithm unit tests
+#include "testHugeAllocator.h" // for the huge page allocator unit tests
 #include "testSpy.h"        // for the spy unit tests
 int Spy::counters[] = {};
 
@@ -27,6 +30,9 @@ int main()
    // unit tests
    TestSpy().run();
    TestVector().run();
+   TestSmallVector().run();
+   TestSimd().run();
+   TestHugeAllocator().run();
 #endif // DEBUG
    
    return 0;
@@ -97,6 +97,10 @@ public:
       test_resize_fourZero();
       test_resize_fourSixDefault();
       test_resize_fourSixValue();
+      test_resizeDefaultInit_fourSix();
+      test_resizeUninitialized_ints();
+      test_appendFrom_partial();
+      test_appendFrom_none();
       test_reserve_emptyZero();
       test_reserve_emptyTen();
       test_reserve_fourZero();
@@ -104,6 +108,13 @@ public:
       test_reserve_fourTen();
       test_reserve_standardZero();
       test_reserve_standardTen();
+      test_reserve_relocateInts();
+      test_reserve_relocateUniquePtr();
+      test_growth_double();
+      test_growth_half();
+      test_growth_pagedSmall();
+      test_growth_pagedLarge();
+      test_pushback_mapped();
 
       // // Remove
       test_popback_empty();
@@ -756,6 +767,87 @@ public:
       teardownStandardFixture(v);
    }
    
+   // default-init constructs Spy with its default constructor, as resize does
+   void test_resizeDefaultInit_fourSix()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.resize_default_init(6);
+      // verify
+      assertUnit(Spy::numDefault() == 2);    // the two new ones
+      assertUnit(Spy::numCopyMove() == 4);   // the four old ones, moved
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.data[3] == Spy(89));
+      assertUnit(v.data[5].empty());
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // uninitialized just moves the end
+   void test_resizeUninitialized_ints()
+   {  // setup
+      custom::vector<int> v;
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      v.resize_uninitialized(5);
+      v.data[4] = 89;
+      // verify
+      assertUnit(v.numCapacity == 5);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[4] == 89);
+   }  // teardown
+
+   // the reader fills less than we asked for
+   void test_appendFrom_partial()
+   {  // setup
+      custom::vector<int> v;
+      v.push_back(26);
+      size_t numOffered = 0;
+      // exercise
+      size_t num = v.append_from([&numOffered](int * pDest, size_t numMax)
+         {
+            numOffered = numMax;
+            for (int i = 0; i < 3; i++)
+               pDest[i] = i + 1;
+            return (size_t)3;
+         }, 8);
+      // verify
+      assertUnit(numOffered == 8);
+      assertUnit(num == 3);
+      assertUnit(v.numCapacity == 9);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 1);
+      assertUnit(v.data[3] == 3);
+   }  // teardown
+
+   // a reader with nothing left leaves the vector alone
+   void test_appendFrom_none()
+   {  // setup
+      custom::vector<int> v;
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      size_t num = v.append_from([](int *, size_t) { return (size_t)0; }, 2);
+      // verify
+      assertUnit(num == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.data[1] == 49);
+   }  // teardown
+
    // reserve zero on an empty vector
    void test_reserve_emptyZero()
    {  // setup
@@ -971,6 +1063,123 @@ public:
       teardownStandardFixture(v);
    }
    
+   // ints are relocated with memcpy and keep their values
+   void test_reserve_relocateInts()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      v.push_back(89);
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(custom::is_trivially_relocatable<int>::value);
+      assertUnit(!custom::is_trivially_relocatable<Spy>::value);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   // a unique_ptr is relocated without a move or a destructor, so
+   // each pointer is in the new buffer and freed exactly once
+   void test_reserve_relocateUniquePtr()
+   {  // setup
+      custom::vector<std::unique_ptr<Spy>> v;
+      v.push_back(std::unique_ptr<Spy>(new Spy(26)));
+      v.push_back(std::unique_ptr<Spy>(new Spy(49)));
+      Spy * p0 = v.data[0].get();
+      Spy * p1 = v.data[1].get();
+      Spy::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(custom::is_trivially_relocatable<std::unique_ptr<Spy>>::value);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.data[0].get() == p0);
+      assertUnit(v.data[1].get() == p1);
+      assertUnit(*v.data[1] == Spy(49));
+   }  // teardown
+
+   // the default policy doubles, starting at one
+   void test_growth_double()
+   {  // setup
+      // exercise
+      size_t num0 = custom::growth_double::next(0, 1, sizeof(int));
+      size_t num3 = custom::growth_double::next(3, 4, sizeof(int));
+      size_t num4 = custom::growth_double::next(4, 20, sizeof(int));
+      // verify
+      assertUnit(num0 == 1);
+      assertUnit(num3 == 6);
+      assertUnit(num4 == 20);   // never less than needed
+   }  // teardown
+
+   // push_back grows by half again with growth_half
+   void test_growth_half()
+   {  // setup
+      custom::vector<Spy, std::allocator<Spy>, custom::growth_half> v;
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(Spy(i));
+      // verify
+      //    capacity 1, 2, 3, 4, 6
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[4] == Spy(4));
+   }  // teardown
+
+   // below a page the paged policy rounds to a power of two bytes
+   void test_growth_pagedSmall()
+   {  // setup
+      // exercise
+      size_t num0  = custom::growth_paged::next(0, 1, sizeof(int));
+      size_t num4  = custom::growth_paged::next(4, 5, sizeof(int));
+      size_t num12 = custom::growth_paged::next(12, 13, 12);
+      // verify
+      assertUnit(num0 == 4);     // 16 bytes at the least
+      assertUnit(num4 == 8);     // 6 ints is 24 bytes, so 32
+      assertUnit(num12 == 21);   // 18 * 12 = 216 bytes, so 256
+   }  // teardown
+
+   // above a page the paged policy rounds to whole pages
+   void test_growth_pagedLarge()
+   {  // setup
+      // exercise
+      size_t num = custom::growth_paged::next(1024, 1025, sizeof(int));
+      // verify
+      //    1536 ints is 6144 bytes, so two pages
+      assertUnit(num == 2048);
+   }  // teardown
+
+   // a big vector of ints is mapped, and keeps its values as it grows
+   void test_pushback_mapped()
+   {  // setup
+      custom::vector<int> v;
+      const int num = 3 << 18;   // three megabytes of ints
+      // exercise
+      for (int i = 0; i < num; i++)
+         v.push_back(i);
+      // verify
+#ifdef __linux__
+      assertUnit(custom::vector<int>::isMapped(v.numCapacity));
+#endif
+      assertUnit(!custom::vector<Spy>::isMapped(v.numCapacity));
+      assertUnit(v.numCapacity == 1 << 20);
+      assertUnit(v.numElements == (size_t)num);
+      bool same = true;
+      for (int i = 0; i < num; i++)
+         same = same && v.data[i] == i;
+      assertUnit(same);
+   }  // teardown
+
    // shrink an empty fixture
    void test_shrink_empty()
    {  // setup
@@ -19,9 +19,14 @@
 
 #pragma once
 
-#include <cassert>  // because I am paranoid
-#include <new>      // std::bad_alloc
-#include <memory>   // for std::allocator
+#include <cassert>      // because I am paranoid
+#include <new>          // std::bad_alloc
+#include <memory>       // for std::allocator
+#include <cstring>      // for memcpy
+#include <type_traits>  // for std::is_trivially_copyable
+#ifdef __linux__
+#include <sys/mman.h>   // for mmap, mremap, munmap
+#endif
 
 #include <iostream> // TESTING
 
@@ -33,11 +38,69 @@ class TestHash;
 namespace custom
 {
 
+/*****************************************
+ * IS TRIVIALLY RELOCATABLE
+ * Can a T be moved to new memory with memcpy, the
+ * old bytes then forgotten without a destructor?
+ * Anything trivially copyable can. Specialize this
+ * for types that only own through a pointer.
+ ****************************************/
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+// a unique_ptr is just its pointer (and its deleter)
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+template <typename T>
+struct is_trivially_relocatable<std::default_delete<T>> : std::true_type {};
+
+// the page size the size classes and the mapped buffers round to
+static const size_t PAGE_BYTES = 4096;
+
+/*****************************************
+ * GROWTH
+ * How much capacity push_back asks for when the
+ * vector is full: NUM/DEN times the old capacity,
+ * and at least what is needed. With PAGED the
+ * buffer also rounds up to a size class: a power
+ * of two bytes below a page, whole pages above.
+ * The rounded capacity is what the allocator would
+ * have handed us anyway, so we may as well use it.
+ ****************************************/
+template <size_t NUM = 2, size_t DEN = 1, bool PAGED = false>
+struct growth
+{
+   static_assert(NUM > DEN, "growth must grow");
+
+   static size_t next(size_t numCapacity, size_t numNeeded, size_t sizeElement)
+   {
+      size_t num = numCapacity / DEN * NUM + numCapacity % DEN * NUM / DEN;
+      if (num < numNeeded)
+         num = numNeeded;
+      if (!PAGED)
+         return num;
+
+      size_t numBytes = num * sizeElement;
+      size_t numBytesClass = 16;
+      if (numBytes >= PAGE_BYTES)
+         numBytesClass = (numBytes + PAGE_BYTES - 1) / PAGE_BYTES * PAGE_BYTES;
+      else
+         while (numBytesClass < numBytes)
+            numBytesClass *= 2;
+      return numBytesClass / sizeElement;
+   }
+};
+
+typedef growth<2, 1>       growth_double;   // what we have always done
+typedef growth<3, 2>       growth_half;     // 1.5x: a freed buffer can be reused sooner
+typedef growth<3, 2, true> growth_paged;    // 1.5x in size classes
+
 /*****************************************
  * VECTOR
- * Just like the std :: vector <T> class
+ * Just like the std :: vector <T> class.
+ * G is the growth policy above.
  ****************************************/
-template <typename T, typename A = std::allocator<T>>
+template <typename T, typename A = std::allocator<T>, typename G = growth_double>
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
@@ -101,6 +164,15 @@ public:
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
 
+   //
+   // Insert without initializing: for bulk loads that are about
+   // to overwrite the new elements anyway
+   //
+   void resize_default_init(size_t newElements);
+   void resize_uninitialized(size_t newElements);
+   template <class Reader>
+   size_t append_from(Reader reader, size_t num);
+
    //
    // Remove
    //
@@ -131,6 +203,34 @@ public:
 
 private:
 
+   // make room for at least numNeeded, growing by the policy
+   void grow(size_t numNeeded)
+   {
+      reserve(G::next(numCapacity, numNeeded, sizeof(T)));
+   }
+
+   // Big buffers of values we may relocate come straight
+   // from the kernel rather than the allocator, so growing one
+   // can remap its pages instead of copying them
+   static bool isMapped(size_t num)
+   {
+#ifdef __linux__
+      return std::is_same<A, std::allocator<T>>::value &&
+             is_trivially_relocatable<T>::value &&
+             num * sizeof(T) >= MAP_BYTES;
+#else
+      return false;
+#endif
+   }
+   static size_t mappedBytes(size_t num)
+   {
+      return (num * sizeof(T) + PAGE_BYTES - 1) / PAGE_BYTES * PAGE_BYTES;
+   }
+   T * allocateBuffer(size_t num);
+   void deallocateBuffer(T * p, size_t num);
+
+   static const size_t MAP_BYTES = 1 << 20;   // smallest buffer we map
+
    A    alloc;                // use allocator for memory allocation
    T *  data;                 // user data, a dynamically-allocated array
    size_t  numCapacity;       // the capacity of the array
@@ -148,8 +248,8 @@ private:
  * This particular iterator is a bi-directional meaning
  * that ++ and -- both work.  Not all iterators are that way.
  *************************************************/
-template <typename T, typename A>
-class vector <T, A> ::iterator
+template <typename T, typename A, typename G>
+class vector <T, A, G> ::iterator
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
@@ -160,7 +260,7 @@ public:
    iterator()                           { this->p = nullptr;        }
    iterator(T* p)                       { this->p = p;              }
    iterator(const iterator& rhs)        { this->p = rhs.p;          }
-   iterator(size_t index, vector<T>& v) { this->p = v.data + index; }
+   iterator(size_t index, vector& v)    { this->p = v.data + index; }
    iterator& operator = (const iterator& rhs)
    {
       return *this;
@@ -216,8 +316,8 @@ private:
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector(const A & a)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(const A & a)
 {
    data = nullptr;
    numElements = 0;
@@ -230,10 +330,10 @@ vector <T, A> :: vector(const A & a)
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector(size_t num, const T & t, const A & a)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(size_t num, const T & t, const A & a)
 {
-   data = alloc.allocate(num);
+   data = allocateBuffer(num);
 
    for (size_t i = 0; i < num; i++)
    {
@@ -248,10 +348,10 @@ vector <T, A> :: vector(size_t num, const T & t, const A & a)
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(const std::initializer_list<T> & l, const A & a)
 {
-   data = alloc.allocate(l.size());
+   data = allocateBuffer(l.size());
 
    int i = 0;
    for (auto it = l.begin(); it != l.end(); ++it)
@@ -269,13 +369,12 @@ vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a)
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector(size_t num, const A & a)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector(size_t num, const A & a)
 {
-   if (num < 1)
-      data = nullptr;
-   else
-      data = new T[num];
+   data = allocateBuffer(num);
+   for (size_t i = 0; i < num; i++)
+      alloc.construct(&data[i]);
    numElements = num;
    numCapacity = num;
 }
@@ -285,12 +384,12 @@ vector <T, A> :: vector(size_t num, const A & a)
  * Allocate the space for numElements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector (const vector & rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (const vector & rhs)
 {
    if (!rhs.empty())
    {
-      data = alloc.allocate(rhs.numElements);
+      data = allocateBuffer(rhs.numElements);
 
       for (size_t i = 0; i < rhs.numElements; i++)
       {
@@ -312,8 +411,8 @@ vector <T, A> :: vector (const vector & rhs)
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector (vector && rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G> :: vector (vector && rhs)
 {
    data = rhs.data;
    rhs.data = nullptr;
@@ -328,13 +427,14 @@ vector <T, A> :: vector (vector && rhs)
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: ~vector()
+template <typename T, typename A, typename G>
+vector <T, A, G> :: ~vector()
 {
    for (size_t i = 0; i < numElements; i++)
    {
       alloc.destroy(&data[i]);
    }
+   deallocateBuffer(data, numCapacity);
 }
 
 /***************************************
@@ -344,8 +444,8 @@ vector <T, A> :: ~vector()
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: resize(size_t newElements)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize(size_t newElements)
 {
    // decrease the size
    if (newElements < numElements)
@@ -368,8 +468,8 @@ void vector <T, A> :: resize(size_t newElements)
 
 }
 
-template <typename T, typename A>
-void vector <T, A> :: resize(size_t newElements, const T & t)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize(size_t newElements, const T & t)
 {
    // decrease the size
    if (newElements < numElements)
@@ -392,6 +492,74 @@ void vector <T, A> :: resize(size_t newElements, const T & t)
 
 }
 
+/***************************************
+ * VECTOR :: RESIZE DEFAULT INIT
+ * Like resize, but new elements are
+ * default-initialized rather than value-
+ * initialized: a class still gets its default
+ * constructor, an int keeps whatever garbage
+ * was in the buffer
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize_default_init(size_t newElements)
+{
+   if (newElements < numElements)
+   {
+      for (size_t i = newElements; i < numElements; i++)
+         alloc.destroy(&data[i]);
+   }
+   else if (newElements > numElements)
+   {
+      if (newElements > numCapacity)
+         reserve(newElements);
+      for (size_t i = numElements; i < newElements; i++)
+         new ((void*)(&data[i])) T;
+   }
+   numElements = newElements;
+}
+
+/***************************************
+ * VECTOR :: RESIZE UNINITIALIZED
+ * Just move the end. Only for types with no
+ * constructor or destructor to skip, where
+ * it does not touch the new elements at all
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: resize_uninitialized(size_t newElements)
+{
+   static_assert(std::is_trivially_default_constructible<T>::value &&
+                 std::is_trivially_destructible<T>::value,
+                 "resize_uninitialized needs a trivial type, use resize_default_init");
+   if (newElements > numCapacity)
+      reserve(newElements);
+   numElements = newElements;
+}
+
+/***************************************
+ * VECTOR :: APPEND FROM
+ * Make room for num more elements, then let
+ * reader fill the spare capacity directly:
+ *     size_t reader(T * pDest, size_t num)
+ * writes up to num elements at pDest and returns
+ * how many it wrote. Only those become part of
+ * the vector. Returns the same count
+ **************************************/
+template <typename T, typename A, typename G>
+template <class Reader>
+size_t vector <T, A, G> :: append_from(Reader reader, size_t num)
+{
+   static_assert(std::is_trivially_default_constructible<T>::value &&
+                 std::is_trivially_destructible<T>::value,
+                 "append_from hands out raw memory, so it needs a trivial type");
+   if (numElements + num > numCapacity)
+      grow(numElements + num);
+
+   size_t numRead = reader(data + numElements, num);
+   assert(numRead <= num);
+   numElements += numRead;
+   return numRead;
+}
+
 /***************************************
  * VECTOR :: RESERVE
  * This method will grow the current buffer
@@ -400,40 +568,103 @@ void vector <T, A> :: resize(size_t newElements, const T & t)
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: reserve(size_t newCapacity)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: reserve(size_t newCapacity)
 {
    if (newCapacity <= numCapacity)
       return;
 
-   T* newData = alloc.allocate(newCapacity);
+#ifdef __linux__
+   // a mapped buffer grows by moving pages, not elements
+   if (isMapped(numCapacity) && isMapped(newCapacity))
+   {
+      void * p = mremap((void*)data, mappedBytes(numCapacity),
+                        mappedBytes(newCapacity), MREMAP_MAYMOVE);
+      if (p == MAP_FAILED)
+         throw std::bad_alloc();
+      data = (T*)p;
+      numCapacity = newCapacity;
+      return;
+   }
+#endif
 
-   for (auto i = 0; i < numElements; i++)
-      new ((void*)(newData + i)) T(std::move(data[i]));
+   T* newData = allocateBuffer(newCapacity);
 
-   for (size_t i = 0; i < numElements; i++)
+   // relocatable elements move with one memcpy and need no destructor
+   if (is_trivially_relocatable<T>::value)
    {
-      alloc.destroy(&data[i]);
+      if (numElements > 0)
+         std::memcpy((void*)newData, (const void*)data, numElements * sizeof(T));
+   }
+   else
+   {
+      for (size_t i = 0; i < numElements; i++)
+         new ((void*)(newData + i)) T(std::move(data[i]));
+      for (size_t i = 0; i < numElements; i++)
+         alloc.destroy(&data[i]);
    }
-   alloc.deallocate(data, numCapacity);
+   deallocateBuffer(data, numCapacity);
 
    data = newData;
    numCapacity = newCapacity;
 }
 
+/***************************************
+ * VECTOR :: ALLOCATE BUFFER
+ * Room for num elements: from the kernel when
+ * the buffer is big enough to be mapped, else
+ * from the allocator. Nothing for zero
+ **************************************/
+template <typename T, typename A, typename G>
+T * vector <T, A, G> :: allocateBuffer(size_t num)
+{
+   if (num == 0)
+      return nullptr;
+#ifdef __linux__
+   if (isMapped(num))
+   {
+      void * p = mmap(nullptr, mappedBytes(num), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+         throw std::bad_alloc();
+      return (T*)p;
+   }
+#endif
+   return alloc.allocate(num);
+}
+
+/***************************************
+ * VECTOR :: DEALLOCATE BUFFER
+ * Give back a buffer from allocateBuffer(num)
+ **************************************/
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: deallocateBuffer(T * p, size_t num)
+{
+   if (p == nullptr)
+      return;
+#ifdef __linux__
+   if (isMapped(num))
+   {
+      munmap((void*)p, mappedBytes(num));
+      return;
+   }
+#endif
+   alloc.deallocate(p, num);
+}
+
 /***************************************
  * VECTOR :: SHRINK TO FIT
  * Get rid of any extra capacity
  *     INPUT  :
  *     OUTPUT :
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: shrink_to_fit()
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: shrink_to_fit()
 {
    if (numElements == numCapacity)
       return;
 
-   T* dataNew = alloc.allocate(numElements);
+   T* dataNew = allocateBuffer(numElements);
 
    for (size_t i = 0; i < numElements; i++)
       alloc.construct(&dataNew[i], data[i]);
@@ -441,7 +672,7 @@ void vector <T, A> :: shrink_to_fit()
    for (size_t i = 0; i < numElements; i++)
       alloc.destroy(&data[i]);
 
-   alloc.deallocate(data, numCapacity);
+   deallocateBuffer(data, numCapacity);
    data = dataNew;
    numCapacity = numElements;
 }
@@ -452,8 +683,8 @@ void vector <T, A> :: shrink_to_fit()
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T, typename A>
-T & vector <T, A> :: operator [] (size_t index)
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: operator [] (size_t index)
 {
    return (data[index]);
 }
@@ -462,8 +693,8 @@ T & vector <T, A> :: operator [] (size_t index)
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T, typename A>
-const T & vector <T, A> :: operator [] (size_t index) const
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: operator [] (size_t index) const
 {
    return (data[index]);
 }
@@ -472,8 +703,8 @@ const T & vector <T, A> :: operator [] (size_t index) const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T, typename A>
-T & vector <T, A> :: front ()
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: front ()
 {
    return *(data + 0);
 }
@@ -482,8 +713,8 @@ T & vector <T, A> :: front ()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T, typename A>
-const T & vector <T, A> :: front () const
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: front () const
 {
    return *(data + 0);
 }
@@ -492,8 +723,8 @@ const T & vector <T, A> :: front () const
  * VECTOR :: BACK
  * Read-Write access
  ****************************************/
-template <typename T, typename A>
-T & vector <T, A> :: back()
+template <typename T, typename A, typename G>
+T & vector <T, A, G> :: back()
 {
    return *(data + numElements - 1);
 }
@@ -502,8 +733,8 @@ T & vector <T, A> :: back()
  * VECTOR :: BACK
  * Read-Write access
  *****************************************/
-template <typename T, typename A>
-const T & vector <T, A> :: back() const
+template <typename T, typename A, typename G>
+const T & vector <T, A, G> :: back() const
 {
    return *(data + numElements - 1);
 }
@@ -516,24 +747,20 @@ const T & vector <T, A> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: push_back (const T & t)
+template <typename T, typename A, typename G>
+void vector <T, A, G> :: push_back (const T & t)
 {
-   if (0 == numElements)
-      reserve(1);
    if (numElements == numCapacity)
-      reserve(numCapacity * 2);
+      grow(numElements + 1);
    alloc.construct(&data[numElements], t);
    numElements++;
 }
 
-template <typename T, typename A>
-void vector <T, A> ::push_back(T && t)
+template <typename T, typename A, typename G>
+void vector <T, A, G> ::push_back(T && t)
 {
-   if (0 == numElements)
-      reserve(1);
    if (numElements == numCapacity)
-      reserve(numCapacity * 2);
+      grow(numElements + 1);
    new ((void*)(&data[numElements++])) T(std::move(t));
 }
 
@@ -544,8 +771,8 @@ void vector <T, A> ::push_back(T && t)
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T, typename A>
-vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G> & vector <T, A, G> :: operator = (const vector & rhs)
 {
    if (rhs.size() == size())
    {
@@ -575,12 +802,12 @@ vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
       }
       else // LHS is smaller then RHS with not not enough capacity
       {
-         T* dataNew = alloc.allocate(rhs.size());
+         T* dataNew = allocateBuffer(rhs.size());
          for (size_t i = 0; i < rhs.size(); i++)
             alloc.construct(&dataNew[i], rhs.data[i]);
 
          clear();
-         alloc.destroy(&data);
+         deallocateBuffer(data, numCapacity);
          data = dataNew;
          numCapacity = rhs.size();
          numElements = rhs.size();
@@ -588,8 +815,8 @@ vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
    }
    return *this;
 }
-template <typename T, typename A>
-vector <T, A>& vector <T, A> :: operator = (vector&& rhs)
+template <typename T, typename A, typename G>
+vector <T, A, G>& vector <T, A, G> :: operator = (vector&& rhs)
 {
    swap(rhs);
    rhs.clear();
@@ -0,0 +1,142 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Copying and freeing a big tree on 1, 2, 4 and 8 threads, and
+ *    how long clearDeferred() keeps the caller waiting against how
+ *    long the nodes take to go. std::set copies and frees on one
+ *    thread for comparison. Building the source tree is not timed.
+ *
+ *    The threads only help on a machine with the cores for them; on
+ *    fewer, the extra columns show what forking costs.
+ *
+ *       benchCopy                   : 1M and 4M keys
+ *       benchCopy 50000000 ...      : any list of sizes
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <future>
+#include <thread>
+#include <cstdlib>
+#include "bst.h"
+
+using namespace std::chrono;
+
+const unsigned NUM_THREADS[] = { 1, 2, 4, 8 };
+
+/**********************************************************************
+ * TIME COPY
+ * assign() onto an empty tree, then clear(), each with numThreads
+ ***********************************************************************/
+void timeCopy(const custom::BST<int> & bst, unsigned numThreads,
+              double & secondsCopy, double & secondsClear)
+{
+   custom::BST<int> * pCopy = new custom::BST<int>;
+
+   auto start = steady_clock::now();
+   pCopy->assign(bst, numThreads);
+   secondsCopy = duration<double>(steady_clock::now() - start).count();
+
+   if (pCopy->size() != bst.size())
+      std::cout << "MISMATCH ";
+
+   start = steady_clock::now();
+   pCopy->clear(numThreads);
+   secondsClear = duration<double>(steady_clock::now() - start).count();
+
+   delete pCopy;
+}
+
+/**********************************************************************
+ * TIME DEFERRED
+ * How long clearDeferred() takes to return, and how long until the
+ * nodes are all gone
+ ***********************************************************************/
+void timeDeferred(const custom::BST<int> & bst, double & secondsReturn, double & secondsDone)
+{
+   custom::BST<int> * pCopy = new custom::BST<int>(bst);
+
+   auto start = steady_clock::now();
+   std::future<void> done = pCopy->clearDeferred();
+   secondsReturn = duration<double>(steady_clock::now() - start).count();
+   done.wait();
+   secondsDone = duration<double>(steady_clock::now() - start).count();
+
+   delete pCopy;
+}
+
+/**********************************************************************
+ * TIME STD
+ * Copy a std::set and free the copy
+ ***********************************************************************/
+void timeStd(const std::set<int> & s, double & secondsCopy, double & secondsClear)
+{
+   std::set<int> * pCopy;
+
+   auto start = steady_clock::now();
+   pCopy = new std::set<int>(s);
+   secondsCopy = duration<double>(steady_clock::now() - start).count();
+
+   start = steady_clock::now();
+   delete pCopy;
+   secondsClear = duration<double>(steady_clock::now() - start).count();
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)1000000, (size_t)4000000 };
+
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+   for (size_t n : sizes)
+   {
+      std::vector<int> values(n);
+      for (size_t i = 0; i < n; i++)
+         values[i] = (int)i;
+      custom::BST<int> bst;
+      bst.build(values.begin(), values.end());
+
+      std::cout << n << " keys" << std::setw(14) << "copy ms" << std::setw(12) << "clear ms"
+                << std::endl;
+      for (unsigned numThreads : NUM_THREADS)
+      {
+         double secondsCopy;
+         double secondsClear;
+         timeCopy(bst, numThreads, secondsCopy, secondsClear);
+         std::cout << std::setw(3) << numThreads << " thread" << (numThreads == 1 ? " " : "s")
+                   << std::setw(13) << secondsCopy * 1.0e3
+                   << std::setw(12) << secondsClear * 1.0e3 << std::endl;
+      }
+
+      {
+         std::set<int> s(values.begin(), values.end());
+         double secondsCopy;
+         double secondsClear;
+         timeStd(s, secondsCopy, secondsClear);
+         std::cout << std::setw(11) << "std::set"
+                   << std::setw(12) << secondsCopy * 1.0e3
+                   << std::setw(12) << secondsClear * 1.0e3 << std::endl;
+      }
+
+      double secondsReturn;
+      double secondsDone;
+      timeDeferred(bst, secondsReturn, secondsDone);
+      std::cout << "clearDeferred returns in " << secondsReturn * 1.0e3
+                << " ms, nodes gone in " << secondsDone * 1.0e3 << " ms" << std::endl;
+   }
+
+   return 0;
+}
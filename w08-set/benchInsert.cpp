@@ -0,0 +1,123 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Insert integers into a set in sorted, reverse-sorted and random
+ *    order, with a plain insert and with the last insert handed back
+ *    as the hint, against std::set doing the same. Then build each
+ *    set from the whole range at once.
+ *
+ *       benchInsert            : 1M keys
+ *       benchInsert 100000 ... : any list of key counts
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include "set.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * TIME INSERT
+ * Fill one kind of set from the keys, with or without the hint
+ ***********************************************************************/
+template <class Set>
+void timeInsert(const char * name, const char * order, const std::vector<int> & keys)
+{
+   double seconds[2];
+   size_t num[2];
+   for (int useHint = 0; useHint < 2; useHint++)
+   {
+      Set * pSet = new Set;
+      auto start = steady_clock::now();
+      if (useHint)
+      {
+         auto it = pSet->end();
+         for (int key : keys)
+            it = pSet->insert(it, key);
+      }
+      else
+      {
+         for (int key : keys)
+            pSet->insert(key);
+      }
+      seconds[useHint] = duration<double>(steady_clock::now() - start).count();
+      num[useHint] = pSet->size();
+      delete pSet;
+   }
+
+   std::cout << std::setw(10) << name
+             << std::setw(10) << order
+             << std::setw(12) << seconds[0] * 1.0e9 / (double)keys.size()
+             << std::setw(12) << seconds[1] * 1.0e9 / (double)keys.size()
+             << std::setw(12) << num[0] + num[1] << std::endl;
+}
+
+/**********************************************************************
+ * TIME BUILD
+ * Fill one kind of set with the range constructor
+ ***********************************************************************/
+template <class Set>
+void timeBuild(const char * name, const char * order, const std::vector<int> & keys)
+{
+   auto start = steady_clock::now();
+   Set * pSet = new Set(keys.begin(), keys.end());
+   double seconds = duration<double>(steady_clock::now() - start).count();
+   size_t num = pSet->size();
+   delete pSet;
+
+   std::cout << std::setw(10) << name
+             << std::setw(10) << order
+             << std::setw(12) << seconds * 1.0e9 / (double)keys.size()
+             << std::setw(24) << num << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)1000000 };
+
+   std::cout << std::fixed << std::setprecision(1);
+   for (size_t num : sizes)
+   {
+      std::vector<int> sorted(num);
+      for (size_t i = 0; i < num; i++)
+         sorted[i] = (int)i;
+      std::vector<int> reversed(sorted.rbegin(), sorted.rend());
+      std::vector<int> shuffled(sorted);
+      std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(43));
+
+      std::cout << num << " keys" << std::setw(27) << "ns/key" << std::setw(12) << "hint ns/key"
+                << std::setw(12) << "checksum" << std::endl;
+      timeInsert<custom::set<int>>("set",      "sorted",   sorted);
+      timeInsert<custom::set<int>>("set",      "reversed", reversed);
+      timeInsert<custom::set<int>>("set",      "random",   shuffled);
+      timeInsert<std::set<int>>   ("std::set", "sorted",   sorted);
+      timeInsert<std::set<int>>   ("std::set", "reversed", reversed);
+      timeInsert<std::set<int>>   ("std::set", "random",   shuffled);
+
+      std::cout << "range constructor" << std::endl;
+      timeBuild<custom::set<int>>("set",      "sorted",   sorted);
+      timeBuild<custom::set<int>>("set",      "reversed", reversed);
+      timeBuild<custom::set<int>>("set",      "random",   shuffled);
+      timeBuild<std::set<int>>   ("std::set", "sorted",   sorted);
+      timeBuild<std::set<int>>   ("std::set", "reversed", reversed);
+      timeBuild<std::set<int>>   ("std::set", "random",   shuffled);
+   }
+
+   return 0;
+}
@@ -0,0 +1,108 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Sum the values in 1000 random windows of a set, through
+ *    for_each_in_range, through lower_bound and an iterator, and by
+ *    scanning from begin(), against std::set's lower_bound. The
+ *    windows are 10, 1000 and 100000 values wide.
+ *
+ *       benchRange             : 1M keys
+ *       benchRange 100000 ...  : any list of key counts
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <random>
+#include <cstdlib>
+#include "set.h"
+
+using namespace std::chrono;
+
+const int NUM_QUERIES = 1000;
+
+/**********************************************************************
+ * TIME
+ * Run every window through one way of finding it, in us per window
+ ***********************************************************************/
+template <class Query>
+double timeQuery(const std::vector<int> & los, int width, long long & sum, Query query)
+{
+   sum = 0;
+   auto start = steady_clock::now();
+   for (int lo : los)
+      query(lo, lo + width, sum);
+   return duration<double>(steady_clock::now() - start).count() * 1.0e6 / (double)los.size();
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)1000000 };
+
+   std::cout << std::fixed << std::setprecision(2);
+   for (size_t num : sizes)
+   {
+      std::vector<int> keys(num);
+      for (size_t i = 0; i < num; i++)
+         keys[i] = (int)i;
+      custom::set<int> s(keys.begin(), keys.end());
+      std::set<int> sStd(keys.begin(), keys.end());
+
+      std::cout << num << " keys" << std::setw(15) << "range us" << std::setw(12) << "bound us"
+                << std::setw(12) << "scan us" << std::setw(12) << "std:: us" << std::endl;
+      for (int width : { 10, 1000, 100000 })
+      {
+         std::mt19937 random(43);
+         std::uniform_int_distribution<int> pick(0, (int)num - 1);
+         std::vector<int> los(NUM_QUERIES);
+         for (int & lo : los)
+            lo = pick(random);
+         long long sums[4];
+
+         double range = timeQuery(los, width, sums[0], [&s](int lo, int hi, long long & sum)
+            {
+               s.for_each_in_range(lo, hi, [&sum](const int & value) { sum += value; });
+            });
+         double bound = timeQuery(los, width, sums[1], [&s](int lo, int hi, long long & sum)
+            {
+               for (auto it = s.lower_bound(lo); it != s.end() && *it < hi; ++it)
+                  sum += *it;
+            });
+         // a scan is so slow that a tenth of the windows is plenty
+         std::vector<int> losScan(los.begin(), los.begin() + NUM_QUERIES / 10);
+         double scan = timeQuery(losScan, width, sums[2], [&s](int lo, int hi, long long & sum)
+            {
+               for (auto it = s.begin(); it != s.end() && *it < hi; ++it)
+                  if (!(*it < lo))
+                     sum += *it;
+            });
+         double merged = timeQuery(los, width, sums[3], [&sStd](int lo, int hi, long long & sum)
+            {
+               for (auto it = sStd.lower_bound(lo); it != sStd.end() && *it < hi; ++it)
+                  sum += *it;
+            });
+
+         std::cout << std::setw(9) << width << " wide"
+                   << std::setw(10) << range
+                   << std::setw(12) << bound
+                   << std::setw(12) << scan
+                   << std::setw(12) << merged
+                   << (sums[0] == sums[1] && sums[0] == sums[3] ? "" : "  MISMATCH")
+                   << std::endl;
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,102 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Find the k-th smallest value and count the values below a key
+ *    with nth() and rank(), against stepping an iterator there from
+ *    begin() the way it had to be done before. Built with
+ *    BST_ORDER_STATISTICS=1, since without the counts nth() and
+ *    rank() walk too.
+ *
+ *       benchRank            : 10K, 100K and 1M keys
+ *       benchRank 5000 ...   : any list of key counts
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include "set.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, double seconds, size_t num, long long checksum)
+{
+   std::cout << std::setw(14) << name
+             << std::setw(14) << seconds * 1.0e9 / (double)num
+             << std::setw(18) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)10000, (size_t)100000, (size_t)1000000 };
+
+   std::cout << std::fixed << std::setprecision(1);
+   for (size_t num : sizes)
+   {
+      std::vector<int> keys(num);
+      for (size_t i = 0; i < num; i++)
+         keys[i] = (int)(i * 2);
+      custom::set<int> s(keys.begin(), keys.end());
+
+      // the same random queries for every method
+      const size_t numQueries = 1000;
+      std::mt19937 random(45);
+      std::vector<size_t> queries(numQueries);
+      for (size_t & k : queries)
+         k = random() % num;
+
+      std::cout << num << " keys" << std::setw(17) << "ns/query"
+                << std::setw(18) << "checksum" << std::endl;
+
+      auto start = steady_clock::now();
+      long long checksum = 0;
+      for (size_t k : queries)
+         checksum += *s.nth(k);
+      report("nth", duration<double>(steady_clock::now() - start).count(), numQueries, checksum);
+
+      start = steady_clock::now();
+      checksum = 0;
+      for (size_t k : queries)
+      {
+         auto it = s.begin();
+         for (size_t i = 0; i < k; i++)
+            ++it;
+         checksum += *it;
+      }
+      report("iterate to k", duration<double>(steady_clock::now() - start).count(), numQueries, checksum);
+
+      start = steady_clock::now();
+      checksum = 0;
+      for (size_t k : queries)
+         checksum += (long long)s.rank((int)k);
+      report("rank", duration<double>(steady_clock::now() - start).count(), numQueries, checksum);
+
+      start = steady_clock::now();
+      checksum = 0;
+      for (size_t k : queries)
+      {
+         long long numBelow = 0;
+         for (auto it = s.begin(); it != s.end() && *it < (int)k; ++it)
+            numBelow++;
+         checksum += numBelow;
+      }
+      report("count below", duration<double>(steady_clock::now() - start).count(), numQueries, checksum);
+   }
+
+   return 0;
+}
@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Insert random integers into a set, look every one of them up,
+ *    walk them in order, then destroy the set. The red-black and the
+ *    B-tree engines, each with the nodes from std::allocator and from
+ *    the node pool, against std::set.
+ *
+ *       benchSet                  : 1M and 10M keys
+ *       benchSet 100000 100000000 : any list of key counts. 100M keys
+ *                                   needs about 5GB for the red-black
+ *                                   engine, under 1GB for the B-tree
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include "set.h"
+#include "node_pool.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, const char * phase, double seconds, size_t num, long long checksum)
+{
+   std::cout << std::setw(22) << name
+             << std::setw(9)  << phase
+             << std::setw(12) << seconds * 1000.0
+             << std::setw(12) << seconds * 1.0e9 / (double)num
+             << std::setw(16) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * TIME SET
+ * Insert, find and destroy with one kind of set
+ ***********************************************************************/
+template <class Set>
+void timeSet(const char * name, const std::vector<int> & keys)
+{
+   Set * pSet = new Set;
+
+   auto start = steady_clock::now();
+   for (int key : keys)
+      pSet->insert(key);
+   report(name, "insert", duration<double>(steady_clock::now() - start).count(),
+          keys.size(), (long long)pSet->size());
+
+   start = steady_clock::now();
+   long long checksum = 0;
+   for (int key : keys)
+      checksum += *pSet->find(key);
+   report(name, "find", duration<double>(steady_clock::now() - start).count(),
+          keys.size(), checksum);
+
+   start = steady_clock::now();
+   checksum = 0;
+   for (auto it = pSet->begin(); it != pSet->end(); ++it)
+      checksum += *it;
+   report(name, "walk", duration<double>(steady_clock::now() - start).count(),
+          keys.size(), checksum);
+
+   start = steady_clock::now();
+   delete pSet;
+   report(name, "destroy", duration<double>(steady_clock::now() - start).count(),
+          keys.size(), 0);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)1000000, (size_t)10000000 };
+
+   std::cout << std::fixed << std::setprecision(1);
+   for (size_t num : sizes)
+   {
+      std::vector<int> keys(num);
+      for (size_t i = 0; i < num; i++)
+         keys[i] = (int)i;
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(26));
+
+      std::cout << num << " keys" << std::setw(30) << "ms" << std::setw(12) << "ns/key"
+                << std::setw(16) << "checksum" << std::endl;
+      timeSet<custom::set<int>>                         ("set",           keys);
+      timeSet<custom::set<int, custom::node_pool<int>>> ("set node_pool", keys);
+      timeSet<custom::set<int, std::allocator<int>, custom::BTree>>
+                                                        ("btree",         keys);
+      timeSet<custom::set<int, custom::node_pool<int>, custom::BTree>>
+                                                        ("btree node_pool", keys);
+      timeSet<std::set<int>>                            ("std::set",      keys);
+   }
+
+   return 0;
+}
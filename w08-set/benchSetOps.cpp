@@ -0,0 +1,170 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Union, intersection and difference of a big set with a smaller
+ *    one, at several size ratios. The join and split versions are
+ *    timed against walking the smaller set and inserting, finding or
+ *    erasing one value at a time, and against the std::set_ algorithms
+ *    merging two std::sets. Only the operation is timed; copying the
+ *    inputs and freeing the results are not. Freeing the values an
+ *    intersection or difference drops is part of the operation, so
+ *    an intersection with a small set pays for most of the big one.
+ *
+ *       benchSetOps                 : 1M keys against 1K to 1M
+ *       benchSetOps 100000 ...      : any size for the big set
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include "set.h"
+
+using namespace std::chrono;
+
+enum Op { UNION, INTERSECTION, DIFFERENCE };
+
+/**********************************************************************
+ * TIME JOIN
+ * One operation through unionWith and friends on copies of the inputs
+ ***********************************************************************/
+double timeJoin(Op op, const custom::set<int> & sBig, const custom::set<int> & sSmall,
+                unsigned numThreads, size_t & num)
+{
+   custom::set<int> * pLeft = new custom::set<int>(sBig);
+   custom::set<int> * pRight = new custom::set<int>(sSmall);
+
+   auto start = steady_clock::now();
+   if (op == UNION)
+      pLeft->unionWith(std::move(*pRight), numThreads);
+   else if (op == INTERSECTION)
+      pLeft->intersectionWith(std::move(*pRight), numThreads);
+   else
+      pLeft->differenceWith(std::move(*pRight), numThreads);
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   num = pLeft->size();
+   delete pLeft;
+   delete pRight;
+   return seconds;
+}
+
+/**********************************************************************
+ * TIME LOOP
+ * The same operation one value of the smaller set at a time
+ ***********************************************************************/
+double timeLoop(Op op, custom::set<int> & sBig, const custom::set<int> & sSmall, size_t & num)
+{
+   custom::set<int> * pResult = (op == INTERSECTION) ? new custom::set<int> :
+                                                       new custom::set<int>(sBig);
+
+   auto start = steady_clock::now();
+   for (auto it = sSmall.begin(); it != sSmall.end(); ++it)
+   {
+      if (op == UNION)
+         pResult->insert(*it);
+      else if (op == INTERSECTION)
+      {
+         if (sBig.find(*it) != sBig.end())
+            pResult->insert(pResult->end(), *it);
+      }
+      else
+         pResult->erase(*it);
+   }
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   num = pResult->size();
+   delete pResult;
+   return seconds;
+}
+
+/**********************************************************************
+ * TIME STD
+ * The std::set_ algorithms merging two std::sets into a vector
+ ***********************************************************************/
+double timeStd(Op op, const std::set<int> & sBig, const std::set<int> & sSmall, size_t & num)
+{
+   std::vector<int> result;
+
+   auto start = steady_clock::now();
+   if (op == UNION)
+      std::set_union(sBig.begin(), sBig.end(), sSmall.begin(), sSmall.end(),
+                     std::back_inserter(result));
+   else if (op == INTERSECTION)
+      std::set_intersection(sBig.begin(), sBig.end(), sSmall.begin(), sSmall.end(),
+                            std::back_inserter(result));
+   else
+      std::set_difference(sBig.begin(), sBig.end(), sSmall.begin(), sSmall.end(),
+                          std::back_inserter(result));
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   num = result.size();
+   return seconds;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<size_t> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+   if (sizes.empty())
+      sizes = { (size_t)1000000 };
+
+   const char * names[] = { "union", "intersection", "difference" };
+
+   std::cout << std::fixed << std::setprecision(2);
+   for (size_t n : sizes)
+   {
+      // the big set is every even number below 2n
+      std::vector<int> big(n);
+      for (size_t i = 0; i < n; i++)
+         big[i] = (int)(2 * i);
+      custom::set<int> sBig(big.begin(), big.end());
+      std::set<int> sBigStd(big.begin(), big.end());
+
+      std::cout << n << " keys against" << std::setw(15) << "join ms"
+                << std::setw(12) << "1 thread ms" << std::setw(12) << "loop ms"
+                << std::setw(12) << "std:: ms" << std::setw(12) << "size" << std::endl;
+      for (size_t m = 1000; m <= n; m *= 10)
+      {
+         // the small one is spread over the same range, half of
+         // its values in the big one and half between them
+         std::vector<int> small(m);
+         size_t stride = 2 * n / m;
+         for (size_t i = 0; i < m; i++)
+            small[i] = (int)(i * stride + (i & 1));
+         custom::set<int> sSmall(small.begin(), small.end());
+         std::set<int> sSmallStd(small.begin(), small.end());
+
+         for (Op op : { UNION, INTERSECTION, DIFFERENCE })
+         {
+            size_t num[4];
+            double join = timeJoin(op, sBig, sSmall, 0, num[0]);
+            double joinOne = timeJoin(op, sBig, sSmall, 1, num[1]);
+            double loop = timeLoop(op, sBig, sSmall, num[2]);
+            double merged = timeStd(op, sBigStd, sSmallStd, num[3]);
+
+            std::cout << std::setw(8) << m << " " << std::setw(12) << names[op]
+                      << std::setw(11) << join * 1.0e3
+                      << std::setw(12) << joinOne * 1.0e3
+                      << std::setw(12) << loop * 1.0e3
+                      << std::setw(12) << merged * 1.0e3
+                      << std::setw(12) << num[0]
+                      << (num[0] == num[1] && num[0] == num[2] && num[0] == num[3] ?
+                          "" : "  MISMATCH") << std::endl;
+         }
+      }
+   }
+
+   return 0;
+}
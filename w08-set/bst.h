@@ -25,49 +25,75 @@
 #define debug(x)
 #endif // !DEBUG
 
+// Build with -DBST_ORDER_STATISTICS=1 and every node counts the
+// nodes below it, so nth() and rank() are O(log n). The price is a
+// word per node and a climb to the root on every insert, which takes
+// a hinted insert of sorted input from O(1) amortized to O(log n).
+// Off, nth() and rank() walk the values
+#ifndef BST_ORDER_STATISTICS
+#define BST_ORDER_STATISTICS 0
+#endif
+
 #include <cassert>
 #include <utility>
-#include <memory>     // for std::allocator
+#include <memory>     // for std::allocator and std::allocator_traits
+#include <type_traits> // for std::is_trivially_destructible
 #include <functional> // for std::less
 #include <utility>    // for std::pair
+#include <vector>     // for std::vector
+#include <algorithm>  // for std::stable_sort
+#include <future>     // for std::async and std::packaged_task
+#include <system_error> // for std::system_error
+#include <thread>     // for std::thread::hardware_concurrency
 
 class TestBST; // forward declaration for unit tests
 class TestSet;
 class TestMap;
+class TestNodePool;
 
 namespace custom
 {
 
-   template <typename TT>
+// the set algebra, copies and clear() only hand halves to other
+// threads when there are at least this many nodes in the trees
+static const size_t BST_PARALLEL_MIN = 100000;
+
+// and never hand over a subtree smaller than this, when the nodes
+// know their subtree sizes
+static const size_t BST_PARALLEL_GRAIN = 16384;
+
+   template <typename TT, typename AA, template <typename, typename> class TR>
    class set;
-   template <typename KK, typename VV>
+   template <typename KK, typename VV, typename AA, template <typename, typename> class TR>
    class map;
 
 /*****************************************************************
  * BINARY SEARCH TREE
- * Create a Binary Search Tree
+ * Create a Binary Search Tree. Nodes come from A rebound to BNode,
+ * so a pool allocator can hand them out and take them all back
  *****************************************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>>
 class BST
 {
    friend class ::TestBST; // give unit tests access to the privates
    friend class ::TestSet;
    friend class ::TestMap;
+   friend class ::TestNodePool;
 
-   template <class TT>
+   template <class TT, class AA, template <class, class> class TR>
    friend class custom::set;
 
-   template <class KK, class VV>
+   template <class KK, class VV, class AA, template <class, class> class TR>
    friend class custom::map;
 public:
    //
    // Construct
    //
 
-   BST();
+   BST(const A & a = A());
    BST(const BST &  rhs);
    BST(      BST && rhs);
-   BST(const std::initializer_list<T>& il);
+   BST(const std::initializer_list<T>& il, const A & a = A());
    ~BST();
 
    //
@@ -92,6 +118,22 @@ public:
    //
 
    iterator find(const T& t);
+   iterator nth(size_t k) const;
+   size_t   rank(const T & t) const;
+   iterator lower_bound(const T & t) const { return iterator(bound(t, false)); }
+   iterator upper_bound(const T & t) const { return iterator(bound(t, true));  }
+   std::pair<iterator, iterator> equal_range(const T & t) const
+   {
+      return std::make_pair(lower_bound(t), upper_bound(t));
+   }
+
+   // call fn on every value in [lo, hi) in order, pruning the
+   // subtrees that fall outside: O(log n + k) with no climbing
+   template <class Function>
+   void for_each_in_range(const T & lo, const T & hi, Function fn) const
+   {
+      forEachInRange(root, lo, hi, fn);
+   }
 
    //
    // Insert
@@ -99,13 +141,44 @@ public:
 
    std::pair<iterator, bool> insert(const T&  t, bool keepUnique = false);
    std::pair<iterator, bool> insert(      T&& t, bool keepUnique = false);
+   iterator insert(iterator itHint, const T&  t, bool keepUnique = false);
+   iterator insert(iterator itHint,       T&& t, bool keepUnique = false);
+   template <typename ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args);
+   template <typename ... Args>
+   std::pair<iterator, bool> emplace_unique(Args && ... args);
+   template <class Iterator>
+   void build(Iterator first, Iterator last, bool keepUnique = false);
 
    //
    // Remove
    //
 
    iterator erase(iterator& it);
-   void   clear() noexcept;
+   void   clear() noexcept { clear(0); }
+
+   //
+   // Copy and tear down across threads. numThreads of 0 means as many
+   // as the hardware has, once the tree is big enough; that is what
+   // the copy constructor, assignment and clear() do
+   //
+
+   void assign(const BST & rhs, unsigned numThreads = 0);
+   void clear(unsigned numThreads) noexcept;
+
+   // empty the tree now and free the nodes on a thread of their own.
+   // Wait on the future if they must be gone before going on
+   std::future<void> clearDeferred();
+
+   //
+   // Set algebra. Every node of rhs ends up here or destroyed, and
+   // rhs is left empty. Values must be unique. numThreads of 0 means
+   // as many as the hardware has, once the trees are big enough
+   //
+
+   void unionWith       (BST & rhs, unsigned numThreads = 0);
+   void intersectionWith(BST & rhs, unsigned numThreads = 0);
+   void differenceWith  (BST & rhs, unsigned numThreads = 0);
 
    //
    // Status
@@ -117,11 +190,83 @@ public:
 private:
 
    class BNode;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<BNode> NodeAlloc;
+
+   template <typename ... Args>
+   BNode * createNode(Args && ... args);
+   void destroyNode(BNode * pNode) noexcept;
+   void assign(BNode *& pDest, const BNode * pSrc, int depthParallel = 0);
    void deleteNode(BNode*& pDelete, bool toRight);
-   void deleteBinaryTree(BNode*& pDelete) noexcept;
+   void deleteBinaryTree(BNode*& pDelete, int depthParallel = 0) noexcept;
+   static bool isWorthForking(const BNode * pNode);
+   void destroyBinaryTree(BNode * pDelete) noexcept;
+
+   // where a new value goes: below pParent on the left or the
+   // right, unless keepUnique found it already in pMatch
+   struct Spot
+   {
+      BNode * pParent;
+      bool    isLeft;
+      BNode * pMatch;
+   };
+   Spot locate(const T & t, bool keepUnique) const;
+   Spot locateNear(iterator itHint, const T & t, bool keepUnique);
+   template <typename U>
+   std::pair<iterator, bool> insertAt(const Spot & spot, U && t);
+   iterator attach(BNode * pNew, const Spot & spot);
+   static BNode * link(BNode ** ppNodes, size_t num, int depth, int depthRed);
+
+   // a subtree cut loose for the set algebra, with its black height:
+   // the number of black nodes on every path down from the root
+   struct Part
+   {
+      BNode * pRoot;
+      int     height;
+   };
+   static bool    isRedNode(const BNode * pNode) { return pNode && pNode->isRed; }
+   static int     blackHeight(const BNode * pNode);
+   static Part    leftOf (Part part);
+   static Part    rightOf(Part part);
+   static BNode * connect(BNode * pLeft, BNode * pMiddle, BNode * pRight, bool isRed);
+   static BNode * rotateLeft (BNode * pNode);
+   static BNode * rotateRight(BNode * pNode);
+   static BNode * joinRight(Part left, BNode * pMiddle, Part right);
+   static BNode * joinLeft (Part left, BNode * pMiddle, Part right);
+   static Part    join (Part left, BNode * pMiddle, Part right);
+   static Part    join2(Part left, Part right);
+   static Part    takeLast(Part part, BNode *& pLast);
+   static void    split(Part part, const T & t, Part & less, BNode *& pMatch, Part & greater);
+   Part   take(BST & rhs);
+   void   adopt(Part part, size_t num);
+   BNode * bound(const T & t, bool isUpper) const;
+   template <class Function>
+   static void forEachInRange(const BNode * pNode, const T & lo, const T & hi, Function & fn);
+   int    parallelDepth(size_t num, unsigned numThreads) const;
+   size_t freeTree(BNode * pNode) noexcept;
+   Part   unite    (Part lhs, Part rhs, int depthParallel, size_t & numFreed);
+   Part   intersect(Part lhs, Part rhs, int depthParallel, size_t & numFreed);
+   Part   subtract (Part lhs, Part rhs, int depthParallel, size_t & numFreed);
+   void findEnds();
+
+   // can the allocator free every node at once? Only a pool that
+   // has release() and that nobody else is using
+   template <typename NA>
+   static auto canRelease(const NA & a, int) -> decltype(std::declval<NA &>().release(), bool())
+   {
+      return a.unique();
+   }
+   template <typename NA>
+   static bool canRelease(const NA &, long) { return false; }
+   template <typename NA>
+   static auto release(NA & a, int) -> decltype(a.release()) { a.release(); }
+   template <typename NA>
+   static void release(NA &, long) { }
 
    BNode * root;              // root node of the binary search tree
    size_t numElements;        // number of elements currently in the tree
+   NodeAlloc alloc;           // where the nodes come from
+   BNode * pFirst;            // left-most node, or nullptr if we lost track
+   BNode * pLast;             // right-most node, or nullptr if we lost track
 };
 
 
@@ -130,8 +275,8 @@ private:
  * A single node in a binary tree. Note that the node does not know
  * anything about the properties of the tree so no validation can be done.
  *****************************************************************/
-template <typename T>
-class BST <T> :: BNode
+template <typename T, typename A>
+class BST <T, A> :: BNode
 {
 public:
    //
@@ -140,6 +285,9 @@ public:
    BNode()           : pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(),             isRed(true) { }
    BNode(const T& t) : pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(t),            isRed(true) { }
    BNode(T&& t)      : pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(std::move(t)), isRed(true) { }
+   template <typename ... Args>
+   BNode(std::in_place_t, Args && ... args) :
+      pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(std::forward<Args>(args)...), isRed(true) { }
 
    // compare
    bool operator == (const BNode& rhs) const
@@ -148,20 +296,11 @@ public:
 
    }
 
-   //
-   // assign
-   //
-   void assign(BNode *& pDest, const BNode * pSrc);
-
    //
    // Insert
    //
    void addLeft (BNode * pNode);
    void addRight(BNode * pNode);
-   void addLeft (const  T &  t);
-   void addRight(const  T &  t);
-   void addLeft (       T && t);
-   void addRight(       T && t);
 
    //
    // Status
@@ -171,11 +310,22 @@ public:
 
    // balance the tree
    void balance();
-
-   //
-   // Remove
-   //
-   void clear(BNode *& pNode);
+   BNode * balanceStep();
+
+   // keep the subtree sizes: count this one again from its
+   // children, or add delta to this one and all above it
+#if BST_ORDER_STATISTICS
+   static size_t sizeOf(const BNode * pNode) { return pNode ? pNode->size : 0; }
+   void resize()         { size = 1 + sizeOf(pLeft) + sizeOf(pRight); }
+   void addSize(int delta)
+   {
+      for (BNode * pNode = this; pNode; pNode = pNode->pParent)
+         pNode->size += delta;
+   }
+#else
+   void resize()         { }
+   void addSize(int)     { }
+#endif // BST_ORDER_STATISTICS
 
    //
    // Swap
@@ -200,20 +350,23 @@ public:
    BNode* pRight;         // Right child - larger
    BNode* pParent;        // Parent
    bool isRed;              // Red-black balancing stuff
+#if BST_ORDER_STATISTICS
+   size_t size = 1;         // nodes in the subtree rooted here
+#endif // BST_ORDER_STATISTICS
 };
 
 /**********************************************************
  * BINARY SEARCH TREE ITERATOR
  * Forward and reverse iterator through a BST
  *********************************************************/
-template <typename T>
-class BST <T> :: iterator
+template <typename T, typename A>
+class BST <T, A> :: iterator
 {
    friend class ::TestBST; // give unit tests access to the privates
    friend class ::TestSet;
    friend class ::TestMap;
 
-   template <class KK, class VV>
+   template <class KK, class VV, class AA, template <class, class> class TR>
    friend class custom::map;
 public:
    // constructors and assignment
@@ -264,7 +417,10 @@ public:
    }
 
    // must give friend status to remove so it can call getNode() from it
-   friend BST <T> :: iterator BST <T> :: erase(iterator & it);
+   friend BST <T, A> :: iterator BST <T, A> :: erase(iterator & it);
+
+   // and to insert with a hint, which starts from the node
+   friend class BST <T, A>;
 
 private:
 
@@ -285,8 +441,9 @@ private:
  /*********************************************
   * BST :: DEFAULT CONSTRUCTOR
   ********************************************/
-template <typename T>
-BST <T> ::BST() : root(nullptr), numElements(0)
+template <typename T, typename A>
+BST <T, A> ::BST(const A & a) : root(nullptr), numElements(0), alloc(a),
+   pFirst(nullptr), pLast(nullptr)
 {
 }
 
@@ -294,8 +451,10 @@ BST <T> ::BST() : root(nullptr), numElements(0)
  * BST :: COPY CONSTRUCTOR
  * Copy one tree to another
  ********************************************/
-template <typename T>
-BST <T> :: BST ( const BST<T>& rhs)
+template <typename T, typename A>
+BST <T, A> :: BST ( const BST<T, A>& rhs) :
+   alloc(std::allocator_traits<NodeAlloc>::select_on_container_copy_construction(rhs.alloc)),
+   pFirst(nullptr), pLast(nullptr)
 {
    this->root = nullptr;
    this->numElements = rhs.numElements;
@@ -311,22 +470,25 @@ BST <T> :: BST ( const BST<T>& rhs)
  * BST :: MOVE CONSTRUCTOR
  * Move one tree to another
  ********************************************/
-template <typename T>
-BST <T> :: BST(BST <T> && rhs)
+template <typename T, typename A>
+BST <T, A> :: BST(BST <T, A> && rhs) : alloc(rhs.alloc),
+   pFirst(rhs.pFirst), pLast(rhs.pLast)
 {
    this->numElements = rhs.numElements;
    this->root = rhs.root;
 
    rhs.numElements = 0;
    rhs.root = nullptr;
+   rhs.pFirst = rhs.pLast = nullptr;
 }
 
 /*********************************************
  * BST :: INITIALIZER LIST CONSTRUCTOR
  * Create a BST from an initializer list
  ********************************************/
-template <typename T>
-BST <T> ::BST(const std::initializer_list<T>& il)
+template <typename T, typename A>
+BST <T, A> ::BST(const std::initializer_list<T>& il, const A & a) : alloc(a),
+   pFirst(nullptr), pLast(nullptr)
 {
    numElements = 0;
    root = nullptr;
@@ -336,8 +498,8 @@ BST <T> ::BST(const std::initializer_list<T>& il)
 /*********************************************
  * BST :: DESTRUCTOR
  ********************************************/
-template <typename T>
-BST <T> :: ~BST()
+template <typename T, typename A>
+BST <T, A> :: ~BST()
 {
    clear();
 }
@@ -347,20 +509,32 @@ BST <T> :: ~BST()
  * BST :: ASSIGNMENT OPERATOR
  * Copy one tree to another
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (const BST <T> & rhs)
+template <typename T, typename A>
+BST <T, A> & BST <T, A> :: operator = (const BST <T, A> & rhs)
 {
-   root->assign(this->root, rhs.root);
-   this->numElements = rhs.numElements;
+   assign(rhs);
    return *this;
 }
 
+/*********************************************
+ * BST :: ASSIGN
+ * Copy one tree to another, the two halves of
+ * every big subtree on two threads
+ ********************************************/
+template <typename T, typename A>
+void BST <T, A> :: assign(const BST <T, A> & rhs, unsigned numThreads)
+{
+   assign(this->root, rhs.root, parallelDepth(rhs.numElements, numThreads));
+   this->numElements = rhs.numElements;
+   findEnds();
+}
+
 /*********************************************
  * BST :: ASSIGNMENT OPERATOR with INITIALIZATION LIST
  * Copy nodes onto a BTree
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (const std::initializer_list<T>& il)
+template <typename T, typename A>
+BST <T, A> & BST <T, A> :: operator = (const std::initializer_list<T>& il)
 {
    clear();
    numElements = 0;
@@ -376,8 +550,8 @@ BST <T> & BST <T> :: operator = (const std::initializer_list<T>& il)
  * BST :: ASSIGN-MOVE OPERATOR
  * Move one tree to another
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (BST <T> && rhs)
+template <typename T, typename A>
+BST <T, A> & BST <T, A> :: operator = (BST <T, A> && rhs)
 {
    clear();
    swap(rhs);
@@ -388,179 +562,952 @@ BST <T> & BST <T> :: operator = (BST <T> && rhs)
  * BST :: SWAP
  * Swap two trees
  ********************************************/
-template <typename T>
-void BST <T> :: swap (BST <T>& rhs)
+template <typename T, typename A>
+void BST <T, A> :: swap (BST <T, A>& rhs)
 {
    BNode * tempRoot = rhs.root;
    rhs.root = this->root;
    this->root = tempRoot;
 
-   int tempElements = rhs.numElements;
-   rhs.numElements = this->numElements;
-   this->numElements = tempElements;
+   int tempElements = rhs.numElements;
+   rhs.numElements = this->numElements;
+   this->numElements = tempElements;
+
+   std::swap(this->pFirst, rhs.pFirst);
+   std::swap(this->pLast, rhs.pLast);
+
+   // the nodes go with the allocator they came from
+   std::swap(this->alloc, rhs.alloc);
+}
+
+/*****************************************************
+ * BST :: INSERT
+ * Insert a node at a given location in the tree
+ ****************************************************/
+template <typename T, typename A>
+std::pair<typename BST <T, A> :: iterator, bool> BST <T, A> :: insert(const T & t, bool keepUnique)
+{
+   return insertAt(locate(t, keepUnique), t);
+}
+
+template <typename T, typename A>
+std::pair<typename BST <T, A> ::iterator, bool> BST <T, A> ::insert(T&& t, bool keepUnique)
+{
+   return insertAt(locate(t, keepUnique), std::move(t));
+}
+
+/*****************************************************
+ * BST :: INSERT WITH A HINT
+ * Insert a node right before itHint if it belongs there,
+ * or anywhere else if it does not. Handing back the
+ * iterator of the last insert, or end(), makes sorted
+ * input one compare and a rebalance a value
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: iterator BST <T, A> :: insert(iterator itHint, const T & t, bool keepUnique)
+{
+   return insertAt(locateNear(itHint, t, keepUnique), t).first;
+}
+
+template <typename T, typename A>
+typename BST <T, A> :: iterator BST <T, A> :: insert(iterator itHint, T && t, bool keepUnique)
+{
+   return insertAt(locateNear(itHint, t, keepUnique), std::move(t)).first;
+}
+
+/*****************************************************
+ * BST :: EMPLACE
+ * Build the value in its node from args, then hang the
+ * node in the tree. Duplicates are allowed
+ ****************************************************/
+template <typename T, typename A>
+template <typename ... Args>
+std::pair<typename BST <T, A> :: iterator, bool> BST <T, A> :: emplace(Args && ... args)
+{
+   BNode * pNew;
+   try
+   {
+      pNew = createNode(std::in_place, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      throw "ERROR: Unable to allocate a node";
+   }
+   return std::pair<iterator, bool>(attach(pNew, locate(pNew->data, false)), true);
+}
+
+/*****************************************************
+ * BST :: EMPLACE UNIQUE
+ * Same, but if the value is already there the new
+ * node goes straight back
+ ****************************************************/
+template <typename T, typename A>
+template <typename ... Args>
+std::pair<typename BST <T, A> :: iterator, bool> BST <T, A> :: emplace_unique(Args && ... args)
+{
+   BNode * pNew;
+   try
+   {
+      pNew = createNode(std::in_place, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      throw "ERROR: Unable to allocate a node";
+   }
+
+   Spot spot = locate(pNew->data, true);
+   if (spot.pMatch)
+   {
+      destroyNode(pNew);
+      return std::pair<iterator, bool>(iterator(spot.pMatch), false);
+   }
+   return std::pair<iterator, bool>(attach(pNew, spot), true);
+}
+
+/*****************************************************
+ * BST :: LOCATE
+ * Walk down from the root to the empty spot where t
+ * belongs. With keepUnique, stop at a node holding t
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Spot BST <T, A> :: locate(const T & t, bool keepUnique) const
+{
+   Spot spot = { nullptr, false, nullptr };
+
+   BNode * pNode = root;
+   while (pNode)
+   {
+      //if the node is a match, then do nothing
+      if (keepUnique && t == pNode->data)
+      {
+         spot.pMatch = pNode;
+         return spot;
+      }
+
+      // if the center node is larger, go left. Otherwise go right
+      spot.pParent = pNode;
+      spot.isLeft = t < pNode->data;
+      pNode = spot.isLeft ? pNode->pLeft : pNode->pRight;
+   }
+
+   return spot;
+}
+
+/*****************************************************
+ * BST :: LOCATE NEAR
+ * Find the spot for t next to itHint: between the hint
+ * and the node before it, or between the hint and the
+ * node after it. If t belongs in neither, walk down
+ * from the root after all
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Spot BST <T, A> :: locateNear(iterator itHint, const T & t, bool keepUnique)
+{
+   if (root == nullptr)
+      return locate(t, keepUnique);
+   if (pFirst == nullptr || pLast == nullptr)
+      findEnds();
+
+   Spot spot = { nullptr, false, nullptr };
+   BNode * pHint = itHint.pNode;
+
+   // past the end: t must go after the last node
+   if (pHint == nullptr)
+   {
+      if (pLast->data < t)
+      {
+         spot.pParent = pLast;
+         return spot;
+      }
+      return locate(t, keepUnique);
+   }
+
+   // before the hint: t must go after the node before it
+   if (t < pHint->data)
+   {
+      BNode * pPrev = nullptr;
+      if (pHint->pLeft)
+      {
+         for (pPrev = pHint->pLeft; pPrev->pRight; pPrev = pPrev->pRight)
+            ;
+      }
+      else if (pHint != pFirst)
+      {
+         BNode * pChild = pHint;
+         for (pPrev = pHint->pParent; pPrev->pLeft == pChild; pPrev = pPrev->pParent)
+            pChild = pPrev;
+      }
+
+      if (pPrev == nullptr || pPrev->data < t)
+      {
+         // one of them has an empty spot facing the other
+         spot.pParent = pHint->pLeft ? pPrev : pHint;
+         spot.isLeft  = pHint->pLeft == nullptr;
+         return spot;
+      }
+      return locate(t, keepUnique);
+   }
+
+   // after the hint: t must go before the node after it
+   if (pHint->data < t)
+   {
+      BNode * pNext = nullptr;
+      if (pHint->pRight)
+      {
+         for (pNext = pHint->pRight; pNext->pLeft; pNext = pNext->pLeft)
+            ;
+      }
+      else if (pHint != pLast)
+      {
+         BNode * pChild = pHint;
+         for (pNext = pHint->pParent; pNext->pRight == pChild; pNext = pNext->pParent)
+            pChild = pNext;
+      }
+
+      if (pNext == nullptr || t < pNext->data)
+      {
+         spot.pParent = pHint->pRight ? pNext : pHint;
+         spot.isLeft  = pHint->pRight != nullptr;
+         return spot;
+      }
+      return locate(t, keepUnique);
+   }
+
+   // the same as the hint
+   if (keepUnique)
+   {
+      spot.pMatch = pHint;
+      return spot;
+   }
+   return locate(t, keepUnique);
+}
+
+/*****************************************************
+ * BST :: INSERT AT
+ * Put t in a new node at the spot, unless the spot
+ * says it is already there
+ ****************************************************/
+template <typename T, typename A>
+template <typename U>
+std::pair<typename BST <T, A> :: iterator, bool> BST <T, A> :: insertAt(const Spot & spot, U && t)
+{
+   if (spot.pMatch)
+      return std::pair<iterator, bool>(iterator(spot.pMatch), false);
+
+   BNode * pNew;
+   try
+   {
+      pNew = createNode(std::forward<U>(t));
+   }
+   catch (...)
+   {
+      throw "ERROR: Unable to allocate a node";
+   }
+   return std::pair<iterator, bool>(attach(pNew, spot), true);
+}
+
+/*****************************************************
+ * BST :: ATTACH
+ * Hang a new node at the spot and rebalance
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: iterator BST <T, A> :: attach(BNode * pNew, const Spot & spot)
+{
+   // if we are at a trivial state (empty tree), then the new node is the root
+   if (spot.pParent == nullptr)
+   {
+      assert(root == nullptr && numElements == 0);
+      root = pFirst = pLast = pNew;
+   }
+   else if (spot.isLeft)
+   {
+      assert(spot.pParent->pLeft == nullptr);
+      spot.pParent->addLeft(pNew);
+      spot.pParent->addSize(1);
+      if (spot.pParent == pFirst)
+         pFirst = pNew;
+   }
+   else
+   {
+      assert(spot.pParent->pRight == nullptr);
+      spot.pParent->addRight(pNew);
+      spot.pParent->addSize(1);
+      if (spot.pParent == pLast)
+         pLast = pNew;
+   }
+   pNew->balance();
+
+   // we just inserted something!
+   numElements++;
+
+   // if the root moved out from under us, find it again.
+   while (root->pParent != nullptr)
+      root = root->pParent;
+   assert(root->pParent == nullptr);
+
+   return iterator(pNew);
+}
+
+/*****************************************************
+ * BST :: BUILD
+ * Replace the tree with the values in a range. Make a
+ * node for each, then link them up perfectly balanced:
+ * O(n) for a sorted range. A range out of order sorts
+ * the nodes first, so the values are never moved
+ ****************************************************/
+template <typename T, typename A>
+template <class Iterator>
+void BST <T, A> :: build(Iterator first, Iterator last, bool keepUnique)
+{
+   clear();
+
+   std::vector<BNode *> nodes;
+   bool isSorted = true;
+   try
+   {
+      for (; first != last; ++first)
+      {
+         nodes.push_back(nullptr);
+         nodes.back() = createNode(*first);
+         if (isSorted && nodes.size() > 1 &&
+             nodes.back()->data < nodes[nodes.size() - 2]->data)
+            isSorted = false;
+      }
+   }
+   catch (...)
+   {
+      for (BNode * pNode : nodes)
+         if (pNode)
+            destroyNode(pNode);
+      throw "ERROR: Unable to allocate a node";
+   }
+
+   if (!isSorted)
+      std::stable_sort(nodes.begin(), nodes.end(),
+                       [](const BNode * pLHS, const BNode * pRHS) { return pLHS->data < pRHS->data; });
+
+   // the first of a run of matches stays, as it would with insert
+   if (keepUnique && nodes.size() > 1)
+   {
+      size_t numKeep = 1;
+      for (size_t i = 1; i < nodes.size(); i++)
+         if (nodes[i]->data == nodes[numKeep - 1]->data)
+            destroyNode(nodes[i]);
+         else
+            nodes[numKeep++] = nodes[i];
+      nodes.resize(numKeep);
+   }
+
+   numElements = nodes.size();
+   if (nodes.empty())
+      return;
+
+   // only the bottom row of a lopsided tree is red
+   int depthRed = 0;
+   for (size_t num = nodes.size(); num > 1; num /= 2)
+      depthRed++;
+
+   root = link(nodes.data(), nodes.size(), 0, depthRed);
+   root->pParent = nullptr;
+   pFirst = nodes.front();
+   pLast = nodes.back();
+}
+
+/*****************************************************
+ * BST :: LINK
+ * Hang num sorted nodes below the middle one. The
+ * halves never differ by more than one so the leaves
+ * are all at depthRed or the row above
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> :: link(BNode ** ppNodes, size_t num, int depth, int depthRed)
+{
+   if (num == 0)
+      return nullptr;
+
+   size_t iMiddle = num / 2;
+   BNode * pNode = ppNodes[iMiddle];
+   pNode->pLeft  = link(ppNodes, iMiddle, depth + 1, depthRed);
+   pNode->pRight = link(ppNodes + iMiddle + 1, num - iMiddle - 1, depth + 1, depthRed);
+   if (pNode->pLeft)
+      pNode->pLeft->pParent = pNode;
+   if (pNode->pRight)
+      pNode->pRight->pParent = pNode;
+   pNode->isRed = depth > 0 && depth == depthRed;
+   pNode->resize();
+   return pNode;
+}
+
+/*****************************************************
+ * BST :: UNION WITH
+ * Everything in either tree. Where both have a value,
+ * ours stays and the one from rhs is destroyed
+ *   COST : O(m log(n/m + 1)) for m the smaller tree
+ ****************************************************/
+template <typename T, typename A>
+void BST <T, A> :: unionWith(BST & rhs, unsigned numThreads)
+{
+   size_t num = numElements + rhs.numElements;
+   size_t numFreed = 0;
+   Part part = { root, blackHeight(root) };
+   Part rhsPart = take(rhs);
+   Part result = unite(part, rhsPart, parallelDepth(num, numThreads), numFreed);
+   adopt(result, num - numFreed);
+}
+
+/*****************************************************
+ * BST :: INTERSECTION WITH
+ * Only what is in both trees, our copy of it
+ *   COST : O(m log(n/m + 1))
+ ****************************************************/
+template <typename T, typename A>
+void BST <T, A> :: intersectionWith(BST & rhs, unsigned numThreads)
+{
+   size_t num = numElements + rhs.numElements;
+   size_t numFreed = 0;
+   Part part = { root, blackHeight(root) };
+   Part rhsPart = take(rhs);
+   Part result = intersect(part, rhsPart, parallelDepth(num, numThreads), numFreed);
+   adopt(result, num - numFreed);
+}
+
+/*****************************************************
+ * BST :: DIFFERENCE WITH
+ * What we have that rhs does not
+ *   COST : O(m log(n/m + 1))
+ ****************************************************/
+template <typename T, typename A>
+void BST <T, A> :: differenceWith(BST & rhs, unsigned numThreads)
+{
+   size_t num = numElements + rhs.numElements;
+   size_t numFreed = 0;
+   Part part = { root, blackHeight(root) };
+   Part rhsPart = take(rhs);
+   Part result = subtract(part, rhsPart, parallelDepth(num, numThreads), numFreed);
+   adopt(result, num - numFreed);
+}
+
+/*****************************************************
+ * BST :: TAKE
+ * Cut every node loose from rhs. If its nodes came from
+ * an allocator that cannot free ours, copy them with
+ * ours instead and let rhs free its own
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: take(BST & rhs)
+{
+   Part part = { rhs.root, 0 };
+   if (!(alloc == rhs.alloc))
+   {
+      part.pRoot = nullptr;
+      assign(part.pRoot, rhs.root);
+      rhs.clear();
+   }
+   part.height = blackHeight(part.pRoot);
+
+   rhs.root = nullptr;
+   rhs.numElements = 0;
+   rhs.pFirst = rhs.pLast = nullptr;
+   return part;
+}
+
+/*****************************************************
+ * BST :: ADOPT
+ * Make a finished part the whole tree
+ ****************************************************/
+template <typename T, typename A>
+void BST <T, A> :: adopt(Part part, size_t num)
+{
+   root = part.pRoot;
+   if (root)
+   {
+      root->pParent = nullptr;
+      root->isRed = false;
+   }
+   numElements = num;
+   findEnds();
+}
+
+/*****************************************************
+ * BST :: PARALLEL DEPTH
+ * How many levels of the recursion hand one half to
+ * another thread. None for small trees, and none if
+ * the allocator might not take nodes from any thread
+ ****************************************************/
+template <typename T, typename A>
+int BST <T, A> :: parallelDepth(size_t num, unsigned numThreads) const
+{
+   if (!std::is_same<NodeAlloc, std::allocator<BNode>>::value)
+      return 0;
+   if (numThreads == 0)
+   {
+      if (num < BST_PARALLEL_MIN)
+         return 0;
+      numThreads = std::thread::hardware_concurrency();
+   }
+
+   int depth = 0;
+   while ((1u << depth) < numThreads)
+      depth++;
+   return depth;
+}
+
+/*****************************************************
+ * BST :: IS WORTH FORKING
+ * Is this subtree big enough to hand to another
+ * thread? Without subtree sizes, the depth alone
+ * has to decide
+ ****************************************************/
+template <typename T, typename A>
+bool BST <T, A> :: isWorthForking(const BNode * pNode)
+{
+#if BST_ORDER_STATISTICS
+   return BNode::sizeOf(pNode) >= BST_PARALLEL_GRAIN;
+#else
+   return pNode != nullptr;
+#endif // BST_ORDER_STATISTICS
+}
+
+/*****************************************************
+ * BST :: BLACK HEIGHT
+ * Count the black nodes down the left edge. Every
+ * other path has as many
+ ****************************************************/
+template <typename T, typename A>
+int BST <T, A> :: blackHeight(const BNode * pNode)
+{
+   int height = 0;
+   for (; pNode; pNode = pNode->pLeft)
+      height += pNode->isRed ? 0 : 1;
+   return height;
+}
+
+/*****************************************************
+ * BST :: LEFT OF and RIGHT OF
+ * Cut a child loose from the root of a part. A black
+ * root is one more black node than its children have
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: leftOf(Part part)
+{
+   Part left = { part.pRoot->pLeft, part.height - (part.pRoot->isRed ? 0 : 1) };
+   if (left.pRoot)
+      left.pRoot->pParent = nullptr;
+   return left;
+}
+
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: rightOf(Part part)
+{
+   Part right = { part.pRoot->pRight, part.height - (part.pRoot->isRed ? 0 : 1) };
+   if (right.pRoot)
+      right.pRoot->pParent = nullptr;
+   return right;
+}
+
+/*****************************************************
+ * BST :: CONNECT
+ * Hang two subtrees below a middle node
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> :: connect(BNode * pLeft, BNode * pMiddle, BNode * pRight, bool isRed)
+{
+   pMiddle->pLeft = pLeft;
+   pMiddle->pRight = pRight;
+   pMiddle->pParent = nullptr;
+   if (pLeft)
+      pLeft->pParent = pMiddle;
+   if (pRight)
+      pRight->pParent = pMiddle;
+   pMiddle->isRed = isRed;
+   pMiddle->resize();
+   return pMiddle;
+}
+
+/*****************************************************
+ * BST :: ROTATE LEFT and ROTATE RIGHT
+ * The child comes up, keeping the colors as they are
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> :: rotateLeft(BNode * pNode)
+{
+   BNode * pChild = pNode->pRight;
+   connect(pNode->pLeft, pNode, pChild->pLeft, pNode->isRed);
+   return connect(pNode, pChild, pChild->pRight, pChild->isRed);
+}
+
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> :: rotateRight(BNode * pNode)
+{
+   BNode * pChild = pNode->pLeft;
+   connect(pChild->pRight, pNode, pNode->pRight, pNode->isRed);
+   return connect(pChild->pLeft, pChild, pNode, pChild->isRed);
+}
+
+/*****************************************************
+ * BST :: JOIN RIGHT
+ * Left is the taller. Walk down its right edge to a
+ * black node as tall as right, put the middle there in
+ * red, and fix any red-red with a rotation on the way
+ * back up. The result is as tall as left
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> :: joinRight(Part left, BNode * pMiddle, Part right)
+{
+   BNode * pNode = left.pRoot;
+   if (pNode == nullptr || (!pNode->isRed && left.height <= right.height))
+      return connect(pNode, pMiddle, right.pRoot, true /* isRed */);
+
+   Part leftLeft = leftOf(left);
+   BNode * pJoined = joinRight(rightOf(left), pMiddle, right);
+   connect(leftLeft.pRoot, pNode, pJoined, pNode->isRed);
+   if (!pNode->isRed && isRedNode(pNode->pRight) && isRedNode(pNode->pRight->pRight))
+   {
+      pNode->pRight->pRight->isRed = false;
+      return rotateLeft(pNode);
+   }
+   return pNode;
+}
+
+/*****************************************************
+ * BST :: JOIN LEFT
+ * The mirror image: right is the taller
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> :: joinLeft(Part left, BNode * pMiddle, Part right)
+{
+   BNode * pNode = right.pRoot;
+   if (pNode == nullptr || (!pNode->isRed && right.height <= left.height))
+      return connect(left.pRoot, pMiddle, pNode, true /* isRed */);
+
+   Part rightRight = rightOf(right);
+   BNode * pJoined = joinLeft(left, pMiddle, leftOf(right));
+   connect(pJoined, pNode, rightRight.pRoot, pNode->isRed);
+   if (!pNode->isRed && isRedNode(pNode->pLeft) && isRedNode(pNode->pLeft->pLeft))
+   {
+      pNode->pLeft->pLeft->isRed = false;
+      return rotateRight(pNode);
+   }
+   return pNode;
+}
+
+/*****************************************************
+ * BST :: JOIN
+ * Everything in left, then the middle node, then
+ * everything in right, as one red-black tree
+ *   COST : O(difference in heights)
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: join(Part left, BNode * pMiddle, Part right)
+{
+   // black roots all around, which is always allowed
+   if (isRedNode(left.pRoot))
+   {
+      left.pRoot->isRed = false;
+      left.height++;
+   }
+   if (isRedNode(right.pRoot))
+   {
+      right.pRoot->isRed = false;
+      right.height++;
+   }
+
+   Part part;
+   if (left.height > right.height)
+      part = { joinRight(left, pMiddle, right), left.height };
+   else if (right.height > left.height)
+      part = { joinLeft(left, pMiddle, right), right.height };
+   else
+      part = { connect(left.pRoot, pMiddle, right.pRoot, true /* isRed */), left.height };
+
+   // a red root over a red child: the root goes black
+   if (part.pRoot->isRed && (isRedNode(part.pRoot->pLeft) || isRedNode(part.pRoot->pRight)))
+   {
+      part.pRoot->isRed = false;
+      part.height++;
+   }
+   return part;
+}
+
+/*****************************************************
+ * BST :: JOIN 2
+ * Join without a middle node: borrow the last of left
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: join2(Part left, Part right)
+{
+   if (left.pRoot == nullptr)
+      return right;
+   if (right.pRoot == nullptr)
+      return left;
+
+   BNode * pLast;
+   Part rest = takeLast(left, pLast);
+   return join(rest, pLast, right);
+}
+
+/*****************************************************
+ * BST :: TAKE LAST
+ * Cut the right-most node out of a part
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: takeLast(Part part, BNode *& pLast)
+{
+   BNode * pNode = part.pRoot;
+   Part left = leftOf(part);
+   if (pNode->pRight == nullptr)
+   {
+      pLast = pNode;
+      return left;
+   }
+
+   Part rest = takeLast(rightOf(part), pLast);
+   return join(left, pNode, rest);
+}
+
+/*****************************************************
+ * BST :: SPLIT
+ * Cut a part into what is less than t and what is
+ * greater, joining back up on the way out. A node
+ * holding t comes out on its own in pMatch
+ *   COST : O(log n)
+ ****************************************************/
+template <typename T, typename A>
+void BST <T, A> :: split(Part part, const T & t, Part & less, BNode *& pMatch, Part & greater)
+{
+   BNode * pNode = part.pRoot;
+   if (pNode == nullptr)
+   {
+      less = greater = { nullptr, 0 };
+      pMatch = nullptr;
+      return;
+   }
+
+   Part left = leftOf(part);
+   Part right = rightOf(part);
+   if (t < pNode->data)
+   {
+      Part greaterLeft;
+      split(left, t, less, pMatch, greaterLeft);
+      greater = join(greaterLeft, pNode, right);
+   }
+   else if (pNode->data < t)
+   {
+      Part lessRight;
+      split(right, t, lessRight, pMatch, greater);
+      less = join(left, pNode, lessRight);
+   }
+   else
+   {
+      less = left;
+      greater = right;
+      pMatch = connect(nullptr, pNode, nullptr, true);
+   }
+}
+
+/*****************************************************
+ * BST :: FREE TREE
+ * Destroy every node in a part, saying how many
+ ****************************************************/
+template <typename T, typename A>
+size_t BST <T, A> :: freeTree(BNode * pNode) noexcept
+{
+   if (pNode == nullptr)
+      return 0;
+
+   size_t num = 1 + freeTree(pNode->pLeft) + freeTree(pNode->pRight);
+   destroyNode(pNode);
+   return num;
+}
+
+/*****************************************************
+ * BST :: UNITE
+ * Split rhs around our root, unite the halves on each
+ * side (the left one on another thread if there is
+ * depth left for it and a thread to be had), then join
+ * them back around our root
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: unite(Part lhs, Part rhs, int depthParallel, size_t & numFreed)
+{
+   if (lhs.pRoot == nullptr)
+      return rhs;
+   if (rhs.pRoot == nullptr)
+      return lhs;
+
+   BNode * pNode = lhs.pRoot;
+   Part lhsLeft = leftOf(lhs);
+   Part lhsRight = rightOf(lhs);
+   Part rhsLess;
+   Part rhsGreater;
+   BNode * pMatch;
+   split(rhs, pNode->data, rhsLess, pMatch, rhsGreater);
+
+   size_t numFreedLeft = 0;
+   Part left;
+   Part right;
+   std::future<Part> future;
+   if (depthParallel > 0)
+   {
+      try
+      {
+         future = std::async(std::launch::async, [&]()
+            { return unite(lhsLeft, rhsLess, depthParallel - 1, numFreedLeft); });
+      }
+      catch (const std::system_error &)
+      {
+      }
+   }
+   if (future.valid())
+   {
+      right = unite(lhsRight, rhsGreater, depthParallel - 1, numFreed);
+      left = future.get();
+   }
+   else
+   {
+      left = unite(lhsLeft, rhsLess, 0, numFreedLeft);
+      right = unite(lhsRight, rhsGreater, 0, numFreed);
+   }
+   numFreed += numFreedLeft;
+
+   if (pMatch)
+   {
+      destroyNode(pMatch);
+      numFreed++;
+   }
+   return join(left, pNode, right);
 }
 
 /*****************************************************
- * BST :: INSERT
- * Insert a node at a given location in the tree
+ * BST :: INTERSECT
+ * The same shape as unite, but our root only stays if
+ * rhs has it too. Anything facing an empty side goes
  ****************************************************/
-template <typename T>
-std::pair<typename BST <T> :: iterator, bool> BST <T> :: insert(const T & t, bool keepUnique)
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: intersect(Part lhs, Part rhs, int depthParallel, size_t & numFreed)
 {
-   std::pair<iterator, bool> pairReturn(end(), false);
+   if (lhs.pRoot == nullptr || rhs.pRoot == nullptr)
+   {
+      numFreed += freeTree(lhs.pRoot) + freeTree(rhs.pRoot);
+      return { nullptr, 0 };
+   }
 
-   try
+   BNode * pNode = lhs.pRoot;
+   Part lhsLeft = leftOf(lhs);
+   Part lhsRight = rightOf(lhs);
+   Part rhsLess;
+   Part rhsGreater;
+   BNode * pMatch;
+   split(rhs, pNode->data, rhsLess, pMatch, rhsGreater);
+
+   size_t numFreedLeft = 0;
+   Part left;
+   Part right;
+   std::future<Part> future;
+   if (depthParallel > 0)
    {
-      // if we are at a trivial state (empty tree), then create a new root
-      if (root == nullptr)
+      try
       {
-         assert(numElements == 0);
-         root = new BNode(t);
-         root->isRed = false;
-         numElements = 1;
-         pairReturn.first = iterator(root);
-         pairReturn.second = true;
-         return pairReturn;
+         future = std::async(std::launch::async, [&]()
+            { return intersect(lhsLeft, rhsLess, depthParallel - 1, numFreedLeft); });
       }
-
-      // otherwise, go searching for the correct spot
-      BNode* node = root;
-      bool done = false;
-      while (!done)
+      catch (const std::system_error &)
       {
-         //if the node is a match, then do nothing
-         if (keepUnique && t == node->data)
-         {
-            pairReturn.first = iterator(node);
-            pairReturn.second = false;
-            return pairReturn;
-         }
-
-         // if the center node is larger, go left
-         if (t < node->data)
-         {
-            //if there is a node to the left, follow it
-            if (node->pLeft)
-               node = node->pLeft;
-            // if we are at the leaf, then create a new node
-            else
-            {
-               node->addLeft(t);
-               done = true;
-               pairReturn.first = iterator(node->pLeft);
-               pairReturn.second = true;
-            }
-         }
-         // if the center node is smaller, go right
-         else
-         {
-            // if there is a node to the right, follow it
-            if (node->pRight)
-               node = node->pRight;
-            // if we are at the leaf, the create a new node
-            else
-            {
-               node->addRight(t);
-               done = true;
-               pairReturn.first = iterator(node->pRight);
-               pairReturn.second = true;
-            }
-         }
       }
-      // we just inserted something!
-      assert(root != nullptr);
-      numElements++;
-
-      // if the root moved out from under us, find it again.
-      while (root->pParent != nullptr)
-         root = root->pParent;
-      assert(root->pParent == nullptr);
    }
-   catch (...)
+   if (future.valid())
    {
-      throw "ERROR: Unable to allocate a node";
+      right = intersect(lhsRight, rhsGreater, depthParallel - 1, numFreed);
+      left = future.get();
    }
-   return pairReturn;
-}
+   else
+   {
+      left = intersect(lhsLeft, rhsLess, 0, numFreedLeft);
+      right = intersect(lhsRight, rhsGreater, 0, numFreed);
+   }
+   numFreed += numFreedLeft + 1;
 
+   if (pMatch)
+   {
+      destroyNode(pMatch);
+      return join(left, pNode, right);
+   }
+   destroyNode(pNode);
+   return join2(left, right);
+}
 
-template <typename T>
-std::pair<typename BST <T> ::iterator, bool> BST <T> ::insert(T&& t, bool keepUnique)
+/*****************************************************
+ * BST :: SUBTRACT
+ * Split us around the root of rhs, take away on each
+ * side, and drop that root along with our copy of it
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: Part BST <T, A> :: subtract(Part lhs, Part rhs, int depthParallel, size_t & numFreed)
 {
-   std::pair<iterator, bool> pairReturn(end(), false);
+   if (lhs.pRoot == nullptr || rhs.pRoot == nullptr)
+   {
+      numFreed += freeTree(rhs.pRoot);
+      return lhs;
+   }
 
-   try
+   BNode * pNode = rhs.pRoot;
+   Part rhsLeft = leftOf(rhs);
+   Part rhsRight = rightOf(rhs);
+   Part lhsLess;
+   Part lhsGreater;
+   BNode * pMatch;
+   split(lhs, pNode->data, lhsLess, pMatch, lhsGreater);
+
+   size_t numFreedLeft = 0;
+   Part left;
+   Part right;
+   std::future<Part> future;
+   if (depthParallel > 0)
    {
-      // if we are at a trivial state (empty tree), then create a new root
-      if (root == nullptr)
+      try
       {
-         assert(numElements == 0);
-         root = new BNode(std::move(t));
-         root->isRed = false;
-         numElements = 1;
-         pairReturn.first = iterator(root);
-         pairReturn.second = true;
-         return pairReturn;
+         future = std::async(std::launch::async, [&]()
+            { return subtract(lhsLess, rhsLeft, depthParallel - 1, numFreedLeft); });
       }
-
-      // otherwise, go searching for the correct spot
-      BNode* node = root;
-      bool done = false;
-      while (!done)
+      catch (const std::system_error &)
       {
-         //if the node is a match, then do nothing
-         if (keepUnique && t == node->data)
-         {
-            pairReturn.first = iterator(node);
-            pairReturn.second = false;
-            return pairReturn;
-         }
-
-         // if the center node is larger, go left
-         if (t < node->data)
-         {
-            //if there is a node to the left, follow it
-            if (node->pLeft)
-               node = node->pLeft;
-            // if we are at the leaf, then create a new node
-            else
-            {
-               node->addLeft(std::move(t));
-               done = true;
-               pairReturn.first = iterator(node->pLeft);
-               pairReturn.second = true;
-            }
-         }
-         // if the center node is smaller, go right
-         else
-         {
-            // if there is a node to the right, follow it
-            if (node->pRight)
-               node = node->pRight;
-            // if we are at the leaf, the create a new node
-            else
-            {
-               node->addRight(std::move(t));
-               done = true;
-               pairReturn.first = iterator(node->pRight);
-               pairReturn.second = true;
-            }
-         }
       }
-      // we just inserted something!
-      assert(root != nullptr);
-      numElements++;
-
-      // if the root moved out from under us, find it again.
-      while (root->pParent != nullptr)
-         root = root->pParent;
-      assert(root->pParent == nullptr);
    }
-   catch (...)
+   if (future.valid())
    {
-      throw "ERROR: Unable to allocate a node";
+      right = subtract(lhsGreater, rhsRight, depthParallel - 1, numFreed);
+      left = future.get();
+   }
+   else
+   {
+      left = subtract(lhsLess, rhsLeft, 0, numFreedLeft);
+      right = subtract(lhsGreater, rhsRight, 0, numFreed);
    }
-   return pairReturn;
+   numFreed += numFreedLeft + 1;
+   destroyNode(pNode);
+
+   if (pMatch)
+   {
+      destroyNode(pMatch);
+      numFreed++;
+   }
+   return join2(left, right);
+}
+
+/*****************************************************
+ * BST :: FIND ENDS
+ * Find the left-most and right-most nodes again
+ ****************************************************/
+template <typename T, typename A>
+void BST <T, A> :: findEnds()
+{
+   pFirst = pLast = root;
+   if (root == nullptr)
+      return;
+   while (pFirst->pLeft)
+      pFirst = pFirst->pLeft;
+   while (pLast->pRight)
+      pLast = pLast->pRight;
 }
 
 /******************************************
@@ -570,8 +1517,8 @@ std::pair<typename BST <T> ::iterator, bool> BST <T> ::insert(T&& t, bool keepUn
  *    pDelete   the node to be deleted
  *    toRight   should the right branch inherit our place?
  ******************************************/
-template <typename T>
-void BST<T>::deleteNode(BNode*& pDelete, bool toRight)
+template <typename T, typename A>
+void BST<T, A>::deleteNode(BNode*& pDelete, bool toRight)
 {
    // shift everything up
    BNode* pNext = (toRight ? pDelete->pRight : pDelete->pLeft);
@@ -602,8 +1549,8 @@ void BST<T>::deleteNode(BNode*& pDelete, bool toRight)
  * BST :: ERASE
  * Remove a given node as specified by the iterator.
  ****************************************************/
-template <typename T>
-typename BST<T>::iterator BST<T>::erase(iterator& it)
+template <typename T, typename A>
+typename BST<T, A>::iterator BST<T, A>::erase(iterator& it)
 {
    // do nothing if there is nothing to do
    if (it == end())
@@ -613,16 +1560,35 @@ typename BST<T>::iterator BST<T>::erase(iterator& it)
    iterator itNext = it;
    BNode* pDelete = it.pNode;
 
+   // the ends have at most one child, so the next one in is that
+   // child's far side or else the parent
+   if (pDelete == pFirst)
+   {
+      for (pFirst = pDelete->pRight ? pDelete->pRight : pDelete->pParent;
+           pFirst && pDelete->pRight && pFirst->pLeft; pFirst = pFirst->pLeft)
+         ;
+   }
+   if (pDelete == pLast)
+   {
+      for (pLast = pDelete->pLeft ? pDelete->pLeft : pDelete->pParent;
+           pLast && pDelete->pLeft && pLast->pRight; pLast = pLast->pRight)
+         ;
+   }
+
    // if there is only one child (right) or no children (how sad!)
    if (pDelete->pLeft == nullptr)
    {
       ++itNext;
+      if (pDelete->pParent)
+         pDelete->pParent->addSize(-1);
       deleteNode(pDelete, true /* goRight */);
    }
    // if there is only one child (left)
    else if (pDelete->pRight == nullptr)
    {
       ++itNext;
+      if (pDelete->pParent)
+         pDelete->pParent->addSize(-1);
       deleteNode(pDelete, false /* goRight */);
    }
    // otherwise, swap places with the in-order successor
@@ -633,6 +1599,9 @@ typename BST<T>::iterator BST<T>::erase(iterator& it)
       while (pIOS->pLeft != nullptr)
          pIOS = pIOS->pLeft;
 
+      // one fewer below where the IOS used to be
+      pIOS->pParent->addSize(-1);
+
       // the IOS must not have a right node. Now it will take pDelete's place.
       assert(pIOS->pLeft == nullptr);
       pIOS->pLeft = pDelete->pLeft;
@@ -664,12 +1633,13 @@ typename BST<T>::iterator BST<T>::erase(iterator& it)
       // what if that was the root?!?!
       if (root == pDelete)
          root = pIOS;
+      pIOS->resize();
 
       itNext = iterator(pIOS);
    }
 
    numElements--;
-   delete pDelete;
+   destroyNode(pDelete);
    return itNext;
 }
 
@@ -677,24 +1647,65 @@ typename BST<T>::iterator BST<T>::erase(iterator& it)
  * BST :: CLEAR
  * Removes all the BNodes from a tree
  ****************************************************/
-template <typename T>
-void BST <T> ::clear() noexcept
+template <typename T, typename A>
+void BST <T, A> ::clear(unsigned numThreads) noexcept
 {
    if (root)
    {
-      root->clear(root);
-      //deleteBinaryTree(root);
+      if (canRelease(alloc, 0))
+      {
+         // the pool holds nothing but our nodes: run the destructors
+         // if there are any to run, then hand back whole chunks
+         if (!std::is_trivially_destructible<T>::value)
+            destroyBinaryTree(root);
+         release(alloc, 0);
+         root = nullptr;
+      }
+      else
+         deleteBinaryTree(root, parallelDepth(numElements, numThreads));
    }
-   //root = nullptr;  // Prevent dangling pointer
    numElements = 0;
+   pFirst = pLast = nullptr;
+}
+
+/*****************************************************
+ * BST :: CLEAR DEFERRED
+ * Move the nodes into a tree of their own and let a
+ * detached thread destroy it. Only for std::allocator,
+ * the one we know any thread can free to; anything
+ * else, or a thread we cannot start, is cleared here
+ ****************************************************/
+template <typename T, typename A>
+std::future<void> BST <T, A> :: clearDeferred()
+{
+   if (root == nullptr || !std::is_same<NodeAlloc, std::allocator<BNode>>::value)
+   {
+      clear();
+      std::promise<void> done;
+      done.set_value();
+      return done.get_future();
+   }
+
+   BST * pDoomed = new BST(std::move(*this));
+   auto pTask = std::make_shared<std::packaged_task<void()>>([pDoomed]() { delete pDoomed; });
+   std::future<void> future = pTask->get_future();
+   try
+   {
+      std::thread([pTask]() { (*pTask)(); }).detach();
+   }
+   catch (const std::system_error &)
+   {
+      (*pTask)();
+   }
+   return future;
 }
 
 /*****************************************************
  * BST :: BEGIN
  * Return the first node (left-most) in a binary search tree
  ****************************************************/
-template <typename T>
-typename BST <T> :: iterator custom :: BST <T> :: begin() const noexcept
+template <typename T, typename A>
+typename BST <T, A> :: iterator custom :: BST <T, A> :: begin() const noexcept
 {
    if (root == nullptr)
       return end();
@@ -711,8 +1722,8 @@ typename BST <T> :: iterator custom :: BST <T> :: begin() const noexcept
  * BST :: FIND
  * Return the node corresponding to a given value
  ****************************************************/
-template <typename T>
-typename BST <T> :: iterator BST<T> :: find(const T & t)
+template <typename T, typename A>
+typename BST <T, A> :: iterator BST<T, A> :: find(const T & t)
 {
    BNode * p = this->root;
 
@@ -729,161 +1740,245 @@ typename BST <T> :: iterator BST<T> :: find(const T & t)
    return end();
 }
 
-/******************************************************
- ******************************************************
- ******************************************************
- *********************** B NODE ***********************
- ******************************************************
- ******************************************************
- ******************************************************/
+/****************************************************
+ * BST :: NTH
+ * Return the node with k nodes before it, or end()
+ * if there are not that many. Steer by the sizes
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: iterator BST<T, A> :: nth(size_t k) const
+{
+#if BST_ORDER_STATISTICS
+   BNode * pNode = root;
+   while (pNode)
+   {
+      size_t numLeft = BNode::sizeOf(pNode->pLeft);
+      if (k < numLeft)
+         pNode = pNode->pLeft;
+      else if (k == numLeft)
+         return iterator(pNode);
+      else
+      {
+         k -= numLeft + 1;
+         pNode = pNode->pRight;
+      }
+   }
+   return end();
+#else
+   iterator it = begin();
+   for (; k > 0 && it != end(); k--)
+      ++it;
+   return it;
+#endif // BST_ORDER_STATISTICS
+}
+
+/****************************************************
+ * BST :: RANK
+ * Return how many values are less than t. Every time
+ * we go right, the node and its left subtree are less
+ ****************************************************/
+template <typename T, typename A>
+size_t BST<T, A> :: rank(const T & t) const
+{
+   size_t num = 0;
+#if BST_ORDER_STATISTICS
+   BNode * pNode = root;
+   while (pNode)
+   {
+      if (pNode->data < t)
+      {
+         num += 1 + BNode::sizeOf(pNode->pLeft);
+         pNode = pNode->pRight;
+      }
+      else
+         pNode = pNode->pLeft;
+   }
+#else
+   for (iterator it = begin(); it != end() && *it < t; ++it)
+      num++;
+#endif // BST_ORDER_STATISTICS
+   return num;
+}
+
+/****************************************************
+ * BST :: BOUND
+ * The first node not less than t (or, for the upper
+ * bound, greater than t), or nullptr. Every time we
+ * go left, the node we leave is the best so far
+ ****************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST<T, A> :: bound(const T & t, bool isUpper) const
+{
+   BNode * pBound = nullptr;
+   BNode * pNode = root;
+   while (pNode)
+   {
+      if (isUpper ? t < pNode->data : !(pNode->data < t))
+      {
+         pBound = pNode;
+         pNode = pNode->pLeft;
+      }
+      else
+         pNode = pNode->pRight;
+   }
+   return pBound;
+}
 
+/****************************************************
+ * BST :: FOR EACH IN RANGE
+ * In order through the subtree, skipping the left of
+ * anything below lo and stopping at anything not
+ * below hi. The right spine is a loop, not a call
+ ****************************************************/
+template <typename T, typename A>
+template <class Function>
+void BST<T, A> :: forEachInRange(const BNode * pNode, const T & lo, const T & hi, Function & fn)
+{
+   while (pNode)
+   {
+      bool isAboveLo = !(pNode->data < lo);
+      if (isAboveLo)
+         forEachInRange(pNode->pLeft, lo, hi, fn);
+      if (!(pNode->data < hi))
+         return;
+      if (isAboveLo)
+         fn(pNode->data);
+      pNode = pNode->pRight;
+   }
+}
 
 /**********************************************
- * assign
+ * BST :: ASSIGN
  * copy the values from pSrc onto pDest preserving
  * as many of the nodes as possible.
  *********************************************/
-template <typename T>
-void BST <T> :: BNode :: assign(BNode * & pDest, const BNode * pSrc)
+template <typename T, typename A>
+void BST <T, A> :: assign(BNode * & pDest, const BNode * pSrc, int depthParallel)
 {
    // src is empty
    if (pSrc == nullptr)
    {
-      clear(pDest);
+      deleteBinaryTree(pDest);
       return;
    }
 
    // dest is empty, create a new node
    if (pDest == nullptr)
-   {
-      pDest = new BNode(pSrc->data);
-      pDest->isRed = pSrc->isRed;
-   }
+      pDest = createNode(pSrc->data);
 
    // Neither src nor dest is empty, update the node
    else
       pDest->data = pSrc->data;
+   pDest->isRed = pSrc->isRed;
 
-   // Recursively loop through tree
-   assign(pDest->pRight, pSrc->pRight);
-   assign(pDest->pLeft, pSrc->pLeft);
+   // Recursively loop through tree, the left side on another
+   // thread while there are threads to spare. The two sides share
+   // nothing but the allocator. With no thread to be had, both run here
+   std::future<void> future;
+   if (depthParallel > 0 && isWorthForking(pSrc->pLeft) && isWorthForking(pSrc->pRight))
+   {
+      try
+      {
+         future = std::async(std::launch::async, [&]()
+            { assign(pDest->pLeft, pSrc->pLeft, depthParallel - 1); });
+      }
+      catch (const std::system_error &)
+      {
+      }
+   }
+   if (future.valid())
+   {
+      try
+      {
+         assign(pDest->pRight, pSrc->pRight, depthParallel - 1);
+      }
+      catch (...)
+      {
+         future.wait();
+         throw;
+      }
+      future.get();
+   }
+   else
+   {
+      assign(pDest->pRight, pSrc->pRight, depthParallel);
+      assign(pDest->pLeft, pSrc->pLeft, depthParallel);
+   }
 
    // Hookup parents
    if (pDest->pRight)
       pDest->pRight->pParent = pDest;
    if (pDest->pLeft)
       pDest->pLeft->pParent = pDest;
+   pDest->resize();
 }
 
-
-/******************************************************
- * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
- ******************************************************/
-template <typename T>
-void BST <T> ::BNode::addLeft(BNode* pNode)
-{
-   this->pLeft = pNode;
-   if (pNode != nullptr)
-      pNode->pParent = this;
-
-}
-
-/******************************************************
- * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
- ******************************************************/
-template <typename T>
-void BST <T> ::BNode::addRight(BNode* pNode)
-{
-   this->pRight = pNode;
-   if (pNode != nullptr)
-      pNode->pParent = this;
-
-}
-
-/******************************************************
- * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
- ******************************************************/
-template <typename T>
-void BST<T> ::BNode::addLeft(const T& t)
+/**********************************************
+ * BST :: CREATE NODE
+ * Get a node from the allocator and build it
+ * in place
+ *********************************************/
+template <typename T, typename A>
+template <typename ... Args>
+typename BST <T, A> :: BNode * BST <T, A> :: createNode(Args && ... args)
 {
-   assert(pLeft == nullptr);
-
+   BNode * pNode = alloc.allocate(1);
    try
    {
-      BNode* pNode = new BNode(t);
-      addLeft(pNode);
-      pNode->balance();
+      std::allocator_traits<NodeAlloc>::construct(alloc, pNode, std::forward<Args>(args)...);
    }
    catch (...)
    {
-      throw "ERROR: Unable to allocate a node";
+      alloc.deallocate(pNode, 1);
+      throw;
    }
+   return pNode;
+}
+
+/**********************************************
+ * BST :: DESTROY NODE
+ * Tear a node down and give it back
+ *********************************************/
+template <typename T, typename A>
+void BST <T, A> :: destroyNode(BNode * pNode) noexcept
+{
+   std::allocator_traits<NodeAlloc>::destroy(alloc, pNode);
+   alloc.deallocate(pNode, 1);
 }
 
 /******************************************************
- * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
+ ******************************************************
+ ******************************************************
+ *********************** B NODE ***********************
+ ******************************************************
+ ******************************************************
  ******************************************************/
-template <typename T>
-void BST<T> ::BNode::addLeft(T&& t)
-{
-   assert(pLeft == nullptr);
 
-   try
-   {
-      BNode* pNode = new BNode(std::move(t));
-      addLeft(pNode);
-      pNode->balance();
-   }
-   catch (...)
-   {
-      throw "ERROR: Unable to allocate a node";
-   }
-}
 
 /******************************************************
- * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
+ * BINARY NODE :: ADD LEFT
+ * Add a node to the left of the current node
  ******************************************************/
-template <typename T>
-void BST <T> ::BNode::addRight(const T& t)
+template <typename T, typename A>
+void BST <T, A> ::BNode::addLeft(BNode* pNode)
 {
-   assert(pRight == nullptr);
+   this->pLeft = pNode;
+   if (pNode != nullptr)
+      pNode->pParent = this;
 
-   try
-   {
-      BNode* pNode = new BNode(t);
-      addRight(pNode);
-      pNode->balance();
-   }
-   catch (...)
-   {
-      throw "ERROR: Unable to allocate a node";
-   }
 }
 
 /******************************************************
  * BINARY NODE :: ADD RIGHT
  * Add a node to the right of the current node
  ******************************************************/
-template <typename T>
-void BST <T> ::BNode::addRight(T&& t)
+template <typename T, typename A>
+void BST <T, A> ::BNode::addRight(BNode* pNode)
 {
-   assert(pRight == nullptr);
+   this->pRight = pNode;
+   if (pNode != nullptr)
+      pNode->pParent = this;
 
-   try
-   {
-      BNode* pNode = new BNode(std::move(t));
-      addRight(pNode);
-      pNode->balance();
-   }
-   catch (...)
-   {
-      throw "ERROR: Unable to allocate a node";
-   }
 }
 
 #ifdef DEBUG
@@ -892,8 +1987,8 @@ void BST <T> ::BNode::addRight(T&& t)
  * Find the depth of the black nodes. This is useful for
  * verifying that a given red-black tree is valid
  ****************************************************/
-template <typename T>
-int BST <T> :: BNode :: findDepth() const
+template <typename T, typename A>
+int BST <T, A> :: BNode :: findDepth() const
 {
    // if there are no children, the depth is ourselves
    if (pRight == nullptr && pLeft == nullptr)
@@ -910,8 +2005,8 @@ int BST <T> :: BNode :: findDepth() const
  * BINARY NODE :: VERIFY RED BLACK
  * Do all four red-black rules work here?
  ***************************************************/
-template <typename T>
-bool BST <T> :: BNode :: verifyRedBlack(int depth) const
+template <typename T, typename A>
+bool BST <T, A> :: BNode :: verifyRedBlack(int depth) const
 {
    bool fReturn = true;
    depth -= (isRed == false) ? 1 : 0;
@@ -955,8 +2050,8 @@ bool BST <T> :: BNode :: verifyRedBlack(int depth) const
  * VERIFY B TREE
  * Verify that the tree is correctly formed
  ******************************************************/
-template <typename T>
-std::pair <T, T> BST <T> :: BNode :: verifyBTree() const
+template <typename T, typename A>
+std::pair <T, T> BST <T, A> :: BNode :: verifyBTree() const
 {
    // largest and smallest values
    std::pair <T, T> extremes;
@@ -999,8 +2094,8 @@ std::pair <T, T> BST <T> :: BNode :: verifyBTree() const
  * COMPUTE SIZE
  * Verify that the BST is as large as we think it is
  ********************************************/
-template <typename T>
-int BST <T> :: BNode :: computeSize() const
+template <typename T, typename A>
+int BST <T, A> :: BNode :: computeSize() const
 {
    return 1 +
       (pLeft  == nullptr ? 0 : pLeft->computeSize()) +
@@ -1010,24 +2105,35 @@ int BST <T> :: BNode :: computeSize() const
 
 /******************************************************
  * BINARY NODE :: BALANCE
- * Balance the tree from a given location
+ * Balance the tree from a given location. Only a recolor
+ * (case 3) moves the trouble up, to granny, so walk up in
+ * a loop rather than recursing
  ******************************************************/
-template <typename T>
-void BST <T> ::BNode::balance()
+template <typename T, typename A>
+void BST <T, A> ::BNode::balance()
 {
-   if (this == nullptr)
-      return;
+   for (BNode * pNode = this; pNode != nullptr; pNode = pNode->balanceStep())
+      ;
+}
 
+/******************************************************
+ * BINARY NODE :: BALANCE STEP
+ * Fix one red-red at this node. Return the node to
+ * balance next, or nullptr when the tree is done
+ ******************************************************/
+template <typename T, typename A>
+typename BST <T, A> :: BNode * BST <T, A> ::BNode::balanceStep()
+{
    // Case 1: if we are the root, then color ourselves black and call it a day.
    if (pParent == nullptr)
    {
       isRed = false;
-      return;
+      return nullptr;
    }
 
    // Case 2: if the parent is black, then there is nothing left to do
    if (!pParent->isRed)
-      return;
+      return nullptr;
 
    assert(pParent->pParent != nullptr);
 
@@ -1069,8 +2175,7 @@ void BST <T> ::BNode::balance()
       pGranny->isRed = true;  // gma    = red
       pParent->isRed = false; // parent = black
       pAunt->isRed = false; // aunt   = black
-      pGranny->balance();     // recursively balance
-      return;
+      return pGranny;         // balance from granny next
    }
 
    // Case 4: if the aunt non-existant or black, then we need to rotate
@@ -1161,6 +2266,12 @@ void BST <T> ::BNode::balance()
       assert(false);
    }
 
+   // the rotated nodes count again, bottom up. Parent is the head
+   // in 4a and 4b, and below it in 4c and 4d
+   pGranny->resize();
+   pParent->resize();
+   pHead->resize();
+
    if (pGreatG == nullptr)
       pHead->pParent = nullptr;
    else if (pGreatG->pRight == pGranny)
@@ -1168,40 +2279,61 @@ void BST <T> ::BNode::balance()
    else if (pGreatG->pLeft == pGranny)
       pGreatG->addLeft(pHead);
 
+   return nullptr;
 }
-/*****************************************************
+/******************************************
  * DELETE BINARY TREE
  * Delete all the nodes below pThis including pThis
  * using postfix traverse: LRV
- ****************************************************/
-template <typename T>
-void BST <T> :: BNode :: clear(BNode *& pNode)
+ ******************************************/
+template <typename T, typename A>
+void BST<T, A>::deleteBinaryTree(BNode*& pDelete, int depthParallel) noexcept
 {
-   if (!pNode)
+   if (pDelete == nullptr)
       return;
 
-   clear(pNode->pLeft);
-   clear(pNode->pRight);
-   delete pNode;
-   pNode = nullptr;
+   // the left side on another thread if we can get one. std::async
+   // may fail for want of a thread or of memory; either way, do it here
+   bool isForked = false;
+   if (depthParallel > 0 && isWorthForking(pDelete->pLeft) && isWorthForking(pDelete->pRight))
+   {
+      try
+      {
+         auto future = std::async(std::launch::async, [&]()
+            { deleteBinaryTree(pDelete->pLeft, depthParallel - 1); });
+         isForked = true;
+         deleteBinaryTree(pDelete->pRight, depthParallel - 1);
+      }
+      catch (...)
+      {
+      }
+   }
+   if (!isForked)
+   {
+      deleteBinaryTree(pDelete->pLeft, depthParallel);   // L
+      deleteBinaryTree(pDelete->pRight, depthParallel);  // R
+   }
+
+   destroyNode(pDelete);               // V
+   pDelete = nullptr;
 }
 
 /******************************************
- * DELETE BINARY TREE
- * Delete all the nodes below pThis including pThis
- * using postfix traverse: LRV
+ * DESTROY BINARY TREE
+ * Run the destructor of every node below pThis
+ * including pThis, but leave the memory for
+ * the allocator to take back in bulk
  ******************************************/
-template <typename T>
-void BST<T>::deleteBinaryTree(BNode*& pDelete) noexcept
+template <typename T, typename A>
+void BST<T, A>::destroyBinaryTree(BNode * pDelete) noexcept
 {
    if (pDelete == nullptr)
       return;
 
-   deleteBinaryTree(pDelete->pLeft);   // L
-   deleteBinaryTree(pDelete->pRight);  // R
+   destroyBinaryTree(pDelete->pLeft);  // L
+   destroyBinaryTree(pDelete->pRight); // R
 
-   delete pDelete;                     // V
-   pDelete = nullptr;
+   std::allocator_traits<NodeAlloc>::destroy(alloc, pDelete); // V
 }
 
 /***********************************************
@@ -1209,8 +2341,8 @@ void BST<T>::deleteBinaryTree(BNode*& pDelete) noexcept
  * Swap the list from LHS to RHS
  *   COST   : O(1)
  **********************************************/
-template <typename T>
-void BST <T> ::BNode:: swap(BNode *& pRHS)
+template <typename T, typename A>
+void BST <T, A> ::BNode:: swap(BNode *& pRHS)
 {
    std::swap(this, pRHS);
 }
@@ -1227,8 +2359,8 @@ void BST <T> ::BNode:: swap(BNode *& pRHS)
  * BST ITERATOR :: INCREMENT PREFIX
  * advance by one
  *************************************************/
-template <typename T>
-typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
+template <typename T, typename A>
+typename BST <T, A> :: iterator & BST <T, A> :: iterator :: operator ++ ()
 {
    // At the end
    if (!pNode)
@@ -1245,6 +2377,13 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
       return *this;
    }
 
+   // the root with nothing to the right: we are done
+   if (this->pNode->pParent == nullptr)
+   {
+      this->pNode = nullptr;
+      return *this;
+   }
+
    // case 2 - We have no right child and we are parent left child
    if (this->pNode->pRight == nullptr &&
        this->pNode->pParent->pLeft == pNode)
@@ -1272,8 +2411,8 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
  * BST ITERATOR :: DECREMENT PREFIX
  * advance by one
  *************************************************/
-template <typename T>
-typename BST <T> :: iterator & BST <T> :: iterator :: operator -- () {
+template <typename T, typename A>
+typename BST <T, A> :: iterator & BST <T, A> :: iterator :: operator -- () {
    // At the end
    if (!pNode)
       return *this;
@@ -1289,6 +2428,13 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator -- () {
       return *this;
    }
 
+   // the root with nothing to the left: we are done
+   if (this->pNode->pParent == nullptr)
+   {
+      this->pNode = nullptr;
+      return *this;
+   }
+
    // case 2 - We have no left child and we are parent right child
    if (this->pNode->pLeft == nullptr &&
        this->pNode->pParent->pRight == pNode)
@@ -0,0 +1,1102 @@
+/***********************************************************************
+ * Header:
+ *    BTREE
+ * Summary:
+ *    A B-tree with the same interface as BST, so set and map can use
+ *    either one. Each node holds a sorted run of values in about 512
+ *    bytes, so a lookup touches a few wide nodes instead of one node
+ *    (and one cache miss) per level of a binary tree
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        BTree                 : A B-tree of values, ordered by <
+ *        BTree::iterator       : An iterator through BTree
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>          // for size_t
+#include <memory>           // for std::allocator and std::allocator_traits
+#include <new>              // for placement new
+#include <type_traits>      // for std::is_trivially_destructible
+#include <utility>          // for std::pair and std::move
+#include <initializer_list>
+#include <vector>
+
+class TestBTree; // forward declaration for unit tests
+class TestSet;
+class TestMap;
+
+namespace custom
+{
+
+// about how big a leaf is: the values fill it
+static const size_t BTREE_NODE_BYTES = 512;
+
+/*****************************************************************
+ * B-TREE
+ * Every node holds between MIN and MAX values in order (only the
+ * root may have fewer), and an internal node with n values has
+ * n + 1 children. All the leaves are at the same depth. Inserts
+ * split full nodes on the way down; erases borrow from or merge
+ * with a sibling on the way back up.
+ *****************************************************************/
+template <typename T, typename A = std::allocator<T>>
+class BTree
+{
+   friend class ::TestBTree; // give unit tests access to the privates
+   friend class ::TestSet;
+   friend class ::TestMap;
+
+public:
+   //
+   // Construct
+   //
+
+   BTree(const A & a = A());
+   BTree(const BTree &  rhs);
+   BTree(      BTree && rhs);
+   BTree(const std::initializer_list<T>& il, const A & a = A());
+  ~BTree() { clear(); }
+
+   //
+   // Assign
+   //
+
+   BTree & operator = (const BTree &  rhs);
+   BTree & operator = (      BTree && rhs);
+   BTree & operator = (const std::initializer_list<T>& il);
+   void swap(BTree & rhs);
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator   begin() const noexcept;
+   iterator   end()   const noexcept { return iterator(); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T& t);
+
+   // the nodes keep no counts, so these walk the values in order.
+   // That is still a pass over packed arrays, not a pointer chase
+   iterator nth(size_t k) const
+   {
+      iterator it = begin();
+      for (; k > 0 && it != end(); k--)
+         ++it;
+      return it;
+   }
+   size_t rank(const T & t) const
+   {
+      size_t num = 0;
+      for (iterator it = begin(); it != end() && *it < t; ++it)
+         num++;
+      return num;
+   }
+   iterator lower_bound(const T & t) const { return bound(t, false); }
+   iterator upper_bound(const T & t) const { return bound(t, true);  }
+   std::pair<iterator, iterator> equal_range(const T & t) const
+   {
+      return std::make_pair(lower_bound(t), upper_bound(t));
+   }
+
+   // the values in a leaf sit side by side, so after the one
+   // descent this is mostly a walk along arrays
+   template <class Function>
+   void for_each_in_range(const T & lo, const T & hi, Function fn) const
+   {
+      for (iterator it = lower_bound(lo); it != end() && *it < hi; ++it)
+         fn(*it);
+   }
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const T&  t, bool keepUnique = false)
+   {
+      return insertValue(t, keepUnique);
+   }
+   std::pair<iterator, bool> insert(      T&& t, bool keepUnique = false)
+   {
+      return insertValue(std::move(t), keepUnique);
+   }
+
+   // values live in arrays that shift, so there is no node to build
+   // them in ahead of time and a hint saves nothing over the short
+   // descent. These are here so set and map can use either engine
+   iterator insert(iterator /*itHint*/, const T&  t, bool keepUnique = false)
+   {
+      return insertValue(t, keepUnique).first;
+   }
+   iterator insert(iterator /*itHint*/,       T&& t, bool keepUnique = false)
+   {
+      return insertValue(std::move(t), keepUnique).first;
+   }
+   template <typename ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args)
+   {
+      return insertValue(T(std::forward<Args>(args)...), false);
+   }
+   template <typename ... Args>
+   std::pair<iterator, bool> emplace_unique(Args && ... args)
+   {
+      return insertValue(T(std::forward<Args>(args)...), true);
+   }
+   template <class Iterator>
+   void build(Iterator first, Iterator last, bool keepUnique = false)
+   {
+      // sorted input only ever splits the right edge, which is
+      // cheap enough here that a bottom-up build buys little
+      clear();
+      for (; first != last; ++first)
+         insertValue(*first, keepUnique);
+   }
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator& it);
+   void   clear() noexcept;
+
+   //
+   // Set algebra. There is no join on a B-tree here, so these merge
+   // both in order and rebuild: O(n + m) whatever the sizes. rhs is
+   // left empty and numThreads is ignored
+   //
+
+   void unionWith       (BTree & rhs, unsigned /*numThreads*/ = 0) { merge(rhs, true,  true,  true);  }
+   void intersectionWith(BTree & rhs, unsigned /*numThreads*/ = 0) { merge(rhs, false, true,  false); }
+   void differenceWith  (BTree & rhs, unsigned /*numThreads*/ = 0) { merge(rhs, true,  false, false); }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return size() == 0; }
+   size_t size()  const noexcept { return numElements; }
+
+private:
+
+   // the most values in a node: odd, so a full node splits into two halves
+   static constexpr int MAX = (BTREE_NODE_BYTES - 16) / sizeof(T) < 3 ? 3 :
+                              (int)(((BTREE_NODE_BYTES - 16) / sizeof(T) - 1) | 1);
+   static constexpr int MIN = MAX / 2;
+
+   struct Node;
+   struct Internal;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node>     LeafAlloc;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Internal> InternalAlloc;
+
+   template <typename U>
+   std::pair<iterator, bool> insertValue(U && t, bool keepUnique);
+
+   // nodes
+   Node     * newLeaf();
+   Internal * newInternal();
+   void freeNode(Node * pNode) noexcept;
+   Node * copyTree(const Node * pSrc);
+   void deleteTree(Node * pNode) noexcept;
+   void destroyValues(Node * pNode) noexcept;
+
+   // values and children within a node
+   void merge(BTree & rhs, bool keepLeft, bool keepBoth, bool keepRight);
+   iterator bound(const T & t, bool isUpper) const;
+   static int lowerBound(const Node * pNode, const T & t);
+   static int upperBound(const Node * pNode, const T & t);
+   template <typename U>
+   static void placeValue(Node * pNode, int i, U && t);
+   static void removeValue(Node * pNode, int i);
+   static void setChild(Internal * pParent, int i, Node * pChild);
+
+   // keeping every node between MIN and MAX
+   void splitChild(Internal * pParent, int i);
+   void rebalance(Node * pNode, iterator & itTrack);
+   void borrowLeft (Internal * pParent, int i, iterator & itTrack);
+   void borrowRight(Internal * pParent, int i, iterator & itTrack);
+   void merge      (Internal * pParent, int i, iterator & itTrack);
+
+   // can the allocators free every node at once? Only pools that
+   // have release() and that nobody else is using
+   template <typename NA>
+   static auto canRelease(const NA & a, int) -> decltype(std::declval<NA &>().release(), bool())
+   {
+      return a.unique();
+   }
+   template <typename NA>
+   static bool canRelease(const NA &, long) { return false; }
+   template <typename NA>
+   static auto release(NA & a, int) -> decltype(a.release()) { a.release(); }
+   template <typename NA>
+   static void release(NA &, long) { }
+
+   Node * root;                  // root node of the B-tree
+   size_t numElements;           // number of elements currently in the tree
+   LeafAlloc     leafAlloc;      // where the leaves come from
+   InternalAlloc internalAlloc;  // where the internal nodes come from
+};
+
+/*****************************************************************
+ * B-TREE NODE
+ * A leaf: a sorted run of values in raw storage, and where it
+ * hangs from its parent
+ *****************************************************************/
+template <typename T, typename A>
+struct BTree <T, A> :: Node
+{
+   Node(bool isLeaf = true) : pParent(nullptr), iParent(0), num(0), isLeaf(isLeaf) {}
+
+         T * values()       { return reinterpret_cast<      T *>(storage); }
+   const T * values() const { return reinterpret_cast<const T *>(storage); }
+
+   Internal * pParent;           // nullptr for the root
+   unsigned short iParent;       // we are pParent->children[iParent]
+   unsigned short num;           // how many values are in use
+   bool isLeaf;
+   alignas(T) unsigned char storage[MAX * sizeof(T)];
+};
+
+/*****************************************************************
+ * B-TREE INTERNAL NODE
+ * A node with children: children[i] holds what sorts before
+ * values()[i], children[num] what sorts after the last
+ *****************************************************************/
+template <typename T, typename A>
+struct BTree <T, A> :: Internal : public Node
+{
+   Internal() : Node(false) {}
+
+   Node * children[MAX + 1];
+};
+
+/**********************************************************
+ * B-TREE ITERATOR
+ * A node and a position within it
+ *********************************************************/
+template <typename T, typename A>
+class BTree <T, A> :: iterator
+{
+   friend class ::TestBTree; // give unit tests access to the privates
+   friend class BTree <T, A>;
+public:
+   // constructors and assignment
+   iterator() : pNode(nullptr), index(0) {}
+   iterator(Node * pNode, int index) : pNode(pNode), index(index) {}
+
+   // compare
+   bool operator == (const iterator & rhs) const
+   {
+      return pNode == rhs.pNode && index == rhs.index;
+   }
+   bool operator != (const iterator & rhs) const
+   {
+      return !(*this == rhs);
+   }
+
+   // de-reference. Cannot change because it will invalidate the BTree
+   const T & operator * () const
+   {
+      return pNode->values()[index];
+   }
+
+   // increment and decrement
+   iterator & operator ++ ();
+   iterator   operator ++ (int postfix)
+   {
+      iterator itReturn = *this;
+      ++(*this);
+      return itReturn;
+   }
+   iterator & operator -- ();
+   iterator   operator -- (int postfix)
+   {
+      iterator itReturn = *this;
+      --(*this);
+      return itReturn;
+   }
+
+private:
+
+   Node * pNode;     // nullptr at the end
+   int index;
+};
+
+
+/*********************************************
+ *********************************************
+ *********************************************
+ ******************* BTREE *******************
+ *********************************************
+ *********************************************
+ *********************************************/
+
+/*********************************************
+ * BTREE :: DEFAULT CONSTRUCTOR
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> ::BTree(const A & a) :
+   root(nullptr), numElements(0), leafAlloc(a), internalAlloc(a)
+{
+}
+
+/*********************************************
+ * BTREE :: COPY CONSTRUCTOR
+ * Copy one tree to another, node for node
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> ::BTree(const BTree & rhs) :
+   root(nullptr), numElements(0),
+   leafAlloc(std::allocator_traits<LeafAlloc>::select_on_container_copy_construction(rhs.leafAlloc)),
+   internalAlloc(std::allocator_traits<InternalAlloc>::select_on_container_copy_construction(rhs.internalAlloc))
+{
+   root = copyTree(rhs.root);
+   numElements = rhs.numElements;
+}
+
+/*********************************************
+ * BTREE :: MOVE CONSTRUCTOR
+ * Steal the nodes and the allocators they came from
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> ::BTree(BTree && rhs) :
+   root(rhs.root), numElements(rhs.numElements),
+   leafAlloc(rhs.leafAlloc), internalAlloc(rhs.internalAlloc)
+{
+   rhs.root = nullptr;
+   rhs.numElements = 0;
+}
+
+/*********************************************
+ * BTREE :: INITIALIZER LIST CONSTRUCTOR
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> ::BTree(const std::initializer_list<T>& il, const A & a) : BTree(a)
+{
+   *this = il;
+}
+
+/*********************************************
+ * BTREE :: ASSIGNMENT OPERATOR
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> & BTree <T, A> :: operator = (const BTree & rhs)
+{
+   if (this != &rhs)
+   {
+      clear();
+      root = copyTree(rhs.root);
+      numElements = rhs.numElements;
+   }
+   return *this;
+}
+
+/*********************************************
+ * BTREE :: ASSIGN-MOVE OPERATOR
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> & BTree <T, A> :: operator = (BTree && rhs)
+{
+   clear();
+   swap(rhs);
+   return *this;
+}
+
+/*********************************************
+ * BTREE :: ASSIGNMENT OPERATOR with INITIALIZATION LIST
+ ********************************************/
+template <typename T, typename A>
+BTree <T, A> & BTree <T, A> :: operator = (const std::initializer_list<T>& il)
+{
+   clear();
+   for (auto && t : il)
+      insert(t, true);
+   return *this;
+}
+
+/*********************************************
+ * BTREE :: SWAP
+ * The nodes go with the allocators they came from
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::swap(BTree & rhs)
+{
+   std::swap(root, rhs.root);
+   std::swap(numElements, rhs.numElements);
+   std::swap(leafAlloc, rhs.leafAlloc);
+   std::swap(internalAlloc, rhs.internalAlloc);
+}
+
+/*********************************************
+ * BTREE :: BEGIN
+ * The first value of the left-most leaf
+ ********************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::iterator BTree <T, A> ::begin() const noexcept
+{
+   if (root == nullptr || numElements == 0)
+      return end();
+
+   Node * pNode = root;
+   while (!pNode->isLeaf)
+      pNode = static_cast<Internal *>(pNode)->children[0];
+   return iterator(pNode, 0);
+}
+
+/*********************************************
+ * BTREE :: FIND
+ * A binary search in each node on the way down
+ ********************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::iterator BTree <T, A> ::find(const T & t)
+{
+   Node * pNode = root;
+   while (pNode)
+   {
+      int i = lowerBound(pNode, t);
+      if (i < pNode->num && !(t < pNode->values()[i]))
+         return iterator(pNode, i);
+      if (pNode->isLeaf)
+         break;
+      pNode = static_cast<Internal *>(pNode)->children[i];
+   }
+   return end();
+}
+
+/*********************************************
+ * BTREE :: BOUND
+ * The first value not less than t (or greater
+ * than t, for the upper bound). Each node down
+ * can only offer a smaller one than the last
+ ********************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::iterator BTree <T, A> ::bound(const T & t, bool isUpper) const
+{
+   iterator itBound = end();
+   Node * pNode = root;
+   while (pNode)
+   {
+      int i = isUpper ? upperBound(pNode, t) : lowerBound(pNode, t);
+      if (i < pNode->num)
+         itBound = iterator(pNode, i);
+      if (pNode->isLeaf)
+         break;
+      pNode = static_cast<Internal *>(pNode)->children[i];
+   }
+   return itBound;
+}
+
+/*********************************************
+ * BTREE :: INSERT
+ * Go down to the leaf, splitting every full node
+ * on the way so there is always room for one more
+ * in the parent. Duplicates go after their equals
+ * unless keepUnique is set
+ ********************************************/
+template <typename T, typename A>
+template <typename U>
+std::pair<typename BTree <T, A> ::iterator, bool> BTree <T, A> ::insertValue(U && t, bool keepUnique)
+{
+   if (root == nullptr)
+      root = newLeaf();
+
+   // a full root splits and the tree gets one level taller
+   if (root->num == MAX)
+   {
+      Internal * pRoot = newInternal();
+      setChild(pRoot, 0, root);
+      root = pRoot;
+      splitChild(pRoot, 0);
+   }
+
+   Node * pNode = root;
+   while (true)
+   {
+      int i = keepUnique ? lowerBound(pNode, t) : upperBound(pNode, t);
+      if (keepUnique && i < pNode->num && !(t < pNode->values()[i]))
+         return std::pair<iterator, bool>(iterator(pNode, i), false);
+
+      if (pNode->isLeaf)
+      {
+         placeValue(pNode, i, std::forward<U>(t));
+         numElements++;
+         return std::pair<iterator, bool>(iterator(pNode, i), true);
+      }
+
+      Internal * pInternal = static_cast<Internal *>(pNode);
+      if (pInternal->children[i]->num == MAX)
+      {
+         // the middle of the child comes up to i: which half do we want?
+         splitChild(pInternal, i);
+         const T & middle = pInternal->values()[i];
+         if (keepUnique && !(t < middle) && !(middle < t))
+            return std::pair<iterator, bool>(iterator(pInternal, i), false);
+         if (keepUnique ? middle < t : !(t < middle))
+            i++;
+      }
+      pNode = pInternal->children[i];
+   }
+}
+
+/*********************************************
+ * BTREE :: ERASE
+ * A value in an internal node trades places with
+ * its successor, the first value of a leaf, so
+ * we only ever take values out of leaves. Then
+ * fix any leaf left with fewer than MIN. Returns
+ * the element after the one erased, followed
+ * through any rebalancing
+ ********************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::iterator BTree <T, A> ::erase(iterator & it)
+{
+   if (it == end())
+      return end();
+
+   Node * pNode = it.pNode;
+   int i = it.index;
+   iterator itNext;
+
+   if (!pNode->isLeaf)
+   {
+      // the successor is the left-most value right of us
+      Node * pLeaf = static_cast<Internal *>(pNode)->children[i + 1];
+      while (!pLeaf->isLeaf)
+         pLeaf = static_cast<Internal *>(pLeaf)->children[0];
+
+      pNode->values()[i] = std::move(pLeaf->values()[0]);
+      itNext = iterator(pNode, i);
+      pNode = pLeaf;
+      i = 0;
+   }
+   else
+   {
+      itNext = it;
+      ++itNext;
+      if (itNext.pNode == pNode)
+         itNext.index--;
+   }
+
+   removeValue(pNode, i);
+   numElements--;
+   rebalance(pNode, itNext);
+   return itNext;
+}
+
+/*********************************************
+ * BTREE :: MERGE
+ * Walk both trees in order, keeping the values
+ * only here, in both (this copy), or only in
+ * rhs, then rebuild from the sorted result
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> :: merge(BTree & rhs, bool keepLeft, bool keepBoth, bool keepRight)
+{
+   std::vector<T> values;
+   values.reserve(numElements + rhs.numElements);
+
+   iterator it = begin();
+   iterator itRHS = rhs.begin();
+   while (it != end() || itRHS != rhs.end())
+   {
+      if (itRHS == rhs.end() || (it != end() && *it < *itRHS))
+      {
+         if (keepLeft)
+            values.push_back(*it);
+         ++it;
+      }
+      else if (it == end() || *itRHS < *it)
+      {
+         if (keepRight)
+            values.push_back(*itRHS);
+         ++itRHS;
+      }
+      else
+      {
+         if (keepBoth)
+            values.push_back(*it);
+         ++it;
+         ++itRHS;
+      }
+   }
+
+   rhs.clear();
+   build(values.begin(), values.end());
+}
+
+/*********************************************
+ * BTREE :: CLEAR
+ * Remove every value. With pools nobody else is
+ * using, that is the destructors (if any) and
+ * then every chunk at once
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::clear() noexcept
+{
+   if (root)
+   {
+      if (canRelease(leafAlloc, 0) && canRelease(internalAlloc, 0))
+      {
+         if (!std::is_trivially_destructible<T>::value)
+            destroyValues(root);
+         release(leafAlloc, 0);
+         release(internalAlloc, 0);
+      }
+      else
+         deleteTree(root);
+      root = nullptr;
+   }
+   numElements = 0;
+}
+
+/*********************************************
+ * BTREE :: NEW LEAF / NEW INTERNAL / FREE NODE
+ * Nodes hold no values when they are made or freed
+ ********************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::Node * BTree <T, A> ::newLeaf()
+{
+   Node * pNode = leafAlloc.allocate(1);
+   std::allocator_traits<LeafAlloc>::construct(leafAlloc, pNode, true);
+   return pNode;
+}
+
+template <typename T, typename A>
+typename BTree <T, A> ::Internal * BTree <T, A> ::newInternal()
+{
+   Internal * pNode = internalAlloc.allocate(1);
+   std::allocator_traits<InternalAlloc>::construct(internalAlloc, pNode);
+   return pNode;
+}
+
+template <typename T, typename A>
+void BTree <T, A> ::freeNode(Node * pNode) noexcept
+{
+   if (pNode->isLeaf)
+   {
+      std::allocator_traits<LeafAlloc>::destroy(leafAlloc, pNode);
+      leafAlloc.deallocate(pNode, 1);
+   }
+   else
+   {
+      Internal * pInternal = static_cast<Internal *>(pNode);
+      std::allocator_traits<InternalAlloc>::destroy(internalAlloc, pInternal);
+      internalAlloc.deallocate(pInternal, 1);
+   }
+}
+
+/*********************************************
+ * BTREE :: COPY TREE
+ * Make a copy of pSrc and everything below it
+ ********************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::Node * BTree <T, A> ::copyTree(const Node * pSrc)
+{
+   if (pSrc == nullptr)
+      return nullptr;
+
+   Node * pDest = pSrc->isLeaf ? newLeaf() : newInternal();
+   for (int i = 0; i < pSrc->num; i++)
+   {
+      new ((void*)(pDest->values() + i)) T(pSrc->values()[i]);
+      pDest->num++;
+   }
+   if (!pSrc->isLeaf)
+      for (int i = 0; i <= pSrc->num; i++)
+         setChild(static_cast<Internal *>(pDest), i,
+                  copyTree(static_cast<const Internal *>(pSrc)->children[i]));
+   return pDest;
+}
+
+/*********************************************
+ * BTREE :: DELETE TREE
+ * Destroy the values of pNode and everything below
+ * it, and give the nodes back
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::deleteTree(Node * pNode) noexcept
+{
+   if (!pNode->isLeaf)
+      for (int i = 0; i <= pNode->num; i++)
+         deleteTree(static_cast<Internal *>(pNode)->children[i]);
+   for (int i = 0; i < pNode->num; i++)
+      pNode->values()[i].~T();
+   freeNode(pNode);
+}
+
+/*********************************************
+ * BTREE :: DESTROY VALUES
+ * Run the destructors but leave the memory for
+ * the allocators to take back in bulk
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::destroyValues(Node * pNode) noexcept
+{
+   if (!pNode->isLeaf)
+      for (int i = 0; i <= pNode->num; i++)
+         destroyValues(static_cast<Internal *>(pNode)->children[i]);
+   for (int i = 0; i < pNode->num; i++)
+      pNode->values()[i].~T();
+}
+
+/*********************************************
+ * BTREE :: LOWER BOUND / UPPER BOUND
+ * The first value not less than t / greater than t.
+ * Halving without an early exit leaves the compiler
+ * a conditional move instead of a branch it will
+ * mispredict half the time
+ ********************************************/
+template <typename T, typename A>
+int BTree <T, A> ::lowerBound(const Node * pNode, const T & t)
+{
+   const T * values = pNode->values();
+   int iBegin = 0;
+   int num = pNode->num;
+   while (num > 0)
+   {
+      int half = num / 2;
+      iBegin = values[iBegin + half] < t ? iBegin + num - half : iBegin;
+      num = half;
+   }
+   return iBegin;
+}
+
+template <typename T, typename A>
+int BTree <T, A> ::upperBound(const Node * pNode, const T & t)
+{
+   const T * values = pNode->values();
+   int iBegin = 0;
+   int num = pNode->num;
+   while (num > 0)
+   {
+      int half = num / 2;
+      iBegin = t < values[iBegin + half] ? iBegin : iBegin + num - half;
+      num = half;
+   }
+   return iBegin;
+}
+
+/*********************************************
+ * BTREE :: PLACE VALUE
+ * Put t at i, moving everything after it over one.
+ * The caller makes sure there is room
+ ********************************************/
+template <typename T, typename A>
+template <typename U>
+void BTree <T, A> ::placeValue(Node * pNode, int i, U && t)
+{
+   assert(pNode->num < MAX);
+   T * values = pNode->values();
+   if (i == pNode->num)
+      new ((void*)(values + i)) T(std::forward<U>(t));
+   else
+   {
+      new ((void*)(values + pNode->num)) T(std::move(values[pNode->num - 1]));
+      for (int j = pNode->num - 1; j > i; j--)
+         values[j] = std::move(values[j - 1]);
+      values[i] = std::forward<U>(t);
+   }
+   pNode->num++;
+}
+
+/*********************************************
+ * BTREE :: REMOVE VALUE
+ * Take out the value at i, closing the gap
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::removeValue(Node * pNode, int i)
+{
+   T * values = pNode->values();
+   for (int j = i; j < pNode->num - 1; j++)
+      values[j] = std::move(values[j + 1]);
+   values[pNode->num - 1].~T();
+   pNode->num--;
+}
+
+/*********************************************
+ * BTREE :: SET CHILD
+ * Hang pChild at i, and let it know where it is
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::setChild(Internal * pParent, int i, Node * pChild)
+{
+   pParent->children[i] = pChild;
+   pChild->pParent = pParent;
+   pChild->iParent = (unsigned short)i;
+}
+
+/*********************************************
+ * BTREE :: SPLIT CHILD
+ * The full child at i keeps its first MIN values,
+ * gives the last MIN to a new sibling at i + 1, and
+ * sends the one in the middle up to pParent
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::splitChild(Internal * pParent, int i)
+{
+   Node * pLeft = pParent->children[i];
+   assert(pLeft->num == MAX);
+   Node * pRight = pLeft->isLeaf ? newLeaf() : newInternal();
+
+   T * values = pLeft->values();
+   for (int j = MIN + 1; j < MAX; j++)
+   {
+      new ((void*)(pRight->values() + j - MIN - 1)) T(std::move(values[j]));
+      values[j].~T();
+   }
+   pRight->num = MAX - MIN - 1;
+   if (!pLeft->isLeaf)
+      for (int j = MIN + 1; j <= MAX; j++)
+         setChild(static_cast<Internal *>(pRight), j - MIN - 1,
+                  static_cast<Internal *>(pLeft)->children[j]);
+
+   // the middle goes up, and the new sibling hangs right of it
+   placeValue(pParent, i, std::move(values[MIN]));
+   values[MIN].~T();
+   pLeft->num = MIN;
+   for (int j = pParent->num; j > i + 1; j--)
+      setChild(pParent, j, pParent->children[j - 1]);
+   setChild(pParent, i + 1, pRight);
+}
+
+/*********************************************
+ * BTREE :: REBALANCE
+ * pNode just lost a value. While it is short,
+ * borrow from a sibling with some to spare, else
+ * merge with one and let the parent be short
+ * instead. itTrack follows its value around
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::rebalance(Node * pNode, iterator & itTrack)
+{
+   while (pNode != root && pNode->num < MIN)
+   {
+      Internal * pParent = pNode->pParent;
+      int i = pNode->iParent;
+      Node * pLeft  = i > 0            ? pParent->children[i - 1] : nullptr;
+      Node * pRight = i < pParent->num ? pParent->children[i + 1] : nullptr;
+
+      if (pLeft && pLeft->num > MIN)
+      {
+         borrowLeft(pParent, i, itTrack);
+         return;
+      }
+      if (pRight && pRight->num > MIN)
+      {
+         borrowRight(pParent, i, itTrack);
+         return;
+      }
+      merge(pParent, pLeft ? i - 1 : i, itTrack);
+      pNode = pParent;
+   }
+
+   // an empty root goes away and its only child, if any, takes its place
+   if (root && root->num == 0)
+   {
+      Node * pOld = root;
+      if (root->isLeaf)
+         root = nullptr;
+      else
+      {
+         root = static_cast<Internal *>(root)->children[0];
+         root->pParent = nullptr;
+         root->iParent = 0;
+      }
+      freeNode(pOld);
+   }
+}
+
+/*********************************************
+ * BTREE :: BORROW LEFT
+ * The child at i takes the parent's value left of
+ * it, and the parent takes the left sibling's last
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::borrowLeft(Internal * pParent, int i, iterator & itTrack)
+{
+   Node * pNode = pParent->children[i];
+   Node * pLeft = pParent->children[i - 1];
+   int numLeft = pLeft->num;
+
+   if (itTrack.pNode == pNode)
+      itTrack.index++;
+   else if (itTrack.pNode == pParent && itTrack.index == i - 1)
+      itTrack = iterator(pNode, 0);
+   else if (itTrack.pNode == pLeft && itTrack.index == numLeft - 1)
+      itTrack = iterator(pParent, i - 1);
+
+   placeValue(pNode, 0, std::move(pParent->values()[i - 1]));
+   pParent->values()[i - 1] = std::move(pLeft->values()[numLeft - 1]);
+   pLeft->values()[numLeft - 1].~T();
+   pLeft->num--;
+
+   if (!pNode->isLeaf)
+   {
+      Internal * pInternal = static_cast<Internal *>(pNode);
+      for (int j = pNode->num; j > 0; j--)
+         setChild(pInternal, j, pInternal->children[j - 1]);
+      setChild(pInternal, 0, static_cast<Internal *>(pLeft)->children[numLeft]);
+   }
+}
+
+/*********************************************
+ * BTREE :: BORROW RIGHT
+ * The child at i takes the parent's value right of
+ * it, and the parent takes the right sibling's first
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::borrowRight(Internal * pParent, int i, iterator & itTrack)
+{
+   Node * pNode  = pParent->children[i];
+   Node * pRight = pParent->children[i + 1];
+   int numNode = pNode->num;
+
+   if (itTrack.pNode == pParent && itTrack.index == i)
+      itTrack = iterator(pNode, numNode);
+   else if (itTrack.pNode == pRight)
+      itTrack = itTrack.index == 0 ? iterator(pParent, i) : iterator(pRight, itTrack.index - 1);
+
+   placeValue(pNode, numNode, std::move(pParent->values()[i]));
+   pParent->values()[i] = std::move(pRight->values()[0]);
+   removeValue(pRight, 0);
+
+   if (!pNode->isLeaf)
+   {
+      Internal * pInternal = static_cast<Internal *>(pRight);
+      setChild(static_cast<Internal *>(pNode), numNode + 1, pInternal->children[0]);
+      for (int j = 0; j <= pRight->num; j++)
+         setChild(pInternal, j, pInternal->children[j + 1]);
+   }
+}
+
+/*********************************************
+ * BTREE :: MERGE
+ * The children at i and i + 1 and the parent's
+ * value between them become one node
+ ********************************************/
+template <typename T, typename A>
+void BTree <T, A> ::merge(Internal * pParent, int i, iterator & itTrack)
+{
+   Node * pLeft  = pParent->children[i];
+   Node * pRight = pParent->children[i + 1];
+   int numLeft = pLeft->num;
+   assert(numLeft + 1 + pRight->num <= MAX);
+
+   if (itTrack.pNode == pParent && itTrack.index == i)
+      itTrack = iterator(pLeft, numLeft);
+   else if (itTrack.pNode == pParent && itTrack.index > i)
+      itTrack.index--;
+   else if (itTrack.pNode == pRight)
+      itTrack = iterator(pLeft, numLeft + 1 + itTrack.index);
+
+   placeValue(pLeft, numLeft, std::move(pParent->values()[i]));
+   for (int j = 0; j < pRight->num; j++)
+   {
+      new ((void*)(pLeft->values() + numLeft + 1 + j)) T(std::move(pRight->values()[j]));
+      pRight->values()[j].~T();
+   }
+   pLeft->num += pRight->num;
+   if (!pLeft->isLeaf)
+      for (int j = 0; j <= pRight->num; j++)
+         setChild(static_cast<Internal *>(pLeft), numLeft + 1 + j,
+                  static_cast<Internal *>(pRight)->children[j]);
+   pRight->num = 0;
+
+   removeValue(pParent, i);
+   for (int j = i + 1; j <= pParent->num; j++)
+      setChild(pParent, j, pParent->children[j + 1]);
+   freeNode(pRight);
+}
+
+/*************************************************
+ *************************************************
+ *************************************************
+ ****************** ITERATOR *********************
+ *************************************************
+ *************************************************
+ *************************************************/
+
+/**************************************************
+ * BTREE ITERATOR :: INCREMENT PREFIX
+ * Down to the left-most leaf right of us, or on
+ * through the leaf, or up to the first ancestor
+ * we are left of
+ *************************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::iterator & BTree <T, A> ::iterator :: operator ++ ()
+{
+   if (pNode == nullptr)
+      return *this;
+
+   if (!pNode->isLeaf)
+   {
+      pNode = static_cast<Internal *>(pNode)->children[index + 1];
+      while (!pNode->isLeaf)
+         pNode = static_cast<Internal *>(pNode)->children[0];
+      index = 0;
+      return *this;
+   }
+
+   if (++index < pNode->num)
+      return *this;
+
+   while (pNode->pParent && pNode->iParent == pNode->pParent->num)
+      pNode = pNode->pParent;
+   if (pNode->pParent == nullptr)
+      *this = iterator();
+   else
+   {
+      index = pNode->iParent;
+      pNode = pNode->pParent;
+   }
+   return *this;
+}
+
+/**************************************************
+ * BTREE ITERATOR :: DECREMENT PREFIX
+ * The mirror image of increment
+ *************************************************/
+template <typename T, typename A>
+typename BTree <T, A> ::iterator & BTree <T, A> ::iterator :: operator -- ()
+{
+   if (pNode == nullptr)
+      return *this;
+
+   if (!pNode->isLeaf)
+   {
+      pNode = static_cast<Internal *>(pNode)->children[index];
+      while (!pNode->isLeaf)
+         pNode = static_cast<Internal *>(pNode)->children[pNode->num];
+      index = pNode->num - 1;
+      return *this;
+   }
+
+   if (index-- > 0)
+      return *this;
+
+   while (pNode->pParent && pNode->iParent == 0)
+      pNode = pNode->pParent;
+   if (pNode->pParent == nullptr)
+      *this = iterator();
+   else
+   {
+      index = pNode->iParent - 1;
+      pNode = pNode->pParent;
+   }
+   return *this;
+}
+
+} // namespace custom
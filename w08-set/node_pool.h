@@ -0,0 +1,212 @@
+/***********************************************************************
+ * Header:
+ *    NODE POOL
+ * Summary:
+ *    An allocator for node-based containers: nodes are carved out of
+ *    big chunks, recycled through a free list, and the whole pool can
+ *    be handed back at once
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        node_pool              : Use as the A of BST<T, A>, set<T, A>, map<K, V, A>
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>      // for size_t and max_align_t
+#include <memory>       // for std::shared_ptr
+#include <new>          // for operator new
+#include <utility>      // for std::forward
+
+class TestNodePool; // forward declaration for unit tests
+
+namespace custom
+{
+
+// how big each chunk of nodes is
+static const size_t NODE_POOL_CHUNK_BYTES = (size_t)64 << 10;
+
+/*****************************************
+ * NODE POOL
+ * Hands out one T at a time from 64KB chunks.
+ * A freed node goes on a free list and is the
+ * next one handed out. Nothing goes back to the
+ * system until release() or the last copy of
+ * the allocator is gone, and then it is one
+ * delete per chunk, not per node.
+ *
+ * Copies share the pool. Rebinding to another
+ * type (as a container does to get its node
+ * type) starts a new one, as does copying a
+ * container (select_on_container_copy_construction).
+ ****************************************/
+template <typename T>
+class node_pool
+{
+   friend class ::TestNodePool; // give unit tests access to the privates
+
+   template <typename U>
+   friend class node_pool;
+
+   static_assert(alignof(T) <= alignof(std::max_align_t),
+                 "node_pool does not do over-aligned types");
+
+public:
+   typedef T value_type;
+   template <typename U>
+   struct rebind { typedef node_pool<U> other; };
+
+   node_pool() : pArena(std::make_shared<Arena>()) {}
+   node_pool(const node_pool & rhs) = default;
+   template <typename U>
+   node_pool(const node_pool<U> &) : node_pool() {}
+
+   node_pool select_on_container_copy_construction() const { return node_pool(); }
+
+   T * allocate(size_t num);
+   void deallocate(T * p, size_t num);
+
+   template <typename U, typename ... Args>
+   void construct(U * p, Args && ... args)
+   {
+      new ((void*)p) U(std::forward<Args>(args)...);
+   }
+   template <typename U>
+   void destroy(U * p)
+   {
+      p->~U();
+   }
+
+   // give every chunk back. Only safe when nothing lives in them
+   void release() { pArena->release(); }
+
+   // is this the only allocator using the pool?
+   bool unique() const { return pArena.use_count() == 1; }
+
+   size_t numChunks() const { return pArena->numChunks; }
+
+   bool operator == (const node_pool & rhs) const { return pArena == rhs.pArena; }
+   bool operator != (const node_pool & rhs) const { return pArena != rhs.pArena; }
+
+private:
+
+   // a slot holds a T or, once freed, the next free slot
+   union Slot
+   {
+      Slot * pNext;
+      alignas(T) unsigned char data[sizeof(T)];
+   };
+
+   // a chunk is a link to the next chunk then as many slots as fit
+   struct Chunk
+   {
+      Chunk * pNext;
+   };
+   static size_t headerBytes()
+   {
+      return (sizeof(Chunk) + alignof(std::max_align_t) - 1) /
+             alignof(std::max_align_t) * alignof(std::max_align_t);
+   }
+   static size_t slotsPerChunk()
+   {
+      size_t num = (NODE_POOL_CHUNK_BYTES - headerBytes()) / sizeof(Slot);
+      return num > 0 ? num : 1;
+   }
+
+   struct Arena
+   {
+      Arena() : pChunks(nullptr), pFree(nullptr), pBump(nullptr), pBumpEnd(nullptr), numChunks(0) {}
+     ~Arena() { release(); }
+      void release();
+
+      Chunk * pChunks;        // every chunk we have
+      Slot  * pFree;          // slots given back to us
+      Slot  * pBump;          // next never-used slot in the newest chunk
+      Slot  * pBumpEnd;       // one past the last slot in the newest chunk
+      size_t  numChunks;
+   };
+
+   std::shared_ptr<Arena> pArena;
+};
+
+/*****************************************
+ * NODE POOL :: ALLOCATE
+ * A recycled slot if there is one, else the
+ * next fresh one, else a new chunk. Anything
+ * but a single T goes straight to operator new
+ ****************************************/
+template <typename T>
+T * node_pool <T> ::allocate(size_t num)
+{
+   if (num != 1)
+      return static_cast<T *>(::operator new(num * sizeof(T)));
+
+   Arena & arena = *pArena;
+   if (arena.pFree)
+   {
+      Slot * p = arena.pFree;
+      arena.pFree = p->pNext;
+      return reinterpret_cast<T *>(p);
+   }
+
+   if (arena.pBump == arena.pBumpEnd)
+   {
+      size_t numSlots = slotsPerChunk();
+      char * pBytes = static_cast<char *>(::operator new(headerBytes() + numSlots * sizeof(Slot)));
+      Chunk * pChunk = reinterpret_cast<Chunk *>(pBytes);
+      pChunk->pNext = arena.pChunks;
+      arena.pChunks = pChunk;
+      arena.numChunks++;
+      arena.pBump = reinterpret_cast<Slot *>(pBytes + headerBytes());
+      arena.pBumpEnd = arena.pBump + numSlots;
+   }
+   return reinterpret_cast<T *>(arena.pBump++);
+}
+
+/*****************************************
+ * NODE POOL :: DEALLOCATE
+ * Put a slot on the free list
+ ****************************************/
+template <typename T>
+void node_pool <T> ::deallocate(T * p, size_t num)
+{
+   if (p == nullptr)
+      return;
+   if (num != 1)
+   {
+      ::operator delete((void*)p);
+      return;
+   }
+
+   Slot * pSlot = reinterpret_cast<Slot *>(p);
+   pSlot->pNext = pArena->pFree;
+   pArena->pFree = pSlot;
+}
+
+/*****************************************
+ * NODE POOL :: ARENA :: RELEASE
+ * Free every chunk. O(chunks), whatever the
+ * number of nodes that were in them
+ ****************************************/
+template <typename T>
+void node_pool <T> ::Arena::release()
+{
+   while (pChunks)
+   {
+      Chunk * pNext = pChunks->pNext;
+      ::operator delete((void*)pChunks);
+      pChunks = pNext;
+   }
+   pFree = pBump = pBumpEnd = nullptr;
+   numChunks = 0;
+}
+
+} // namespace custom
@@ -21,6 +21,7 @@
 #include <cassert>
 #include <iostream>
 #include "bst.h"
+#include "btree.h"
 #include <memory>     // for std::allocator
 #include <functional> // for std::less
 
@@ -33,9 +34,12 @@ namespace custom
 
 /************************************************
  * SET
- * A class that represents a Set
+ * A class that represents a Set. A gives the
+ * allocator for the tree's nodes, and Tree the
+ * engine: the red-black BST or the BTree
  ***********************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>,
+          template <typename, typename> class Tree = BST>
 class set
 {
    friend class ::TestSet; // give unit tests access to the privates
@@ -44,7 +48,7 @@ public:
    // 
    // Construct
    //
-   set() : bst()
+   set(const A & a = A()) : bst(a)
    {
    }
    set(const set &  rhs) : bst(rhs.bst)
@@ -53,16 +57,13 @@ public:
    set(set && rhs) : bst(std::move(rhs.bst))
    {
    }
-   set(const std::initializer_list <T> & il) : bst(il)
+   set(const std::initializer_list <T> & il, const A & a = A()) : bst(il, a)
    {
    }
    template <class Iterator>
-   set(Iterator first, Iterator last)
+   set(Iterator first, Iterator last, const A & a = A()) : bst(a)
    {
-      for (auto it = first; it != last; it++)
-      {
-         bst.insert(*it, true);
-      }
+      bst.build(first, last, true);
    }
   ~set() { this->bst.clear(); }
 
@@ -112,6 +113,31 @@ public:
       iterator itR = bst.find(t);
       return itR;
    }
+   iterator nth(size_t k) const
+   {
+      return iterator(bst.nth(k));
+   }
+   size_t rank(const T & t) const
+   {
+      return bst.rank(t);
+   }
+   iterator lower_bound(const T & t) const
+   {
+      return iterator(bst.lower_bound(t));
+   }
+   iterator upper_bound(const T & t) const
+   {
+      return iterator(bst.upper_bound(t));
+   }
+   std::pair<iterator, iterator> equal_range(const T & t) const
+   {
+      return std::make_pair(lower_bound(t), upper_bound(t));
+   }
+   template <class Function>
+   void for_each_in_range(const T & lo, const T & hi, Function fn) const
+   {
+      bst.for_each_in_range(lo, hi, fn);
+   }
 
    //
    // Status
@@ -138,6 +164,25 @@ public:
       std::pair<iterator, bool> p = bst.insert(std::move(t), true);
       return p;
    }
+   iterator insert(iterator itHint, const T& t)
+   {
+      return iterator(bst.insert(itHint.it, t, true));
+   }
+   iterator insert(iterator itHint, T&& t)
+   {
+      return iterator(bst.insert(itHint.it, std::move(t), true));
+   }
+   template <typename ... Args>
+   std::pair<iterator, bool> emplace(Args && ... args)
+   {
+      std::pair<iterator, bool> p = bst.emplace_unique(std::forward<Args>(args)...);
+      return p;
+   }
+   template <typename ... Args>
+   iterator emplace_hint(iterator itHint, Args && ... args)
+   {
+      return insert(itHint, T(std::forward<Args>(args)...));
+   }
    void insert(const std::initializer_list <T>& il)
    {
       for (auto &&element : il)
@@ -158,6 +203,11 @@ public:
    {
       bst.clear();
    }
+   // empty now, free the nodes on another thread
+   std::future<void> clearDeferred()
+   {
+      return bst.clearDeferred();
+   }
    iterator erase(iterator &it)
    { 
       return iterator(bst.erase(it.it));
@@ -179,9 +229,44 @@ public:
       return itEnd;
    }
 
+   //
+   // Set algebra. The rvalue forms hand rhs's nodes over and
+   // leave it empty; the const forms work on a copy
+   //
+   set & unionWith(set && rhs, unsigned numThreads = 0)
+   {
+      bst.unionWith(rhs.bst, numThreads);
+      return *this;
+   }
+   set & unionWith(const set & rhs, unsigned numThreads = 0)
+   {
+      set copy(rhs);
+      return unionWith(std::move(copy), numThreads);
+   }
+   set & intersectionWith(set && rhs, unsigned numThreads = 0)
+   {
+      bst.intersectionWith(rhs.bst, numThreads);
+      return *this;
+   }
+   set & intersectionWith(const set & rhs, unsigned numThreads = 0)
+   {
+      set copy(rhs);
+      return intersectionWith(std::move(copy), numThreads);
+   }
+   set & differenceWith(set && rhs, unsigned numThreads = 0)
+   {
+      bst.differenceWith(rhs.bst, numThreads);
+      return *this;
+   }
+   set & differenceWith(const set & rhs, unsigned numThreads = 0)
+   {
+      set copy(rhs);
+      return differenceWith(std::move(copy), numThreads);
+   }
+
 private:
    
-   custom::BST <T> bst;
+   Tree <T, A> bst;
 };
 
 
@@ -189,17 +274,17 @@ private:
  * SET ITERATOR
  * An iterator through Set
  *************************************************/
-template <typename T>
-class set <T> :: iterator
+template <typename T, typename A, template <typename, typename> class Tree>
+class set <T, A, Tree> :: iterator
 {
    friend class ::TestSet; // give unit tests access to the privates
-   friend class custom::set<T>;
+   friend class custom::set<T, A, Tree>;
 public:
    // constructors, destructors, and assignment operator
    iterator() : it()
    {
    }
-   iterator(const typename custom::BST<T>::iterator& itRHS) : it()
+   iterator(const typename Tree<T, A>::iterator& itRHS) : it()
    {
       this->it = itRHS;
    }
@@ -259,7 +344,7 @@ public:
    
 private:
 
-   typename custom::BST<T>::iterator it;
+   typename Tree<T, A>::iterator it;
 };
 
 
@@ -0,0 +1,233 @@
+/***********************************************************************
+ * Header:
+ *    TEST NODE POOL
+ * Summary:
+ *    Unit tests for the node pool, alone and under a BST
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "node_pool.h"
+#include "bst.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+
+class TestNodePool : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_firstChunk();
+      test_allocate_reuse();
+      test_allocate_newChunk();
+      test_allocate_array();
+
+      // Share
+      test_copy_shares();
+      test_rebind_fresh();
+      test_release_chunks();
+
+      // Under a BST
+      test_bst_insertErase();
+      test_bst_clearDestroys();
+      test_bst_copyOwnPool();
+      test_bst_swapPools();
+
+      report("NodePool");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // nothing is taken from the system until the first node
+   void test_allocate_firstChunk()
+   {  // setup
+      custom::node_pool<double> pool;
+      assertUnit(pool.numChunks() == 0);
+      // exercise
+      double * p = pool.allocate(1);
+      // verify
+      assertUnit(p != nullptr);
+      assertUnit(pool.numChunks() == 1);
+      pool.deallocate(p, 1);
+   }  // teardown
+
+   // a freed node is the next one handed out
+   void test_allocate_reuse()
+   {  // setup
+      custom::node_pool<double> pool;
+      double * p1 = pool.allocate(1);
+      double * p2 = pool.allocate(1);
+      // exercise
+      pool.deallocate(p1, 1);
+      double * p3 = pool.allocate(1);
+      // verify
+      assertUnit(p3 == p1);
+      assertUnit(p2 != p1);
+      assertUnit(pool.numChunks() == 1);
+   }  // teardown
+
+   // the slot after the last in a chunk starts another
+   void test_allocate_newChunk()
+   {  // setup
+      custom::node_pool<double> pool;
+      size_t numSlots = custom::node_pool<double>::slotsPerChunk();
+      for (size_t i = 0; i < numSlots; i++)
+         pool.allocate(1);
+      assertUnit(pool.numChunks() == 1);
+      // exercise
+      pool.allocate(1);
+      // verify
+      assertUnit(pool.numChunks() == 2);
+   }  // teardown
+
+   // more than one at a time bypasses the chunks
+   void test_allocate_array()
+   {  // setup
+      custom::node_pool<double> pool;
+      // exercise
+      double * p = pool.allocate(3);
+      p[2] = 2.5;
+      // verify
+      assertUnit(pool.numChunks() == 0);
+      assertUnit(p[2] == 2.5);
+      pool.deallocate(p, 3);
+   }  // teardown
+
+   /***************************************
+    * SHARE
+    ***************************************/
+
+   // a copy hands out from the same pool
+   void test_copy_shares()
+   {  // setup
+      custom::node_pool<double> pool;
+      // exercise
+      custom::node_pool<double> poolCopy(pool);
+      double * p = poolCopy.allocate(1);
+      // verify
+      assertUnit(pool == poolCopy);
+      assertUnit(!pool.unique());
+      assertUnit(pool.numChunks() == 1);
+      pool.deallocate(p, 1);
+   }  // teardown
+
+   // another type, or a copied container, gets its own
+   void test_rebind_fresh()
+   {  // setup
+      custom::node_pool<double> pool;
+      pool.allocate(1);
+      // exercise
+      custom::node_pool<int> poolInt(pool);
+      custom::node_pool<double> poolSelect = pool.select_on_container_copy_construction();
+      // verify
+      assertUnit(poolInt.unique());
+      assertUnit(poolInt.numChunks() == 0);
+      assertUnit(poolSelect != pool);
+      assertUnit(pool.unique());
+   }  // teardown
+
+   // release gives every chunk back at once
+   void test_release_chunks()
+   {  // setup
+      custom::node_pool<double> pool;
+      size_t numSlots = custom::node_pool<double>::slotsPerChunk();
+      for (size_t i = 0; i < numSlots * 3; i++)
+         pool.allocate(1);
+      assertUnit(pool.numChunks() == 3);
+      // exercise
+      pool.release();
+      // verify
+      assertUnit(pool.numChunks() == 0);
+      assertUnit(pool.allocate(1) != nullptr);
+      assertUnit(pool.numChunks() == 1);
+   }  // teardown
+
+   /***************************************
+    * BST
+    ***************************************/
+
+   // erase gives the node back to the pool and insert takes it again
+   void test_bst_insertErase()
+   {  // setup
+      custom::BST<int, custom::node_pool<int>> bst;
+      bst.insert(50);
+      auto it = bst.insert(30).first;
+      bst.insert(70);
+      const int * pThirty = &*it;
+      // exercise
+      bst.erase(it);
+      auto itNew = bst.insert(40).first;
+      // verify
+      assertUnit(&*itNew == pThirty);
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.alloc.numChunks() == 1);
+      assertUnit(bst.find(40) != bst.end());
+      assertUnit(bst.find(30) == bst.end());
+   }  // teardown
+
+   // clear runs every destructor, then hands the chunks back
+   void test_bst_clearDestroys()
+   {  // setup
+      custom::BST<Spy, custom::node_pool<Spy>> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(Spy(i));
+      Spy::reset();
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 100);
+      assertUnit(Spy::numDelete() == 100);
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.size() == 0);
+      assertUnit(bst.alloc.numChunks() == 0);
+   }  // teardown
+
+   // a copy allocates from a pool of its own
+   void test_bst_copyOwnPool()
+   {  // setup
+      custom::BST<int, custom::node_pool<int>> bstSrc;
+      bstSrc.insert(50);
+      bstSrc.insert(30);
+      bstSrc.insert(70);
+      // exercise
+      custom::BST<int, custom::node_pool<int>> bstDest(bstSrc);
+      // verify
+      assertUnit(bstDest.alloc != bstSrc.alloc);
+      assertUnit(bstDest.size() == 3);
+      assertUnit(bstDest.root != bstSrc.root);
+      assertUnit(bstDest.root->data == 50);
+      assertUnit(bstDest.root->pLeft->data == 30);
+      assertUnit(bstDest.root->pRight->data == 70);
+      bstSrc.clear();
+      assertUnit(bstDest.find(70) != bstDest.end());
+   }  // teardown
+
+   // the nodes go with the pool they came from
+   void test_bst_swapPools()
+   {  // setup
+      custom::BST<int, custom::node_pool<int>> bstLeft;
+      custom::BST<int, custom::node_pool<int>> bstRight;
+      bstLeft.insert(50);
+      custom::node_pool<custom::BST<int, custom::node_pool<int>>::BNode> poolLeft = bstLeft.alloc;
+      // exercise
+      bstLeft.swap(bstRight);
+      // verify
+      assertUnit(bstRight.alloc == poolLeft);
+      assertUnit(bstLeft.alloc != poolLeft);
+      assertUnit(bstRight.size() == 1);
+      assertUnit(bstLeft.size() == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
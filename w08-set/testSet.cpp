@@ -15,6 +15,8 @@
 #include "testSet.h"        // for the set unit tests
 #include "testBST.h"        // for the BST unit tests
 #include "testSpy.h"        // for the spy unit tests
+#include "testNodePool.h"   // for the node pool unit tests
+#include "testBTree.h"      // for the B-tree unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -28,6 +30,8 @@ int main()
    TestSpy().run();
    TestBST().run();
    TestSet().run();
+   TestNodePool().run();
+   TestBTree().run();
 #endif // DEBUG
    
    return 0;
@@ -44,6 +44,7 @@ public:
       test_constructRange_empty(); //
       test_constructRange_one();
       test_constructRange_standard(); //
+      test_constructRange_sorted();
       test_destructor_empty();
       test_destructor_standard();
 
@@ -88,6 +89,13 @@ public:
       test_find_standardBegin();
       test_find_standardLast();
       test_find_standardMissing();
+      test_nthRank_standard();
+
+      // Range
+      test_range_standard();
+
+      // Set algebra
+      test_algebra_standard();
 
       // Insert
       test_insert_empty();
@@ -95,6 +103,8 @@ public:
       test_insert_standardFront();
       test_insert_standardMiddle();
       test_insert_standardDuplicate();
+      test_insertHint_sorted();
+      test_emplace_standardDuplicate();
       test_insertMove_empty();
       test_insertMove_standardEnd();
       test_insertMove_standardFront();
@@ -394,8 +404,8 @@ public:
       // verify
       assertUnit(Spy::numCopy() == 7);     // copy-create [50][30][70][20][40][60][80]
       assertUnit(Spy::numAlloc() == 7);    // allocate    [50][30][70][20][40][60][80]
-      assertUnit(Spy::numLessthan() == 10);// compare 50: 30:[50] 70:[50] 20:[50][30] 40:[50][30] 60:[50][70] 80:[50][70]
-      assertUnit(Spy::numEquals() == 10);  // compare 50: 30:[50] 70:[50] 20:[50][30] 40:[50][30] 60:[50][70] 80:[50][70]
+      assertUnit(Spy::numLessthan() <= 1 + 7 * 3);// out of order at 30:[50], then sort the nodes
+      assertUnit(Spy::numEquals() == 6);   // duplicate? 30:[20] 40:[30] 50:[40] 60:[50] 70:[60] 80:[70]
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
@@ -463,9 +473,39 @@ public:
       // verify
       assertUnit(Spy::numCopy() == 7);      // copy-construct [50,30,70,20,40,60,80]
       assertUnit(Spy::numAlloc() == 7);     // allocate [50,30,70,20,40,60,80]
-      assertUnit(Spy::numLessthan() == 10); // compare 50: 30:[50] 70:[50] 20:[50][30] 40:[50][30] 60:[50][70] 80:[50][70]
-      assertUnit(Spy::numEquals() == 10);   // equal   50: 30:[50] 70:[50] 20:[50][30] 40:[50][30] 60:[50][70] 80:[50][70]
-      assertUnit(Spy::numEquals() == 10);
+      assertUnit(Spy::numLessthan() <= 1 + 7 * 3); // out of order at 30:[50], then sort the nodes
+      assertUnit(Spy::numEquals() == 6);    // duplicate? 30:[20] 40:[30] 50:[40] 60:[50] 70:[60] 80:[70]
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      //                (50b)
+      //          +-------+-------+
+      //        (30b)           (70b)
+      //     +----+----+     +----+----+
+      //   (20r)     (40r) (60r)     (80r)
+      assertStandardFixture(s);
+      // teardown
+      teardownStandardFixture(s);
+   }
+
+   // create a new set using a sorted range, no sort and no rebalancing
+   void test_constructRange_sorted()
+   {  // setup
+      std::initializer_list<Spy> il{ Spy(20), Spy(30), Spy(40), Spy(50), Spy(60), Spy(70), Spy(80) };
+      auto itBegin = il.begin();
+      auto itEnd = il.end();
+      Spy::reset();
+      // exercise
+      custom::set <Spy> s(itBegin, itEnd);
+      // verify
+      assertUnit(Spy::numCopy() == 7);      // copy-construct [20,30,40,50,60,70,80]
+      assertUnit(Spy::numAlloc() == 7);     // allocate [20,30,40,50,60,70,80]
+      assertUnit(Spy::numLessthan() == 6);  // in order? 30:[20] 40:[30] 50:[40] 60:[50] 70:[60] 80:[70]
+      assertUnit(Spy::numEquals() == 6);    // duplicate? 30:[20] 40:[30] 50:[40] 60:[50] 70:[60] 80:[70]
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
@@ -2120,6 +2160,111 @@ public:
       teardownStandardFixture(s);
    }
 
+   // the k-th value and the count below a value, on either engine
+   void test_nthRank_standard()
+   {  // setup
+      custom::set <int> s{ 50, 30, 70, 20, 40, 60, 80 };
+      custom::set <int, std::allocator<int>, custom::BTree> sBTree{ 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      custom::set <int>::iterator it = s.nth(2);
+      auto itBTree = sBTree.nth(2);
+      // verify
+      assertUnit(*it == 40);
+      assertUnit(*itBTree == 40);
+      assertUnit(s.nth(7) == s.end());
+      assertUnit(sBTree.nth(7) == sBTree.end());
+      assertUnit(s.rank(40) == 2);
+      assertUnit(s.rank(45) == 3);
+      assertUnit(sBTree.rank(40) == 2);
+      assertUnit(sBTree.rank(45) == 3);
+   }  // teardown
+
+   /***************************************
+    * RANGE
+    *  set::lower_bound(t)
+    *  set::upper_bound(t)
+    *  set::equal_range(t)
+    *  set::for_each_in_range(lo, hi, fn)
+    ***************************************/
+
+   // each engine gives the same bounds and the same window
+   void test_range_standard()
+   {  // setup
+      custom::set <int> s{ 50, 30, 70, 20, 40, 60, 80 };
+      custom::set <int, std::allocator<int>, custom::BTree> sBTree{ 50, 30, 70, 20, 40, 60, 80 };
+      std::vector<int> values;
+      std::vector<int> valuesBTree;
+      // exercise
+      auto range = s.equal_range(40);
+      auto rangeBTree = sBTree.equal_range(45);
+      s.for_each_in_range(25, 60, [&values](const int & value) { values.push_back(value); });
+      sBTree.for_each_in_range(25, 60, [&valuesBTree](const int & value) { valuesBTree.push_back(value); });
+      // verify
+      assertUnit(*s.lower_bound(45) == 50);
+      assertUnit(*s.upper_bound(50) == 60);
+      assertUnit(s.lower_bound(99) == s.end());
+      assertUnit(*range.first == 40);
+      assertUnit(*range.second == 50);
+      assertUnit(*sBTree.lower_bound(45) == 50);
+      assertUnit(*sBTree.upper_bound(50) == 60);
+      assertUnit(sBTree.upper_bound(80) == sBTree.end());
+      assertUnit(rangeBTree.first == rangeBTree.second);
+      assertUnit(*rangeBTree.first == 50);
+      assertUnit(values == std::vector<int>({ 30, 40, 50 }));
+      assertUnit(valuesBTree == values);
+   }  // teardown
+
+   /***************************************
+    * SET ALGEBRA
+    *  set::unionWith(rhs)
+    *  set::intersectionWith(rhs)
+    *  set::differenceWith(rhs)
+    ***************************************/
+
+   // each engine against the same answers, from a copy and from a move
+   void test_algebra_standard()
+   {  // setup
+      custom::set <int> sEven{ 0, 2, 4, 6, 8, 10, 12 };
+      custom::set <int> sThree{ 0, 3, 6, 9, 12 };
+      custom::set <int, std::allocator<int>, custom::BTree> sEvenBTree{ 0, 2, 4, 6, 8, 10, 12 };
+      custom::set <int, std::allocator<int>, custom::BTree> sThreeBTree{ 0, 3, 6, 9, 12 };
+      std::vector<int> both{ 0, 6, 12 };
+      std::vector<int> either{ 0, 2, 3, 4, 6, 8, 9, 10, 12 };
+      std::vector<int> evenOnly{ 2, 4, 8, 10 };
+      // exercise
+      custom::set <int> sUnion(sEven);
+      sUnion.unionWith(sThree);
+      custom::set <int> sIntersection(sEven);
+      sIntersection.intersectionWith(sThree);
+      custom::set <int> sDifference(sEven);
+      sDifference.differenceWith(custom::set <int>(sThree));
+      auto sUnionBTree(sEvenBTree);
+      sUnionBTree.unionWith(sThreeBTree);
+      auto sIntersectionBTree(sEvenBTree);
+      sIntersectionBTree.intersectionWith(sThreeBTree);
+      auto sDifferenceBTree(sEvenBTree);
+      sDifferenceBTree.differenceWith(std::move(sThreeBTree));
+      // verify
+      assertUnit(toVector(sUnion) == either);
+      assertUnit(toVector(sIntersection) == both);
+      assertUnit(toVector(sDifference) == evenOnly);
+      assertUnit(sThree.size() == 5);
+      assertUnit(toVector(sUnionBTree) == either);
+      assertUnit(toVector(sIntersectionBTree) == both);
+      assertUnit(toVector(sDifferenceBTree) == evenOnly);
+      assertUnit(sThreeBTree.empty());
+   }  // teardown
+
+   // the values of a set, in order
+   template <class Set>
+   static std::vector<int> toVector(const Set & s)
+   {
+      std::vector<int> values;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+
 
    /***************************************
     * INSERT
@@ -2337,6 +2482,58 @@ public:
       teardownStandardFixture(s);
    }
 
+   // sorted input with the last insert as the hint, duplicates and all
+   void test_insertHint_sorted()
+   {  // setup
+      custom::set <int> s;
+      custom::set <int>::iterator it = s.end();
+      // exercise
+      for (int i = 0; i < 200; i++)
+         it = s.insert(it, i / 2);
+      // verify
+      assertUnit(s.size() == 100);
+      assertUnit(*it == 99);
+      int expect = 0;
+      bool inOrder = true;
+      for (it = s.begin(); it != s.end(); ++it)
+         inOrder = inOrder && *it == expect++;
+      assertUnit(inOrder);
+      assertUnit(expect == 100);
+   }  // teardown
+
+   // emplace a value that is already there
+   void test_emplace_standardDuplicate()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::set <Spy> s;
+      setupStandardFixture(s);
+      Spy::reset();
+      // exercise
+      auto pairSet = s.emplace(60);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);  // build [60]
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(Spy::numDestructor() == 1);  // and throw it away
+      assertUnit(Spy::numDelete() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(pairSet.second == false);
+      if (pairSet.first != s.end())
+         assertUnit(*(pairSet.first) == Spy(60));
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      assertStandardFixture(s);
+      // teardown
+      teardownStandardFixture(s);
+   }
+
    /***************************************
     * INSERT MOVE
     *  set::insert(T &&)
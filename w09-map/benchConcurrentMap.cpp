@@ -0,0 +1,209 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    A shared cache: threads look up, insert and erase keys in one
+ *    map, 80% finds, 10% inserts and 10% erases, and now and then
+ *    scan a short range. The map is a concurrent_map, or a custom::map
+ *    or std::map behind a mutex. Reports operations per second for
+ *    1, 2, 4 and 8 threads, and the same again with range scans mixed
+ *    in.
+ *
+ *    Built with NDEBUG: custom::map's erase does not keep the red-black
+ *    colors right, and the asserts in its insert catch that once a
+ *    key is erased and others go in after.
+ *
+ *       benchConcurrentMap               : 100K keys
+ *       benchConcurrentMap 1000000 ...   : any list of key counts
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include "map.h"
+#include "concurrent_map.h"
+
+using namespace std::chrono;
+
+const int NUM_OPS = 200000;      // per thread per run
+const int SCAN_LENGTH = 100;     // keys in a range scan
+const int NUM_THREADS[] = { 1, 2, 4, 8 };
+
+typedef custom::pair<int, int> Pair;
+
+/**********************************************************************
+ * LOCKED MAP
+ * Any map, one mutex around every call
+ ***********************************************************************/
+template <class M>
+struct LockedMap
+{
+   bool find(int key)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return map.find(key) != map.end();
+   }
+   void insert(int key, int value)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      map.insert(Pair(key, value));
+   }
+   void erase(int key)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      map.erase(key);
+   }
+   long scan(int key);
+
+   M map;
+   std::mutex mutex;
+};
+
+template <>
+long LockedMap<custom::map<int, int>>::scan(int key)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   long sum = 0;
+   for (auto it = map.lower_bound(key); it != map.end() && (*it).first < key + SCAN_LENGTH; ++it)
+      sum += (*it).second;
+   return sum;
+}
+
+template <>
+long LockedMap<std::map<int, int>>::scan(int key)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   long sum = 0;
+   for (auto it = map.lower_bound(key); it != map.end() && it->first < key + SCAN_LENGTH; ++it)
+      sum += it->second;
+   return sum;
+}
+
+template <>
+void LockedMap<std::map<int, int>>::insert(int key, int value)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   map.emplace(key, value);
+}
+
+/**********************************************************************
+ * CONCURRENT
+ * The same calls, with no lock
+ ***********************************************************************/
+struct Concurrent
+{
+   bool find(int key)              { return map.contains(key);     }
+   void insert(int key, int value) { map.insert(Pair(key, value)); }
+   void erase(int key)             { map.erase(key);               }
+   long scan(int key)
+   {
+      long sum = 0;
+      map.for_each_in_range(key, key + SCAN_LENGTH, [&sum](const Pair & pair)
+      {
+         sum += pair.second;
+      });
+      return sum;
+   }
+
+   custom::concurrent_map<int, int> map;
+};
+
+/**********************************************************************
+ * TIME THREADS
+ * Half the keys in to start, then every thread does its share of the
+ * mix. One op in scanEvery is a scan, if scanEvery is not zero.
+ * Filling the map is not timed
+ ***********************************************************************/
+template <class M>
+double timeThreads(int num, int numThreads, int scanEvery)
+{
+   M * pMap = new M;
+   for (int i = 0; i < num; i += 2)
+      pMap->insert(i, i);
+
+   std::atomic<long> checksum(0);
+   std::vector<std::thread> threads;
+   auto start = steady_clock::now();
+   for (int t = 0; t < numThreads; t++)
+      threads.emplace_back([pMap, num, scanEvery, t, &checksum]()
+      {
+         uint32_t state = 2463534242u + 977 * t;
+         long sum = 0;
+         for (int i = 0; i < NUM_OPS; i++)
+         {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            int key = (int)(state % (uint32_t)num);
+            int op = (int)((state >> 20) % 10);
+            if (scanEvery && i % scanEvery == 0)
+               sum += pMap->scan(key);
+            else if (op < 8)
+               sum += pMap->find(key) ? 1 : 0;
+            else if (op == 8)
+               pMap->insert(key, i);
+            else
+               pMap->erase(key);
+         }
+         checksum += sum;
+      });
+   for (auto & thread : threads)
+      thread.join();
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   delete pMap;
+   return (double)NUM_OPS * numThreads / seconds / 1e6;
+}
+
+/**********************************************************************
+ * REPORT
+ * One row: a map at each thread count
+ ***********************************************************************/
+template <class M>
+void report(const char * name, int num, int scanEvery)
+{
+   std::cout << std::setw(22) << name;
+   for (int numThreads : NUM_THREADS)
+      std::cout << std::setw(10) << timeThreads<M>(num, numThreads, scanEvery);
+   std::cout << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<int> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::atoi(argv[i]));
+   if (sizes.empty())
+      sizes = { 100000 };
+
+   std::cout << std::fixed << std::setprecision(2);
+   std::cout << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+   for (int num : sizes)
+      for (int scanEvery : { 0, 50 })
+      {
+         std::cout << num << " keys, 80/10/10 find/insert/erase";
+         if (scanEvery)
+            std::cout << ", one op in " << scanEvery << " a " << SCAN_LENGTH << "-key scan";
+         std::cout << std::endl << std::setw(22) << "Mops/s, threads:";
+         for (int numThreads : NUM_THREADS)
+            std::cout << std::setw(10) << numThreads;
+         std::cout << std::endl;
+         report<LockedMap<custom::map<int, int>>>("custom::map + mutex", num, scanEvery);
+         report<LockedMap<std::map<int, int>>>   ("std::map + mutex", num, scanEvery);
+         report<Concurrent>                      ("concurrent_map", num, scanEvery);
+      }
+
+   return 0;
+}
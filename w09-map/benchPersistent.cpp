@@ -0,0 +1,154 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    A config service: every round a writer makes a few updates and
+ *    hands readers a snapshot, and the last few snapshots stay alive
+ *    while readers look things up in them. The snapshot is a deep copy
+ *    of a custom::map or of a std::map, or an O(1) copy of a
+ *    persistent_map. Reports rounds per second, and the bytes the
+ *    nodes of all the live snapshots take, through a counting
+ *    allocator.
+ *
+ *    custom::map cannot change a value in place, so its update is an
+ *    erase and an insert.
+ *
+ *       benchPersistent                  : 100K keys
+ *       benchPersistent 1000000 ...      : any list of key counts
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <random>
+#include <cstdlib>
+#include "map.h"
+#include "persistent_map.h"
+
+using namespace std::chrono;
+
+const int NUM_ROUNDS = 200;
+const int NUM_UPDATES = 10;     // per round
+const int NUM_LOOKUPS = 1000;   // per round
+const int NUM_LIVE = 8;         // snapshots kept alive
+
+size_t numBytes = 0;
+size_t numBytesPeak = 0;
+
+/**********************************************************************
+ * COUNTING ALLOCATOR
+ * std::allocator, keeping a tally of the bytes out
+ ***********************************************************************/
+template <class T>
+struct CountingAllocator
+{
+   using value_type = T;
+   CountingAllocator() {}
+   template <class U>
+   CountingAllocator(const CountingAllocator<U> &) {}
+
+   T * allocate(size_t num)
+   {
+      numBytes += num * sizeof(T);
+      if (numBytes > numBytesPeak)
+         numBytesPeak = numBytes;
+      return std::allocator<T>().allocate(num);
+   }
+   void deallocate(T * p, size_t num)
+   {
+      numBytes -= num * sizeof(T);
+      std::allocator<T>().deallocate(p, num);
+   }
+   template <class U>
+   bool operator == (const CountingAllocator<U> &) const { return true; }
+   template <class U>
+   bool operator != (const CountingAllocator<U> &) const { return false; }
+};
+
+typedef custom::pair<int, int> Pair;
+typedef custom::map<int, int, CountingAllocator<Pair>> Map;
+typedef std::map<int, int, std::less<int>, CountingAllocator<std::pair<const int, int>>> StdMap;
+typedef custom::persistent_map<int, int, CountingAllocator<Pair>> PMap;
+
+void update(Map & m, int key, int value)
+{
+   m.erase(key);
+   m.insert(Pair(key, value));
+}
+void update(StdMap & m, int key, int value)    { m[key] = value;                 }
+void update(PMap & m, int key, int value)      { m.insert_or_assign(key, value); }
+bool lookup(Map & m, int key)                  { return m.find(key) != m.end();  }
+bool lookup(StdMap & m, int key)               { return m.find(key) != m.end();  }
+bool lookup(PMap & m, int key)                 { return m.contains(key);         }
+
+/**********************************************************************
+ * TIME ROUNDS
+ * Updates, a snapshot, and lookups in the live snapshots, round after
+ * round. The first snapshot and filling the map are not timed
+ ***********************************************************************/
+template <class M>
+void timeRounds(const char * name, int num)
+{
+   std::mt19937 random(43);
+   std::uniform_int_distribution<int> pick(0, num - 1);
+   size_t numBytesBefore = numBytes;
+   numBytesPeak = numBytes;
+   size_t numFound = 0;
+   double seconds;
+   size_t numBytesLive;
+   {
+      M * pMap = new M;
+      for (int i = 0; i < num; i++)
+         update(*pMap, i, i);
+      std::vector<M> snapshots(NUM_LIVE, *pMap);
+
+      auto start = steady_clock::now();
+      for (int round = 0; round < NUM_ROUNDS; round++)
+      {
+         for (int i = 0; i < NUM_UPDATES; i++)
+            update(*pMap, pick(random), round);
+         snapshots[round % NUM_LIVE] = *pMap;
+         for (int i = 0; i < NUM_LOOKUPS; i++)
+            numFound += lookup(snapshots[i % NUM_LIVE], pick(random)) ? 1 : 0;
+      }
+      seconds = duration<double>(steady_clock::now() - start).count();
+
+      numBytesLive = numBytes - numBytesBefore;
+      delete pMap;
+   }
+
+   std::cout << std::setw(16) << name
+             << std::setw(14) << (double)NUM_ROUNDS / seconds
+             << std::setw(14) << (double)numBytesLive / 1048576.0
+             << std::setw(14) << (double)(numBytesPeak - numBytesBefore) / 1048576.0
+             << std::setw(10) << numFound << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   std::vector<int> sizes;
+   for (int i = 1; i < argc; i++)
+      sizes.push_back(std::atoi(argv[i]));
+   if (sizes.empty())
+      sizes = { 100000 };
+
+   std::cout << std::fixed << std::setprecision(1);
+   for (int num : sizes)
+   {
+      std::cout << num << " keys, " << NUM_LIVE << " live snapshots" << std::endl;
+      std::cout << std::setw(30) << "rounds/s" << std::setw(14) << "live MB"
+                << std::setw(14) << "peak MB" << std::setw(10) << "found" << std::endl;
+      timeRounds<Map>   ("custom::map", num);
+      timeRounds<StdMap>("std::map", num);
+      timeRounds<PMap>  ("persistent_map", num);
+   }
+
+   return 0;
+}
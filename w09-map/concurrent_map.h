@@ -0,0 +1,604 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT MAP
+ * Summary:
+ *    An ordered map that many threads can search, scan, insert into
+ *    and erase from at once: a skip list whose readers take no locks
+ *    and whose unlinked nodes are freed through epochs
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        concurrent_map            : A concurrent skip list of pairs
+ *        concurrent_map::iterator  : A forward iterator that pins its epoch
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <cassert>
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t
+#include <functional>  // for std::hash
+#include <initializer_list>
+#include <new>         // for placement new
+#include <thread>      // for std::this_thread::yield
+#include <utility>     // for std::forward
+#include "pair.h"      // for pair
+#include "epoch.h"     // for epoch_guard
+
+class TestConcurrentMap; // forward declaration for unit tests
+
+namespace custom
+{
+
+// the tallest tower. With one node in two going up a level, that is
+// plenty for 2^24 keys and still fine well past it
+static const int CONCURRENT_MAP_MAX_LEVEL = 24;
+
+/*****************************************************************
+ * CONCURRENT MAP
+ * The lazy skip list of Herlihy, Lev, Luchangco and Shavit ("A
+ * Simple Optimistic Skiplist Algorithm", SIROCCO 2007).
+ *
+ *    find, contains, lower_bound and iteration take no locks.
+ *    insert locks the nodes it links after, checks nothing moved,
+ *       and links the new node from the bottom up; the node only
+ *       counts once it is linked at every level.
+ *    erase marks the node (that is the moment it is gone), then
+ *       locks the nodes before it and unlinks it at every level.
+ *
+ * A node is only retired once erase has unlinked it everywhere, so
+ * nobody can link it back in afterwards. Readers that still hold it
+ * are pinned to an epoch, and it is freed when they all move on.
+ *
+ * A value is fixed once its pair is in: insert does not replace
+ * one. Iteration is weakly consistent: it sees every pair that was
+ * there for the whole walk, and any mix of the ones that came and
+ * went during it, always in key order.
+ *****************************************************************/
+template <class K, class V>
+class concurrent_map
+{
+   friend class ::TestConcurrentMap;
+
+public:
+   using Pairs = custom::pair<K, V>;
+
+   //
+   // Construct
+   //
+
+   concurrent_map();
+   concurrent_map(const std::initializer_list<Pairs> & il) : concurrent_map()
+   {
+      for (auto && element : il)
+         insert(element);
+   }
+   concurrent_map(const concurrent_map &) = delete;
+   concurrent_map & operator = (const concurrent_map &) = delete;
+   // no other thread may be using the map by now
+   ~concurrent_map();
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const;
+   iterator end()   const { return iterator(); }
+
+   //
+   // Access
+   //
+
+   iterator find(const K & k) const;
+   iterator lower_bound(const K & k) const;
+   bool contains(const K & k) const;
+
+   // call fn on every pair with a key in [kLo, kHi), in order
+   template <class Function>
+   void for_each_in_range(const K & kLo, const K & kHi, Function fn) const;
+
+   //
+   // Insert
+   //
+
+   custom::pair<iterator, bool> insert(const Pairs & rhs);
+
+   //
+   // Remove
+   //
+
+   size_t erase(const K & k);
+
+   //
+   // Status
+   //
+
+   // exact when nothing is changing, close when something is
+   size_t size()  const noexcept { return numElements.load(std::memory_order_relaxed); }
+   bool   empty() const noexcept { return size() == 0; }
+
+private:
+
+   struct Node;
+
+   static Node * createNode(const Pairs & rhs, int height);
+   static void destroyNode(void * p);
+   static int randomHeight();
+   int findPath(const K & k, Node ** preds, Node ** succs) const;
+   Node * firstNotLess(const K & k) const;
+   static void unlockAll(Node ** preds, int levelHighest);
+
+   Node * pHead;                       // a tower of every height, before every key
+   std::atomic<size_t> numElements;
+};
+
+/*****************************************************************
+ * CONCURRENT MAP NODE
+ * The pair, the flags, a spin lock, and a tower of next pointers
+ * laid out right after the node in the same allocation
+ *****************************************************************/
+template <class K, class V>
+struct alignas(alignof(std::atomic<void *>)) concurrent_map <K, V> :: Node
+{
+   template <class ... Args>
+   Node(int height, Args && ... args) :
+      data(std::forward<Args>(args)...), height(height),
+      isMarked(false), isLinked(false), isLocked(false)
+   {
+      for (int i = 0; i < height; i++)
+         new (next() + i) std::atomic<Node *>(nullptr);
+   }
+
+   std::atomic<Node *> * next() { return reinterpret_cast<std::atomic<Node *> *>(this + 1); }
+
+   void lock()
+   {
+      while (isLocked.exchange(true, std::memory_order_acquire))
+         while (isLocked.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+   }
+   void unlock()
+   {
+      isLocked.store(false, std::memory_order_release);
+   }
+
+   Pairs data;
+   int height;                      // how many next pointers follow
+   std::atomic<bool> isMarked;      // erased, maybe not unlinked yet
+   std::atomic<bool> isLinked;      // linked at every level
+   std::atomic<bool> isLocked;
+};
+
+/**********************************************************
+ * CONCURRENT MAP ITERATOR
+ * A node on the bottom level, and a guard keeping it from
+ * being freed while we are on it. Like the guard, an
+ * iterator belongs to the thread that made it. Holding
+ * one for a long time holds back freeing for everyone
+ *********************************************************/
+template <class K, class V>
+class concurrent_map <K, V> :: iterator
+{
+   friend class concurrent_map <K, V>;
+
+public:
+   iterator() : pNode(nullptr) {}
+
+   bool operator == (const iterator & rhs) const { return pNode == rhs.pNode; }
+   bool operator != (const iterator & rhs) const { return pNode != rhs.pNode; }
+
+   const Pairs & operator * () const
+   {
+      assert(pNode != nullptr);
+      return pNode->data;
+   }
+   const Pairs * operator -> () const
+   {
+      return &**this;
+   }
+
+   // on along the bottom, past anything erased or half inserted
+   iterator & operator ++ ()
+   {
+      if (pNode)
+         pNode = skipGone(pNode->next()[0].load(std::memory_order_acquire));
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn = *this;
+      ++*this;
+      return itReturn;
+   }
+
+private:
+   iterator(Node * pNode) : pNode(pNode) {}
+
+   static Node * skipGone(Node * pNode)
+   {
+      while (pNode && (pNode->isMarked.load(std::memory_order_acquire) ||
+                       !pNode->isLinked.load(std::memory_order_acquire)))
+         pNode = pNode->next()[0].load(std::memory_order_acquire);
+      return pNode;
+   }
+
+   epoch_guard guard;
+   Node * pNode;
+};
+
+/*****************************************************
+ * CONCURRENT MAP :: CONSTRUCTOR
+ * The head holds a default pair nobody looks at
+ ****************************************************/
+template <class K, class V>
+concurrent_map <K, V> :: concurrent_map() : pHead(nullptr), numElements(0)
+{
+   pHead = createNode(Pairs(), CONCURRENT_MAP_MAX_LEVEL);
+   pHead->isLinked.store(true, std::memory_order_relaxed);
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: DESTRUCTOR
+ * Every node still linked. The ones erased already
+ * belong to the epochs
+ ****************************************************/
+template <class K, class V>
+concurrent_map <K, V> :: ~concurrent_map()
+{
+   Node * pNode = pHead;
+   while (pNode)
+   {
+      Node * pNext = pNode->next()[0].load(std::memory_order_relaxed);
+      destroyNode(pNode);
+      pNode = pNext;
+   }
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: BEGIN
+ ****************************************************/
+template <class K, class V>
+typename concurrent_map <K, V> :: iterator concurrent_map <K, V> :: begin() const
+{
+   iterator it;
+   it.pNode = iterator::skipGone(pHead->next()[0].load(std::memory_order_acquire));
+   return it;
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: FIND
+ ****************************************************/
+template <class K, class V>
+typename concurrent_map <K, V> :: iterator concurrent_map <K, V> :: find(const K & k) const
+{
+   iterator it;
+   Node * pNode = firstNotLess(k);
+   if (pNode && !(k < pNode->data.first) &&
+       pNode->isLinked.load(std::memory_order_acquire) &&
+       !pNode->isMarked.load(std::memory_order_acquire))
+      it.pNode = pNode;
+   return it;
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: LOWER BOUND
+ ****************************************************/
+template <class K, class V>
+typename concurrent_map <K, V> :: iterator concurrent_map <K, V> :: lower_bound(const K & k) const
+{
+   iterator it;
+   it.pNode = iterator::skipGone(firstNotLess(k));
+   return it;
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: CONTAINS
+ ****************************************************/
+template <class K, class V>
+bool concurrent_map <K, V> :: contains(const K & k) const
+{
+   epoch_guard guard;
+   Node * pNode = firstNotLess(k);
+   return pNode && !(k < pNode->data.first) &&
+          pNode->isLinked.load(std::memory_order_acquire) &&
+          !pNode->isMarked.load(std::memory_order_acquire);
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: FOR EACH IN RANGE
+ * One descent to kLo, then along the bottom
+ ****************************************************/
+template <class K, class V>
+template <class Function>
+void concurrent_map <K, V> :: for_each_in_range(const K & kLo, const K & kHi, Function fn) const
+{
+   epoch_guard guard;
+   for (Node * pNode = iterator::skipGone(firstNotLess(kLo));
+        pNode && pNode->data.first < kHi;
+        pNode = iterator::skipGone(pNode->next()[0].load(std::memory_order_acquire)))
+      fn(static_cast<const Pairs &>(pNode->data));
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: FIRST NOT LESS
+ * Down the levels, as far right as stays below k.
+ * The caller is pinned
+ ****************************************************/
+template <class K, class V>
+typename concurrent_map <K, V> :: Node * concurrent_map <K, V> :: firstNotLess(const K & k) const
+{
+   Node * pPred = pHead;
+   Node * pCurr = nullptr;
+   for (int level = CONCURRENT_MAP_MAX_LEVEL - 1; level >= 0; level--)
+   {
+      pCurr = pPred->next()[level].load(std::memory_order_acquire);
+      while (pCurr && pCurr->data.first < k)
+      {
+         pPred = pCurr;
+         pCurr = pPred->next()[level].load(std::memory_order_acquire);
+      }
+   }
+   return pCurr;
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: FIND PATH
+ * The node before k and the node at or after it, at
+ * every level. Returns the highest level k itself was
+ * found at, or -1. The caller is pinned
+ ****************************************************/
+template <class K, class V>
+int concurrent_map <K, V> :: findPath(const K & k, Node ** preds, Node ** succs) const
+{
+   int levelFound = -1;
+   Node * pPred = pHead;
+   for (int level = CONCURRENT_MAP_MAX_LEVEL - 1; level >= 0; level--)
+   {
+      Node * pCurr = pPred->next()[level].load(std::memory_order_acquire);
+      while (pCurr && pCurr->data.first < k)
+      {
+         pPred = pCurr;
+         pCurr = pPred->next()[level].load(std::memory_order_acquire);
+      }
+      if (levelFound == -1 && pCurr && !(k < pCurr->data.first))
+         levelFound = level;
+      preds[level] = pPred;
+      succs[level] = pCurr;
+   }
+   return levelFound;
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: INSERT
+ * If k is here (and not on its way out), wait until it
+ * is all the way in and hand it back. Otherwise lock
+ * the nodes before it, level by level from the bottom,
+ * checking each is still unmarked and still points
+ * where we saw. If anything moved, let go and start
+ * over. The node is built before any lock is taken,
+ * so a copy that throws leaves nothing locked
+ ****************************************************/
+template <class K, class V>
+custom::pair<typename concurrent_map <K, V> :: iterator, bool>
+concurrent_map <K, V> :: insert(const Pairs & rhs)
+{
+   Node * preds[CONCURRENT_MAP_MAX_LEVEL];
+   Node * succs[CONCURRENT_MAP_MAX_LEVEL];
+   int height = randomHeight();
+   iterator it;             // pins us for the whole insert
+   Node * pNew = nullptr;   // kept across retries until linked
+
+   while (true)
+   {
+      int levelFound = findPath(rhs.first, preds, succs);
+      if (levelFound != -1)
+      {
+         Node * pFound = succs[levelFound];
+         if (!pFound->isMarked.load(std::memory_order_acquire))
+         {
+            while (!pFound->isLinked.load(std::memory_order_acquire))
+               std::this_thread::yield();
+            if (pNew)
+               destroyNode(pNew);
+            it.pNode = pFound;
+            return custom::pair<iterator, bool>(it, false);
+         }
+         continue;
+      }
+
+      if (!pNew)
+         pNew = createNode(rhs, height);
+
+      int levelLocked = -1;
+      bool isValid = true;
+      Node * pPrev = nullptr;
+      for (int level = 0; isValid && level < height; level++)
+      {
+         Node * pPred = preds[level];
+         Node * pSucc = succs[level];
+         if (pPred != pPrev)
+         {
+            pPred->lock();
+            levelLocked = level;
+            pPrev = pPred;
+         }
+         isValid = !pPred->isMarked.load(std::memory_order_acquire) &&
+                   (pSucc == nullptr || !pSucc->isMarked.load(std::memory_order_acquire)) &&
+                   pPred->next()[level].load(std::memory_order_acquire) == pSucc;
+      }
+      if (!isValid)
+      {
+         unlockAll(preds, levelLocked);
+         continue;
+      }
+
+      for (int level = 0; level < height; level++)
+         pNew->next()[level].store(succs[level], std::memory_order_relaxed);
+      for (int level = 0; level < height; level++)
+         preds[level]->next()[level].store(pNew, std::memory_order_release);
+      pNew->isLinked.store(true, std::memory_order_release);
+      unlockAll(preds, levelLocked);
+
+      numElements.fetch_add(1, std::memory_order_relaxed);
+      it.pNode = pNew;
+      return custom::pair<iterator, bool>(it, true);
+   }
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: ERASE
+ * Find k all the way in, lock it and mark it: from
+ * then on it is gone. Then lock the nodes before it,
+ * check they still point to it, and unlink it from
+ * the top down. Only now can it be retired
+ ****************************************************/
+template <class K, class V>
+size_t concurrent_map <K, V> :: erase(const K & k)
+{
+   Node * preds[CONCURRENT_MAP_MAX_LEVEL];
+   Node * succs[CONCURRENT_MAP_MAX_LEVEL];
+   Node * pVictim = nullptr;
+   bool isMarked = false;
+   epoch_guard guard;
+
+   while (true)
+   {
+      int levelFound = findPath(k, preds, succs);
+      if (!isMarked)
+      {
+         if (levelFound == -1)
+            return 0;
+         pVictim = succs[levelFound];
+         // only a node linked at every level, found at its top,
+         // and not already on its way out
+         if (!pVictim->isLinked.load(std::memory_order_acquire) ||
+             pVictim->height - 1 != levelFound ||
+             pVictim->isMarked.load(std::memory_order_acquire))
+         {
+            if (pVictim->isMarked.load(std::memory_order_acquire))
+               return 0;
+            std::this_thread::yield();
+            continue;
+         }
+
+         pVictim->lock();
+         if (pVictim->isMarked.load(std::memory_order_relaxed))
+         {
+            pVictim->unlock();
+            return 0;
+         }
+         pVictim->isMarked.store(true, std::memory_order_release);
+         isMarked = true;
+      }
+
+      int levelLocked = -1;
+      bool isValid = true;
+      Node * pPrev = nullptr;
+      for (int level = 0; isValid && level < pVictim->height; level++)
+      {
+         Node * pPred = preds[level];
+         if (pPred != pPrev)
+         {
+            pPred->lock();
+            levelLocked = level;
+            pPrev = pPred;
+         }
+         isValid = !pPred->isMarked.load(std::memory_order_acquire) &&
+                   pPred->next()[level].load(std::memory_order_acquire) == pVictim;
+      }
+      if (!isValid)
+      {
+         unlockAll(preds, levelLocked);
+         continue;
+      }
+
+      for (int level = pVictim->height - 1; level >= 0; level--)
+         preds[level]->next()[level].store(pVictim->next()[level].load(std::memory_order_relaxed),
+                                           std::memory_order_release);
+      pVictim->unlock();
+      unlockAll(preds, levelLocked);
+
+      numElements.fetch_sub(1, std::memory_order_relaxed);
+      epoch_domain::global().retire(pVictim, &concurrent_map::destroyNode);
+      return 1;
+   }
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: UNLOCK ALL
+ * Each distinct node in preds[0 ... levelHighest]
+ * was locked once
+ ****************************************************/
+template <class K, class V>
+void concurrent_map <K, V> :: unlockAll(Node ** preds, int levelHighest)
+{
+   Node * pPrev = nullptr;
+   for (int level = 0; level <= levelHighest; level++)
+      if (preds[level] != pPrev)
+      {
+         preds[level]->unlock();
+         pPrev = preds[level];
+      }
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: RANDOM HEIGHT
+ * One level, then each more with one chance in two.
+ * Each thread has its own generator
+ ****************************************************/
+template <class K, class V>
+int concurrent_map <K, V> :: randomHeight()
+{
+   static thread_local uint32_t state =
+      (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+   state ^= state << 13;
+   state ^= state >> 17;
+   state ^= state << 5;
+
+   int height = 1;
+   for (uint32_t bits = state; (bits & 1) && height < CONCURRENT_MAP_MAX_LEVEL; bits >>= 1)
+      height++;
+   return height;
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: CREATE NODE
+ * The node and its tower in one block
+ ****************************************************/
+template <class K, class V>
+typename concurrent_map <K, V> :: Node * concurrent_map <K, V> :: createNode(const Pairs & rhs, int height)
+{
+   void * p = ::operator new(sizeof(Node) + height * sizeof(std::atomic<Node *>));
+   try
+   {
+      return new (p) Node(height, rhs);
+   }
+   catch (...)
+   {
+      ::operator delete(p);
+      throw;
+   }
+}
+
+/*****************************************************
+ * CONCURRENT MAP :: DESTROY NODE
+ * Takes a void * so the epochs can call it
+ ****************************************************/
+template <class K, class V>
+void concurrent_map <K, V> :: destroyNode(void * p)
+{
+   Node * pNode = static_cast<Node *>(p);
+   pNode->~Node();
+   ::operator delete(p);
+}
+
+} // namespace custom
@@ -0,0 +1,310 @@
+/***********************************************************************
+ * Header:
+ *    EPOCH
+ * Summary:
+ *    Epoch-based reclamation: a node unlinked from a concurrent
+ *    structure is not freed until every thread that might still be
+ *    looking at it has moved on
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        epoch_domain          : The global epoch and every thread's record
+ *        epoch_guard           : Keeps this thread in the current epoch
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <cassert>
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <vector>      // for the lists waiting to be freed
+
+class TestConcurrentMap; // forward declaration for unit tests
+
+namespace custom
+{
+
+// how many retired nodes a thread collects before it tries to move
+// the epoch along and free the old ones
+static const size_t EPOCH_RETIRE_BATCH = 64;
+
+/******************************************************
+ * EPOCH DOMAIN
+ * Fraser's scheme ("Practical lock-freedom", 2004). A
+ * thread reading shared nodes first pins itself to the
+ * global epoch. A node unlinked while the epoch is e
+ * goes on the unlinking thread's list for e. The epoch
+ * only moves from e to e + 1 once every pinned thread
+ * has seen e, so by the time it reaches e + 2 nobody
+ * pinned can still hold the node, and the list for e
+ * is freed.
+ *
+ * Each thread gets a record the first time it pins. The
+ * records are never freed while the program runs; a
+ * thread that exits leaves its record, and whatever is
+ * still on its lists, for the next new thread to pick
+ * up. There is one domain for the whole program.
+ *****************************************************/
+class epoch_domain
+{
+   friend class ::TestConcurrentMap;
+
+   // something unlinked, and how to free it
+   struct Retired
+   {
+      void * p;
+      void (*pfnDelete)(void *);
+   };
+
+   // one thread's state. state is (epoch << 1) | 1 while pinned,
+   // and 0 when not
+   struct Record
+   {
+      Record() : state(0), inUse(true), numPins(0), numRetired(0), pNext(nullptr)
+      {
+         for (int i = 0; i < 3; i++)
+            epochRetired[i] = 0;
+      }
+
+      std::atomic<uint64_t> state;
+      std::atomic<bool> inUse;       // a live thread owns this record
+      int numPins;                   // guards alive on the owner
+      size_t numRetired;             // since the last try to advance
+      std::vector<Retired> retired[3];
+      uint64_t epochRetired[3];      // the epoch each list was filled in
+      Record * pNext;
+   };
+
+   // releases this thread's record when the thread exits
+   struct Handle
+   {
+      Handle(epoch_domain & domain) : domain(domain), pRecord(domain.acquire()) {}
+      ~Handle() { domain.leave(pRecord); }
+      epoch_domain & domain;
+      Record * pRecord;
+   };
+
+public:
+   epoch_domain() : epoch(0), pHead(nullptr) {}
+   epoch_domain(const epoch_domain &) = delete;
+   epoch_domain & operator = (const epoch_domain &) = delete;
+   ~epoch_domain();
+
+   // the one every concurrent structure shares
+   static epoch_domain & global()
+   {
+      static epoch_domain domain;
+      return domain;
+   }
+
+   void pin();
+   void unpin();
+
+   // hand over something this thread just unlinked. Must be pinned
+   void retire(void * p, void (*pfnDelete)(void *));
+
+   // try to move the epoch along and free what this thread can. With
+   // no other thread pinned, three calls free everything it retired
+   void collect();
+
+private:
+   Record * current()
+   {
+      static thread_local Handle handle(*this);
+      return handle.pRecord;
+   }
+   Record * acquire();
+   void leave(Record * pRecord);
+   bool tryAdvance(uint64_t epochSeen);
+   void freeOld(Record * pRecord, uint64_t epochNow);
+   static void freeList(std::vector<Retired> & list);
+
+   std::atomic<uint64_t> epoch;
+   std::atomic<Record *> pHead;   // every record, newest first
+};
+
+/******************************************************
+ * EPOCH GUARD
+ * While one is alive, nothing this thread can reach
+ * through a concurrent structure will be freed. Guards
+ * nest, and belong to the thread that made them
+ *****************************************************/
+class epoch_guard
+{
+public:
+   epoch_guard()                      { epoch_domain::global().pin();   }
+   epoch_guard(const epoch_guard &)   { epoch_domain::global().pin();   }
+   epoch_guard & operator = (const epoch_guard &) { return *this; }
+   ~epoch_guard()                     { epoch_domain::global().unpin(); }
+};
+
+/******************************************************
+ * EPOCH DOMAIN :: PIN
+ * Publish the epoch we are in. The fence keeps any
+ * read of a shared node from moving ahead of it, so a
+ * thread advancing the epoch either sees us pinned or
+ * we see everything it unlinked before it advanced
+ *****************************************************/
+inline void epoch_domain :: pin()
+{
+   Record * pRecord = current();
+   if (pRecord->numPins++ == 0)
+   {
+      uint64_t epochNow = epoch.load(std::memory_order_relaxed);
+      pRecord->state.store((epochNow << 1) | 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+   }
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: UNPIN
+ *****************************************************/
+inline void epoch_domain :: unpin()
+{
+   Record * pRecord = current();
+   assert(pRecord->numPins > 0);
+   if (--pRecord->numPins == 0)
+      pRecord->state.store(0, std::memory_order_release);
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: RETIRE
+ * Onto the list for the epoch now. A list still
+ * holding an epoch three or more back is safe to free
+ * first. Every so often, try to move things along
+ *****************************************************/
+inline void epoch_domain :: retire(void * p, void (*pfnDelete)(void *))
+{
+   Record * pRecord = current();
+   assert(pRecord->numPins > 0);
+
+   uint64_t epochNow = epoch.load(std::memory_order_seq_cst);
+   int i = (int)(epochNow % 3);
+   if (pRecord->epochRetired[i] != epochNow)
+   {
+      freeList(pRecord->retired[i]);
+      pRecord->epochRetired[i] = epochNow;
+   }
+   pRecord->retired[i].push_back(Retired{ p, pfnDelete });
+
+   if (++pRecord->numRetired >= EPOCH_RETIRE_BATCH)
+   {
+      pRecord->numRetired = 0;
+      collect();
+   }
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: COLLECT
+ *****************************************************/
+inline void epoch_domain :: collect()
+{
+   Record * pRecord = current();
+   uint64_t epochNow = epoch.load(std::memory_order_seq_cst);
+   if (tryAdvance(epochNow))
+      epochNow++;
+   freeOld(pRecord, epochNow);
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: TRY ADVANCE
+ * Only if every pinned thread is in this epoch
+ *****************************************************/
+inline bool epoch_domain :: tryAdvance(uint64_t epochSeen)
+{
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   for (Record * p = pHead.load(std::memory_order_acquire); p; p = p->pNext)
+   {
+      uint64_t state = p->state.load(std::memory_order_seq_cst);
+      if ((state & 1) && (state >> 1) != epochSeen)
+         return false;
+   }
+   return epoch.compare_exchange_strong(epochSeen, epochSeen + 1, std::memory_order_seq_cst);
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: FREE OLD
+ * Every list of this record filled two or more
+ * epochs ago
+ *****************************************************/
+inline void epoch_domain :: freeOld(Record * pRecord, uint64_t epochNow)
+{
+   for (int i = 0; i < 3; i++)
+      if (!pRecord->retired[i].empty() && pRecord->epochRetired[i] + 2 <= epochNow)
+         freeList(pRecord->retired[i]);
+}
+
+inline void epoch_domain :: freeList(std::vector<Retired> & list)
+{
+   for (const Retired & retired : list)
+      retired.pfnDelete(retired.p);
+   list.clear();
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: ACQUIRE
+ * A record some exited thread left, or a new one
+ * pushed on the front of the list
+ *****************************************************/
+inline epoch_domain :: Record * epoch_domain :: acquire()
+{
+   for (Record * p = pHead.load(std::memory_order_acquire); p; p = p->pNext)
+   {
+      bool isInUse = false;
+      if (!p->inUse.load(std::memory_order_relaxed) &&
+          p->inUse.compare_exchange_strong(isInUse, true, std::memory_order_acquire))
+         return p;
+   }
+
+   Record * pRecord = new Record;
+   Record * pOld = pHead.load(std::memory_order_relaxed);
+   do
+      pRecord->pNext = pOld;
+   while (!pHead.compare_exchange_weak(pOld, pRecord, std::memory_order_release,
+                                       std::memory_order_relaxed));
+   return pRecord;
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: LEAVE
+ * A thread is exiting: free what we can now, and let
+ * the next thread have the record and the rest
+ *****************************************************/
+inline void epoch_domain :: leave(Record * pRecord)
+{
+   assert(pRecord->numPins == 0);
+   pRecord->state.store(0, std::memory_order_release);
+   uint64_t epochNow = epoch.load(std::memory_order_seq_cst);
+   if (tryAdvance(epochNow))
+      epochNow++;
+   freeOld(pRecord, epochNow);
+   pRecord->inUse.store(false, std::memory_order_release);
+}
+
+/******************************************************
+ * EPOCH DOMAIN :: DESTRUCTOR
+ * The program is ending and no thread is left to
+ * read anything, so every list goes
+ *****************************************************/
+inline epoch_domain :: ~epoch_domain()
+{
+   Record * p = pHead.load(std::memory_order_acquire);
+   while (p)
+   {
+      for (int i = 0; i < 3; i++)
+         freeList(p->retired[i]);
+      Record * pNext = p->pNext;
+      delete p;
+      p = pNext;
+   }
+}
+
+} // namespace custom
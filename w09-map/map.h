@@ -21,6 +21,7 @@
 
 #include "pair.h"     // for pair
 #include "bst.h"      // no nested class necessary for this assignment
+#include "btree.h"    // or a B-tree, if you ask for one
 
 #ifndef debug
 #ifdef DEBUG
@@ -37,22 +38,25 @@ namespace custom
 
 /*****************************************************************
  * MAP
- * Create a Map, similar to a Binary Search Tree
+ * Create a Map, similar to a Binary Search Tree. A gives the
+ * allocator for the tree's nodes, and Tree the engine: the
+ * red-black BST or the BTree
  *****************************************************************/
-template <class K, class V>
+template <class K, class V, class A = std::allocator<custom::pair<K, V>>,
+          template <class, class> class Tree = BST>
 class map
 {
    friend class ::TestMap;
 
-   template <class KK, class VV>
-   friend void swap(map<KK, VV>& lhs, map<KK, VV>& rhs); 
+   template <class KK, class VV, class AA, template <class, class> class TR>
+   friend void swap(map<KK, VV, AA, TR>& lhs, map<KK, VV, AA, TR>& rhs); 
 public:
    using Pairs = custom::pair<K, V>;
 
    // 
    // Construct
    //
-   map()
+   map(const A & a = A()) : bst(a)
    {
    }
    map(const map &  rhs) : bst(rhs.bst)
@@ -62,14 +66,11 @@ public:
    { 
    }
    template <class Iterator>
-   map(Iterator first, Iterator last)
+   map(Iterator first, Iterator last, const A & a = A()) : bst(a)
    {
-      for (auto it = first; it != last; it++)
-      {
-         bst.insert(*it, true);
-      }
+      bst.build(first, last, true);
    }
-   map(const std::initializer_list <Pairs>& il) : bst(il)
+   map(const std::initializer_list <Pairs>& il, const A & a = A()) : bst(il, a)
    {
    }
    ~map()         
@@ -119,6 +120,32 @@ public:
    {
       return iterator(bst.find(k));
    }
+   iterator nth(size_t k) const
+   {
+      return iterator(bst.nth(k));
+   }
+   size_t rank(const K & k) const
+   {
+      return bst.rank(k);
+   }
+   iterator lower_bound(const K & k) const
+   {
+      return iterator(bst.lower_bound(k));
+   }
+   iterator upper_bound(const K & k) const
+   {
+      return iterator(bst.upper_bound(k));
+   }
+   custom::pair<iterator, iterator> equal_range(const K & k) const
+   {
+      return custom::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+   }
+   // fn sees each pair with a key in [kLo, kHi), in order
+   template <class Function>
+   void for_each_in_range(const K & kLo, const K & kHi, Function fn) const
+   {
+      bst.for_each_in_range(kLo, kHi, fn);
+   }
 
    //
    // Insert
@@ -135,6 +162,21 @@ public:
 
       return { pair.first, pair.second };
    }
+   iterator insert(iterator itHint, Pairs && rhs)
+   {
+      return iterator(bst.insert(itHint.it, std::move(rhs), true));
+   }
+   iterator insert(iterator itHint, const Pairs & rhs)
+   {
+      return iterator(bst.insert(itHint.it, rhs, true));
+   }
+   template <class ... Args>
+   custom::pair<typename map::iterator, bool> emplace(Args && ... args)
+   {
+      auto pair = bst.emplace_unique(std::forward<Args>(args)...);
+
+      return { pair.first, pair.second };
+   }
 
    template <class Iterator>
    void insert(Iterator first, Iterator last)
@@ -155,10 +197,51 @@ public:
    {
       bst.clear();
    }
+   // empty now, free the nodes on another thread
+   std::future<void> clearDeferred()
+   {
+      return bst.clearDeferred();
+   }
    size_t erase(const K& k);
    iterator erase(iterator it);
    iterator erase(iterator first, iterator last);
 
+   //
+   // Set algebra on the keys. A key in both keeps the value here.
+   // The rvalue forms hand rhs's nodes over and leave it empty;
+   // the const forms work on a copy
+   //
+   map & unionWith(map && rhs, unsigned numThreads = 0)
+   {
+      bst.unionWith(rhs.bst, numThreads);
+      return *this;
+   }
+   map & unionWith(const map & rhs, unsigned numThreads = 0)
+   {
+      map copy(rhs);
+      return unionWith(std::move(copy), numThreads);
+   }
+   map & intersectionWith(map && rhs, unsigned numThreads = 0)
+   {
+      bst.intersectionWith(rhs.bst, numThreads);
+      return *this;
+   }
+   map & intersectionWith(const map & rhs, unsigned numThreads = 0)
+   {
+      map copy(rhs);
+      return intersectionWith(std::move(copy), numThreads);
+   }
+   map & differenceWith(map && rhs, unsigned numThreads = 0)
+   {
+      bst.differenceWith(rhs.bst, numThreads);
+      return *this;
+   }
+   map & differenceWith(const map & rhs, unsigned numThreads = 0)
+   {
+      map copy(rhs);
+      return differenceWith(std::move(copy), numThreads);
+   }
+
    //
    // Status
    //
@@ -175,7 +258,7 @@ public:
 private:
 
    // the students DO NOT need to use a nested class
-   BST < pair <K, V >> bst;
+   Tree < pair <K, V >, A > bst;
 };
 
 
@@ -184,11 +267,11 @@ private:
  * Forward and reverse iterator through a Map, just call
  * through to BSTIterator
  *********************************************************/
-template <typename K, typename V>
-class map <K, V> :: iterator
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+class map <K, V, A, Tree> :: iterator
 {
    friend class ::TestMap;
-   template <class KK, class VV>
+   template <class KK, class VV, class AA, template <class, class> class TR>
    friend class custom::map; 
 public:
    //
@@ -197,7 +280,7 @@ public:
    iterator() 
    {
    }
-   iterator(const typename BST < pair <K, V> > :: iterator & rhs) : it()
+   iterator(const typename Tree < pair <K, V>, A > :: iterator & rhs) : it()
    {
       this->it = rhs;
    }
@@ -262,7 +345,7 @@ public:
 private:
 
    // Member variable
-   typename BST < pair <K, V >>  :: iterator it;   
+   typename Tree < pair <K, V >, A >  :: iterator it;   
 };
 
 
@@ -270,8 +353,8 @@ private:
  * MAP :: SUBSCRIPT
  * Retrieve an element from the map
  ****************************************************/
-template <typename K, typename V>
-V& map <K, V> :: operator [] (const K& key)
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+V& map <K, V, A, Tree> :: operator [] (const K& key)
 {
    //pair <K, V> pair = key, Value();
    //iterator it = bst.find(pair);
@@ -288,8 +371,8 @@ V& map <K, V> :: operator [] (const K& key)
  * MAP :: SUBSCRIPT
  * Retrieve an element from the map
  ****************************************************/
-template <typename K, typename V>
-const V& map <K, V> :: operator [] (const K& key) const
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+const V& map <K, V, A, Tree> :: operator [] (const K& key) const
 {
    return *(new V);
 }
@@ -298,8 +381,8 @@ const V& map <K, V> :: operator [] (const K& key) const
  * MAP :: AT
  * Retrieve an element from the map
  ****************************************************/
-template <typename K, typename V>
-V& map <K, V> ::at(const K& key)
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+V& map <K, V, A, Tree> ::at(const K& key)
 {
    //Pairs p = { key, V() };
    //iterator it = bst.find(pair);
@@ -314,8 +397,8 @@ V& map <K, V> ::at(const K& key)
  * MAP :: AT
  * Retrieve an element from the map
  ****************************************************/
-template <typename K, typename V>
-const V& map <K, V> ::at(const K& key) const
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+const V& map <K, V, A, Tree> ::at(const K& key) const
 {
    return *(new V);
 }
@@ -324,8 +407,8 @@ const V& map <K, V> ::at(const K& key) const
  * SWAP
  * Swap two maps
  ****************************************************/
-template <typename K, typename V>
-void swap(map <K, V>& lhs, map <K, V>& rhs)
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+void swap(map <K, V, A, Tree>& lhs, map <K, V, A, Tree>& rhs)
 {
    std::swap(lhs, rhs);
 }
@@ -334,8 +417,8 @@ void swap(map <K, V>& lhs, map <K, V>& rhs)
  * ERASE
  * Erase one element
  ****************************************************/
-template <typename K, typename V>
-size_t map<K, V>::erase(const K& k)
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+size_t map<K, V, A, Tree>::erase(const K& k)
 {
    //Pairs pair(k, V());
    iterator it = find(k);
@@ -349,8 +432,8 @@ size_t map<K, V>::erase(const K& k)
  * ERASE
  * Erase several elements
  ****************************************************/
-template <typename K, typename V>
-typename map<K, V>::iterator map<K, V>::erase(map<K, V>::iterator first, map<K, V>::iterator last)
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+typename map<K, V, A, Tree>::iterator map<K, V, A, Tree>::erase(map<K, V, A, Tree>::iterator first, map<K, V, A, Tree>::iterator last)
 {
    while (first != last)
       first = erase(first);
@@ -361,8 +444,8 @@ typename map<K, V>::iterator map<K, V>::erase(map<K, V>::iterator first, map<K,
  * ERASE
  * Erase one element
  ****************************************************/
-template <typename K, typename V>
-typename map<K, V>::iterator map<K, V>::erase(map<K, V>::iterator it)
+template <typename K, typename V, typename A, template <typename, typename> class Tree>
+typename map<K, V, A, Tree>::iterator map<K, V, A, Tree>::erase(map<K, V, A, Tree>::iterator it)
 {
    return iterator(bst.erase(it.it));
 }
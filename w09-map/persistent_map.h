@@ -0,0 +1,624 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT MAP
+ * Summary:
+ *    A map whose copies share everything they have not changed since.
+ *    An update copies only the nodes on the path down to the key, so
+ *    taking a snapshot to hand to a reader is O(1) and keeping many
+ *    of them costs O(log n) nodes per update between them
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        persistent_map            : A map with O(1) snapshots
+ *        persistent_map::iterator  : A forward iterator through one
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>           // for std::atomic
+#include <cassert>
+#include <cstddef>          // for size_t
+#include <initializer_list>
+#include <memory>           // for std::allocator and std::allocator_traits
+#include <stdexcept>        // for std::out_of_range
+#include <utility>          // for std::move and std::forward
+#include <vector>           // for the iterator's path
+#include "pair.h"           // for pair
+
+class TestPersistentMap; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * PERSISTENT MAP
+ * An AVL tree of reference-counted nodes. Copying the map takes
+ * one more reference on the root, nothing else. A node is only
+ * ever changed in place when this map is the only one that can
+ * reach it (every node from the root down to it has a count of
+ * one); otherwise it is copied first, and the copy takes a
+ * reference on both children. So an update after a snapshot
+ * makes O(log n) new nodes, and an update with no snapshot alive
+ * makes none beyond the one it inserts.
+ *
+ * Different maps that share nodes may be read, updated and
+ * destroyed on different threads: the counts are atomic and a
+ * shared node is never written. One map is not itself safe to
+ * update from two threads at once.
+ *****************************************************************/
+template <class K, class V, class A = std::allocator<custom::pair<K, V>>>
+class persistent_map
+{
+   friend class ::TestPersistentMap;
+
+public:
+   using Pairs = custom::pair<K, V>;
+
+   //
+   // Construct
+   //
+
+   persistent_map(const A & a = A()) : root(nullptr), numElements(0), alloc(a) {}
+   persistent_map(const persistent_map & rhs) :
+      root(retain(rhs.root)), numElements(rhs.numElements), alloc(rhs.alloc) {}
+   persistent_map(persistent_map && rhs) noexcept :
+      root(rhs.root), numElements(rhs.numElements), alloc(std::move(rhs.alloc))
+   {
+      rhs.root = nullptr;
+      rhs.numElements = 0;
+   }
+   persistent_map(const std::initializer_list<Pairs> & il, const A & a = A()) :
+      persistent_map(a)
+   {
+      for (auto && element : il)
+         insert(element);
+   }
+   ~persistent_map()
+   {
+      release(root);
+   }
+
+   persistent_map & operator = (const persistent_map & rhs)
+   {
+      Node * pOld = root;
+      root = retain(rhs.root);   // before the release, in case rhs is us
+      release(pOld);
+      numElements = rhs.numElements;
+      return *this;
+   }
+   persistent_map & operator = (persistent_map && rhs) noexcept
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(persistent_map & rhs) noexcept
+   {
+      std::swap(root, rhs.root);
+      std::swap(numElements, rhs.numElements);
+      std::swap(alloc, rhs.alloc);
+   }
+
+   // the same as a copy; here to say what the copy is for
+   persistent_map snapshot() const
+   {
+      return *this;
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const;
+   iterator end()   const { return iterator(); }
+
+   //
+   // Access
+   //
+
+   iterator find(const K & k) const;
+   const V & at(const K & k) const;
+   bool contains(const K & k) const
+   {
+      return findNode(k) != nullptr;
+   }
+
+   //
+   // Insert
+   //
+
+   // add the pair unless its key is already here. Nothing is
+   // copied when it is
+   bool insert(const Pairs & rhs);
+   // add the key, or give it a new value if it is already here
+   void insert_or_assign(const K & k, const V &  v) { assign(k, v);            }
+   void insert_or_assign(const K & k,       V && v) { assign(k, std::move(v)); }
+
+   //
+   // Remove
+   //
+
+   size_t erase(const K & k);
+   void clear() noexcept
+   {
+      release(root);
+      root = nullptr;
+      numElements = 0;
+   }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return numElements == 0; }
+   size_t size()  const noexcept { return numElements;      }
+
+private:
+
+   struct Node;
+   using NodeAlloc = typename std::allocator_traits<A>::template rebind_alloc<Node>;
+
+   template <class ... Args>
+   Node * createNode(Args && ... args);
+   void destroyNode(Node * pNode) noexcept;
+   static Node * retain(Node * pNode) noexcept;
+   void release(Node * pNode) noexcept;
+   Node * own(Node * & pSlot);
+
+   const Node * findNode(const K & k) const;
+   template <class U>
+   void assign(const K & k, U && v);
+   template <class U>
+   void insertAt(Node * & pSlot, const K & k, U && v);
+   void eraseAt(Node * & pSlot, const K & k);
+   Node * detachMin(Node * & pSlot);
+
+   static int heightOf(const Node * pNode) { return pNode ? pNode->height : 0; }
+   static void fixHeight(Node * pNode);
+   void rebalance(Node * & pSlot);
+   void rotateLeft(Node * & pSlot);
+   void rotateRight(Node * & pSlot);
+
+   Node * root;           // shared with every snapshot that has not diverged
+   size_t numElements;    // number of pairs reachable from root
+   NodeAlloc alloc;       // where the nodes come from
+};
+
+/*****************************************************************
+ * PERSISTENT MAP NODE
+ * A pair, its two subtrees, its height, and how many parents (or
+ * maps, for a root) point to it
+ *****************************************************************/
+template <class K, class V, class A>
+struct persistent_map <K, V, A> :: Node
+{
+   template <class ... Args>
+   Node(Args && ... args) :
+      data(std::forward<Args>(args)...), pLeft(nullptr), pRight(nullptr),
+      height(1), numRefs(1) {}
+
+   Pairs data;
+   Node * pLeft;
+   Node * pRight;
+   int height;                       // 1 for a leaf
+   std::atomic<size_t> numRefs;
+};
+
+/**********************************************************
+ * PERSISTENT MAP ITERATOR
+ * With no parent pointers (a shared node has many parents),
+ * the iterator keeps the way back itself: the current node
+ * on top, and under it each ancestor still to be visited.
+ * It is valid while the map it came from is alive and
+ * unchanged; other snapshots changing do not matter
+ *********************************************************/
+template <class K, class V, class A>
+class persistent_map <K, V, A> :: iterator
+{
+   friend class persistent_map <K, V, A>;
+
+public:
+   iterator() {}
+
+   bool operator == (const iterator & rhs) const { return top() == rhs.top(); }
+   bool operator != (const iterator & rhs) const { return top() != rhs.top(); }
+
+   const Pairs & operator * () const
+   {
+      assert(!path.empty());
+      return path.back()->data;
+   }
+   const Pairs * operator -> () const
+   {
+      return &**this;
+   }
+
+   // up to the ancestor we were left of, or down the right subtree
+   iterator & operator ++ ()
+   {
+      if (!path.empty())
+      {
+         const Node * pNode = path.back();
+         path.pop_back();
+         pushLeft(pNode->pRight);
+      }
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn = *this;
+      ++*this;
+      return itReturn;
+   }
+
+private:
+   const Node * top() const { return path.empty() ? nullptr : path.back(); }
+   void pushLeft(const Node * pNode)
+   {
+      for (; pNode; pNode = pNode->pLeft)
+         path.push_back(pNode);
+   }
+
+   std::vector<const Node *> path;
+};
+
+/*****************************************************
+ * PERSISTENT MAP :: BEGIN
+ * Down the left spine
+ ****************************************************/
+template <class K, class V, class A>
+typename persistent_map <K, V, A> :: iterator persistent_map <K, V, A> :: begin() const
+{
+   iterator it;
+   it.pushLeft(root);
+   return it;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: FIND
+ * Remember every node we go left of on the way down,
+ * so the iterator can carry on from the match
+ ****************************************************/
+template <class K, class V, class A>
+typename persistent_map <K, V, A> :: iterator persistent_map <K, V, A> :: find(const K & k) const
+{
+   iterator it;
+   const Node * pNode = root;
+   while (pNode)
+   {
+      if (k < pNode->data.first)
+      {
+         it.path.push_back(pNode);
+         pNode = pNode->pLeft;
+      }
+      else if (pNode->data.first < k)
+         pNode = pNode->pRight;
+      else
+      {
+         it.path.push_back(pNode);
+         return it;
+      }
+   }
+   return end();
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: AT
+ * The value for k, which had better be there
+ ****************************************************/
+template <class K, class V, class A>
+const V & persistent_map <K, V, A> :: at(const K & k) const
+{
+   const Node * pNode = findNode(k);
+   if (pNode == nullptr)
+      throw std::out_of_range("invalid map<K, T> key");
+   return pNode->data.second;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: FIND NODE
+ ****************************************************/
+template <class K, class V, class A>
+const typename persistent_map <K, V, A> :: Node * persistent_map <K, V, A> :: findNode(const K & k) const
+{
+   const Node * pNode = root;
+   while (pNode)
+   {
+      if (k < pNode->data.first)
+         pNode = pNode->pLeft;
+      else if (pNode->data.first < k)
+         pNode = pNode->pRight;
+      else
+         return pNode;
+   }
+   return nullptr;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: INSERT
+ * Look first, so a key that is already here does not
+ * copy the path to it for nothing
+ ****************************************************/
+template <class K, class V, class A>
+bool persistent_map <K, V, A> :: insert(const Pairs & rhs)
+{
+   if (findNode(rhs.first))
+      return false;
+   insertAt(root, rhs.first, rhs.second);
+   return true;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: ASSIGN
+ * Insert, or replace the value. Either way the path
+ * down is ours afterwards
+ ****************************************************/
+template <class K, class V, class A>
+template <class U>
+void persistent_map <K, V, A> :: assign(const K & k, U && v)
+{
+   insertAt(root, k, std::forward<U>(v));
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: INSERT AT
+ * Make the node in the slot ours, go down the side k
+ * belongs on, and rebalance on the way back up. pSlot
+ * is the root or a child pointer in a node we own
+ ****************************************************/
+template <class K, class V, class A>
+template <class U>
+void persistent_map <K, V, A> :: insertAt(Node * & pSlot, const K & k, U && v)
+{
+   if (pSlot == nullptr)
+   {
+      pSlot = createNode(k, std::forward<U>(v));
+      numElements++;
+      return;
+   }
+
+   Node * pNode = own(pSlot);
+   if (k < pNode->data.first)
+      insertAt(pNode->pLeft, k, std::forward<U>(v));
+   else if (pNode->data.first < k)
+      insertAt(pNode->pRight, k, std::forward<U>(v));
+   else
+   {
+      pNode->data.second = std::forward<U>(v);
+      return;
+   }
+   rebalance(pSlot);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: ERASE
+ * Look first, for the same reason as insert
+ ****************************************************/
+template <class K, class V, class A>
+size_t persistent_map <K, V, A> :: erase(const K & k)
+{
+   if (findNode(k) == nullptr)
+      return 0;
+   eraseAt(root, k);
+   numElements--;
+   return 1;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: ERASE AT
+ * A node with one child or none is replaced by it. A
+ * node with two takes the pair of the smallest node
+ * on its right, which is unlinked instead
+ ****************************************************/
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: eraseAt(Node * & pSlot, const K & k)
+{
+   Node * pNode = own(pSlot);
+   if (k < pNode->data.first)
+      eraseAt(pNode->pLeft, k);
+   else if (pNode->data.first < k)
+      eraseAt(pNode->pRight, k);
+   else if (pNode->pLeft == nullptr || pNode->pRight == nullptr)
+   {
+      // the slot takes over our reference on the child
+      pSlot = pNode->pLeft ? pNode->pLeft : pNode->pRight;
+      pNode->pLeft = pNode->pRight = nullptr;
+      release(pNode);
+      return;
+   }
+   else
+   {
+      Node * pMin = detachMin(pNode->pRight);
+      pNode->data = std::move(pMin->data);
+      release(pMin);
+   }
+   rebalance(pSlot);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: DETACH MIN
+ * Unlink the left-most node under the slot and hand
+ * it back, owned and with no children
+ ****************************************************/
+template <class K, class V, class A>
+typename persistent_map <K, V, A> :: Node * persistent_map <K, V, A> :: detachMin(Node * & pSlot)
+{
+   Node * pNode = own(pSlot);
+   if (pNode->pLeft == nullptr)
+   {
+      pSlot = pNode->pRight;
+      pNode->pRight = nullptr;
+      return pNode;
+   }
+
+   Node * pMin = detachMin(pNode->pLeft);
+   rebalance(pSlot);
+   return pMin;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: OWN
+ * Make the node in the slot one only we can reach. If
+ * anyone else holds it, put a copy in the slot: the
+ * copy shares the children, and the original loses
+ * our reference. The children are retained before
+ * the original is released, so a snapshot dropping
+ * it on another thread cannot free them under us
+ ****************************************************/
+template <class K, class V, class A>
+typename persistent_map <K, V, A> :: Node * persistent_map <K, V, A> :: own(Node * & pSlot)
+{
+   Node * pNode = pSlot;
+   if (pNode->numRefs.load(std::memory_order_acquire) == 1)
+      return pNode;
+
+   Node * pCopy = createNode(pNode->data);
+   pCopy->pLeft = retain(pNode->pLeft);
+   pCopy->pRight = retain(pNode->pRight);
+   pCopy->height = pNode->height;
+   pSlot = pCopy;
+   release(pNode);
+   return pCopy;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: RETAIN
+ * One more parent or map points here
+ ****************************************************/
+template <class K, class V, class A>
+typename persistent_map <K, V, A> :: Node * persistent_map <K, V, A> :: retain(Node * pNode) noexcept
+{
+   if (pNode)
+      pNode->numRefs.fetch_add(1, std::memory_order_relaxed);
+   return pNode;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: RELEASE
+ * One fewer. The last one out frees the node and lets
+ * go of its children: the left by recursion, the right
+ * by looping, so the stack only goes as deep as the
+ * tree is high
+ ****************************************************/
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: release(Node * pNode) noexcept
+{
+   while (pNode && pNode->numRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+   {
+      release(pNode->pLeft);
+      Node * pRight = pNode->pRight;
+      destroyNode(pNode);
+      pNode = pRight;
+   }
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: CREATE NODE
+ * Allocate and construct a node in one step
+ ****************************************************/
+template <class K, class V, class A>
+template <class ... Args>
+typename persistent_map <K, V, A> :: Node * persistent_map <K, V, A> :: createNode(Args && ... args)
+{
+   Node * pNode = alloc.allocate(1);
+   try
+   {
+      std::allocator_traits<NodeAlloc>::construct(alloc, pNode, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      alloc.deallocate(pNode, 1);
+      throw;
+   }
+   return pNode;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: DESTROY NODE
+ * Tear a node down and give it back
+ ****************************************************/
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: destroyNode(Node * pNode) noexcept
+{
+   std::allocator_traits<NodeAlloc>::destroy(alloc, pNode);
+   alloc.deallocate(pNode, 1);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: FIX HEIGHT
+ ****************************************************/
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: fixHeight(Node * pNode)
+{
+   int heightLeft = heightOf(pNode->pLeft);
+   int heightRight = heightOf(pNode->pRight);
+   pNode->height = 1 + (heightLeft > heightRight ? heightLeft : heightRight);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: REBALANCE
+ * The node in the slot is ours and its subtrees are
+ * AVL trees whose heights differ by at most two. One
+ * rotation, or two when the heavy child leans the
+ * other way, brings it back within one
+ ****************************************************/
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: rebalance(Node * & pSlot)
+{
+   Node * pNode = pSlot;
+   int balance = heightOf(pNode->pLeft) - heightOf(pNode->pRight);
+   if (balance > 1)
+   {
+      if (heightOf(pNode->pLeft->pLeft) < heightOf(pNode->pLeft->pRight))
+         rotateLeft(pNode->pLeft);
+      rotateRight(pSlot);
+   }
+   else if (balance < -1)
+   {
+      if (heightOf(pNode->pRight->pRight) < heightOf(pNode->pRight->pLeft))
+         rotateRight(pNode->pRight);
+      rotateLeft(pSlot);
+   }
+   else
+      fixHeight(pNode);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: ROTATE LEFT / ROTATE RIGHT
+ * Both nodes that move get written, so both must be
+ * ours. The references just change hands: no count
+ * goes up or down
+ ****************************************************/
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: rotateLeft(Node * & pSlot)
+{
+   Node * pNode = own(pSlot);
+   Node * pRight = own(pNode->pRight);
+   pNode->pRight = pRight->pLeft;
+   pRight->pLeft = pNode;
+   pSlot = pRight;
+   fixHeight(pNode);
+   fixHeight(pRight);
+}
+
+template <class K, class V, class A>
+void persistent_map <K, V, A> :: rotateRight(Node * & pSlot)
+{
+   Node * pNode = own(pSlot);
+   Node * pLeft = own(pNode->pLeft);
+   pNode->pLeft = pLeft->pRight;
+   pLeft->pRight = pNode;
+   pSlot = pLeft;
+   fixHeight(pNode);
+   fixHeight(pLeft);
+}
+
+} // namespace custom
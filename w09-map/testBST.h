@@ -14,12 +14,16 @@
 #include "bst.h"
 #include "unitTest.h"
 #include "spy.h"
+#include "node_pool.h"
 
 #include <cassert>
 #include <memory>
 #include <iostream>
 #include <string>
 #include <functional> // for std::less and std::greater
+#include <vector>
+#include <future>     // for std::future
+#include <chrono>     // for std::chrono::seconds
 
  /***********************************************
   * TEST BST
@@ -74,6 +78,8 @@ public:
       test_iterator_increment_standardToGrandchild();
       test_iterator_increment_standardToDone();
       test_iterator_increment_standardEnd();
+      test_iterator_increment_rootLast();
+      test_iterator_decrement_rootFirst();
       test_iterator_dereference_standardRead();
 
       // Find
@@ -82,6 +88,21 @@ public:
       test_find_standardLast();
       test_find_standardMissing();
 
+      // Order statistics
+      test_nth_standard();
+      test_nth_past();
+      test_rank_standard();
+      test_size_insertErase();
+
+      // Range
+      test_lowerBound_standard();
+      test_upperBound_standard();
+      test_equalRange_duplicates();
+      test_equalRange_missing();
+      test_forEachInRange_standard();
+      test_forEachInRange_outside();
+      test_forEachInRange_big();
+
       // Insert
       test_insert_oneLeft();
       test_insert_oneRight();
@@ -102,6 +123,34 @@ public:
       test_insert_case4bComplex();
       test_insert_case4cComplex();
       test_insert_case4dComplex();
+      test_emplace_inPlace();
+      test_emplaceUnique_duplicate();
+      test_insertHint_end();
+      test_insertHint_sorted();
+      test_insertHint_reverse();
+      test_insertHint_wrong();
+      test_insertHint_keepUnique();
+      test_build_sorted();
+      test_build_unsorted();
+      test_build_replaces();
+
+     // Set algebra
+     test_union_skewed();
+     test_union_parallel();
+     test_union_otherAllocator();
+     test_union_duplicateDestroyed();
+     test_intersection_skewed();
+     test_intersection_parallel();
+     test_difference_skewed();
+     test_difference_parallel();
+     test_difference_empty();
+
+     // Copy and tear down across threads
+     test_assign_parallel();
+     test_assign_parallelOverStandard();
+     test_clear_parallel();
+     test_clearDeferred_standard();
+     test_clearDeferred_pool();
 
       // Remove
       test_erase_empty();
@@ -1615,6 +1664,40 @@ public:
       teardownStandardFixture(bst);
    }
 
+   // increment from a root with nothing to its right
+   void test_iterator_increment_rootLast()
+   {  // setup
+      //            (20b)
+      //       +-----+
+      //     (10r)
+      custom::BST <int> bst;
+      bst.insert(20);
+      bst.insert(10);
+      custom::BST <int>::iterator it = bst.find(20);
+      assertUnit(it.pNode == bst.root);
+      // exercise
+      ++it;
+      // verify
+      assertUnit(it == bst.end());
+   }  // teardown
+
+   // decrement from a root with nothing to its left
+   void test_iterator_decrement_rootFirst()
+   {  // setup
+      //            (10b)
+      //             +-----+
+      //                 (20r)
+      custom::BST <int> bst;
+      bst.insert(10);
+      bst.insert(20);
+      custom::BST <int>::iterator it = bst.find(10);
+      assertUnit(it.pNode == bst.root);
+      // exercise
+      --it;
+      // verify
+      assertUnit(it == bst.end());
+   }  // teardown
+
    // itereator dereference were we just read
    void test_iterator_dereference_standardRead()
    {  // setup
@@ -1798,6 +1881,232 @@ public:
       teardownStandardFixture(bst);
    }
 
+   /***************************************
+    * ORDER STATISTICS
+    *    BST::nth(k)
+    *    BST::rank(t)
+    ***************************************/
+
+   // nth lands on every value in turn
+   void test_nth_standard()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      custom::BST <int>::iterator it0 = bst.nth(0);
+      custom::BST <int>::iterator it3 = bst.nth(3);
+      custom::BST <int>::iterator it6 = bst.nth(6);
+      // verify
+      assertUnit(*it0 == 20);
+      assertUnit(*it3 == 50);
+      assertUnit(*it6 == 80);
+      assertUnit(it3.pNode == bst.root);
+   }  // teardown
+
+   // past the last one is the end
+   void test_nth_past()
+   {  // setup
+      custom::BST <int> bst{ 50, 30, 70 };
+      custom::BST <int> bstEmpty;
+      // exercise
+      custom::BST <int>::iterator it = bst.nth(3);
+      custom::BST <int>::iterator itEmpty = bstEmpty.nth(0);
+      // verify
+      assertUnit(it == bst.end());
+      assertUnit(itEmpty == bstEmpty.end());
+   }  // teardown
+
+   // rank counts the values less than the one asked for
+   void test_rank_standard()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      // exercise and verify
+      assertUnit(bst.rank(10) == 0);
+      assertUnit(bst.rank(20) == 0);
+      assertUnit(bst.rank(50) == 3);
+      assertUnit(bst.rank(55) == 4);
+      assertUnit(bst.rank(80) == 6);
+      assertUnit(bst.rank(99) == 7);
+   }  // teardown
+
+   // the counts stay right through rotations, erases and copies
+   void test_size_insertErase()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i);
+      // exercise
+      for (int i = 0; i < 1000; i += 3)
+      {
+         auto it = bst.find(i * 7 % 1000);
+         bst.erase(it);
+      }
+      custom::BST <int> bstCopy(bst);
+      // verify
+      bool same = true;
+      size_t k = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++k)
+         same = same && bst.nth(k) == it && bst.rank(*it) == k &&
+                *bstCopy.nth(k) == *it;
+      assertUnit(same);
+      assertUnit(k == 666);
+#if BST_ORDER_STATISTICS
+      assertUnit(sizesValid(bst.root));
+      assertUnit(sizesValid(bstCopy.root));
+#endif // BST_ORDER_STATISTICS
+   }  // teardown
+
+#if BST_ORDER_STATISTICS
+   // does every node count the nodes below it?
+   template <class BNode>
+   static bool sizesValid(const BNode * pNode)
+   {
+      if (pNode == nullptr)
+         return true;
+      return pNode->size == (size_t)pNode->computeSize() &&
+             sizesValid(pNode->pLeft) && sizesValid(pNode->pRight);
+   }
+#endif // BST_ORDER_STATISTICS
+
+   /***************************************
+    * Range
+    *    BST::lower_bound(t)
+    *    BST::upper_bound(t)
+    *    BST::equal_range(t)
+    *    BST::for_each_in_range(lo, hi, fn)
+    ***************************************/
+
+   // the first value not less than the one asked for
+   void test_lowerBound_standard()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      // exercise and verify
+      assertUnit(*bst.lower_bound(10) == 20);
+      assertUnit(*bst.lower_bound(20) == 20);
+      assertUnit(*bst.lower_bound(45) == 50);
+      assertUnit(*bst.lower_bound(50) == 50);
+      assertUnit(*bst.lower_bound(55) == 60);
+      assertUnit(*bst.lower_bound(80) == 80);
+      assertUnit(bst.lower_bound(81) == bst.end());
+   }  // teardown
+
+   // the first value greater than the one asked for
+   void test_upperBound_standard()
+   {  // setup
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      // exercise and verify
+      assertUnit(*bst.upper_bound(10) == 20);
+      assertUnit(*bst.upper_bound(20) == 30);
+      assertUnit(*bst.upper_bound(45) == 50);
+      assertUnit(*bst.upper_bound(50) == 60);
+      assertUnit(*bst.upper_bound(79) == 80);
+      assertUnit(bst.upper_bound(80) == bst.end());
+   }  // teardown
+
+   // every copy of a duplicated value is in the range, and nothing else
+   void test_equalRange_duplicates()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i * 7 % 20);
+      // exercise
+      auto range = bst.equal_range(13);
+      // verify
+      int num = 0;
+      bool allSame = true;
+      for (auto it = range.first; it != range.second; ++it, ++num)
+         allSame = allSame && *it == 13;
+      assertUnit(allSame);
+      assertUnit(num == 5);
+      assertUnit(*range.second == 14);
+      assertUnit(bst.rank(13) == 65);
+      assertUnit(range.first == bst.nth(65));
+   }  // teardown
+
+   // a value that is not there gives an empty range where it would go
+   void test_equalRange_missing()
+   {  // setup
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      // exercise
+      auto range = bst.equal_range(65);
+      auto rangePast = bst.equal_range(99);
+      // verify
+      assertUnit(range.first == range.second);
+      assertUnit(*range.first == 70);
+      assertUnit(rangePast.first == bst.end());
+      assertUnit(rangePast.second == bst.end());
+   }  // teardown
+
+   // [lo, hi) in order: lo is in, hi is out
+   void test_forEachInRange_standard()
+   {  // setup
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      std::vector<int> values;
+      // exercise
+      bst.for_each_in_range(30, 70, [&values](const int & value) { values.push_back(value); });
+      // verify
+      assertUnit(values == std::vector<int>({ 30, 40, 50, 60 }));
+   }  // teardown
+
+   // ranges that miss, are empty, or hold everything
+   void test_forEachInRange_outside()
+   {  // setup
+      custom::BST <int> bst{ 50, 30, 70, 20, 40, 60, 80 };
+      custom::BST <int> bstEmpty;
+      int numBelow = 0;
+      int numAbove = 0;
+      int numEmpty = 0;
+      int numBetween = 0;
+      int numAll = 0;
+      // exercise
+      bst.for_each_in_range(0, 20, [&](const int &) { numBelow++; });
+      bst.for_each_in_range(81, 99, [&](const int &) { numAbove++; });
+      bst.for_each_in_range(55, 55, [&](const int &) { numEmpty++; });
+      bst.for_each_in_range(41, 50, [&](const int &) { numBetween++; });
+      bst.for_each_in_range(0, 99, [&](const int &) { numAll++; });
+      bstEmpty.for_each_in_range(0, 99, [&](const int &) { numEmpty++; });
+      // verify
+      assertUnit(numBelow == 0);
+      assertUnit(numAbove == 0);
+      assertUnit(numEmpty == 0);
+      assertUnit(numBetween == 0);
+      assertUnit(numAll == 7);
+   }  // teardown
+
+   // a narrow window in a big tree sees only its values, and only
+   // compares the values near the path down to it
+   void test_forEachInRange_big()
+   {  // setup
+      custom::BST <Spy> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(Spy(i * 7 % 1000));
+      std::vector<int> values;
+      Spy::reset();
+      // exercise
+      bst.for_each_in_range(Spy(500), Spy(510),
+                            [&values](const Spy & s) { values.push_back(s.get()); });
+      // verify
+      std::vector<int> expect;
+      for (int i = 500; i < 510; i++)
+         expect.push_back(i);
+      assertUnit(values == expect);
+      assertUnit(Spy::numLessthan() < 100);
+   }  // teardown
+
 
 
    /***************************************
@@ -3347,6 +3656,557 @@ public:
       bst.root = nullptr;
    }
 
+   /***************************************
+    * Emplace
+    *    BST::emplace(args...)
+    *    BST::emplace_unique(args...)
+    ***************************************/
+
+   // the value is built right in its node, never copied or moved
+   void test_emplace_inPlace()
+   {  // setup
+      //            (50b)
+      custom::BST <Spy> bst;
+      bst.insert(Spy(50));
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.emplace(30);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);  // build [30]
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [30]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(pairBST.second == true);
+      assertUnit(*(pairBST.first) == Spy(30));
+      //            (50b)
+      //       +-----+
+      //     (30r)
+      assertUnit(bst.root->pLeft != nullptr);
+      if (bst.root->pLeft)
+         assertUnit(bst.root->pLeft->isRed == true);
+      assertUnit(bst.numElements == 2);
+   }  // teardown
+
+   // a duplicate is built, found already there, and thrown away
+   void test_emplaceUnique_duplicate()
+   {  // setup
+      //            (50b)
+      //       +-----+
+      //     (30r)
+      custom::BST <Spy> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.emplace_unique(30);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);  // build [30]
+      assertUnit(Spy::numDestructor() == 1);  // throw [30] away
+      assertUnit(Spy::numDelete() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(pairBST.second == false);
+      assertUnit(pairBST.first.pNode == bst.root->pLeft);
+      assertUnit(bst.numElements == 2);
+   }  // teardown
+
+   /***************************************
+    * Insert with a hint
+    *    BST::insert(it, t)
+    ***************************************/
+
+   // past the last node takes one compare, not a walk from the root
+   void test_insertHint_end()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      custom::BST <Spy> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      Spy s(80);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(bst.end(), s);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [70]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 1);        // copy [80]
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(*it == Spy(80));
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //                          +----+
+      //                              80
+      assertUnit(bst.root->pRight->pRight == it.pNode);
+      assertUnit(bst.numElements == 4);
+   }  // teardown
+
+   // sorted input with the last insert as the hint stays a red-black tree
+   void test_insertHint_sorted()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int>::iterator it = bst.end();
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         it = bst.insert(it, i);
+      // verify
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.root->computeSize() == 1000);
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+      int expect = 0;
+      bool inOrder = true;
+      for (it = bst.begin(); it != bst.end(); ++it)
+         inOrder = inOrder && *it == expect++;
+      assertUnit(inOrder);
+      assertUnit(expect == 1000);
+   }  // teardown
+
+   // so does reverse-sorted input
+   void test_insertHint_reverse()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int>::iterator it = bst.end();
+      // exercise
+      for (int i = 999; i >= 0; i--)
+         it = bst.insert(it, i);
+      // verify
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.root->computeSize() == 1000);
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+      int expect = 0;
+      bool inOrder = true;
+      for (it = bst.begin(); it != bst.end(); ++it)
+         inOrder = inOrder && *it == expect++;
+      assertUnit(inOrder);
+      assertUnit(expect == 1000);
+   }  // teardown
+
+   // a hint far from the spot is ignored
+   void test_insertHint_wrong()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i += 2)
+         bst.insert(i);
+      // exercise
+      auto itLow  = bst.insert(bst.find(90), 11);
+      auto itHigh = bst.insert(bst.begin(), 51);
+      auto itEnd  = bst.insert(bst.end(), 3);
+      // verify
+      assertUnit(*itLow == 11);
+      assertUnit(*itHigh == 51);
+      assertUnit(*itEnd == 3);
+      assertUnit(*--itLow == 10);
+      assertUnit(*++itHigh == 52);
+      assertUnit(bst.size() == 53);
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+      int prev = -1;
+      bool inOrder = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+      {
+         inOrder = inOrder && prev < *it;
+         prev = *it;
+      }
+      assertUnit(inOrder);
+   }  // teardown
+
+   // the hint itself is the match, nothing is allocated
+   void test_insertHint_keepUnique()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      custom::BST <Spy> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      auto itHint = bst.find(Spy(30));
+      Spy s(30);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(itHint, s, true /* keepUnique */);
+      // verify
+      assertUnit(Spy::numLessthan() == 2);    // compare [30] both ways
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(it == itHint);
+      assertUnit(bst.numElements == 3);
+   }  // teardown
+
+   /***************************************
+    * Build
+    *    BST::build(first, last)
+    ***************************************/
+
+   // a sorted range links up into a red-black tree of least height
+   void test_build_sorted()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i / 2);
+      custom::BST <int> bst;
+      // exercise
+      bst.build(values.begin(), values.end(), true /* keepUnique */);
+      // verify
+      assertUnit(bst.size() == 500);
+      assertUnit(bst.root->computeSize() == 500);
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+      assertUnit(bst.root->findDepth() == 8);   // 2^8 - 1 < 500 < 2^9 - 1
+      assertUnit(bst.root->data == 250);
+      int expect = 0;
+      bool inOrder = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         inOrder = inOrder && *it == expect++;
+      assertUnit(inOrder);
+      assertUnit(expect == 500);
+      assertUnit(bst.insert(bst.end(), 500).pNode == bst.pLast);
+   }  // teardown
+
+   // a range out of order is sorted first, duplicates and all
+   void test_build_unsorted()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i * 7 % 1000 / 2);
+      custom::BST <int> bst;
+      // exercise
+      bst.build(values.begin(), values.end());
+      // verify
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+      int prev = -1;
+      bool inOrder = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+      {
+         inOrder = inOrder && prev <= *it;
+         prev = *it;
+      }
+      assertUnit(inOrder);
+   }  // teardown
+
+   // whatever was in the tree before is gone
+   void test_build_replaces()
+   {  // setup
+      custom::BST <Spy> bst;
+      bst.insert(Spy(99));
+      bst.insert(Spy(98));
+      std::vector<Spy> values{ Spy(10), Spy(20) };
+      Spy::reset();
+      // exercise
+      bst.build(values.begin(), values.end());
+      // verify
+      assertUnit(Spy::numDestructor() == 2);  // [99][98]
+      assertUnit(Spy::numCopy() == 2);        // [10][20]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.root->data == Spy(20));
+      assertUnit(bst.root->isRed == false);
+      assertUnit(bst.root->pLeft->data == Spy(10));
+      assertUnit(bst.root->pLeft->isRed == true);
+      assertUnit(bst.root->pRight == nullptr);
+   }  // teardown
+
+   /***************************************
+    * Set algebra
+    *    BST::unionWith(rhs)
+    *    BST::intersectionWith(rhs)
+    *    BST::differenceWith(rhs)
+    ***************************************/
+
+   // a big tree with every third value joined with a small one with
+   // every fifth: the small one splits the big one a few times
+   void test_union_skewed()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRHS;
+      fillStep(bst, 3000, 3);
+      fillStep(bstRHS, 3000, 50);
+      // exercise
+      bst.unionWith(bstRHS);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(bstRHS.root == nullptr);
+      assertUnit(treeValid(bst, [](int i) { return i % 3 == 0 || i % 50 == 0; }, 3000));
+   }  // teardown
+
+   // the big one on the right this time, with the halves on threads
+   void test_union_parallel()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRHS;
+      fillStep(bst, 5000, 7);
+      fillStep(bstRHS, 5000, 2);
+      // exercise
+      bst.unionWith(bstRHS, 4 /* numThreads */);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(treeValid(bst, [](int i) { return i % 7 == 0 || i % 2 == 0; }, 5000));
+   }  // teardown
+
+   // nodes from another pool cannot be adopted, so they are copied
+   void test_union_otherAllocator()
+   {  // setup
+      custom::BST <int, custom::node_pool<int>> bst;
+      custom::BST <int, custom::node_pool<int>> bstRHS;
+      fillStep(bst, 1000, 2);
+      fillStep(bstRHS, 1000, 3);
+      // exercise
+      bst.unionWith(bstRHS);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(treeValid(bst, [](int i) { return i % 2 == 0 || i % 3 == 0; }, 1000));
+   }  // teardown
+
+   // a value in both keeps the node already here
+   void test_union_duplicateDestroyed()
+   {  // setup
+      custom::BST <Spy> bst;
+      custom::BST <Spy> bstRHS;
+      bst.insert(Spy(10));
+      bst.insert(Spy(20));
+      bstRHS.insert(Spy(20));
+      bstRHS.insert(Spy(30));
+      const Spy * pTwenty = &*bst.find(Spy(20));
+      Spy::reset();
+      // exercise
+      bst.unionWith(bstRHS);
+      // verify
+      assertUnit(Spy::numDestructor() == 1);  // rhs's [20]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(bst.size() == 3);
+      assertUnit(bstRHS.empty());
+      assertUnit(&*bst.find(Spy(20)) == pTwenty);
+      assertUnit(*bst.begin() == Spy(10));
+      assertUnit(*bst.nth(2) == Spy(30));
+   }  // teardown
+
+   // what is left of the big tree is only the values the small one shares
+   void test_intersection_skewed()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRHS;
+      fillStep(bst, 3000, 3);
+      fillStep(bstRHS, 3000, 50);
+      // exercise
+      bst.intersectionWith(bstRHS);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(treeValid(bst, [](int i) { return i % 150 == 0; }, 3000));
+   }  // teardown
+
+   // a small tree meeting a big one on threads
+   void test_intersection_parallel()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRHS;
+      fillStep(bst, 5000, 25);
+      fillStep(bstRHS, 5000, 2);
+      // exercise
+      bst.intersectionWith(bstRHS, 4 /* numThreads */);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(treeValid(bst, [](int i) { return i % 50 == 0; }, 5000));
+   }  // teardown
+
+   // the small tree cuts a few values out of the big one
+   void test_difference_skewed()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRHS;
+      fillStep(bst, 3000, 3);
+      fillStep(bstRHS, 3000, 50);
+      // exercise
+      bst.differenceWith(bstRHS);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(treeValid(bst, [](int i) { return i % 3 == 0 && i % 50 != 0; }, 3000));
+   }  // teardown
+
+   // the big tree cuts most of the small one away, on threads
+   void test_difference_parallel()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRHS;
+      fillStep(bst, 5000, 7);
+      fillStep(bstRHS, 5000, 2);
+      // exercise
+      bst.differenceWith(bstRHS, 4 /* numThreads */);
+      // verify
+      assertUnit(bstRHS.empty());
+      assertUnit(treeValid(bst, [](int i) { return i % 7 == 0 && i % 2 != 0; }, 5000));
+   }  // teardown
+
+   // nothing minus something is nothing, and the something is freed
+   void test_difference_empty()
+   {  // setup
+      custom::BST <Spy> bst;
+      custom::BST <Spy> bstRHS{ Spy(10), Spy(20), Spy(30) };
+      Spy::reset();
+      // exercise
+      bst.differenceWith(bstRHS);
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(bst.empty());
+      assertUnit(bst.root == nullptr);
+      assertUnit(bstRHS.empty());
+      assertUnit(bstRHS.root == nullptr);
+      assertUnit(bst.begin() == bst.end());
+   }  // teardown
+
+   /***************************************
+    * Copy and tear down across threads
+    *    BST::assign(rhs, numThreads)
+    *    BST::clear(numThreads)
+    *    BST::clearDeferred()
+    ***************************************/
+
+   // big enough that the top few levels copy on threads
+   void test_assign_parallel()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstSrc;
+      fillStep(bstSrc, 200000, 2);
+      // exercise
+      bst.assign(bstSrc, 4 /* numThreads */);
+      // verify
+      assertUnit(treeValid(bst, [](int i) { return i % 2 == 0; }, 200000));
+      assertUnit(treeValid(bstSrc, [](int i) { return i % 2 == 0; }, 200000));
+      assertUnit(bst.root != bstSrc.root);
+      assertUnit(bst.root->data == bstSrc.root->data);
+   }  // teardown
+
+   // the nodes already here are reused, the extra ones freed, on threads
+   void test_assign_parallelOverStandard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstSrc;
+      fillStep(bst, 200000, 1);
+      fillStep(bstSrc, 200000, 3);
+      auto pRoot = bst.root;
+      // exercise
+      bst.assign(bstSrc, 4 /* numThreads */);
+      // verify
+      assertUnit(bst.root == pRoot);
+      assertUnit(treeValid(bst, [](int i) { return i % 3 == 0; }, 200000));
+   }  // teardown
+
+   // every value destroyed, on however many threads
+   void test_clear_parallel()
+   {  // setup
+      custom::BST <std::pair<int, std::shared_ptr<int>>> bst;
+      auto token = std::make_shared<int>(0);
+      for (int i = 0; i < 100000; i++)
+         bst.insert(std::make_pair(i, token));
+      // exercise
+      bst.clear(4 /* numThreads */);
+      // verify
+      assertUnit(token.use_count() == 1);
+      assertUnit(bst.empty());
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.begin() == bst.end());
+   }  // teardown
+
+   // the tree is empty at once, and the values go on another thread
+   void test_clearDeferred_standard()
+   {  // setup
+      custom::BST <std::pair<int, std::shared_ptr<int>>> bst;
+      auto token = std::make_shared<int>(0);
+      for (int i = 0; i < 1000; i++)
+         bst.insert(std::make_pair(i, token));
+      // exercise
+      std::future<void> done = bst.clearDeferred();
+      // verify
+      assertUnit(bst.empty());
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.begin() == bst.end());
+      done.wait();
+      assertUnit(token.use_count() == 1);
+      bst.insert(std::make_pair(1, token));   // still a working tree
+      assertUnit(bst.size() == 1);
+   }  // teardown
+
+   // a pool is not ours to free on another thread: cleared right here
+   void test_clearDeferred_pool()
+   {  // setup
+      custom::BST <Spy, custom::node_pool<Spy>> bst{ Spy(10), Spy(20), Spy(30) };
+      Spy::reset();
+      // exercise
+      std::future<void> done = bst.clearDeferred();
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(done.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+      assertUnit(bst.empty());
+      assertUnit(bst.root == nullptr);
+   }  // teardown
+
+   // every step'th value below num, inserted out of order
+   template <class Tree>
+   static void fillStep(Tree & bst, int num, int step)
+   {
+      int numValues = (num + step - 1) / step;
+      for (int i = 0; i < numValues; i++)
+         bst.insert((i * 7919) % numValues * step);
+   }
+
+   // is the tree red-black and in order, holding exactly the values
+   // below num that belong, with its counts and ends right?
+   template <class Tree, class Belongs>
+   static bool treeValid(const Tree & bst, Belongs belongs, int num)
+   {
+      size_t numExpect = 0;
+      for (int i = 0; i < num; i++)
+         numExpect += belongs(i) ? 1 : 0;
+      if (bst.size() != numExpect)
+         return false;
+      if (bst.root == nullptr)
+         return numExpect == 0;
+      if (bst.root->isRed || !bst.root->verifyRedBlack(bst.root->findDepth()) ||
+          blackHeightOf(bst.root) < 0)
+         return false;
+      if (bst.root->pParent != nullptr || bst.root->computeSize() != (int)numExpect)
+         return false;
+#if BST_ORDER_STATISTICS
+      if (!sizesValid(bst.root))
+         return false;
+#endif // BST_ORDER_STATISTICS
+
+      auto it = bst.begin();
+      for (int i = 0; i < num; i++)
+         if (belongs(i))
+         {
+            if (it == bst.end() || *it != i)
+               return false;
+            ++it;
+         }
+      return it == bst.end() &&
+             bst.pFirst->data == *bst.begin() &&
+             bst.pLast->data == *bst.nth(numExpect - 1);
+   }
+
+   // the black nodes on every path down, or -1 if the paths disagree
+   // or a child does not point back to its parent
+   template <class BNode>
+   static int blackHeightOf(const BNode * pNode)
+   {
+      if (pNode == nullptr)
+         return 0;
+      if ((pNode->pLeft && pNode->pLeft->pParent != pNode) ||
+          (pNode->pRight && pNode->pRight->pParent != pNode))
+         return -1;
+      int heightLeft = blackHeightOf(pNode->pLeft);
+      int heightRight = blackHeightOf(pNode->pRight);
+      if (heightLeft < 0 || heightLeft != heightRight)
+         return -1;
+      return heightLeft + (pNode->isRed ? 0 : 1);
+   }
+
    /***************************************
     * Erase
     *    BST::erase(it)
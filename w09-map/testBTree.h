@@ -0,0 +1,444 @@
+/***********************************************************************
+ * Header:
+ *    TEST BTREE
+ * Summary:
+ *    Unit tests for the B-tree engine
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "btree.h"
+#include "node_pool.h"
+#include "map.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+
+class TestBTree : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Insert
+      test_insert_leaf();
+      test_insert_splitRoot();
+      test_insert_duplicate();
+      test_insert_many();
+
+      // Iterate and find
+      test_iterate_backward();
+      test_find_present();
+      test_find_missing();
+      test_bound_everyGap();
+      test_forEachInRange_acrossLeaves();
+
+      // Erase
+      test_erase_leaf();
+      test_erase_internal();
+      test_erase_all();
+
+      // Clear
+      test_clear_destroys();
+      test_clear_pool();
+
+      // Through map
+      test_map_btree();
+
+      report("BTree");
+   }
+
+   typedef custom::BTree<int> Tree;
+   typedef Tree::Node         Node;
+   typedef Tree::Internal     Internal;
+
+   // count the values under pNode, or -1 if a node is out of
+   // order, out of bounds, not where its parent thinks, or a
+   // leaf at the wrong depth
+   template <class BT>
+   static int verify(const typename BT::Node * pNode, bool isRoot, int depth, int & depthLeaf)
+   {
+      if (!isRoot && (pNode->num < BT::MIN || pNode->num > BT::MAX))
+         return -1;
+      for (int i = 1; i < pNode->num; i++)
+         if (pNode->values()[i] < pNode->values()[i - 1])
+            return -1;
+      if (pNode->isLeaf)
+      {
+         if (depthLeaf == -1)
+            depthLeaf = depth;
+         return depthLeaf == depth ? pNode->num : -1;
+      }
+
+      int num = pNode->num;
+      const typename BT::Internal * pInternal = static_cast<const typename BT::Internal *>(pNode);
+      for (int i = 0; i <= pNode->num; i++)
+      {
+         const typename BT::Node * pChild = pInternal->children[i];
+         if (pChild->pParent != pInternal || pChild->iParent != i)
+            return -1;
+         if (i > 0 && pChild->values()[0] < pNode->values()[i - 1])
+            return -1;
+         if (i < pNode->num && pNode->values()[i] < pChild->values()[pChild->num - 1])
+            return -1;
+         int numChild = verify<BT>(pChild, false, depth + 1, depthLeaf);
+         if (numChild < 0)
+            return -1;
+         num += numChild;
+      }
+      return num;
+   }
+   template <class BT>
+   static bool isValid(const BT & tree)
+   {
+      if (tree.root == nullptr)
+         return tree.numElements == 0;
+      int depthLeaf = -1;
+      return verify<BT>(tree.root, true, 0, depthLeaf) == (int)tree.numElements;
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty tree has no nodes at all
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Tree tree;
+      // verify
+      assertUnit(tree.root == nullptr);
+      assertUnit(tree.numElements == 0);
+      assertUnit(tree.begin() == tree.end());
+   }  // teardown
+
+   // a copy has its own nodes with the same values
+   void test_constructCopy_standard()
+   {  // setup
+      Tree treeSrc;
+      for (int i = 0; i < 1000; i++)
+         treeSrc.insert(i * 7 % 1000, true);
+      // exercise
+      Tree treeDest(treeSrc);
+      // verify
+      assertUnit(isValid(treeDest));
+      assertUnit(treeDest.size() == 1000);
+      assertUnit(treeDest.root != treeSrc.root);
+      Tree::iterator itSrc = treeSrc.begin();
+      Tree::iterator itDest = treeDest.begin();
+      bool same = true;
+      for (; itSrc != treeSrc.end(); ++itSrc, ++itDest)
+         same = same && *itSrc == *itDest;
+      assertUnit(same);
+      assertUnit(itDest == treeDest.end());
+   }  // teardown
+
+   // a move takes the nodes
+   void test_constructMove_standard()
+   {  // setup
+      Tree treeSrc;
+      for (int i = 0; i < 500; i++)
+         treeSrc.insert(i, true);
+      Node * pRoot = treeSrc.root;
+      // exercise
+      Tree treeDest(std::move(treeSrc));
+      // verify
+      assertUnit(treeDest.root == pRoot);
+      assertUnit(treeDest.size() == 500);
+      assertUnit(treeSrc.root == nullptr);
+      assertUnit(treeSrc.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // a few values sit in order in one leaf
+   void test_insert_leaf()
+   {  // setup
+      Tree tree;
+      // exercise
+      tree.insert(50);
+      tree.insert(30);
+      auto pairReturn = tree.insert(70);
+      // verify
+      assertUnit(pairReturn.second);
+      assertUnit(*pairReturn.first == 70);
+      assertUnit(tree.root->isLeaf);
+      assertUnit(tree.root->num == 3);
+      assertUnit(tree.root->values()[0] == 30);
+      assertUnit(tree.root->values()[1] == 50);
+      assertUnit(tree.root->values()[2] == 70);
+   }  // teardown
+
+   // one more than a full root splits it around the middle
+   void test_insert_splitRoot()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < Tree::MAX; i++)
+         tree.insert(i);
+      assertUnit(tree.root->isLeaf);
+      // exercise
+      tree.insert(Tree::MAX);
+      // verify
+      assertUnit(!tree.root->isLeaf);
+      assertUnit(tree.root->num == 1);
+      assertUnit(tree.root->values()[0] == Tree::MIN);
+      assertUnit(static_cast<Internal *>(tree.root)->children[0]->num == Tree::MIN);
+      assertUnit(static_cast<Internal *>(tree.root)->children[1]->num == Tree::MIN + 1);
+      assertUnit(isValid(tree));
+   }  // teardown
+
+   // keepUnique finds the one already there
+   void test_insert_duplicate()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 300; i++)
+         tree.insert(i, true);
+      // exercise
+      auto pairReturn = tree.insert(123, true);
+      // verify
+      assertUnit(!pairReturn.second);
+      assertUnit(*pairReturn.first == 123);
+      assertUnit(tree.size() == 300);
+      assertUnit(isValid(tree));
+   }  // teardown
+
+   // many values in a scrambled order stay sorted and balanced
+   void test_insert_many()
+   {  // setup
+      Tree tree;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+         tree.insert(i * 7919 % 20000, true);
+      // verify
+      assertUnit(isValid(tree));
+      assertUnit(tree.size() == 20000);
+      int expect = 0;
+      bool inOrder = true;
+      for (auto it = tree.begin(); it != tree.end(); ++it)
+         inOrder = inOrder && *it == expect++;
+      assertUnit(inOrder);
+      assertUnit(expect == 20000);
+   }  // teardown
+
+   /***************************************
+    * ITERATE AND FIND
+    ***************************************/
+
+   // walking back from the last value visits every one
+   void test_iterate_backward()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(i, true);
+      Tree::iterator it = tree.find(4999);
+      int expect = 4999;
+      bool inOrder = true;
+      // exercise
+      for (; it != tree.end(); --it)
+         inOrder = inOrder && *it == expect--;
+      // verify
+      assertUnit(inOrder);
+      assertUnit(expect == -1);
+   }  // teardown
+
+   // find lands on the value wherever it is
+   void test_find_present()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(i * 2, true);
+      // exercise
+      Tree::iterator itRoot = tree.find(tree.root->values()[0]);
+      Tree::iterator itLeaf = tree.find(9998);
+      // verify
+      assertUnit(itRoot.pNode == tree.root);
+      assertUnit(itLeaf.pNode->isLeaf);
+      assertUnit(*itLeaf == 9998);
+   }  // teardown
+
+   // find gives end when it is not there
+   void test_find_missing()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(i * 2, true);
+      // exercise
+      Tree::iterator it = tree.find(4001);
+      // verify
+      assertUnit(it == tree.end());
+   }  // teardown
+
+   // between every pair of values, and on each, through several levels
+   void test_bound_everyGap()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(i * 2, true);
+      // exercise
+      bool allRight = true;
+      for (int i = -1; i < 9998; i++)
+      {
+         Tree::iterator itLower = tree.lower_bound(i);
+         Tree::iterator itUpper = tree.upper_bound(i);
+         allRight = allRight && *itLower == (i + 1) / 2 * 2 &&
+                                *itUpper == (i + 2) / 2 * 2;
+      }
+      // verify
+      assertUnit(allRight);
+      assertUnit(tree.lower_bound(9999) == tree.end());
+      assertUnit(tree.upper_bound(9998) == tree.end());
+      assertUnit(tree.equal_range(4000).first == tree.find(4000));
+      assertUnit(*tree.equal_range(4000).second == 4002);
+   }  // teardown
+
+   // a window wider than a leaf walks up and down between them
+   void test_forEachInRange_acrossLeaves()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(i * 2, true);
+      int num = 0;
+      int expect = 1000;
+      bool inOrder = true;
+      // exercise
+      tree.for_each_in_range(999, 3001, [&](const int & value)
+         {
+            inOrder = inOrder && value == expect;
+            expect += 2;
+            num++;
+         });
+      // verify
+      assertUnit(inOrder);
+      assertUnit(num == 1001);   // 1000, 1002, ... 3000
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erase from a leaf returns the next value
+   void test_erase_leaf()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 10; i++)
+         tree.insert(i * 10);
+      Tree::iterator it = tree.find(40);
+      // exercise
+      Tree::iterator itNext = tree.erase(it);
+      // verify
+      assertUnit(*itNext == 50);
+      assertUnit(tree.size() == 9);
+      assertUnit(tree.find(40) == tree.end());
+      assertUnit(isValid(tree));
+   }  // teardown
+
+   // erase from an internal node returns the next value too
+   void test_erase_internal()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(i, true);
+      int value = tree.root->values()[0];
+      Tree::iterator it = tree.find(value);
+      assertUnit(it.pNode == tree.root);
+      // exercise
+      Tree::iterator itNext = tree.erase(it);
+      // verify
+      assertUnit(*itNext == value + 1);
+      assertUnit(tree.find(value) == tree.end());
+      assertUnit(isValid(tree));
+   }  // teardown
+
+   // erasing everything, scrambled, borrows and merges down to nothing
+   void test_erase_all()
+   {  // setup
+      Tree tree;
+      for (int i = 0; i < 20000; i++)
+         tree.insert(i, true);
+      bool valid = true;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+      {
+         Tree::iterator it = tree.find(i * 7919 % 20000);
+         tree.erase(it);
+         if (i % 1000 == 0)
+            valid = valid && isValid(tree);
+      }
+      // verify
+      assertUnit(valid);
+      assertUnit(tree.root == nullptr);
+      assertUnit(tree.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * CLEAR
+    ***************************************/
+
+   // clear destroys every value
+   void test_clear_destroys()
+   {  // setup
+      custom::BTree<Spy> tree;
+      for (int i = 0; i < 1000; i++)
+         tree.insert(Spy(i), true);
+      Spy::reset();
+      // exercise
+      tree.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 1000);
+      assertUnit(tree.root == nullptr);
+      assertUnit(tree.size() == 0);
+   }  // teardown
+
+   // with a pool of its own, clear hands back the chunks
+   void test_clear_pool()
+   {  // setup
+      custom::BTree<int, custom::node_pool<int>> tree;
+      for (int i = 0; i < 20000; i++)
+         tree.insert(i, true);
+      assertUnit(tree.leafAlloc.numChunks() > 0);
+      assertUnit(tree.internalAlloc.numChunks() > 0);
+      // exercise
+      tree.clear();
+      // verify
+      assertUnit(tree.leafAlloc.numChunks() == 0);
+      assertUnit(tree.internalAlloc.numChunks() == 0);
+      assertUnit(tree.root == nullptr);
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // a map on a B-tree behaves like one on a BST
+   void test_map_btree()
+   {  // setup
+      typedef custom::pair<int, int> Pair;
+      custom::map<int, int, std::allocator<Pair>, custom::BTree> m;
+      for (int i = 0; i < 1000; i++)
+         m.insert(Pair(i, i * i));
+      // exercise
+      m.erase(10);
+      // verify
+      assertUnit(m.size() == 999);
+      assertUnit(m.find(10) == m.end());
+      assertUnit((*m.find(12)).second == 144);
+      auto it = m.begin();
+      assertUnit((*it).first == 0);
+      assertUnit((*++it).first == 1);
+   }  // teardown
+};
+
+#endif // DEBUG
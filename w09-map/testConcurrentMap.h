@@ -0,0 +1,523 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT MAP
+ * Summary:
+ *    Unit tests for the concurrent map: order and towers on one
+ *    thread, what stays true with many, and when the epochs free
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_map.h"
+#include "epoch.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <atomic>
+#include <cassert>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class TestConcurrentMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializer();
+
+      // Insert
+      test_insert_ordered();
+      test_insert_duplicate();
+      test_insert_threadsDisjoint();
+      test_insert_threadsSameKeys();
+      test_insert_copyThrows();
+
+      // Access
+      test_find_missing();
+      test_lowerBound();
+      test_forEachInRange();
+
+      // Erase
+      test_erase_missing();
+      test_erase_towers();
+      test_erase_destroysAfterCollect();
+      test_erase_threadsMixed();
+      test_iterate_whileWriting();
+
+      // Epoch
+      test_epoch_waitsForReader();
+
+      report("ConcurrentMap");
+   }
+
+   typedef custom::concurrent_map<int, int> CMap;
+   typedef CMap::Node                        Node;
+   typedef custom::pair<int, int>            Pair;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty map is just the head
+   void test_construct_default()
+   {  // setup
+      // exercise
+      CMap m;
+      // verify
+      assertUnit(m.empty());
+      assertUnit(m.size() == 0);
+      assertUnit(m.begin() == m.end());
+      assertUnit(m.pHead->height == custom::CONCURRENT_MAP_MAX_LEVEL);
+      for (int level = 0; level < custom::CONCURRENT_MAP_MAX_LEVEL; level++)
+         assertUnit(m.pHead->next()[level].load() == nullptr);
+   }  // teardown
+
+   // the pairs come back in key order, the first of each key kept
+   void test_construct_initializer()
+   {  // setup
+      // exercise
+      CMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7), Pair(30, 9) };
+      // verify
+      assertUnit(m.size() == 3);
+      assertUnit(keys(m) == std::vector<int>({ 30, 50, 70 }));
+      assertUnit(m.find(30)->second == 3);
+      assertUnit(isValid(m));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // scrambled input comes back sorted, every level in order
+   void test_insert_ordered()
+   {  // setup
+      CMap m;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         m.insert(Pair(i * 7919 % 1000, i));
+      // verify
+      assertUnit(m.size() == 1000);
+      assertUnit(isValid(m));
+      std::vector<int> expect;
+      for (int i = 0; i < 1000; i++)
+         expect.push_back(i);
+      assertUnit(keys(m) == expect);
+      assertUnit(tallest(m) > 4);   // the towers do go up
+   }  // teardown
+
+   // a key that is already there keeps its value
+   void test_insert_duplicate()
+   {  // setup
+      CMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7) };
+      // exercise
+      auto result = m.insert(Pair(30, 99));
+      // verify
+      assertUnit(!result.second);
+      assertUnit(result.first != m.end());
+      assertUnit(result.first->first == 30);
+      assertUnit(result.first->second == 3);
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   // a copy that throws leaves the map as it was and nothing locked
+   void test_insert_copyThrows()
+   {  // setup
+      custom::concurrent_map<int, CopyThrows> m;
+      m.insert(custom::pair<int, CopyThrows>(50, CopyThrows()));
+      custom::pair<int, CopyThrows> pair(30, CopyThrows());
+      bool isThrown = false;
+      CopyThrows::isArmed = true;
+      // exercise
+      try
+      {
+         m.insert(pair);
+      }
+      catch (const std::runtime_error &)
+      {
+         isThrown = true;
+      }
+      CopyThrows::isArmed = false;
+      // verify
+      assertUnit(isThrown);
+      assertUnit(m.size() == 1);
+      assertUnit(!m.pHead->isLocked.load());
+      assertUnit(!m.pHead->next()[0].load()->isLocked.load());
+      assertUnit(m.insert(pair).second);
+      assertUnit(m.size() == 2);
+   }  // teardown
+
+   // throws on copy while isArmed
+   struct CopyThrows
+   {
+      CopyThrows() {}
+      CopyThrows(const CopyThrows &)
+      {
+         if (isArmed)
+            throw std::runtime_error("copy");
+      }
+      static inline bool isArmed = false;
+   };
+
+   // four threads, each its own keys: every one of them lands
+   void test_insert_threadsDisjoint()
+   {  // setup
+      CMap m;
+      const int numThreads = 4;
+      const int numEach = 2000;
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&m, t]()
+         {
+            for (int i = 0; i < numEach; i++)
+               m.insert(Pair(i * numThreads + t, t));
+         });
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(m.size() == numThreads * numEach);
+      assertUnit(isValid(m));
+      bool allThere = true;
+      for (int i = 0; i < numThreads * numEach; i++)
+      {
+         auto it = m.find(i);
+         allThere = allThere && it != m.end() && it->second == i % numThreads;
+      }
+      assertUnit(allThere);
+   }  // teardown
+
+   // four threads racing for the same keys: each key goes in once
+   void test_insert_threadsSameKeys()
+   {  // setup
+      CMap m;
+      const int numThreads = 4;
+      std::atomic<int> numInserted(0);
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&m, &numInserted, t]()
+         {
+            for (int i = 0; i < 1000; i++)
+               if (m.insert(Pair(i, t)).second)
+                  numInserted++;
+         });
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(numInserted == 1000);
+      assertUnit(m.size() == 1000);
+      assertUnit(isValid(m));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // keys between, before and after the ones in the map
+   void test_find_missing()
+   {  // setup
+      CMap m{ Pair(20, 2), Pair(40, 4) };
+      // exercise
+      // verify
+      assertUnit(m.find(10) == m.end());
+      assertUnit(m.find(30) == m.end());
+      assertUnit(m.find(50) == m.end());
+      assertUnit(!m.contains(30));
+      assertUnit(m.contains(40));
+      assertUnit(m.find(20)->second == 2);
+   }  // teardown
+
+   // the first key not less, in every gap
+   void test_lowerBound()
+   {  // setup
+      CMap m;
+      for (int i = 0; i < 100; i++)
+         m.insert(Pair(i * 2, i));
+      // exercise
+      bool allRight = true;
+      for (int k = -1; k < 199; k++)
+      {
+         auto it = m.lower_bound(k);
+         int expect = k < 0 ? 0 : (k + 1) / 2 * 2;
+         allRight = allRight && it != m.end() && it->first == expect;
+      }
+      // verify
+      assertUnit(allRight);
+      assertUnit(m.lower_bound(199) == m.end());
+   }  // teardown
+
+   // [lo, hi), in order, and nothing for an empty range
+   void test_forEachInRange()
+   {  // setup
+      CMap m;
+      for (int i = 0; i < 100; i++)
+         m.insert(Pair(i, i * 10));
+      m.erase(25);
+      std::vector<int> seen;
+      // exercise
+      m.for_each_in_range(20, 30, [&seen](const Pair & pair)
+      {
+         seen.push_back(pair.first);
+      });
+      int numEmpty = 0;
+      m.for_each_in_range(50, 50, [&numEmpty](const Pair &) { numEmpty++; });
+      // verify
+      assertUnit(seen == std::vector<int>({ 20, 21, 22, 23, 24, 26, 27, 28, 29 }));
+      assertUnit(numEmpty == 0);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // nothing there, nothing erased
+   void test_erase_missing()
+   {  // setup
+      CMap m{ Pair(20, 2), Pair(40, 4) };
+      // exercise
+      size_t numErased = m.erase(30);
+      // verify
+      assertUnit(numErased == 0);
+      assertUnit(m.size() == 2);
+      assertUnit(m.erase(20) == 1);
+      assertUnit(m.erase(20) == 0);
+      assertUnit(keys(m) == std::vector<int>({ 40 }));
+   }  // teardown
+
+   // erasing every other key leaves no tower pointing at a gone node
+   void test_erase_towers()
+   {  // setup
+      CMap m;
+      for (int i = 0; i < 1000; i++)
+         m.insert(Pair(i, i));
+      // exercise
+      for (int i = 0; i < 1000; i += 2)
+         m.erase(i);
+      // verify
+      assertUnit(m.size() == 500);
+      assertUnit(isValid(m));
+      std::vector<int> expect;
+      for (int i = 1; i < 1000; i += 2)
+         expect.push_back(i);
+      assertUnit(keys(m) == expect);
+   }  // teardown
+
+   // an erased value lives on until the epochs let it go
+   void test_erase_destroysAfterCollect()
+   {  // setup
+      custom::epoch_domain & domain = custom::epoch_domain::global();
+      for (int i = 0; i < 3; i++)
+         domain.collect();
+      custom::concurrent_map<int, Spy> * pMap = new custom::concurrent_map<int, Spy>;
+      for (int i = 0; i < 10; i++)
+         pMap->insert(custom::pair<int, Spy>(i, Spy(i)));
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 10; i += 2)
+         pMap->erase(i);
+      int numAfterErase = Spy::numDestructor();
+      for (int i = 0; i < 3; i++)
+         domain.collect();
+      int numAfterCollect = Spy::numDestructor();
+      delete pMap;
+      // verify
+      assertUnit(numAfterErase == 0);
+      assertUnit(numAfterCollect == 5);
+      assertUnit(Spy::numDestructor() == 10 + 1);   // the head too
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   // threads inserting and erasing the same keys: whatever is left
+   // is what the last word on each key says
+   void test_erase_threadsMixed()
+   {  // setup
+      CMap m;
+      const int numThreads = 4;
+      const int numKeys = 256;
+      std::atomic<int> balance[numKeys];
+      for (int i = 0; i < numKeys; i++)
+         balance[i] = 0;
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&m, &balance, t]()
+         {
+            uint32_t state = 2463534242u + t;
+            for (int i = 0; i < 20000; i++)
+            {
+               state ^= state << 13;
+               state ^= state >> 17;
+               state ^= state << 5;
+               int k = (int)(state % numKeys);
+               if (state & 0x100)
+               {
+                  if (m.insert(Pair(k, t)).second)
+                     balance[k]++;
+               }
+               else
+                  balance[k] -= (int)m.erase(k);
+            }
+         });
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      bool allBalanced = true;
+      size_t numLeft = 0;
+      for (int k = 0; k < numKeys; k++)
+      {
+         allBalanced = allBalanced && (balance[k] == 0 || balance[k] == 1) &&
+                       m.contains(k) == (balance[k] == 1);
+         numLeft += balance[k];
+      }
+      assertUnit(allBalanced);
+      assertUnit(m.size() == numLeft);
+      assertUnit(isValid(m));
+   }  // teardown
+
+   // a scan running while others write still sees keys in order, and
+   // always sees the ones nobody touches
+   void test_iterate_whileWriting()
+   {  // setup
+      CMap m;
+      for (int i = 0; i < 2000; i += 2)
+         m.insert(Pair(i, i));
+      std::atomic<bool> isDone(false);
+      std::vector<std::thread> writers;
+      for (int t = 0; t < 2; t++)
+         writers.emplace_back([&m, &isDone, t]()
+         {
+            while (!isDone)
+               for (int i = 1 + t * 2; i < 2000; i += 4)
+               {
+                  m.insert(Pair(i, i));
+                  m.erase(i);
+               }
+         });
+      // exercise
+      bool allOrdered = true;
+      bool allEvenSeen = true;
+      for (int scan = 0; scan < 50; scan++)
+      {
+         int numEven = 0;
+         int kPrev = -1;
+         for (auto it = m.begin(); it != m.end(); ++it)
+         {
+            allOrdered = allOrdered && it->first > kPrev;
+            numEven += (it->first % 2 == 0) ? 1 : 0;
+            kPrev = it->first;
+         }
+         allEvenSeen = allEvenSeen && numEven == 1000;
+      }
+      isDone = true;
+      for (auto & thread : writers)
+         thread.join();
+      // verify
+      assertUnit(allOrdered);
+      assertUnit(allEvenSeen);
+      assertUnit(m.size() == 1000);
+      assertUnit(isValid(m));
+   }  // teardown
+
+   /***************************************
+    * EPOCH
+    ***************************************/
+
+   // nothing retired is freed while another thread is still pinned,
+   // and it is once that thread lets go
+   void test_epoch_waitsForReader()
+   {  // setup
+      custom::epoch_domain & domain = custom::epoch_domain::global();
+      static std::atomic<int> numFreed;
+      numFreed = 0;
+      std::atomic<bool> isPinned(false);
+      std::atomic<bool> isReleased(false);
+      std::thread reader([&isPinned, &isReleased]()
+      {
+         custom::epoch_guard guard;
+         isPinned = true;
+         while (!isReleased)
+            std::this_thread::yield();
+      });
+      while (!isPinned)
+         std::this_thread::yield();
+      // exercise
+      {
+         custom::epoch_guard guard;
+         domain.retire(new int(1), [](void * p)
+         {
+            delete static_cast<int *>(p);
+            numFreed++;
+         });
+      }
+      for (int i = 0; i < 5; i++)
+         domain.collect();
+      int numWhilePinned = numFreed;
+      isReleased = true;
+      reader.join();
+      for (int i = 0; i < 3; i++)
+         domain.collect();
+      // verify
+      assertUnit(numWhilePinned == 0);
+      assertUnit(numFreed == 1);
+   }  // teardown
+
+   /***************************************
+    * HELPERS
+    ***************************************/
+
+   // the keys, in order
+   template <class M>
+   static std::vector<int> keys(const M & m)
+   {
+      std::vector<int> values;
+      for (auto it = m.begin(); it != m.end(); ++it)
+         values.push_back((*it).first);
+      return values;
+   }
+
+   // the highest tower in the map
+   static int tallest(const CMap & m)
+   {
+      int height = 0;
+      for (Node * p = m.pHead->next()[0].load(); p; p = p->next()[0].load())
+         height = p->height > height ? p->height : height;
+      return height;
+   }
+
+   // with nobody writing: every level strictly increasing, every
+   // node on it is linked, unmarked, tall enough, and on the bottom
+   // level too, and the bottom level has size() nodes
+   static bool isValid(const CMap & m)
+   {
+      std::set<Node *> bottom;
+      for (Node * p = m.pHead->next()[0].load(); p; p = p->next()[0].load())
+         bottom.insert(p);
+      if (bottom.size() != m.size())
+         return false;
+
+      for (int level = 0; level < custom::CONCURRENT_MAP_MAX_LEVEL; level++)
+      {
+         Node * pPrev = nullptr;
+         for (Node * p = m.pHead->next()[level].load(); p; p = p->next()[level].load())
+         {
+            if (p->isMarked || !p->isLinked || p->isLocked || p->height <= level ||
+                bottom.count(p) == 0 || (pPrev && !(pPrev->data.first < p->data.first)))
+               return false;
+            pPrev = p;
+         }
+      }
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -16,6 +16,10 @@
 #include "testPair.h"      // for the pair unit tests
 #include "testBST.h"       // for the BST unit tests
 #include "testMap.h"       // for the map unit tests
+#include "testNodePool.h"  // for the node pool unit tests
+#include "testBTree.h"     // for the B-tree unit tests
+#include "testPersistentMap.h" // for the persistent map unit tests
+#include "testConcurrentMap.h" // for the concurrent map unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +34,10 @@ int main()
    TestPair().run();
    TestBST().run();
    TestMap().run();
+   TestNodePool().run();
+   TestBTree().run();
+   TestPersistentMap().run();
+   TestConcurrentMap().run();
 #endif // DEBUG
    
    return 0;
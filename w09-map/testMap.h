@@ -42,6 +42,7 @@ public:
       test_constructRange_empty();
       test_constructRange_one();
       test_constructRange_standard();
+      test_constructRange_duplicates();
       test_destructor_empty();
       test_destructor_standard();
 
@@ -101,6 +102,18 @@ public:
       test_insertCopy_standardMiddle();
       test_insertMove_empty();
       test_insertMove_standard();
+      test_insertHint_sorted();
+      test_insertHint_duplicate();
+      test_emplace_duplicate();
+
+      // Order statistics
+      test_nthRank_standard();
+
+      // Range
+      test_range_timeWindow();
+
+      // Set algebra
+      test_union_keepsValue();
 
       // Remove
       test_erase_emptyKey();
@@ -113,6 +126,7 @@ public:
       test_erase_standardRange();
       test_clear_empty();
       test_clear_standard();
+      test_clearDeferred_standard();
 
       // Status
       test_empty_empty();
@@ -578,6 +592,28 @@ public:
       teardownStandardFixture(m);
    }
 
+   // out of order with repeated keys: the first of each key wins
+   void test_constructRange_duplicates()
+   {  // setup
+      std::vector<custom::pair<int, int>> v;
+      for (int i = 0; i < 300; i++)
+         v.push_back(custom::pair<int, int>(i * 7 % 100, i));
+      // exercise
+      custom::map<int, int> m(v.begin(), v.end());
+      // verify
+      assertUnit(m.size() == 100);
+      assertUnit(m.bst.root->verifyRedBlack(m.bst.root->findDepth()));
+      int expect = 0;
+      bool firstWins = true;
+      for (auto it = m.begin(); it != m.end(); ++it)
+      {
+         firstWins = firstWins && (*it).first == expect && (*it).second < 100;
+         expect++;
+      }
+      assertUnit(firstWins);
+      assertUnit(expect == 100);
+   }  // teardown
+
    /***************************************
     * DESTRUCTOR
     ***************************************/
@@ -1361,6 +1397,7 @@ public:
    /***************************************
     * CLEAR
     *     map::clear()
+    *     map::clearDeferred()
     ***************************************/
 
    // clear an empty map
@@ -1412,6 +1449,27 @@ public:
       assertEmptyFixture(m);
    }  // teardown
 
+   // the map is empty at once; the pairs are gone once the future is ready
+   void test_clearDeferred_standard()
+   {  // setup
+      //    "30"     "50"     "70"   = m
+      //   +----+   +----+   +----+
+      //   | 30 | - | 50 | - | 70 |
+      //   +----+   +----+   +----+
+      custom::map<std::string, Spy> m;
+      setupStandardFixture(m);
+      Spy::reset();
+      // exercise
+      std::future<void> done = m.clearDeferred();
+      // verify
+      assertEmptyFixture(m);
+      done.wait();
+      assertUnit(Spy::numDestructor() == 3);  // destroy [50][30][70]
+      assertUnit(Spy::numDelete() == 3);      // delete  [50][30][70]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
 
    /***************************************
     * ITERATOR
@@ -2095,6 +2153,142 @@ public:
       teardownStandardFixture(m);
    }
 
+   // sorted keys with the last insert as the hint
+   void test_insertHint_sorted()
+   {  // setup
+      custom::map<int, int> m;
+      custom::map<int, int>::iterator it = m.end();
+      // exercise
+      for (int i = 0; i < 500; i++)
+         it = m.insert(it, custom::pair<int, int>(i, i * 10));
+      // verify
+      assertUnit(m.size() == 500);
+      assertUnit((*it).first == 499);
+      assertUnit(m.bst.root->verifyRedBlack(m.bst.root->findDepth()));
+      int expect = 0;
+      bool inOrder = true;
+      for (it = m.begin(); it != m.end(); ++it)
+      {
+         inOrder = inOrder && (*it).first == expect && (*it).second == expect * 10;
+         expect++;
+      }
+      assertUnit(inOrder);
+      assertUnit(expect == 500);
+   }  // teardown
+
+   // a hinted insert of a key already here keeps the old value
+   void test_insertHint_duplicate()
+   {  // setup
+      custom::map<int, int> m;
+      custom::map<int, int>::iterator it = m.insert(m.end(), custom::pair<int, int>(1, 1));
+      // exercise
+      it = m.insert(it, custom::pair<int, int>(1, 2));
+      // verify
+      assertUnit(m.size() == 1);
+      assertUnit((*it).first == 1);
+      assertUnit((*it).second == 1);
+   }  // teardown
+
+   // emplace of a key already here keeps the old value
+   void test_emplace_duplicate()
+   {  // setup
+      custom::map<int, int> m;
+      m.emplace(1, 1);
+      // exercise
+      auto result = m.emplace(1, 2);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(m.size() == 1);
+      assertUnit((*result.first).first == 1);
+      assertUnit((*result.first).second == 1);
+   }  // teardown
+
+   // the k-th key and the count of keys below one
+   void test_nthRank_standard()
+   {  // setup
+      custom::map<int, int> m;
+      for (int i = 0; i < 100; i++)
+         m.insert(custom::pair<int, int>(i * 37 % 100, i));
+      // exercise
+      custom::map<int, int>::iterator it = m.nth(42);
+      // verify
+      assertUnit((*it).first == 42);
+      assertUnit((*it).second * 37 % 100 == 42);
+      assertUnit(m.nth(100) == m.end());
+      assertUnit(m.rank(42) == 42);
+      assertUnit(m.rank(-1) == 0);
+      assertUnit(m.rank(100) == 100);
+   }  // teardown
+
+   /***************************************
+    * RANGE
+    *     map::lower_bound(k)
+    *     map::upper_bound(k)
+    *     map::equal_range(k)
+    *     map::for_each_in_range(kLo, kHi, fn)
+    ***************************************/
+
+   // readings keyed by time: one window of them, and the bounds around it
+   void test_range_timeWindow()
+   {  // setup
+      custom::map<int, int> m;
+      for (int i = 0; i < 100; i++)
+         m.insert(custom::pair<int, int>(i * 37 % 100 * 10, i));
+      int num = 0;
+      int expect = 250;
+      bool inOrder = true;
+      // exercise
+      m.for_each_in_range(245, 300, [&](const custom::pair<int, int> & reading)
+         {
+            inOrder = inOrder && reading.first == expect && reading.second * 37 % 100 * 10 == expect;
+            expect += 10;
+            num++;
+         });
+      auto range = m.equal_range(300);
+      // verify
+      assertUnit(inOrder);
+      assertUnit(num == 5);   // 250, 260, 270, 280, 290
+      assertUnit((*m.lower_bound(245)).first == 250);
+      assertUnit((*m.upper_bound(250)).first == 260);
+      assertUnit(m.upper_bound(990) == m.end());
+      assertUnit((*range.first).first == 300);
+      assertUnit((*range.second).first == 310);
+   }  // teardown
+
+   /***************************************
+    * SET ALGEBRA
+    *     map::unionWith(rhs)
+    *     map::intersectionWith(rhs)
+    *     map::differenceWith(rhs)
+    ***************************************/
+
+   // keys in both keep the value from the left
+   void test_union_keepsValue()
+   {  // setup
+      custom::map<int, int> mLeft;
+      custom::map<int, int> mRight;
+      for (int i = 0; i < 100; i += 2)
+         mLeft.insert(custom::pair<int, int>(i, 1));
+      for (int i = 0; i < 100; i += 3)
+         mRight.insert(custom::pair<int, int>(i, 2));
+      custom::map<int, int> mBoth(mLeft);
+      custom::map<int, int> mLeftOnly(mLeft);
+      // exercise
+      mLeft.unionWith(mRight);
+      mBoth.intersectionWith(mRight);
+      mLeftOnly.differenceWith(std::move(mRight));
+      // verify
+      assertUnit(mLeft.size() == 67);   // 50 even + 17 odd threes
+      assertUnit(mBoth.size() == 17);   // multiples of 6
+      assertUnit(mLeftOnly.size() == 33);
+      assertUnit(mRight.empty());
+      assertUnit((*mLeft.find(6)).second == 1);
+      assertUnit((*mLeft.find(9)).second == 2);
+      assertUnit((*mBoth.find(12)).second == 1);
+      assertUnit(mLeftOnly.find(6) == mLeftOnly.end());
+      assertUnit((*mLeftOnly.find(8)).second == 1);
+   }  // teardown
+
 
    /***************************************
     * SQUARE BRACKET
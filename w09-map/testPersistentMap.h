@@ -0,0 +1,470 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT MAP
+ * Summary:
+ *    Unit tests for the persistent map: order, balance, and what the
+ *    snapshots share
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistent_map.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TestPersistentMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializer();
+
+      // Insert
+      test_insert_balanced();
+      test_insert_duplicate();
+      test_insert_noSnapshotInPlace();
+      test_insertOrAssign_replaces();
+
+      // Snapshot
+      test_snapshot_shares();
+      test_snapshot_insertCopiesPath();
+      test_snapshot_eraseCopiesPath();
+      test_snapshot_assignToSelf();
+      test_snapshot_manyAgainstStd();
+
+      // Access
+      test_find_iterates();
+      test_at_missing();
+
+      // Erase and release
+      test_erase_missing();
+      test_erase_all();
+      test_release_lastSnapshot();
+
+      report("PersistentMap");
+   }
+
+   typedef custom::persistent_map<int, int> PMap;
+   typedef PMap::Node                        Node;
+   typedef custom::pair<int, int>            Pair;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty map has no nodes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      PMap m;
+      // verify
+      assertUnit(m.root == nullptr);
+      assertUnit(m.empty());
+      assertUnit(m.size() == 0);
+      assertUnit(m.begin() == m.end());
+   }  // teardown
+
+   // the pairs come back in key order
+   void test_construct_initializer()
+   {  // setup
+      // exercise
+      PMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7), Pair(30, 9) };
+      // verify
+      assertUnit(m.size() == 3);
+      assertUnit(keys(m) == std::vector<int>({ 30, 50, 70 }));
+      assertUnit(m.at(30) == 3);
+      assertUnit(isValid(m));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // sorted input still gives a tree of logarithmic height
+   void test_insert_balanced()
+   {  // setup
+      PMap m;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         m.insert(Pair(i, i * i));
+      // verify
+      assertUnit(m.size() == 1000);
+      assertUnit(isValid(m));
+      assertUnit(m.root->height <= 14);   // 1.44 log2(1000)
+      std::vector<int> expect;
+      for (int i = 0; i < 1000; i++)
+         expect.push_back(i);
+      assertUnit(keys(m) == expect);
+   }  // teardown
+
+   // a key that is already there leaves the value and the nodes alone
+   void test_insert_duplicate()
+   {  // setup
+      PMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7) };
+      PMap mSnapshot(m);
+      Node * pRoot = m.root;
+      // exercise
+      bool inserted = m.insert(Pair(30, 99));
+      // verify
+      assertUnit(!inserted);
+      assertUnit(m.root == pRoot);
+      assertUnit(m.at(30) == 3);
+      assertUnit(pRoot->numRefs == 2);
+   }  // teardown
+
+   // with nobody else looking, an update copies no node
+   void test_insert_noSnapshotInPlace()
+   {  // setup
+      custom::persistent_map<int, Spy> m;
+      for (int i = 0; i < 100; i++)
+         m.insert_or_assign(i, Spy(i));
+      std::set<const void *> nodesBefore = nodes(m.root);
+      Spy::reset();
+      // exercise
+      m.insert_or_assign(50, Spy(500));
+      m.insert_or_assign(100, Spy(100));
+      m.erase(10);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numNondefault() == 2);
+      std::set<const void *> nodesAfter = nodes(m.root);
+      size_t numNew = 0;
+      for (const void * p : nodesAfter)
+         numNew += nodesBefore.count(p) ? 0 : 1;
+      assertUnit(numNew == 1);   // the node for 100
+      assertUnit(m.at(50) == Spy(500));
+      assertUnit(isValid(m));
+   }  // teardown
+
+   // an existing key takes the new value
+   void test_insertOrAssign_replaces()
+   {  // setup
+      PMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7) };
+      // exercise
+      m.insert_or_assign(30, 33);
+      m.insert_or_assign(40, 44);
+      // verify
+      assertUnit(m.size() == 4);
+      assertUnit(m.at(30) == 33);
+      assertUnit(m.at(40) == 44);
+      assertUnit(isValid(m));
+   }  // teardown
+
+   /***************************************
+    * SNAPSHOT
+    ***************************************/
+
+   // a snapshot is one more reference on the root
+   void test_snapshot_shares()
+   {  // setup
+      PMap m;
+      for (int i = 0; i < 100; i++)
+         m.insert(Pair(i, i));
+      // exercise
+      PMap mSnapshot = m.snapshot();
+      // verify
+      assertUnit(mSnapshot.root == m.root);
+      assertUnit(m.root->numRefs == 2);
+      assertUnit(m.root->pLeft->numRefs == 1);
+      assertUnit(mSnapshot.size() == 100);
+   }  // teardown
+
+   // an insert after a snapshot copies the path down and nothing else,
+   // and the snapshot does not see it
+   void test_snapshot_insertCopiesPath()
+   {  // setup
+      PMap m;
+      for (int i = 0; i < 1000; i += 2)
+         m.insert(Pair(i, i));
+      PMap mSnapshot(m);
+      std::set<const void *> nodesBefore = nodes(m.root);
+      // exercise
+      m.insert(Pair(501, 501));
+      // verify
+      size_t numNew = 0;
+      for (const void * p : nodes(m.root))
+         numNew += nodesBefore.count(p) ? 0 : 1;
+      assertUnit(numNew <= (size_t)m.root->height + 2);
+      assertUnit(nodes(mSnapshot.root) == nodesBefore);
+      assertUnit(mSnapshot.size() == 500);
+      assertUnit(!mSnapshot.contains(501));
+      assertUnit(m.size() == 501);
+      assertUnit(m.contains(501));
+      assertUnit(isValid(m));
+      assertUnit(isValid(mSnapshot));
+   }  // teardown
+
+   // so does an erase, rotations and all
+   void test_snapshot_eraseCopiesPath()
+   {  // setup
+      PMap m;
+      for (int i = 0; i < 1000; i++)
+         m.insert(Pair(i, i));
+      PMap mSnapshot(m);
+      std::set<const void *> nodesBefore = nodes(m.root);
+      // exercise
+      m.erase(m.root->data.first);   // two children
+      m.erase(0);                     // a leaf
+      // verify
+      size_t numNew = 0;
+      for (const void * p : nodes(m.root))
+         numNew += nodesBefore.count(p) ? 0 : 1;
+      assertUnit(numNew <= 2 * ((size_t)m.root->height + 2));
+      assertUnit(nodes(mSnapshot.root) == nodesBefore);
+      assertUnit(mSnapshot.size() == 1000);
+      assertUnit(mSnapshot.contains(0));
+      assertUnit(m.size() == 998);
+      assertUnit(!m.contains(0));
+      assertUnit(isValid(m));
+      assertUnit(isValid(mSnapshot));
+   }  // teardown
+
+   // assigning a map to itself keeps its nodes
+   void test_snapshot_assignToSelf()
+   {  // setup
+      PMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7) };
+      PMap & mSame = m;
+      // exercise
+      m = mSame;
+      // verify
+      assertUnit(m.size() == 3);
+      assertUnit(m.root->numRefs == 1);
+      assertUnit(m.at(70) == 7);
+   }  // teardown
+
+   // every snapshot along the way still holds what it held,
+   // whatever came after it
+   void test_snapshot_manyAgainstStd()
+   {  // setup
+      PMap m;
+      std::map<int, int> mStd;
+      std::vector<PMap> snapshots;
+      std::vector<std::map<int, int>> snapshotsStd;
+      unsigned int random = 43;
+      // exercise
+      for (int i = 0; i < 3000; i++)
+      {
+         random = random * 1103515245 + 12345;
+         int key = (int)(random >> 16) % 200;
+         if (random & 0x100)
+         {
+            m.erase(key);
+            mStd.erase(key);
+         }
+         else
+         {
+            m.insert_or_assign(key, i);
+            mStd[key] = i;
+         }
+         if (i % 100 == 0)
+         {
+            snapshots.push_back(m);
+            snapshotsStd.push_back(mStd);
+         }
+      }
+      // verify
+      bool allSame = true;
+      for (size_t i = 0; i < snapshots.size(); i++)
+         allSame = allSame && isValid(snapshots[i]) && same(snapshots[i], snapshotsStd[i]);
+      assertUnit(allSame);
+      assertUnit(same(m, mStd));
+      assertUnit(isValid(m));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find gives an iterator that carries on in order from there
+   void test_find_iterates()
+   {  // setup
+      PMap m;
+      for (int i = 0; i < 100; i++)
+         m.insert(Pair(i * 37 % 100, i));
+      // exercise
+      PMap::iterator it = m.find(42);
+      // verify
+      bool inOrder = true;
+      int expect = 42;
+      for (; it != m.end(); ++it)
+         inOrder = inOrder && it->first == expect++;
+      assertUnit(inOrder);
+      assertUnit(expect == 100);
+      assertUnit(m.find(100) == m.end());
+   }  // teardown
+
+   // at() on a missing key throws
+   void test_at_missing()
+   {  // setup
+      PMap m{ Pair(50, 5) };
+      // exercise
+      try
+      {
+         m.at(40);
+         // verify
+         assertUnit(false);
+      }
+      catch (const std::out_of_range & e)
+      {
+         assertUnit(e.what() == std::string("invalid map<K, T> key"));
+      }
+   }  // teardown
+
+   /***************************************
+    * ERASE AND RELEASE
+    ***************************************/
+
+   // erasing a key that is not there copies nothing, even when shared
+   void test_erase_missing()
+   {  // setup
+      PMap m{ Pair(50, 5), Pair(30, 3), Pair(70, 7) };
+      PMap mSnapshot(m);
+      // exercise
+      size_t num = m.erase(40);
+      // verify
+      assertUnit(num == 0);
+      assertUnit(m.root == mSnapshot.root);
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   // erasing everything, one key at a time, frees every node
+   void test_erase_all()
+   {  // setup
+      custom::persistent_map<int, Spy> m;
+      for (int i = 0; i < 200; i++)
+         m.insert_or_assign(i * 7 % 200, Spy(i));
+      Spy::reset();
+      // exercise
+      bool allValid = true;
+      for (int i = 0; i < 200; i++)
+      {
+         m.erase(i * 13 % 200);
+         allValid = allValid && isValid(m);
+      }
+      // verify
+      assertUnit(allValid);
+      assertUnit(m.empty());
+      assertUnit(m.root == nullptr);
+      assertUnit(Spy::numDestructor() == 200);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   // a node goes when the last map that can reach it does
+   void test_release_lastSnapshot()
+   {  // setup
+      custom::persistent_map<int, Spy> * pMap = new custom::persistent_map<int, Spy>;
+      for (int i = 0; i < 100; i++)
+         pMap->insert_or_assign(i, Spy(i));
+      custom::persistent_map<int, Spy> * pSnapshot = new custom::persistent_map<int, Spy>(*pMap);
+      pMap->insert_or_assign(0, Spy(1000));
+      Spy::reset();
+      // exercise
+      delete pMap;
+      int numAfterFirst = Spy::numDestructor();
+      delete pSnapshot;
+      // verify
+      assertUnit(numAfterFirst == pathLength(100));   // only the copied path
+      assertUnit(Spy::numDestructor() == 100 + pathLength(100));
+   }  // teardown
+
+   /***************************************
+    * HELPERS
+    ***************************************/
+
+   // the keys, in order
+   template <class M>
+   static std::vector<int> keys(const M & m)
+   {
+      std::vector<int> values;
+      for (auto it = m.begin(); it != m.end(); ++it)
+         values.push_back((*it).first);
+      return values;
+   }
+
+   // every node reachable from pNode
+   template <class N>
+   static std::set<const void *> nodes(const N * pNode)
+   {
+      std::set<const void *> found;
+      addNodes(pNode, found);
+      return found;
+   }
+   template <class N>
+   static void addNodes(const N * pNode, std::set<const void *> & found)
+   {
+      if (pNode == nullptr)
+         return;
+      found.insert(pNode);
+      addNodes(pNode->pLeft, found);
+      addNodes(pNode->pRight, found);
+   }
+
+   // how many nodes are on the way down to the smallest key in a
+   // tree built by inserting 0 ... num-1 in order
+   static int pathLength(int num)
+   {
+      PMap m;
+      for (int i = 0; i < num; i++)
+         m.insert(Pair(i, i));
+      int length = 0;
+      for (const Node * pNode = m.root; pNode; pNode = pNode->pLeft)
+         length++;
+      return length;
+   }
+
+   // the height of the subtree, or -1 if it is out of order, out
+   // of balance, or its height field is wrong
+   template <class N>
+   static int verify(const N * pNode, const N * pLow, const N * pHigh)
+   {
+      if (pNode == nullptr)
+         return 0;
+      if ((pLow && !(pLow->data.first < pNode->data.first)) ||
+          (pHigh && !(pNode->data.first < pHigh->data.first)))
+         return -1;
+      if (pNode->numRefs == 0)
+         return -1;
+      int heightLeft = verify(pNode->pLeft, pLow, pNode);
+      int heightRight = verify(pNode->pRight, pNode, pHigh);
+      if (heightLeft < 0 || heightRight < 0 ||
+          heightLeft - heightRight > 1 || heightRight - heightLeft > 1)
+         return -1;
+      int height = 1 + (heightLeft > heightRight ? heightLeft : heightRight);
+      return height == pNode->height ? height : -1;
+   }
+   template <class M>
+   static bool isValid(const M & m)
+   {
+      return verify(m.root, (decltype(m.root))nullptr, (decltype(m.root))nullptr) >= 0 &&
+             nodes(m.root).size() == m.size();
+   }
+
+   // does the persistent map hold exactly what the std::map does?
+   static bool same(const PMap & m, const std::map<int, int> & mStd)
+   {
+      if (m.size() != mStd.size())
+         return false;
+      auto itStd = mStd.begin();
+      for (auto it = m.begin(); it != m.end(); ++it, ++itStd)
+         if (it->first != itStd->first || it->second != itStd->second)
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
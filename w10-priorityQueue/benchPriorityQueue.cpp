@@ -0,0 +1,82 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Time the binary heap layout of priority_queue against the
+ *    cache line and page blocked layouts. Each run pushes N random
+ *    integers and then pops them all.
+ *
+ *       benchPriorityQueue            : 1M, 10M, and 100M elements
+ *       benchPriorityQueue 1000000    : just the one size
+ * Author
+ *    Calvin Bullock, Daniel Malasky
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "priority_queue.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * TIME LAYOUT
+ * Push then pop num random values, returning the seconds for each
+ ***********************************************************************/
+template <class Layout>
+void timeLayout(const char * name, size_t num)
+{
+   custom::priority_queue <int, custom::vector<int>, std::less<int>, Layout> pq;
+   std::mt19937 random(num);
+
+   auto start = steady_clock::now();
+   for (size_t i = 0; i < num; i++)
+      pq.push((int)random());
+   auto middle = steady_clock::now();
+
+   int checksum = 0;
+   while (!pq.empty())
+   {
+      checksum ^= pq.top();
+      pq.pop();
+   }
+   auto finish = steady_clock::now();
+
+   std::cout << std::setw(12) << num
+             << std::setw(16) << name
+             << std::setw(12) << duration<double>(middle - start).count()
+             << std::setw(12) << duration<double>(finish - middle).count()
+             << std::setw(14) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t sizes[] = { 1000000, 10000000, 100000000 };
+   size_t numSizes = 3;
+   if (argc > 1)
+   {
+      sizes[0] = std::strtoull(argv[1], nullptr, 10);
+      numSizes = 1;
+   }
+
+   std::cout << std::fixed << std::setprecision(3);
+   std::cout << std::setw(12) << "elements"
+             << std::setw(16) << "layout"
+             << std::setw(12) << "push (s)"
+             << std::setw(12) << "pop (s)"
+             << std::setw(14) << "checksum" << std::endl;
+
+   for (size_t i = 0; i < numSizes; i++)
+   {
+      timeLayout<custom::heap_binary     >("binary",       sizes[i]);
+      timeLayout<custom::heap_blocked<4> >("line (H=4)",   sizes[i]);
+      timeLayout<custom::heap_blocked<10>>("page (H=10)",  sizes[i]);
+   }
+
+   return 0;
+}
@@ -13,6 +13,8 @@
  *
  *    This will contain the class definition of:
  *        priority_queue          : A class that represents a Priority Queue
+ *        heap_binary             : The classic 2i / 2i+1 heap layout
+ *        heap_blocked            : A B-heap layout where subtrees share a block
  * Author
  *    <your names here>
  ************************************************************************/
@@ -27,16 +29,116 @@ class TestPQueue;    // forward declaration for unit test class
 namespace custom
 {
 
+/*************************************************
+ * HEAP BINARY
+ * The textbook heap layout. Heap indices are base 1:
+ * the children of i sit at 2i and 2i+1.
+ *************************************************/
+struct heap_binary
+{
+   static size_t left  (size_t indexHeap) { return indexHeap * 2;     }
+   static size_t right (size_t indexHeap) { return indexHeap * 2 + 1; }
+   static size_t parent(size_t indexHeap) { return indexHeap / 2;     }
+
+   // every slot holds an element
+   static bool   isPad  (size_t /* indexHeap */) { return false; }
+   static size_t numPads(size_t /* numSlots */)  { return 0;     }
+
+   // the last heap index that can have a child
+   static size_t lastParent(size_t numSlots) { return numSlots / 2; }
+};
+
+/*************************************************
+ * HEAP BLOCKED
+ * A B-heap layout. The container is cut into blocks
+ * of 2^H slots, and each block holds two sibling
+ * subtrees of height H-1 laid out like a little
+ * binary heap (children of slot s at 2s and 2s+1).
+ * Every H-1 levels of percolateDown therefore stay
+ * in one block, and both children being compared
+ * are always in the same block. Pick H so a block
+ * is a cache line (H=4 for int) or a page (H=10).
+ *
+ *         block 0             block 1
+ *    +---+---+---+---+   +---+---+---+---+
+ *    |   | 1 | 2 | 3 |   |pad|pad| 6 | 7 |  ...
+ *    +---+---+---+---+   +---+---+---+---+
+ *
+ * Slots 0 and 1 of each block but the first are
+ * padding holding a default-constructed T. Heap
+ * indices are slot numbers, still base 1. Block b
+ * leaf j has the block b * 2^(H-1) + j + 1 under it.
+ *************************************************/
+template <size_t H>
+struct heap_blocked
+{
+   static_assert(H >= 2 && H < 32, "heap_blocked height must be 2..31");
+
+   static const size_t numSlots = size_t(1) << H;       // slots in a block
+   static const size_t mask     = numSlots - 1;         // slot within a block
+   static const size_t numLeaf  = numSlots / 2;         // first leaf, and fan-out
+
+   static size_t left(size_t indexHeap)
+   {
+      size_t is = indexHeap & mask;
+
+      // still inside the block
+      if (is < numLeaf)
+         return indexHeap + is;
+
+      // a block leaf: the children open the next block down
+      size_t ibChild = (indexHeap >> H) * numLeaf + (is - numLeaf) + 1;
+      return (ibChild << H) + 2;
+   }
+
+   static size_t right(size_t indexHeap)
+   {
+      return left(indexHeap) + 1;
+   }
+
+   static size_t parent(size_t indexHeap)
+   {
+      size_t is = indexHeap & mask;
+      size_t ib = indexHeap >> H;
+
+      // still inside the block, or the top of the first block
+      if (is >= 4 || ib == 0)
+         return (ib << H) + (is >> 1);
+
+      // the two roots of a block hang off a leaf of the parent block
+      size_t ibParent = (ib - 1) / numLeaf;
+      size_t isParent = numLeaf + (ib - 1) % numLeaf;
+      return (ibParent << H) + isParent;
+   }
+
+   // slots 0 and 1 of every block after the first are unused
+   static bool isPad(size_t indexHeap)
+   {
+      return indexHeap >= numSlots && (indexHeap & mask) < 2;
+   }
+
+   // number of pads in the slots [1, num]
+   static size_t numPads(size_t num)
+   {
+      return num ? (num >> H) + ((num - 1) >> H) : 0;
+   }
+
+   // the children of a block leaf sit far to the right, so any
+   // slot can be a parent
+   static size_t lastParent(size_t num) { return num; }
+};
+
 /*************************************************
  * P QUEUE
  * Create a priority queue.
  *************************************************/
-template<class T, class Container = custom::vector<T>, class Compare = std::less<T>>
+template<class T, class Container = custom::vector<T>, class Compare = std::less<T>,
+         class Layout = heap_binary>
 class priority_queue
 {
    friend class ::TestPQueue; // give the unit test class access to the privates
-   template <class TT, class CContainer, class CCompare>
-   friend void swap(priority_queue<TT, CContainer, CCompare>& lhs, priority_queue<TT, CContainer, CCompare>& rhs);
+   template <class TT, class CContainer, class CCompare, class LLayout>
+   friend void swap(priority_queue<TT, CContainer, CCompare, LLayout>& lhs, priority_queue<TT, CContainer, CCompare, LLayout>& rhs);
 
 public:
 
@@ -66,12 +168,15 @@ public:
    {
       this->container = std::move(rhs);
       this->compare = c;
+      spread();
       heapify();
    }
    explicit priority_queue (const Compare& c, Container & rhs) 
    {
       this->container = rhs;
       this->compare = c;
+      spread();
+      heapify();
    }
   ~priority_queue() 
    {
@@ -98,7 +203,7 @@ public:
    //
    size_t size()  const 
    { 
-      return this->container.size();
+      return this->container.size() - Layout::numPads(this->container.size());
    }
    bool empty() const 
    { 
@@ -108,6 +213,7 @@ public:
 private:
 
    void heapify();                            // convert the container in to a heap
+   void spread();                             // insert the padding the layout needs
    bool percolateDown(size_t indexHeap);      // fix heap from index down. This is a heap index!
 
    Container container;       // underlying container (probably a vector)
@@ -119,8 +225,8 @@ private:
  * P QUEUE :: TOP
  * Get the maximum item from the heap: the top item.
  ***********************************************/
-template <class T, class Container, class Compare>
-const T & priority_queue <T, Container, Compare> :: top() const
+template <class T, class Container, class Compare, class Layout>
+const T & priority_queue <T, Container, Compare, Layout> :: top() const
 {
    if (!container.empty())
       return container[0];
@@ -132,14 +238,18 @@ const T & priority_queue <T, Container, Compare> :: top() const
  * P QUEUE :: POP
  * Delete the top item from the heap.
  **********************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: pop()
+template <class T, class Container, class Compare, class Layout>
+void priority_queue <T, Container, Compare, Layout> :: pop()
 {
    if (!empty())
    {
       using std::swap;
-      swap(this->container[0], this->container[size() - 1]); // indexArray
+      swap(this->container[0], this->container[this->container.size() - 1]); // indexArray
       this->container.pop_back();
+
+      // never leave padding at the end of the container
+      while (!this->container.empty() && Layout::isPad(this->container.size()))
+         this->container.pop_back();
       percolateDown(1); // indexHeap
    }
 }
@@ -148,21 +258,27 @@ void priority_queue <T, Container, Compare> :: pop()
  * P QUEUE :: PUSH
  * Add a new element to the heap, reallocating as necessary
  ****************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: push(const T & t)
+template <class T, class Container, class Compare, class Layout>
+void priority_queue <T, Container, Compare, Layout> :: push(const T & t)
 {
+   // skip over the padding at the start of a new block
+   while (Layout::isPad(this->container.size() + 1))
+      this->container.push_back(T());
    this->container.push_back(t);
-   size_t indexHeap = size() / 2;
+   size_t indexHeap = Layout::parent(this->container.size());
    while (indexHeap && percolateDown(indexHeap))
-      indexHeap /= 2;
+      indexHeap = Layout::parent(indexHeap);
 }
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: push(T && t)
+template <class T, class Container, class Compare, class Layout>
+void priority_queue <T, Container, Compare, Layout> :: push(T && t)
 {
+   // skip over the padding at the start of a new block
+   while (Layout::isPad(this->container.size() + 1))
+      this->container.push_back(T());
    this->container.push_back(std::move(t));
-   size_t indexHeap = size() / 2;
+   size_t indexHeap = Layout::parent(this->container.size());
    while (indexHeap && percolateDown(indexHeap))
-      indexHeap /= 2;
+      indexHeap = Layout::parent(indexHeap);
 }
 
 /************************************************
@@ -171,27 +287,28 @@ void priority_queue <T, Container, Compare> :: push(T && t)
  * order. Take care of that little detail!
  * Return TRUE if anything changed.
  ************************************************/
-template <class T, class Container, class Compare>
-bool priority_queue <T, Container, Compare> :: percolateDown(size_t indexHeap)
+template <class T, class Container, class Compare, class Layout>
+bool priority_queue <T, Container, Compare, Layout> :: percolateDown(size_t indexHeap)
 {
    // heap index is base 1
    using std::swap;
 
    size_t indexPQ = indexHeap - 1;
+   size_t numSlots = container.size();
 
    // find left and right child of indexHeap
-   size_t indexLeft = indexHeap * 2;
-   size_t indexRight = indexLeft+ 1;
+   size_t indexLeft = Layout::left(indexHeap);
+   size_t indexRight = Layout::right(indexHeap);
 
    // find which child is bigger, the right or the left child
    size_t indexBigger = 0;
-   if (indexRight <= size() && compare(container[indexLeft - 1], container[indexRight - 1]))
+   if (indexRight <= numSlots && compare(container[indexLeft - 1], container[indexRight - 1]))
       indexBigger = indexRight;
    else
       indexBigger = indexLeft;
 
    // if the bigger child is greater than parent, then swap
-   if (indexBigger <= size() && compare(container[indexPQ], container[indexBigger - 1]))
+   if (indexBigger <= numSlots && compare(container[indexPQ], container[indexBigger - 1]))
    {
       swap(container[indexPQ], container[indexBigger - 1]);
       percolateDown(indexBigger);
@@ -205,22 +322,45 @@ bool priority_queue <T, Container, Compare> :: percolateDown(size_t indexHeap)
  * P QUEUE :: HEAPIFY
  * Turn the container into a heap.
  ************************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> ::heapify()
+template <class T, class Container, class Compare, class Layout>
+void priority_queue <T, Container, Compare, Layout> ::heapify()
 {
    if (!empty())
-      for (size_t indexHeap = size() / 2; indexHeap >= 1; indexHeap--)
-         percolateDown(indexHeap);
+      for (size_t indexHeap = Layout::lastParent(container.size()); indexHeap >= 1; indexHeap--)
+         if (!Layout::isPad(indexHeap))
+            percolateDown(indexHeap);
 
 }
 
+/************************************************
+ * P QUEUE :: SPREAD
+ * A container handed to us is packed. Move the
+ * elements out to their slots, leaving room for
+ * the padding the layout wants.
+ ************************************************/
+template <class T, class Container, class Compare, class Layout>
+void priority_queue <T, Container, Compare, Layout> ::spread()
+{
+   if (Layout::numPads(container.size()) == 0)
+      return;
+
+   Container spread;
+   for (size_t i = 0; i < container.size(); i++)
+   {
+      while (Layout::isPad(spread.size() + 1))
+         spread.push_back(T());
+      spread.push_back(std::move(container[i]));
+   }
+   container = std::move(spread);
+}
+
 /************************************************
  * SWAP
  * Swap the contents of two priority queues
  ************************************************/
-template <class T, class Container, class Compare>
-inline void swap(custom::priority_queue <T, Container, Compare> & lhs,
-                 custom::priority_queue <T, Container, Compare> & rhs)
+template <class T, class Container, class Compare, class Layout>
+inline void swap(custom::priority_queue <T, Container, Compare, Layout> & lhs,
+                 custom::priority_queue <T, Container, Compare, Layout> & rhs)
 {
    std::swap(lhs.container, rhs.container);
    std::swap(lhs.compare, rhs.compare);
@@ -92,6 +92,14 @@ public:
       test_heapify_oneLevel();
       test_heapify_twoLevels();
 
+      // Layout
+      test_blocked_pads();
+      test_blocked_navigate();
+      test_blocked_push_standard();
+      test_blocked_pop_standard();
+      test_blocked_heapify_standard();
+      test_blocked_heapify_copy();
+
       report("PQueue");
    }
 
@@ -1175,6 +1183,151 @@ public:
       pq.container.clear();
    }
 
+   /***************************************
+    * BLOCKED LAYOUT
+    ***************************************/
+
+   // the padding at the front of each block
+   void test_blocked_pads()
+   {  // setup
+      //         block 0             block 1             block 2
+      //    +---+---+---+---+   +---+---+---+---+   +---+---+---+---+
+      //    |   | 1 | 2 | 3 |   |pad|pad| 6 | 7 |   |pad|pad| 10| 11|
+      //    +---+---+---+---+   +---+---+---+---+   +---+---+---+---+
+      typedef custom::heap_blocked<2> Blocked;
+      // exercise and verify
+      assertUnit(!Blocked::isPad(1));
+      assertUnit(!Blocked::isPad(3));
+      assertUnit(Blocked::isPad(4));
+      assertUnit(Blocked::isPad(5));
+      assertUnit(!Blocked::isPad(6));
+      assertUnit(!Blocked::isPad(7));
+      assertUnit(Blocked::isPad(8));
+      assertUnit(Blocked::numPads(0) == 0);
+      assertUnit(Blocked::numPads(3) == 0);
+      assertUnit(Blocked::numPads(4) == 1);
+      assertUnit(Blocked::numPads(5) == 2);
+      assertUnit(Blocked::numPads(7) == 2);
+      assertUnit(Blocked::numPads(9) == 4);
+      assertUnit(Blocked::numPads(11) == 4);
+   }
+
+   // walk a blocked heap with 8-slot blocks
+   void test_blocked_navigate()
+   {  // setup
+      //                      1
+      //              2               3
+      //          4       5       6       7
+      //       [10 11] [18 19] [26 27] [34 35]
+      //       12..15  20..23  28..31  36..39
+      typedef custom::heap_blocked<3> Blocked;
+      // exercise and verify
+      assertUnit(Blocked::left(1) == 2);
+      assertUnit(Blocked::right(1) == 3);
+      assertUnit(Blocked::left(3) == 6);
+      assertUnit(Blocked::right(3) == 7);
+      assertUnit(Blocked::left(4) == 10);
+      assertUnit(Blocked::right(4) == 11);
+      assertUnit(Blocked::left(5) == 18);
+      assertUnit(Blocked::left(7) == 34);
+      assertUnit(Blocked::left(10) == 12);
+      assertUnit(Blocked::right(11) == 15);
+      assertUnit(Blocked::left(12) == 42);
+      assertUnit(Blocked::parent(1) == 0);
+      assertUnit(Blocked::parent(2) == 1);
+      assertUnit(Blocked::parent(7) == 3);
+      assertUnit(Blocked::parent(10) == 4);
+      assertUnit(Blocked::parent(11) == 4);
+      assertUnit(Blocked::parent(13) == 10);
+      assertUnit(Blocked::parent(19) == 5);
+      assertUnit(Blocked::parent(35) == 7);
+      assertUnit(Blocked::parent(42) == 12);
+   }
+
+   // push 50 elements into a blocked heap
+   void test_blocked_push_standard()
+   {  // setup
+      typedef custom::heap_blocked<2> Blocked;
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, Blocked> pq;
+      // exercise
+      for (int i = 0; i < 50; i++)
+         pq.push((i * 37) % 50);
+      // verify
+      assertUnit(pq.size() == 50);
+      assertUnit(pq.top() == 49);
+      for (size_t indexHeap = 2; indexHeap <= pq.container.size(); indexHeap++)
+         if (!Blocked::isPad(indexHeap))
+            assertUnit(pq.container[Blocked::parent(indexHeap) - 1] >= pq.container[indexHeap - 1]);
+      // teardown
+      pq.container.clear();
+   }
+
+   // pop everything out of a blocked heap
+   void test_blocked_pop_standard()
+   {  // setup
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, custom::heap_blocked<3>> pq;
+      for (int i = 0; i < 100; i++)
+         pq.push((i * 37) % 100);
+      // exercise
+      bool sorted = true;
+      for (int expected = 99; expected >= 0; expected--)
+      {
+         sorted = sorted && (pq.top() == expected);
+         pq.pop();
+      }
+      // verify
+      assertUnit(sorted);
+      assertUnit(pq.empty());
+   }
+
+   // heapify a blocked heap
+   void test_blocked_heapify_standard()
+   {  // setup
+      typedef custom::heap_blocked<2> Blocked;
+      custom::vector<int> v;
+      for (int i = 0; i < 40; i++)
+         v.push_back(i);
+      // exercise
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, Blocked> pq(std::less<int>(), std::move(v));
+      // verify
+      assertUnit(pq.size() == 40);
+      assertUnit(pq.top() == 39);
+      for (size_t indexHeap = 2; indexHeap <= pq.container.size(); indexHeap++)
+         if (!Blocked::isPad(indexHeap))
+            assertUnit(pq.container[Blocked::parent(indexHeap) - 1] >= pq.container[indexHeap - 1]);
+      // teardown
+      pq.container.clear();
+   }
+
+   // heapify a copy of a packed container into a blocked heap
+   void test_blocked_heapify_copy()
+   {  // setup
+      typedef custom::heap_blocked<2> Blocked;
+      custom::vector<int> v;
+      for (int i = 0; i < 40; i++)
+         v.push_back(i);
+      // exercise
+      custom::priority_queue <int, custom::vector<int>, std::less<int>, Blocked> pq(std::less<int>(), v);
+      // verify
+      assertUnit(v.size() == 40);
+      assertUnit(pq.size() == 40);
+      assertUnit(pq.container.size() == 40 + Blocked::numPads(pq.container.size()));
+      assertUnit(pq.top() == 39);
+      for (size_t indexHeap = 2; indexHeap <= pq.container.size(); indexHeap++)
+         if (!Blocked::isPad(indexHeap))
+            assertUnit(pq.container[Blocked::parent(indexHeap) - 1] >= pq.container[indexHeap - 1]);
+      bool sorted = true;
+      for (int expected = 39; expected >= 0; expected--)
+      {
+         sorted = sorted && (pq.top() == expected);
+         pq.pop();
+      }
+      assertUnit(sorted);
+      assertUnit(pq.empty());
+      // teardown
+      pq.container.clear();
+   }
+
    /***************************************
     * TOP
     ***************************************/
@@ -0,0 +1,125 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Push/pop churn through the deque on std::list and on the
+ *    segmented block engine. Counts every allocation through a
+ *    replaced operator new, so the table shows the calls to the
+ *    allocator and the peak bytes held as well as the time.
+ *
+ *       benchDeque                  : 10M operations, a window of 1000
+ *       benchDeque 1000000 100000   : operations, window size
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "deque.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * ALLOCATION COUNTING
+ * Every new goes through here. The size is stored in front of the
+ * block so delete can take it back off the total
+ ***********************************************************************/
+static size_t numAllocs = 0;
+static size_t numBytesLive = 0;
+static size_t numBytesPeak = 0;
+
+void * operator new(size_t size)
+{
+   size_t * p = (size_t *)std::malloc(size + sizeof(max_align_t));
+   if (!p)
+      throw std::bad_alloc();
+   *p = size;
+   numAllocs++;
+   numBytesLive += size;
+   if (numBytesLive > numBytesPeak)
+      numBytesPeak = numBytesLive;
+   return (char *)p + sizeof(max_align_t);
+}
+
+void operator delete(void * pUser) noexcept
+{
+   if (!pUser)
+      return;
+   size_t * p = (size_t *)((char *)pUser - sizeof(max_align_t));
+   numBytesLive -= *p;
+   std::free(p);
+}
+
+void operator delete(void * pUser, size_t) noexcept
+{
+   operator delete(pUser);
+}
+
+/**********************************************************************
+ * TIME CHURN
+ * Fill a window, then push at one end and pop at the other num
+ * times. Queue churns back to front; alternate swaps the ends
+ * every window so both directions get used
+ ***********************************************************************/
+template <class Deque>
+void timeChurn(const char * name, size_t num, size_t numWindow)
+{
+   numAllocs = 0;
+   numBytesPeak = numBytesLive;
+   size_t numBytesBase = numBytesLive;
+   long long checksum = 0;
+   auto start = steady_clock::now();
+   {
+      Deque d;
+      for (size_t i = 0; i < numWindow; i++)
+         d.push_back((int)i);
+
+      for (size_t i = 0; i < num; i++)
+      {
+         if ((i / numWindow) % 2 == 0)
+         {
+            d.push_back((int)i);
+            checksum += d.front();
+            d.pop_front();
+         }
+         else
+         {
+            d.push_front((int)i);
+            checksum += d.back();
+            d.pop_back();
+         }
+      }
+   }
+   double seconds = duration<double>(steady_clock::now() - start).count();
+
+   std::cout << std::setw(22) << name
+             << std::setw(12) << seconds * 1.0e9 / (double)num
+             << std::setw(14) << numAllocs
+             << std::setw(14) << (numBytesPeak - numBytesBase)
+             << std::setw(20) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t num       = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+   size_t numWindow = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000;
+
+   std::cout << std::fixed << std::setprecision(2);
+   std::cout << std::setw(22) << "container"
+             << std::setw(12) << "ns/op"
+             << std::setw(14) << "allocations"
+             << std::setw(14) << "peak bytes"
+             << std::setw(20) << "checksum" << std::endl;
+
+   timeChurn<custom::deque<int>>                                   ("std::list",      num, numWindow);
+   timeChurn<custom::deque<int, custom::segmented<int>>>           ("segmented 64",   num, numWindow);
+   timeChurn<custom::deque<int, custom::segmented<int, 512>>>      ("segmented 512",  num, numWindow);
+
+   return 0;
+}
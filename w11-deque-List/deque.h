@@ -11,8 +11,8 @@
  *     `.______.'  \______.' /_/
  *
  *    This will contain the class definition of:
- *        deque                 : A class that represents a binary search tree
- *        deque::iterator       : An iterator through BST
+ *        deque                 : A class that represents a deque
+ *        deque::iterator       : An iterator through a deque
  * Author
  *    <your names here>
  ************************************************************************/
@@ -21,7 +21,10 @@
 
 // Debug stuff
 #include <cassert>  // for assert()
+#include <cstddef>  // for size_t
 #include <list>     // for std::list
+#include <utility>  // for std::move
+#include "segmented.h"
 
 class TestDeque;    // forward declaration for TestDeque unit test class
 
@@ -30,8 +33,14 @@ namespace custom
 
 /******************************************************
  * DEQUE
+ * An adapter, like std::queue: Container holds the
+ * elements and needs front, back, push and pop at both
+ * ends, size, and bidirectional iterators. std::list
+ * allocates a node for every element; segmented keeps
+ * them in reusable blocks:
+ *    custom::deque<int, custom::segmented<int>>
  *****************************************************/
-template <typename T>
+template <typename T, typename Container = std::list<T>>
 class deque
 {
    friend class ::TestDeque; // give unit tests access to the privates
@@ -66,11 +75,11 @@ public:
    class iterator;
    iterator begin() 
    { 
-      return iterator(); 
+      return iterator(container.begin()); 
    }
    iterator end()   
    { 
-      return iterator(); 
+      return iterator(container.end()); 
    }
 
    // 
@@ -139,7 +148,7 @@ public:
    bool   empty() const { return container.size() == 0; }
    
 private:
-   std::list <T> container;
+   Container container;
 };
 
 /**************************************************
@@ -153,8 +162,8 @@ private:
  * This particular iterator is a bi-directional meaning
  * that ++ and -- both work.  Not all iterators are that way.
  *************************************************/
-template <typename T>
-class deque <T> ::iterator
+template <typename T, typename Container>
+class deque <T, Container> ::iterator
 {
    friend class ::TestDeque; // give unit tests access to the privates
 public:
@@ -164,7 +173,7 @@ public:
    iterator() 
    {
    }
-   iterator(typename const std::list<T>::iterator& itList) 
+   iterator(const typename Container::iterator& itList) 
    {
       it = itList;
    }
@@ -223,7 +232,7 @@ public:
    }
 
 private:
-   typename std::list<T>::iterator it;
+   typename Container::iterator it;
 };
 
 
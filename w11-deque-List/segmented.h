@@ -0,0 +1,325 @@
+/***********************************************************************
+ * Header:
+ *    SEGMENTED
+ * Summary:
+ *    A sequence stored in fixed-size blocks, for the deque to sit on
+ *    in place of std::list
+ *        ____     _______        __
+ *      .' __ '.  |  _____|   _  / /
+ *      | (__) |  | |____    (_)/ /
+ *      .`____'.  '_.____''.   / / _
+ *     | (____) | | \____) |  / / (_)
+ *     `.______.'  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        segmented             : A ring of blocks of elements
+ *        segmented::iterator   : An iterator through the blocks
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>           // for assert()
+#include <cstddef>           // for size_t
+#include <initializer_list>  // for std::initializer_list
+#include <iterator>          // for std::bidirectional_iterator_tag
+#include <memory>            // for std::allocator
+#include <new>               // for placement new
+#include <utility>           // for std::move
+
+class TestSegmented;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/******************************************************
+ * SEGMENTED
+ * The elements live in blocks of NUM_CELLS. The map of
+ * block pointers is a ring of numBlocks, and both it
+ * and NUM_CELLS are powers of two, so the ring holds
+ * numBlocks * NUM_CELLS cells and element i is at cell
+ * (iaFront + i) masked by that. We grow before the back
+ * could wrap into the front's block, so every block
+ * holds one contiguous run.
+ *
+ * A block stays in its slot of the map once allocated,
+ * so a queue that churns at both ends reuses the same
+ * blocks forever. They are only freed with the
+ * container (or by shrink_to_fit).
+ *****************************************************/
+template <typename T, size_t NUM_CELLS = 64, typename A = std::allocator<T>>
+class segmented
+{
+   static_assert(NUM_CELLS > 0 && (NUM_CELLS & (NUM_CELLS - 1)) == 0,
+                 "segmented NUM_CELLS must be a power of two");
+
+   friend class ::TestSegmented; // give unit tests access to the privates
+
+   template <class U, class S>
+   class basic_iterator;
+
+public:
+
+   typedef T value_type;
+   typedef basic_iterator<T, segmented> iterator;
+   typedef basic_iterator<const T, const segmented> const_iterator;
+
+   //
+   // Construct
+   //
+   segmented(const A & a = A()) : alloc(a), data(nullptr), numBlocks(0),
+                                  iaFront(0), numElements(0) {}
+   segmented(std::initializer_list<T> il) : segmented()
+   {
+      *this = il;
+   }
+   segmented(const segmented & rhs) : segmented(rhs.alloc)
+   {
+      *this = rhs;
+   }
+   segmented(segmented && rhs) : segmented(rhs.alloc)
+   {
+      swap(rhs);
+   }
+   ~segmented()
+   {
+      clear();
+      shrink_to_fit();
+   }
+
+   //
+   // Assign
+   //
+   segmented & operator = (const segmented & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         for (size_t i = 0; i < rhs.numElements; i++)
+            push_back(rhs[i]);
+      }
+      return *this;
+   }
+   segmented & operator = (segmented && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   segmented & operator = (std::initializer_list<T> il)
+   {
+      clear();
+      for (const T & t : il)
+         push_back(t);
+      return *this;
+   }
+   void swap(segmented & rhs)
+   {
+      std::swap(data,        rhs.data);
+      std::swap(numBlocks,   rhs.numBlocks);
+      std::swap(iaFront,     rhs.iaFront);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Iterator
+   //
+   iterator       begin()       { return iterator(this, 0);                 }
+   iterator       end()         { return iterator(this, numElements);       }
+   const_iterator begin() const { return const_iterator(this, 0);           }
+   const_iterator end()   const { return const_iterator(this, numElements); }
+
+   //
+   // Access
+   //
+   T & operator [] (size_t i)             { return *cell(i); }
+   const T & operator [] (size_t i) const { return *cell(i); }
+   T & front()             { assert(numElements != 0); return *cell(0);               }
+   const T & front() const { assert(numElements != 0); return *cell(0);               }
+   T & back()              { assert(numElements != 0); return *cell(numElements - 1); }
+   const T & back() const  { assert(numElements != 0); return *cell(numElements - 1); }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t)  { new ((void*)slotBack()) T(t);             numElements++; }
+   void push_back(T && t)       { new ((void*)slotBack()) T(std::move(t));  numElements++; }
+   void push_front(const T & t) { new ((void*)slotFront()) T(t);            numElements++; }
+   void push_front(T && t)      { new ((void*)slotFront()) T(std::move(t)); numElements++; }
+
+   //
+   // Remove
+   //
+   void pop_back()
+   {
+      assert(numElements != 0);
+      cell(numElements - 1)->~T();
+      numElements--;
+   }
+   void pop_front()
+   {
+      assert(numElements != 0);
+      cell(0)->~T();
+      iaFront = (iaFront + 1) & (numBlocks * NUM_CELLS - 1);
+      numElements--;
+   }
+   void clear()
+   {
+      for (size_t i = 0; i < numElements; i++)
+         cell(i)->~T();
+      numElements = 0;
+   }
+
+   // free the blocks that hold no elements, and the map when empty
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+   size_t size()  const { return numElements; }
+   bool   empty() const { return numElements == 0; }
+
+private:
+
+   // the cell of element i
+   T * cell(size_t i) const
+   {
+      size_t ia = (iaFront + i) & (numBlocks * NUM_CELLS - 1);
+      return data[ia / NUM_CELLS] + (ia & (NUM_CELLS - 1));
+   }
+
+   // the empty cell past the back, growing and allocating as needed
+   T * slotBack()
+   {
+      reserveOne();
+      size_t ia = (iaFront + numElements) & (numBlocks * NUM_CELLS - 1);
+      return blockAt(ia / NUM_CELLS) + (ia & (NUM_CELLS - 1));
+   }
+
+   // the empty cell before the front, which becomes the front
+   T * slotFront()
+   {
+      reserveOne();
+      iaFront = (iaFront - 1) & (numBlocks * NUM_CELLS - 1);
+      return blockAt(iaFront / NUM_CELLS) + (iaFront & (NUM_CELLS - 1));
+   }
+
+   // the block in slot ib of the map, allocated on first use
+   T * blockAt(size_t ib)
+   {
+      if (data[ib] == nullptr)
+         data[ib] = alloc.allocate(NUM_CELLS);
+      return data[ib];
+   }
+
+   // leave a whole block free so the ends never share one
+   void reserveOne()
+   {
+      if (numElements + 1 + NUM_CELLS > numBlocks * NUM_CELLS)
+         reallocate(numBlocks == 0 ? 2 : numBlocks * 2);
+   }
+
+   void reallocate(size_t numBlocksNew);
+
+   A alloc;               // use allocator for memory allocation
+   T ** data;             // the map: a ring of block pointers
+   size_t numBlocks;      // slots in the map, a power of two
+   size_t iaFront;        // cell of the front in the ring
+   size_t numElements;    // number of elements
+};
+
+/**************************************************
+ * SEGMENTED ITERATOR
+ * A position in the sequence. U is T or const T
+ *************************************************/
+template <typename T, size_t NUM_CELLS, typename A>
+template <class U, class S>
+class segmented <T, NUM_CELLS, A> ::basic_iterator
+{
+   friend class ::TestSegmented;
+   friend class segmented;
+public:
+   typedef std::bidirectional_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef ptrdiff_t                       difference_type;
+   typedef U *                             pointer;
+   typedef U &                             reference;
+
+   basic_iterator() : p(nullptr), i(0) {}
+   basic_iterator(S * p, size_t i) : p(p), i(i) {}
+
+   bool operator == (const basic_iterator & rhs) const { return i == rhs.i && p == rhs.p; }
+   bool operator != (const basic_iterator & rhs) const { return !(*this == rhs); }
+
+   U & operator * () const { return (*p)[i]; }
+   U * operator -> () const { return &(*p)[i]; }
+
+   basic_iterator & operator ++ ()    { ++i; return *this; }
+   basic_iterator   operator ++ (int) { basic_iterator temp = *this; ++i; return temp; }
+   basic_iterator & operator -- ()    { --i; return *this; }
+   basic_iterator   operator -- (int) { basic_iterator temp = *this; --i; return temp; }
+
+private:
+   S * p;        // the container
+   size_t i;     // index of the element
+};
+
+/*****************************************
+ * SEGMENTED :: SHRINK TO FIT
+ * Hand back every block holding no element
+ ****************************************/
+template <typename T, size_t NUM_CELLS, typename A>
+void segmented <T, NUM_CELLS, A> ::shrink_to_fit()
+{
+   if (numBlocks == 0)
+      return;
+
+   size_t mask = numBlocks * NUM_CELLS - 1;
+   size_t ibFront = iaFront / NUM_CELLS;
+   size_t ibBack = ((iaFront + numElements - 1) & mask) / NUM_CELLS;
+   size_t numUsed = (numElements == 0) ? 0 : ((ibBack - ibFront) & (numBlocks - 1)) + 1;
+
+   // the used blocks run from ibFront for numUsed slots
+   for (size_t ib = 0; ib < numBlocks; ib++)
+   {
+      bool used = ((ib - ibFront) & (numBlocks - 1)) < numUsed;
+      if (!used && data[ib] != nullptr)
+      {
+         alloc.deallocate(data[ib], NUM_CELLS);
+         data[ib] = nullptr;
+      }
+   }
+
+   if (numElements == 0)
+   {
+      delete [] data;
+      data = nullptr;
+      numBlocks = 0;
+      iaFront = 0;
+   }
+}
+
+/*****************************************
+ * SEGMENTED :: REALLOCATE
+ * A bigger map with the front's block in slot 0.
+ * Every block comes along, used or not, in ring
+ * order, so none are lost
+ ****************************************/
+template <typename T, size_t NUM_CELLS, typename A>
+void segmented <T, NUM_CELLS, A> ::reallocate(size_t numBlocksNew)
+{
+   T ** dataNew = new T * [numBlocksNew];
+   size_t ibFront = iaFront / NUM_CELLS;
+   for (size_t n = 0; n < numBlocks; n++)
+      dataNew[n] = data[(ibFront + n) & (numBlocks - 1)];
+   for (size_t n = numBlocks; n < numBlocksNew; n++)
+      dataNew[n] = nullptr;
+
+   delete [] data;
+   data = dataNew;
+   numBlocks = numBlocksNew;
+   iaFront &= NUM_CELLS - 1;
+}
+
+} // namespace custom
@@ -13,6 +13,7 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testDeque.h"       // for the deque unit tests
+#include "testSegmented.h"   // for the block engine unit tests
 
 /**********************************************************************
  * MAIN
@@ -23,6 +24,7 @@ int main()
 #ifdef DEBUG
    // unit tests
    TestDeque().run();
+   TestSegmented().run();
 #endif // DEBUG
    
    return 0;
@@ -0,0 +1,255 @@
+/***********************************************************************
+ * Header:
+ *    TEST SEGMENTED
+ * Summary:
+ *    Unit tests for the block engine under the deque
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "segmented.h"
+#include "deque.h"
+#include "unitTest.h"
+
+#include <deque>
+
+class TestSegmented : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_constructCopy_wrapped();
+
+      // Insert
+      test_pushback_firstBlock();
+      test_pushfront_wrap();
+      test_realloc_wrapped();
+
+      // Remove
+      test_churn_reusesBlocks();
+      test_shrink_freesUnused();
+
+      // As the deque's container
+      test_deque_pushPopBoth();
+
+      report("Segmented");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // default constructor, no allocations
+   void test_construct_default()
+   {  // exercise
+      custom::segmented<int, 4> s;
+      // verify
+      assertUnit(s.data == nullptr);
+      assertUnit(s.numBlocks == 0);
+      assertUnit(s.numElements == 0);
+      assertUnit(s.empty());
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // fill from a list of values
+   void test_construct_initializerList()
+   {  // exercise
+      custom::segmented<int, 4> s = { 11, 26, 31 };
+      // verify
+      assertUnit(s.size() == 3);
+      assertUnit(s.front() == 11);
+      assertUnit(s[1] == 26);
+      assertUnit(s.back() == 31);
+   }  // teardown
+
+   // copying a wrapped sequence unwraps it
+   void test_constructCopy_wrapped()
+   {  // setup
+      custom::segmented<int, 4> sSrc;
+      for (int i = 5; i < 9; i++)
+         sSrc.push_back(i);
+      for (int i = 4; i >= 0; i--)
+         sSrc.push_front(i);
+      // exercise
+      custom::segmented<int, 4> sDes(sSrc);
+      // verify
+      assertUnit(sDes.size() == 9);
+      bool same = true;
+      int i = 0;
+      for (auto it = sDes.begin(); it != sDes.end(); ++it)
+         same = same && *it == i++;
+      assertUnit(same);
+      assertUnit(sDes.iaFront == 0);
+      assertUnit(sSrc.iaFront != 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first push makes a map of two slots and one block
+   void test_pushback_firstBlock()
+   {  // exercise
+      custom::segmented<int, 4> s;
+      s.push_back(99);
+      // verify
+      assertUnit(s.numBlocks == 2);
+      assertUnit(s.data[0] != nullptr);
+      assertUnit(s.data[1] == nullptr);
+      assertUnit(s.data[0][0] == 99);
+      assertUnit(s.iaFront == 0);
+   }  // teardown
+
+   // push_front from cell 0 wraps to the last cell of the ring
+   void test_pushfront_wrap()
+   {  // setup
+      custom::segmented<int, 4> s;
+      s.push_back(26);
+      // exercise
+      s.push_front(11);
+      // verify
+      assertUnit(s.iaFront == 7);
+      assertUnit(s.data[1] != nullptr);
+      assertUnit(s.data[1][3] == 11);
+      assertUnit(s.front() == 11);
+      assertUnit(s.back() == 26);
+   }  // teardown
+
+   // growing the map puts the front's block first and keeps the order
+   void test_realloc_wrapped()
+   {  // setup
+      custom::segmented<int, 4> s;
+      s.push_back(2);
+      s.push_back(3);
+      s.push_back(4);
+      s.push_front(1);
+      int * pFrontBlock = s.data[1];
+      int * pBackBlock = s.data[0];
+      // exercise
+      s.push_front(0);     // 4 + 1 + 4 > 8 cells: grow
+      // verify
+      assertUnit(s.numBlocks == 4);
+      assertUnit(s.data[0] == pFrontBlock);
+      assertUnit(s.data[1] == pBackBlock);
+      assertUnit(s.iaFront == 2);
+      assertUnit(s[0] == 0);
+      assertUnit(s[1] == 1);
+      assertUnit(s[2] == 2);
+      assertUnit(s[3] == 3);
+      assertUnit(s[4] == 4);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // a queue that churns keeps using the same blocks
+   void test_churn_reusesBlocks()
+   {  // setup
+      custom::segmented<int, 4> s;
+      for (int i = 0; i < 6; i++)
+         s.push_back(i);
+      for (int i = 0; i < 40; i++)
+      {
+         s.push_back(i);
+         s.pop_front();
+      }
+      size_t numBlocks = s.numBlocks;
+      int * blocks[4] = { s.data[0], s.data[1], s.data[2], s.data[3] };
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         s.push_back(i);
+         s.pop_front();
+      }
+      // verify
+      assertUnit(s.numBlocks == numBlocks);
+      bool sameBlocks = true;
+      for (size_t ib = 0; ib < 4; ib++)
+         sameBlocks = sameBlocks && s.data[ib] == blocks[ib];
+      assertUnit(sameBlocks);
+      assertUnit(s.size() == 6);
+      assertUnit(s.front() == 994);
+      assertUnit(s.back() == 999);
+   }  // teardown
+
+   // shrink_to_fit frees the blocks with no elements
+   void test_shrink_freesUnused()
+   {  // setup
+      custom::segmented<int, 4> s;
+      for (int i = 0; i < 12; i++)
+         s.push_back(i);
+      for (int i = 0; i < 9; i++)
+         s.pop_front();
+      // exercise
+      s.shrink_to_fit();
+      // verify
+      assertUnit(s.data[0] == nullptr);
+      assertUnit(s.data[1] == nullptr);
+      assertUnit(s.data[2] != nullptr);
+      assertUnit(s.data[3] == nullptr);
+      assertUnit(s.front() == 9);
+      assertUnit(s.back() == 11);
+      // exercise
+      s.clear();
+      s.shrink_to_fit();
+      // verify
+      assertUnit(s.data == nullptr);
+      assertUnit(s.numBlocks == 0);
+   }  // teardown
+
+   /***************************************
+    * DEQUE
+    ***************************************/
+
+   // the deque on segmented agrees with std::deque
+   void test_deque_pushPopBoth()
+   {  // setup
+      custom::deque<int, custom::segmented<int, 4>> d;
+      std::deque<int> dStd;
+      // exercise
+      for (int i = 0; i < 200; i++)
+      {
+         if (i % 3 == 0)
+         {
+            d.push_front(i);
+            dStd.push_front(i);
+         }
+         else
+         {
+            d.push_back(i);
+            dStd.push_back(i);
+         }
+         if (i % 7 == 0 && !dStd.empty())
+         {
+            d.pop_back();
+            dStd.pop_back();
+         }
+         if (i % 5 == 0 && !dStd.empty())
+         {
+            d.pop_front();
+            dStd.pop_front();
+         }
+      }
+      // verify
+      assertUnit(d.size() == dStd.size());
+      bool same = true;
+      auto itStd = dStd.begin();
+      for (auto it = d.begin(); it != d.end(); ++it, ++itStd)
+         same = same && itStd != dStd.end() && *it == *itStd;
+      assertUnit(same);
+      assertUnit(d.front() == dStd.front());
+      assertUnit(d.back() == dStd.back());
+   }  // teardown
+};
+
+#endif // DEBUG
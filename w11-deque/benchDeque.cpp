@@ -0,0 +1,193 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Time random access and iteration through custom::deque against
+ *    std::deque, both element by element and through the segmented
+ *    algorithms, then the block-at-a-time append, prepend, erase, and
+ *    assignment against the same work done one element at a time.
+ *
+ *       benchDeque            : 10M elements
+ *       benchDeque 1000000    : the number of elements to use
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <deque>
+#include <numeric>
+#include <cstdlib>
+#include "deque.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * REPORT
+ * Display one line of the results table
+ ***********************************************************************/
+void report(const char * name, const char * test, double seconds, size_t num, long long checksum)
+{
+   std::cout << std::setw(22) << name
+             << std::setw(12) << test
+             << std::setw(10) << seconds * 1.0e9 / (double)num
+             << std::setw(22) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * TIME DEQUE
+ * Fill a deque with num elements, then read it three ways
+ ***********************************************************************/
+template <class Deque>
+void timeDeque(const char * name, size_t num, const std::vector<int> & indices)
+{
+   Deque d;
+
+   // fill, alternating the ends so the front wraps
+   auto start = steady_clock::now();
+   for (size_t i = 0; i < num; i++)
+      if (i % 2)
+         d.push_back((int)i);
+      else
+         d.push_front((int)i);
+   report(name, "push", duration<double>(steady_clock::now() - start).count(), num, (long long)d.size());
+
+   // random access through the subscript operator
+   long long checksum = 0;
+   start = steady_clock::now();
+   for (size_t i = 0; i < indices.size(); i++)
+      checksum += d[indices[i]];
+   report(name, "random", duration<double>(steady_clock::now() - start).count(), indices.size(), checksum);
+
+   // sequential access through the subscript operator
+   checksum = 0;
+   start = steady_clock::now();
+   for (size_t i = 0; i < num; i++)
+      checksum += d[(int)i];
+   report(name, "subscript", duration<double>(steady_clock::now() - start).count(), num, checksum);
+
+   // sequential access through the iterator
+   checksum = 0;
+   start = steady_clock::now();
+   for (auto it = d.begin(); it != d.end(); ++it)
+      checksum += *it;
+   report(name, "iterate", duration<double>(steady_clock::now() - start).count(), num, checksum);
+
+   // the standard algorithm, one element at a time
+   start = steady_clock::now();
+   checksum = std::accumulate(d.begin(), d.end(), 0LL);
+   report(name, "std::accum", duration<double>(steady_clock::now() - start).count(), num, checksum);
+
+   // a block at a time where the iterator can do it
+   start = steady_clock::now();
+   checksum = custom::accumulate(d.begin(), d.end(), 0LL);
+   report(name, "accumulate", duration<double>(steady_clock::now() - start).count(), num, checksum);
+
+   // copy out to a vector
+   std::vector<int> out(num);
+   start = steady_clock::now();
+   custom::copy(d.begin(), d.end(), out.data());
+   report(name, "copy", duration<double>(steady_clock::now() - start).count(), num, (long long)out[num / 2]);
+}
+
+/**********************************************************************
+ * TIME BULK
+ * Move num elements in and out of a deque in chunks of numChunk,
+ * once with the bulk operations and once with the element loops
+ ***********************************************************************/
+template <class T>
+void timeBulk(const char * name, size_t num, size_t numChunk)
+{
+   std::vector<T> source(numChunk);
+   for (size_t i = 0; i < numChunk; i++)
+      source[i] = (T)i;
+   const T * pFirst = source.data();
+   const T * pLast = source.data() + numChunk;
+   size_t numRounds = num / numChunk;
+
+   // append and erase_front: a queue fed in chunks
+   custom::deque<T> d;
+   auto start = steady_clock::now();
+   for (size_t r = 0; r < numRounds; r++)
+   {
+      d.append(pFirst, pLast);
+      if (d.size() > 4 * numChunk)
+         d.erase_front(numChunk);
+   }
+   report(name, "append", duration<double>(steady_clock::now() - start).count(), num, (long long)d.size());
+
+   d.clear();
+   start = steady_clock::now();
+   for (size_t r = 0; r < numRounds; r++)
+   {
+      for (const T * p = pFirst; p != pLast; ++p)
+         d.push_back(*p);
+      if (d.size() > 4 * numChunk)
+         for (size_t i = 0; i < numChunk; i++)
+            d.pop_front();
+   }
+   report(name, "push loop", duration<double>(steady_clock::now() - start).count(), num, (long long)d.size());
+
+   // prepend and erase_back: the same from the other end
+   d.clear();
+   start = steady_clock::now();
+   for (size_t r = 0; r < numRounds; r++)
+   {
+      d.prepend(pFirst, pLast);
+      if (d.size() > 4 * numChunk)
+         d.erase_back(numChunk);
+   }
+   report(name, "prepend", duration<double>(steady_clock::now() - start).count(), num, (long long)d.size());
+
+   d.clear();
+   start = steady_clock::now();
+   for (size_t r = 0; r < numRounds; r++)
+   {
+      for (const T * p = pLast; p != pFirst; )
+         d.push_front(*--p);
+      if (d.size() > 4 * numChunk)
+         for (size_t i = 0; i < numChunk; i++)
+            d.pop_back();
+   }
+   report(name, "pushF loop", duration<double>(steady_clock::now() - start).count(), num, (long long)d.size());
+
+   // copy-assign a whole deque into an empty one
+   custom::deque<T> big;
+   for (size_t r = 0; r < numRounds; r++)
+      big.append(pFirst, pLast);
+   custom::deque<T> copy;
+   start = steady_clock::now();
+   copy = big;
+   report(name, "assign", duration<double>(steady_clock::now() - start).count(), big.size(), (long long)copy.size());
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t num = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+   std::mt19937 random(1);
+   std::vector<int> indices(num);
+   for (size_t i = 0; i < num; i++)
+      indices[i] = (int)(random() % num);
+
+   std::cout << std::fixed << std::setprecision(2);
+   std::cout << std::setw(22) << "container"
+             << std::setw(12) << "test"
+             << std::setw(10) << "ns/elem"
+             << std::setw(22) << "checksum" << std::endl;
+
+   timeDeque<std::deque<int>>                              ("std::deque",       num, indices);
+   timeDeque<custom::deque<int>>                           ("custom::deque",    num, indices);
+   timeDeque<custom::deque<int, std::allocator<int>, 128>> ("custom::deque 128", num, indices);
+
+   timeBulk<int>   ("bulk int x256",    num, 256);
+   timeBulk<double>("bulk double x4096", num, 4096);
+
+   return 0;
+}
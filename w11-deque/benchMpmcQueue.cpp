@@ -0,0 +1,195 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Pass integers from N producer threads to N consumer threads
+ *    through one shared queue, for 2 up to 64 threads in all. Compare
+ *    mpmc_queue (one at a time and in batches) against a
+ *    custom::deque guarded by a mutex.
+ *
+ *       benchMpmcQueue                  : 4M items, 2..64 threads
+ *       benchMpmcQueue 1000000 16       : items, most threads
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include "deque.h"
+#include "mpmc_queue.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * RUN
+ * Start numPairs producers and numPairs consumers, each moving its
+ * share of num items with the given functions, and return the
+ * seconds from the first start to the last join
+ ***********************************************************************/
+template <class Produce, class Consume>
+double run(size_t num, int numPairs, Produce produce, Consume consume,
+           std::atomic<long long> & checksum)
+{
+   size_t numEach = num / numPairs;
+   std::vector<std::thread> threads;
+   auto start = steady_clock::now();
+   for (int t = 0; t < numPairs; t++)
+   {
+      threads.push_back(std::thread(produce, (int)(t * numEach), numEach));
+      threads.push_back(std::thread([&, numEach]()
+      {
+         checksum += consume(numEach);
+      }));
+   }
+   for (auto & thread : threads)
+      thread.join();
+   return duration<double>(steady_clock::now() - start).count();
+}
+
+/**********************************************************************
+ * TIME MUTEX DEQUE
+ * What we had: a deque and a lock
+ ***********************************************************************/
+double timeMutexDeque(size_t num, int numPairs, std::atomic<long long> & checksum)
+{
+   custom::deque<int> d;
+   std::mutex lock;
+
+   return run(num, numPairs,
+      [&](int first, size_t numEach)
+      {
+         for (size_t i = 0; i < numEach; i++)
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            d.push_back(first + (int)i);
+         }
+      },
+      [&](size_t numEach)
+      {
+         long long sum = 0;
+         for (size_t i = 0; i < numEach; )
+         {
+            std::unique_lock<std::mutex> guard(lock);
+            if (d.empty())
+            {
+               guard.unlock();
+               std::this_thread::yield();
+               continue;
+            }
+            sum += d.front();
+            d.pop_front();
+            i++;
+         }
+         return sum;
+      }, checksum);
+}
+
+/**********************************************************************
+ * TIME MPMC
+ * One element per push and pop
+ ***********************************************************************/
+double timeMpmc(size_t num, int numPairs, std::atomic<long long> & checksum)
+{
+   custom::mpmc_queue<int> q(4096);
+
+   return run(num, numPairs,
+      [&](int first, size_t numEach)
+      {
+         for (size_t i = 0; i < numEach; i++)
+            q.push_back(first + (int)i);
+      },
+      [&](size_t numEach)
+      {
+         long long sum = 0;
+         int value;
+         for (size_t i = 0; i < numEach; i++)
+         {
+            q.pop_front(value);
+            sum += value;
+         }
+         return sum;
+      }, checksum);
+}
+
+/**********************************************************************
+ * TIME MPMC BATCH
+ * Up to numBatch elements per claim
+ ***********************************************************************/
+double timeMpmcBatch(size_t num, int numPairs, std::atomic<long long> & checksum)
+{
+   const size_t numBatch = 64;
+   custom::mpmc_queue<int> q(4096);
+
+   return run(num, numPairs,
+      [&](int first, size_t numEach)
+      {
+         std::vector<int> batch(numBatch);
+         for (size_t i = 0; i < numEach; )
+         {
+            size_t numWant = std::min(numBatch, numEach - i);
+            for (size_t j = 0; j < numWant; j++)
+               batch[j] = first + (int)(i + j);
+            q.push_back(batch.begin(), batch.begin() + numWant);
+            i += numWant;
+         }
+      },
+      [&](size_t numEach)
+      {
+         long long sum = 0;
+         std::vector<int> batch(numBatch);
+         for (size_t i = 0; i < numEach; )
+         {
+            size_t n = q.try_pop_front(batch.begin(), std::min(numBatch, numEach - i));
+            if (n == 0)
+               std::this_thread::yield();
+            for (size_t j = 0; j < n; j++)
+               sum += batch[j];
+            i += n;
+         }
+         return sum;
+      }, checksum);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t num     = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+   int numThreads = (argc > 2) ? std::atoi(argv[2]) : 64;
+
+   std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(8)  << "threads"
+             << std::setw(16) << "mutex + deque"
+             << std::setw(16) << "mpmc_queue"
+             << std::setw(16) << "mpmc batch 64"
+             << "   (M items/s)" << std::endl;
+
+   for (int numPairs = 1; 2 * numPairs <= numThreads; numPairs *= 2)
+   {
+      size_t numRun = num / numPairs * numPairs;
+      std::atomic<long long> checkDeque(0);
+      std::atomic<long long> checkMpmc(0);
+      std::atomic<long long> checkBatch(0);
+      double secDeque = timeMutexDeque(numRun, numPairs, checkDeque);
+      double secMpmc  = timeMpmc      (numRun, numPairs, checkMpmc);
+      double secBatch = timeMpmcBatch (numRun, numPairs, checkBatch);
+
+      std::cout << std::setw(8)  << 2 * numPairs
+                << std::setw(16) << numRun / secDeque / 1.0e6
+                << std::setw(16) << numRun / secMpmc  / 1.0e6
+                << std::setw(16) << numRun / secBatch / 1.0e6;
+      if (checkDeque != checkMpmc || checkMpmc != checkBatch)
+         std::cout << "   checksum mismatch";
+      std::cout << std::endl;
+   }
+
+   return 0;
+}
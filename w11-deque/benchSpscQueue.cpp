@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Hand integers from a producer thread to a consumer thread,
+ *    each pinned to its own CPU. Compare spsc_queue (one at a time
+ *    and in batches) against a custom::deque guarded by a mutex,
+ *    then measure the round-trip latency of a ping-pong.
+ *
+ *       benchSpscQueue                  : 10M items, CPUs 0 and 1
+ *       benchSpscQueue 1000000 2 3      : items, producer CPU, consumer CPU
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "deque.h"
+#include "spsc_queue.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * PIN
+ * Keep the calling thread on one CPU. Carry on unpinned if we can't
+ ***********************************************************************/
+void pin(int cpu)
+{
+#ifdef __linux__
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   CPU_SET(cpu, &set);
+   if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+      std::cerr << "could not pin to CPU " << cpu << ", running unpinned\n";
+#endif
+}
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, double seconds, size_t num, long long checksum)
+{
+   std::cout << std::setw(26) << name
+             << std::setw(14) << (double)num / seconds / 1.0e6
+             << std::setw(20) << checksum << std::endl;
+}
+
+/**********************************************************************
+ * TIME MUTEX DEQUE
+ * What we had: a deque and a lock
+ ***********************************************************************/
+void timeMutexDeque(size_t num, int cpuProducer, int cpuConsumer)
+{
+   custom::deque<int> d;
+   std::mutex lock;
+
+   auto start = steady_clock::now();
+   std::thread producer([&]()
+   {
+      pin(cpuProducer);
+      for (size_t i = 0; i < num; i++)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         d.push_back((int)i);
+      }
+   });
+
+   pin(cpuConsumer);
+   long long checksum = 0;
+   for (size_t i = 0; i < num; )
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      if (d.empty())
+      {
+         guard.unlock();
+         std::this_thread::yield();
+         continue;
+      }
+      checksum += d.front();
+      d.pop_front();
+      i++;
+   }
+   producer.join();
+   report("mutex + deque", duration<double>(steady_clock::now() - start).count(), num, checksum);
+}
+
+/**********************************************************************
+ * TIME SPSC
+ * One element per push and pop
+ ***********************************************************************/
+void timeSpsc(size_t num, int cpuProducer, int cpuConsumer)
+{
+   custom::spsc_queue<int> q(4096);
+
+   auto start = steady_clock::now();
+   std::thread producer([&]()
+   {
+      pin(cpuProducer);
+      for (size_t i = 0; i < num; )
+         if (q.push_back((int)i))
+            i++;
+         else
+            std::this_thread::yield();
+   });
+
+   pin(cpuConsumer);
+   long long checksum = 0;
+   int value;
+   for (size_t i = 0; i < num; )
+      if (q.pop_front(value))
+      {
+         checksum += value;
+         i++;
+      }
+      else
+         std::this_thread::yield();
+   producer.join();
+   report("spsc_queue", duration<double>(steady_clock::now() - start).count(), num, checksum);
+}
+
+/**********************************************************************
+ * TIME SPSC BATCH
+ * Up to numBatch elements per push and pop
+ ***********************************************************************/
+void timeSpscBatch(size_t num, size_t numBatch, int cpuProducer, int cpuConsumer)
+{
+   custom::spsc_queue<int> q(4096);
+
+   auto start = steady_clock::now();
+   std::thread producer([&]()
+   {
+      pin(cpuProducer);
+      std::vector<int> batch(numBatch);
+      for (size_t i = 0; i < num; )
+      {
+         size_t numWant = std::min(numBatch, num - i);
+         for (size_t j = 0; j < numWant; j++)
+            batch[j] = (int)(i + j);
+         size_t numSent = 0;
+         while (numSent < numWant)
+         {
+            size_t n = q.push_back(batch.begin() + numSent, batch.begin() + numWant);
+            if (n == 0)
+               std::this_thread::yield();
+            numSent += n;
+         }
+         i += numWant;
+      }
+   });
+
+   pin(cpuConsumer);
+   long long checksum = 0;
+   std::vector<int> batch(numBatch);
+   for (size_t i = 0; i < num; )
+   {
+      size_t n = q.pop_front(batch.begin(), numBatch);
+      if (n == 0)
+         std::this_thread::yield();
+      for (size_t j = 0; j < n; j++)
+         checksum += batch[j];
+      i += n;
+   }
+   producer.join();
+   report("spsc_queue batch 64", duration<double>(steady_clock::now() - start).count(), num, checksum);
+}
+
+/**********************************************************************
+ * TIME LATENCY
+ * Bounce a value back and forth num times through two queues
+ * and report percentiles of the round trip
+ ***********************************************************************/
+void timeLatency(size_t num, int cpuProducer, int cpuConsumer)
+{
+   custom::spsc_queue<int> ping(64);
+   custom::spsc_queue<int> pong(64);
+
+   std::thread echo([&]()
+   {
+      pin(cpuConsumer);
+      int value;
+      for (size_t i = 0; i < num; i++)
+      {
+         while (!ping.pop_front(value))
+            std::this_thread::yield();
+         while (!pong.push_back(value))
+            std::this_thread::yield();
+      }
+   });
+
+   pin(cpuProducer);
+   std::vector<double> trips(num);
+   int value;
+   for (size_t i = 0; i < num; i++)
+   {
+      auto start = steady_clock::now();
+      while (!ping.push_back((int)i))
+         std::this_thread::yield();
+      while (!pong.pop_front(value))
+         std::this_thread::yield();
+      trips[i] = duration<double, std::nano>(steady_clock::now() - start).count();
+   }
+   echo.join();
+
+   std::sort(trips.begin(), trips.end());
+   std::cout << "round trip ns:  p50 " << trips[num / 2]
+             << "  p99 " << trips[num * 99 / 100]
+             << "  max " << trips[num - 1] << std::endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t num      = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+   int cpuProducer = (argc > 2) ? std::atoi(argv[2]) : 0;
+   int cpuConsumer = (argc > 3) ? std::atoi(argv[3]) : 1;
+
+   std::cout << std::fixed << std::setprecision(1);
+   std::cout << std::setw(26) << "queue"
+             << std::setw(14) << "M items/s"
+             << std::setw(20) << "checksum" << std::endl;
+
+   timeMutexDeque(num, cpuProducer, cpuConsumer);
+   timeSpsc      (num, cpuProducer, cpuConsumer);
+   timeSpscBatch (num, 64, cpuProducer, cpuConsumer);
+   timeLatency   (std::min(num, (size_t)100000), cpuProducer, cpuConsumer);
+
+   return 0;
+}
@@ -0,0 +1,135 @@
+/***********************************************************************
+ * Header:
+ *    Benchmark
+ * Summary:
+ *    Fork/join on the work-stealing pool: a recursive fib and a
+ *    quick sort, each with a serial cutoff, on 1, 2, 4, ... workers.
+ *    Reports the time and the speedup over one worker.
+ *
+ *       benchWsPool                     : fib(38), 10M ints, up to 8 workers
+ *       benchWsPool 30 1000000 4        : fib n, ints to sort, most workers
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "ws_pool.h"
+
+using namespace std::chrono;
+
+/**********************************************************************
+ * FIB
+ * Spawn one half, do the other, join. Below the cutoff a task
+ * is not worth its allocation, so go serial
+ ***********************************************************************/
+long fibSerial(int n)
+{
+   return n < 2 ? n : fibSerial(n - 1) + fibSerial(n - 2);
+}
+
+long fib(custom::ws_pool & pool, int n)
+{
+   if (n < 20)
+      return fibSerial(n);
+   long a = 0;
+   custom::task_group children;
+   pool.spawn(children, [&pool, &a, n]() { a = fib(pool, n - 1); });
+   long b = fib(pool, n - 2);
+   pool.wait(children);
+   return a + b;
+}
+
+/**********************************************************************
+ * QUICK SORT
+ * Partition, spawn the left side, sort the right side, join
+ ***********************************************************************/
+void quickSort(custom::ws_pool & pool, int * first, int * last)
+{
+   if (last - first < 10000)
+   {
+      std::sort(first, last);
+      return;
+   }
+   int pivot = first[(last - first) / 2];
+   int * middle1 = std::partition(first, last, [pivot](int x) { return x < pivot; });
+   int * middle2 = std::partition(middle1, last, [pivot](int x) { return !(pivot < x); });
+
+   custom::task_group children;
+   pool.spawn(children, [&pool, first, middle1]() { quickSort(pool, first, middle1); });
+   quickSort(pool, middle2, last);
+   pool.wait(children);
+}
+
+/**********************************************************************
+ * RUN
+ * Run one root task on the pool and return the seconds it took
+ ***********************************************************************/
+template <class F>
+double run(custom::ws_pool & pool, F f)
+{
+   custom::task_group group;
+   auto start = steady_clock::now();
+   pool.spawn(group, f);
+   pool.wait(group);
+   return duration<double>(steady_clock::now() - start).count();
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   int n          = (argc > 1) ? std::atoi(argv[1]) : 38;
+   size_t numInts = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+   size_t numMost = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 8;
+
+   std::vector<int> unsorted(numInts);
+   std::mt19937 random(2024);
+   for (auto & x : unsorted)
+      x = (int)random();
+   std::vector<int> sorted(unsorted);
+   std::sort(sorted.begin(), sorted.end());
+
+   std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+   std::cout << std::fixed << std::setprecision(3);
+   std::cout << std::setw(8)  << "workers"
+             << std::setw(12) << "fib (s)"
+             << std::setw(10) << "speedup"
+             << std::setw(12) << "sort (s)"
+             << std::setw(10) << "speedup" << std::endl;
+
+   double fibOne = 0.0;
+   double sortOne = 0.0;
+   for (size_t numWorkers = 1; numWorkers <= numMost; numWorkers *= 2)
+   {
+      custom::ws_pool pool(numWorkers);
+
+      long result = 0;
+      double fibTime = run(pool, [&]() { result = fib(pool, n); });
+
+      std::vector<int> v(unsorted);
+      double sortTime = run(pool, [&]() { quickSort(pool, v.data(), v.data() + v.size()); });
+
+      if (numWorkers == 1)
+      {
+         fibOne = fibTime;
+         sortOne = sortTime;
+      }
+      std::cout << std::setw(8)  << numWorkers
+                << std::setw(12) << fibTime
+                << std::setw(10) << fibOne / fibTime
+                << std::setw(12) << sortTime
+                << std::setw(10) << sortOne / sortTime;
+      if (result != fibSerial(n) || v != sorted)
+         std::cout << "   wrong answer";
+      std::cout << std::endl;
+   }
+
+   return 0;
+}
@@ -21,7 +21,14 @@
 
 // Debug stuff
 #include <cassert>
-#include <memory>   // for std::allocator
+#include <cstddef>      // for size_t
+#include <algorithm>    // for std::copy
+#include <cstring>      // for memcpy
+#include <iterator>     // for std::distance, std::random_access_iterator_tag
+#include <memory>       // for std::allocator
+#include <new>          // for placement new
+#include <type_traits>  // for std::is_trivially_copyable
+#include <utility>      // for std::move
 
 class TestDeque;    // forward declaration for TestDeque unit test class
 
@@ -30,11 +37,19 @@ namespace custom
 
 /******************************************************
  * DEQUE
+ * NUM_CELLS is the number of cells in a block. It is a
+ * compile-time constant, so the block and cell of an
+ * element come from / and % by a constant: a shift and
+ * a mask when it is a power of two, as the default is.
  *****************************************************/
-template <typename T, typename A = std::allocator<T>>
+template <typename T, typename A = std::allocator<T>, size_t NUM_CELLS = 16>
 class deque
 {
+   static_assert(NUM_CELLS > 0, "deque NUM_CELLS must be at least one");
+
    friend class ::TestDeque; // give unit tests access to the privates
+   template <typename TT, typename AA, size_t NN>
+   friend class deque;       // to copy from a deque with other blocks
 public:
 
    // 
@@ -43,22 +58,35 @@ public:
    deque(const A & a = A()) 
    { 
       data = nullptr;
-      numCells = 16;    
       numBlocks = 0;   
       numElements = 0; 
       iaFront = 0;               
-
+      spare = nullptr;
+      numSpare = 0;
+      maxSpare = 2;
    }
-   deque(deque & rhs);
+   deque(const deque & rhs);
+   template <size_t N>
+   deque(const deque <T, A, N> & rhs);
    ~deque()
    {
       clear();
+      spare_limit(0);
+      delete [] data;
    }
 
    //
    // Assign
    //
-   deque & operator = (deque& rhs);
+   deque & operator = (const deque & rhs)
+   {
+      return copyFrom(rhs);
+   }
+   template <size_t N>
+   deque & operator = (const deque <T, A, N> & rhs)
+   {
+      return copyFrom(rhs);
+   }
 
    // 
    // Iterator
@@ -70,7 +98,7 @@ public:
    }
    iterator end()   
    { 
-      return iterator(numElements, this);
+      return iterator((int)numElements, this);
    }
 
    // 
@@ -91,24 +119,24 @@ public:
    T & back()
    {
       assert(numElements != 0);
-      assert(nullptr != data[ibFromID(numElements - 1)]);
-      return data[ibFromID(numElements - 1)][icFromID(numElements - 1)];
+      assert(nullptr != data[ibFromID((int)numElements - 1)]);
+      return data[ibFromID((int)numElements - 1)][icFromID((int)numElements - 1)];
    }
    const T & back() const
    {
       assert(numElements != 0);
-      assert(nullptr != data[ibFromID(numElements - 1)]);
-      return data[ibFromID(numElements - 1)][icFromID(numElements - 1)];
+      assert(nullptr != data[ibFromID((int)numElements - 1)]);
+      return data[ibFromID((int)numElements - 1)][icFromID((int)numElements - 1)];
    }
    T & operator[](int id)
    {
-      assert(id >= 0 && id < numElements);
+      assert(id >= 0 && id < (int)numElements);
       assert(nullptr != data[ibFromID(id)]);
       return data[ibFromID(id)][icFromID(id)];
    }
    const T & operator[](int id) const
    {
-      assert(id >= 0 && id < numElements);
+      assert(id >= 0 && id < (int)numElements);
       assert(nullptr != data[ibFromID(id)]);
       return data[ibFromID(id)][icFromID(id)];
    }
@@ -120,12 +148,18 @@ public:
    void push_back(T && t);
    void push_front(const T& t);
    void push_front(T&& t);
+   template <class Iterator>
+   void append(Iterator first, Iterator last);
+   template <class Iterator>
+   void prepend(Iterator first, Iterator last);
 
    //
    // Remove
    //
    void pop_front();
    void pop_back();
+   void erase_front(size_t num);
+   void erase_back(size_t num);
    void clear();
 
    //
@@ -133,177 +167,408 @@ public:
    //
    size_t size()  const { return numElements; }
    bool   empty() const { return numElements == 0; }
+
+   //
+   // Spare blocks
+   //
+   size_t spare_limit() const { return maxSpare; }
+   void   spare_limit(size_t numMax);
    
 private:
 
-   // TODO: fix divide by zero
-   // array index from deque index
+   // array index from deque index. Both id and iaFront are less
+   // than the capacity, so one subtraction does the wrapping
    int iaFromID(int id) const
    {
-      return (id + iaFront) % (numCells * numBlocks);
+      int ia = id + iaFront;
+      int numSlots = (int)(numCells * numBlocks);
+      return (ia >= numSlots) ? ia - numSlots : ia;
    }
 
    // block index from deque index
    int ibFromID(int id) const
    {
-      return iaFromID(id) / numCells;
+      return (int)((size_t)iaFromID(id) / NUM_CELLS);
    }
 
    // cell index from deque index
    int icFromID(int id) const
    {
-      return iaFromID(id) % numCells;
+      return (int)((size_t)iaFromID(id) % NUM_CELLS);
+   }
+
+   // assign over the elements we already have, then copy or remove the rest
+   template <size_t N>
+   deque & copyFrom(const deque <T, A, N> & rhs);
+
+   // make room for num more elements at the back. The back may not
+   // wrap around into the cells before the front in the front's block
+   void growBack(size_t num = 1)
+   {
+      grow(num, (size_t)icFromID(0));
+   }
+
+   // make room for num more elements at the front. The front may not
+   // wrap around into the cells after the back in the back's block
+   void growFront(size_t num = 1)
+   {
+      size_t icEnd = ((size_t)icFromID(0) + numElements) % numCells;
+      grow(num, (icEnd == 0) ? 0 : numCells - icEnd);
+   }
+
+   // double the blocks until num more elements fit beside the numSkip
+   // cells we may not use. Reallocating keeps the front's cell, so
+   // numSkip does not change
+   void grow(size_t num, size_t numSkip)
+   {
+      if (numElements + num + numSkip <= numBlocks * numCells)
+         return;
+      size_t numBlocksNew = (numBlocks == 0) ? 1 : numBlocks * 2;
+      while (numElements + num + numSkip > numBlocksNew * numCells)
+         numBlocksNew *= 2;
+      reallocate((int)numBlocksNew);
+   }
+
+   // copy num elements from first into the empty slots starting at id,
+   // a block at a time
+   template <class Iterator>
+   void construct(int id, Iterator first, size_t num);
+
+   // destroy num elements starting at id, a block at a time, handing
+   // back each block that empties
+   void destroy(int id, size_t num);
+
+   // allocate the block holding deque index id, as needed
+   T * blockFromID(int id)
+   {
+      int ib = ibFromID(id);
+      if (data[ib] == nullptr)
+         data[ib] = allocateBlock();
+      return data[ib];
+   }
+
+   // get an empty block, recycling a spare one when we have it
+   T * allocateBlock()
+   {
+      if (numSpare != 0)
+         return spare[--numSpare];
+      return alloc.allocate(numCells);
+   }
+
+   // give up an empty block, keeping it as a spare when there is room
+   void deallocateBlock(T * pBlock)
+   {
+      if (numSpare < maxSpare)
+      {
+         if (spare == nullptr)
+            spare = new T * [maxSpare];
+         spare[numSpare++] = pBlock;
+      }
+      else
+         alloc.deallocate(pBlock, numCells);
    }
 
    // reallocate
    void reallocate(int numBlocksNew);
 
    A    alloc;                // use alloacator for memory allocation
-   size_t numCells;           // number of cells in a block
+   static constexpr size_t numCells = NUM_CELLS;   // number of cells in a block
    size_t numBlocks;          // number of blocks in the data array
    size_t numElements;        // number of elements in the deque
    int iaFront;               // array-centered index of the front of the deque
    T ** data;                 // array of arrays
+   T ** spare;                // empty blocks kept for reuse
+   size_t numSpare;           // number of blocks in spare
+   size_t maxSpare;           // most empty blocks we will hold on to
 };
 
 /**************************************************
  * DEQUE ITERATOR
- * An iterator through deque.  You only need to
- * support the following:
- *   1. Constructors (default and copy)
- *   2. Not equals operator
- *   3. Increment (prefix and postfix)
- *   4. Dereference
- * This particular iterator is a bi-directional meaning
- * that ++ and -- both work.  Not all iterators are that way.
+ * A random-access iterator through deque. The id is
+ * the position; the iterator also remembers the cell
+ * it points to and the bounds of that cell's block,
+ * so stepping within a block is pointer arithmetic.
+ * The cache is filled on the first dereference and
+ * dropped whenever a step leaves the block, so only
+ * a block crossing pays for the index math.
  *************************************************/
-template <typename T, typename A>
-class deque <T, A> ::iterator
+template <typename T, typename A, size_t NUM_CELLS>
+class deque <T, A, NUM_CELLS> ::iterator
 {
    friend class ::TestDeque; // give unit tests access to the privates
 public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef int                             difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
    // 
    // Construct
    //
-   iterator() : id(), d()
+   iterator() : id(), d(), pCell(), pFirst(), pLast()
    {
    }
-   iterator(int id, deque* d) : id(), d()
+   iterator(int id, deque* d) : id(id), d(d), pCell(), pFirst(), pLast()
    {
-      this->id = id;
-      this->d = d;
-   }
-   iterator(const iterator& rhs) 
-   {
-      *this = rhs;
    }
 
+   // 
+   // Compare
    //
-   // Assign
-   //
-   iterator& operator = (const iterator& rhs)
-   {
-      this->d = rhs.d;
-      this->id = rhs.id;
-      return *this;
-   }
+   bool operator == (const iterator& rhs) const { return d == rhs.d && id == rhs.id; }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs);            }
+   bool operator <  (const iterator& rhs) const { return id <  rhs.id;               }
+   bool operator >  (const iterator& rhs) const { return id >  rhs.id;               }
+   bool operator <= (const iterator& rhs) const { return id <= rhs.id;               }
+   bool operator >= (const iterator& rhs) const { return id >= rhs.id;               }
 
    // 
-   // Compare
+   // Access
    //
-   bool operator != (const iterator& rhs) const
+   T& operator * () const
    {
-      return !(*this == rhs);
+      if (pCell == nullptr)
+         locate();
+      return *pCell;
    }
-   bool operator == (const iterator& rhs) const
+   T* operator -> () const
    {
-      return this->d == rhs.d && this->id == rhs.id;
+      return &**this;
    }
-
-   // 
-   // Access
-   //
-   T& operator * ()
+   T& operator [] (int offset) const
    {
-      return d->data[d->ibFromID(id)][d->icFromID(id)];
+      return *(*this + offset);
    }
 
    // 
    // Arithmetic
    //
-   int operator - (iterator it) const
+   int operator - (const iterator& it) const
    {
       return this->id - it.id;
    }
    iterator& operator += (int offset)
    {
-      this->id += offset;
+      id += offset;
+      if (pCell != nullptr)
+      {
+         if (offset >= (int)(pFirst - pCell) && offset < (int)(pLast - pCell))
+            pCell += offset;
+         else
+            pCell = nullptr;
+      }
       return *this;
    }
+   iterator& operator -= (int offset)           { return *this += -offset;              }
+   iterator  operator +  (int offset) const     { iterator temp = *this; return temp += offset; }
+   iterator  operator -  (int offset) const     { iterator temp = *this; return temp -= offset; }
+   friend iterator operator + (int offset, const iterator& it) { return it + offset; }
+
    iterator& operator ++ ()
    {
-      ++(this->id);
+      ++id;
+      if (pCell != nullptr && ++pCell == pLast)
+         pCell = nullptr;
       return *this;
    }
    iterator operator ++ (int postfix)
    {
       iterator temp = *this;
-      ++(this->id);
+      ++(*this);
       return temp;
    }
    iterator& operator -- ()
    {
-      ++this->id;
+      --id;
+      if (pCell != nullptr && pCell-- == pFirst)
+         pCell = nullptr;
       return *this;
    }
    iterator operator -- (int postfix)
    {
       iterator temp = *this;
-      ++this->id;
+      --(*this);
       return temp;
    }
 
+   //
+   // Segments
+   //
+   template <class F>
+   void for_each_segment(const iterator& last, F f) const;
+
 private:
+
+   // find the cell of id and the block around it
+   void locate() const
+   {
+      int ib = d->ibFromID(id);
+      int ic = d->icFromID(id);
+      pFirst = d->data[ib];
+      pLast  = pFirst + d->numCells;
+      pCell  = pFirst + ic;
+   }
+
    int id;
    deque* d;
+   mutable T* pCell;       // the element at id, or nullptr until we look
+   mutable T* pFirst;      // the first cell of pCell's block
+   mutable T* pLast;       // one past the last cell of pCell's block
 };
 
+/*****************************************
+ * DEQUE ITERATOR :: FOR EACH SEGMENT
+ * Call f(pBegin, pEnd) for every run of
+ * [*this, last) that is contiguous in memory:
+ * at most one per block
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+template <class F>
+void deque <T, A, NUM_CELLS> ::iterator::for_each_segment(const iterator& last, F f) const
+{
+   for (int idSeg = id; idSeg < last.id; )
+   {
+      T* pBegin = &d->data[d->ibFromID(idSeg)][d->icFromID(idSeg)];
+      int num = (int)d->numCells - d->icFromID(idSeg);
+      if (num > last.id - idSeg)
+         num = last.id - idSeg;
+      f(pBegin, pBegin + num);
+      idSeg += num;
+   }
+}
+
+/*****************************************
+ * SEGMENTED ALGORITHMS
+ * for_each, copy, and accumulate, done a block
+ * at a time when the iterator can hand out
+ * contiguous runs, so the inner loop is over
+ * plain pointers. Any other iterator gets the
+ * ordinary element loop.
+ ****************************************/
+template <class Iterator, class = void>
+struct is_segmented_iterator : std::false_type {};
+
+template <class Iterator>
+struct is_segmented_iterator<Iterator,
+   decltype(std::declval<const Iterator&>().for_each_segment(
+      std::declval<const Iterator&>(),
+      std::declval<void (*)(typename Iterator::pointer, typename Iterator::pointer)>()))>
+   : std::true_type {};
+
+template <class Iterator, class F>
+F for_each(Iterator first, Iterator last, F f)
+{
+   if constexpr (is_segmented_iterator<Iterator>::value)
+      first.for_each_segment(last, [&f](typename Iterator::pointer p, typename Iterator::pointer pEnd)
+      {
+         for (; p != pEnd; ++p)
+            f(*p);
+      });
+   else
+      for (; first != last; ++first)
+         f(*first);
+   return f;
+}
+
+template <class Iterator, class OutputIterator>
+OutputIterator copy(Iterator first, Iterator last, OutputIterator out)
+{
+   if constexpr (is_segmented_iterator<Iterator>::value)
+      first.for_each_segment(last, [&out](typename Iterator::pointer p, typename Iterator::pointer pEnd)
+      {
+         out = std::copy(p, pEnd, out);
+      });
+   else
+      for (; first != last; ++first, ++out)
+         *out = *first;
+   return out;
+}
+
+template <class Iterator, class U>
+U accumulate(Iterator first, Iterator last, U init)
+{
+   if constexpr (is_segmented_iterator<Iterator>::value)
+      first.for_each_segment(last, [&init](typename Iterator::pointer p, typename Iterator::pointer pEnd)
+      {
+         for (; p != pEnd; ++p)
+            init = init + *p;
+      });
+   else
+      for (; first != last; ++first)
+         init = init + *first;
+   return init;
+}
+
 /*****************************************
  * DEQUE :: COPY CONSTRUCTOR
  * Allocate the space for the elements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T, typename A>
-deque <T, A> ::deque(deque& rhs) 
+template <typename T, typename A, size_t NUM_CELLS>
+deque <T, A, NUM_CELLS> ::deque(const deque& rhs) 
 {
+   data = nullptr;
+   numBlocks = 0;
+   numElements = 0;
+   iaFront = 0;
+   spare = nullptr;
+   numSpare = 0;
+   maxSpare = rhs.maxSpare;
    *this = rhs;
 }
 
 /*****************************************
- * DEQUE :: COPY-ASSIGN
- * Allocate the space for the elements and
- * call the copy constructor on each element
+ * DEQUE :: COPY CONSTRUCTOR from other blocks
+ * The same, from a deque with another block size
  ****************************************/
-template <typename T, typename A>
-deque <T, A> & deque <T, A> :: operator = (deque & rhs)
+template <typename T, typename A, size_t NUM_CELLS>
+template <size_t N>
+deque <T, A, NUM_CELLS> ::deque(const deque <T, A, N> & rhs)
 {
-   this->clear();
-   for (auto it = rhs.begin(); it != rhs.end(); ++it)
-   {
-      this->push_back(*it);
-   }
-   
-   //iterator itLHS = this->begin();
-   //iterator itRHS = rhs.begin();
+   data = nullptr;
+   numBlocks = 0;
+   numElements = 0;
+   iaFront = 0;
+   spare = nullptr;
+   numSpare = 0;
+   maxSpare = rhs.maxSpare;
+   *this = rhs;
+}
 
-   //while (itLHS != this->end() && itRHS != rhs.end())
-   //{
-   //   *itLHS = *itRHS;
-   //   ++itLHS;
-   //   ++itRHS;
-   //}
+/*****************************************
+ * DEQUE :: COPY FROM
+ * Assign over the elements we already have, then
+ * copy or remove the rest. rhs may have blocks of
+ * another size
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+template <size_t N>
+deque <T, A, NUM_CELLS> & deque <T, A, NUM_CELLS> :: copyFrom(const deque <T, A, N> & rhs)
+{
+   if ((const void *)this == (const void *)&rhs)
+      return *this;
+
+   // assign over the elements both deques have
+   int numCommon = (int)(numElements < rhs.numElements ? numElements : rhs.numElements);
+   for (int id = 0; id < numCommon; id++)
+      (*this)[id] = rhs[id];
 
+   // remove the extra elements from the back
+   if (numElements > rhs.numElements)
+      erase_back(numElements - rhs.numElements);
 
+   // copy the rest a block of rhs at a time
+   growBack(rhs.numElements - numElements);
+   while (numElements < rhs.numElements)
+   {
+      int id = (int)numElements;
+      const T * pFirst = &rhs.data[rhs.ibFromID(id)][rhs.icFromID(id)];
+      size_t num = rhs.numCells - (size_t)rhs.icFromID(id);
+      if (num > rhs.numElements - numElements)
+         num = rhs.numElements - numElements;
+      append(pFirst, pFirst + num);
+   }
 
    return *this;
 }
@@ -312,23 +577,15 @@ deque <T, A> & deque <T, A> :: operator = (deque & rhs)
  * DEQUE :: PUSH_BACK
  * add an element to the back of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_back(const T& t)
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::push_back(const T& t)
 {
    // Reallocate the array of blocks as needed
-   if (numElements == numBlocks * numCells)
-      reallocate((numBlocks == 0) ? 0 : numBlocks * 2);
-
-   // Allocate a new block as needed
-   size_t ib = ibFromID(numElements);          // Find index of new block
-   if (data[ib] == nullptr)
-   {
-      data[ib] = new T[numCells];   // Use an allocator or new
-      //numBlocks++;
-   }
+   growBack();
 
-   // Assign the value into the block
-   new((void*)(&(data[ib][icFromID(numElements)]))) T(t);
+   // Allocate a new block as needed, then copy the value into it
+   T * pBlock = blockFromID((int)numElements);
+   new((void*)(&pBlock[icFromID((int)numElements)])) T(t);
    numElements++;
 }
 
@@ -336,35 +593,37 @@ void deque <T, A> ::push_back(const T& t)
  * DEQUE :: PUSH_BACK - move
  * add an element to the back of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_back(T && t)
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::push_back(T && t)
 {
+   // Reallocate the array of blocks as needed
+   growBack();
+
+   // Allocate a new block as needed, then move the value into it
+   T * pBlock = blockFromID((int)numElements);
+   new((void*)(&pBlock[icFromID((int)numElements)])) T(std::move(t));
+   numElements++;
 }
 
 /*****************************************
  * DEQUE :: PUSH_FRONT
  * add an element to the front of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_front(const T& t)
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::push_front(const T& t)
 {
    // Reallocate the array of blocks as needed
-   if (numElements == numBlocks * numCells)
-      reallocate((numBlocks == 0) ? 0 : numBlocks * 2);
+   growFront();
 
    // Adjust the front array index, wrapping as needed
    if (iaFront != 0)
       iaFront--;
    else
-      iaFront = numBlocks * numCells - 1;
-
-   // Allocate a new block as needed
-   size_t ib = ibFromID(0);          // Find index of new block
-   if (data[ib] == nullptr)
-      data[ib] = new T[numCells];   // Use an allocator or new
+      iaFront = (int)(numBlocks * numCells) - 1;
 
-   // Assign the value into the block
-   data[ib][icFromID(numElements)] = t;
+   // Allocate a new block as needed, then copy the value into it
+   T * pBlock = blockFromID(0);
+   new((void*)(&pBlock[icFromID(0)])) T(t);
    numElements++;
 }
 
@@ -372,56 +631,224 @@ void deque <T, A> ::push_front(const T& t)
  * DEQUE :: PUSH_FRONT - move
  * add an element to the front of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_front(T&& t)
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::push_front(T&& t)
+{
+   // Reallocate the array of blocks as needed
+   growFront();
+
+   // Adjust the front array index, wrapping as needed
+   if (iaFront != 0)
+      iaFront--;
+   else
+      iaFront = (int)(numBlocks * numCells) - 1;
+
+   // Allocate a new block as needed, then move the value into it
+   T * pBlock = blockFromID(0);
+   new((void*)(&pBlock[icFromID(0)])) T(std::move(t));
+   numElements++;
+}
+
+/*****************************************
+ * DEQUE :: APPEND
+ * Add [first, last) to the back of the deque,
+ * growing the array of blocks at most once
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+template <class Iterator>
+void deque <T, A, NUM_CELLS> ::append(Iterator first, Iterator last)
 {
+   size_t num = (size_t)std::distance(first, last);
+   if (num == 0)
+      return;
+   growBack(num);
+   construct((int)numElements, first, num);
+   numElements += num;
+}
+
+/*****************************************
+ * DEQUE :: PREPEND
+ * Add [first, last) to the front of the deque,
+ * keeping its order, so *first becomes the front
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+template <class Iterator>
+void deque <T, A, NUM_CELLS> ::prepend(Iterator first, Iterator last)
+{
+   size_t num = (size_t)std::distance(first, last);
+   if (num == 0)
+      return;
+   growFront(num);
+
+   // move the front back num slots, wrapping as needed
+   iaFront = iaFromID((int)(numBlocks * numCells - num));
+
+   construct(0, first, num);
+   numElements += num;
+}
+
+/*****************************************
+ * DEQUE :: CONSTRUCT
+ * Fill the slots one block at a time. A pointer
+ * to trivially copyable values is one memcpy per
+ * block; anything else is copied element by element
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+template <class Iterator>
+void deque <T, A, NUM_CELLS> ::construct(int id, Iterator first, size_t num)
+{
+   const bool canCopyBlock =
+      std::is_pointer<Iterator>::value &&
+      std::is_trivially_copyable<T>::value &&
+      std::is_same<typename std::iterator_traits<Iterator>::value_type,
+                   typename std::remove_cv<T>::type>::value;
+
+   while (num > 0)
+   {
+      T * pBlock = blockFromID(id);
+      int ic = icFromID(id);
+      size_t numHere = numCells - (size_t)ic;
+      if (numHere > num)
+         numHere = num;
+
+      if (canCopyBlock)
+      {
+         memcpy((void*)(pBlock + ic), (const void*)&*first, numHere * sizeof(T));
+         std::advance(first, numHere);
+      }
+      else
+         for (size_t i = 0; i < numHere; i++, ++first)
+            new((void*)(&pBlock[ic + i])) T(*first);
+
+      id += (int)numHere;
+      num -= numHere;
+   }
+}
+
+/*****************************************
+ * DEQUE :: ERASE FRONT
+ * Remove the first num elements
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::erase_front(size_t num)
+{
+   assert(num <= numElements);
+   if (num == numElements)
+   {
+      clear();
+      return;
+   }
+   destroy(0, num);
+   iaFront = iaFromID((int)num);
+   numElements -= num;
+}
+
+/*****************************************
+ * DEQUE :: ERASE BACK
+ * Remove the last num elements
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::erase_back(size_t num)
+{
+   assert(num <= numElements);
+   if (num == numElements)
+   {
+      clear();
+      return;
+   }
+   destroy((int)(numElements - num), num);
+   numElements -= num;
+}
+
+/*****************************************
+ * DEQUE :: DESTROY
+ * Run the destructors a block at a time, unless
+ * T does not have one. The range is at the front
+ * or the back and some elements remain (clear()
+ * removes them all). A block the range touched
+ * still holds a kept element only when it is the
+ * block next to the range or, once the back has
+ * wrapped into the front's block, the block at the
+ * other end. Every other block goes.
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::destroy(int id, size_t num)
+{
+   assert(num < numElements);
+   assert(id == 0 || id + num == numElements);
+   int idEnd = id + (int)num;
+   int ibNext = (id == 0) ? ibFromID(idEnd) : ibFromID(id - 1);
+   int ibFar  = (id == 0) ? ibFromID((int)numElements - 1) : ibFromID(0);
+
+   while (id < idEnd)
+   {
+      int ib = ibFromID(id);
+      int ic = icFromID(id);
+      size_t numHere = numCells - (size_t)ic;
+      if (numHere > (size_t)(idEnd - id))
+         numHere = (size_t)(idEnd - id);
+
+      if (!std::is_trivially_destructible<T>::value)
+         for (size_t i = 0; i < numHere; i++)
+            alloc.destroy(&data[ib][ic + i]);
+
+      if (ib != ibNext && ib != ibFar)
+      {
+         deallocateBlock(data[ib]);
+         data[ib] = nullptr;
+      }
+
+      id += (int)numHere;
+   }
 }
 
 /*****************************************
  * DEQUE :: CLEAR
  * Remove all the elements from a deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::clear()
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::clear()
 {
    // delete the elements
-   for (size_t id = 0; id < numElements; id++)
-      alloc.destroy(&data[ibFromID(id)][icFromID(id)]);
+   if (!std::is_trivially_destructible<T>::value)
+      for (int id = 0; id < (int)numElements; id++)
+         alloc.destroy(&data[ibFromID(id)][icFromID(id)]);
 
    // Delete the blocks themselves
    for (size_t ib = 0; ib < numBlocks; ib++)
    {
       if (data[ib] != nullptr)
       {
-         alloc.destroy(&data[ib]);
+         deallocateBlock(data[ib]);
          data[ib] = nullptr;
       }
    }
 
    numElements = 0;
-
-   
 }
 
 /*****************************************
  * DEQUE :: POP FRONT
  * Remove the front element from a deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> :: pop_front()
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> :: pop_front()
 {
-   size_t idRemove = 0;
+   assert(numElements != 0);
+   int idRemove = 0;
+   int ibRemove = ibFromID(idRemove);
 
-   // call deconsturctor on back element
-   alloc.destroy(&data[ibFromID(idRemove)][icFromID(idRemove)]);
+   // call deconsturctor on front element
+   alloc.destroy(&data[ibRemove][icFromID(idRemove)]);
 
    // delete block as needed
-   if (numElements == 1
-      || (icFromID(idRemove) == (numCells - 1) && ibFromID(idRemove) != ibFromID(numCells - 1)))
+   if (numElements == 1 ||
+       (icFromID(idRemove) == (int)numCells - 1 && ibRemove != ibFromID((int)numElements - 1)))
    {
-      alloc.destroy(&data[ibFromID(idRemove)]);
-      data[ibFromID(idRemove)] = nullptr;
+      deallocateBlock(data[ibRemove]);
+      data[ibRemove] = nullptr;
    }
+
    numElements--;
    iaFront = iaFromID(1);
 }
@@ -430,73 +857,101 @@ void deque <T, A> :: pop_front()
  * DEQUE :: POP BACK
  * Remove the back element from a deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::pop_back()
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::pop_back()
 {
-   size_t idRemove = numElements - 1;
+   assert(numElements != 0);
+   int idRemove = (int)numElements - 1;
+   int ibRemove = ibFromID(idRemove);
 
    // call deconsturctor on back element
-   alloc.destroy(&data[ibFromID(idRemove)][icFromID(idRemove)]);
+   alloc.destroy(&data[ibRemove][icFromID(idRemove)]);
 
    // delete block as needed
-   if (numElements == 1
-      || (icFromID(idRemove) == 0 && ibFromID(idRemove) != ibFromID(0)))
+   if (numElements == 1 ||
+       (icFromID(idRemove) == 0 && ibRemove != ibFromID(0)))
    {
-      alloc.destroy(&data[ibFromID(idRemove)]);
-      data[ibFromID(idRemove)] = nullptr;
+      deallocateBlock(data[ibRemove]);
+      data[ibRemove] = nullptr;
    }
+
    numElements--;
 }
 
+/*****************************************
+ * DEQUE :: SPARE LIMIT
+ * Set the most empty blocks we keep around for
+ * reuse. A queue that keeps crossing a block
+ * boundary then never goes back to the allocator.
+ * Zero frees every block as soon as it empties.
+ ****************************************/
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> ::spare_limit(size_t numMax)
+{
+   // free the spares we no longer have room for
+   while (numSpare > numMax)
+      alloc.deallocate(spare[--numSpare], numCells);
+
+   // resize the spare list itself
+   T ** spareNew = (numMax == 0) ? nullptr : new T * [numMax];
+   for (size_t i = 0; i < numSpare; i++)
+      spareNew[i] = spare[i];
+   delete [] spare;
+   spare = spareNew;
+   maxSpare = numMax;
+}
+
 /*****************************************
  * DEQUE :: REALLOCATE
- * Remove all the elements from a deque
+ * Grow the array of blocks, unwrapping so the
+ * front block lands in the first slot
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> :: reallocate(int numBlocksNew)
+template <typename T, typename A, size_t NUM_CELLS>
+void deque <T, A, NUM_CELLS> :: reallocate(int numBlocksNew)
 {
    // Allocate a new array of pointers that is the requested size
    T** dataNew = new T * [numBlocksNew];
 
-   // Copy over the pointers, unwrapping as we go
+   // Copy over the pointers, unwrapping as we go. The elements can
+   // straddle one more block than they fill when the front is not
+   // in the first cell of its block
    size_t ibNew = 0;
-   for (size_t ibOld = 0; ibOld < numElements; ibOld+= numCells)
+   if (numElements != 0)
    {
-      dataNew[ibNew] = data[ibFromID(ibOld)];
-      ibNew++;
+      int icFront = icFromID(0);
+      size_t numUsed = (icFront + numElements + numCells - 1) / numCells;
+      int ibOld = ibFromID(0);
+      for (; ibNew < numUsed && ibNew < numBlocks; ibNew++)
+      {
+         dataNew[ibNew] = data[ibOld];
+         ibOld = (ibOld + 1 == (int)numBlocks) ? 0 : ibOld + 1;
+      }
    }
 
    // Set all the block pointers to NULL when there are no block to point to
-   while (ibNew < numBlocksNew)
-   {
-      dataNew[ibNew] = nullptr;
-      ibNew++;
-   }
+   for (size_t ib = ibNew; ib < (size_t)numBlocksNew; ib++)
+      dataNew[ib] = nullptr;
 
-   // If the back element is in the fron element's block, then move it
-   if (numElements < 0 &&
-      ibFromID(0) == ibFromID(numElements - 1) &&
-      icFromID(0) > icFromID(numElements - 1))
+   // If the back element is in the front element's block, then move it
+   if (numElements > 0 &&
+       ibFromID(0) == ibFromID((int)numElements - 1) &&
+       icFromID(0) > icFromID((int)numElements - 1))
    {
-      size_t ibFrontOld = ibFromID(0);
-      size_t ibBackOld = ibFromID(numElements - 1);
-      size_t ibBackNew = numElements / numCells;
-      dataNew[ibBackNew] = new T[numCells];
-      for (size_t ic = 0; ic <= icFromID(numElements - 1); ic++) // check <
+      int ibBackOld = ibFromID((int)numElements - 1);
+      size_t ibBackNew = numBlocks;
+      dataNew[ibBackNew] = allocateBlock();
+      for (int ic = 0; ic <= icFromID((int)numElements - 1); ic++)
       {
          new((void*)(&(dataNew[ibBackNew][ic]))) T(std::move(data[ibBackOld][ic]));
+         alloc.destroy(&data[ibBackOld][ic]);
       }
-
-      // Change the deque's member variables with the new values
-      if (data)
-         alloc.destroy(&data);
-      data = dataNew;
-      numBlocks = numBlocksNew;
-      iaFront = iaFront % numCells;
    }
-}
-
-
 
+   // Change the deque's member variables with the new values
+   delete [] data;
+   data = dataNew;
+   numBlocks = numBlocksNew;
+   iaFront = iaFront % (int)numCells;
+}
 
 } // namespace custom
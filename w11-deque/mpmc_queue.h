@@ -0,0 +1,332 @@
+/***********************************************************************
+ * Header:
+ *    MPMC QUEUE
+ * Summary:
+ *    A bounded, lock-free queue that any number of producer threads
+ *    and consumer threads can share
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        mpmc_queue            : A multi-producer multi-consumer ring
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for size_t
+#include <memory>   // for std::allocator
+#include <new>      // for placement new
+#include <thread>   // for std::this_thread::yield
+#include <utility>  // for std::move
+#include "spsc_queue.h"   // for CACHE_LINE
+
+class TestMpmcQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/******************************************************
+ * MPMC QUEUE
+ * Dmitry Vyukov's bounded queue. Every slot carries a
+ * sequence number that says whose turn it is:
+ *    seq == pos       the slot is free for the producer at pos
+ *    seq == pos + 1   the slot is full for the consumer at pos
+ * A thread claims a position with one CAS on iTail (or
+ * iHead), works on its slot alone, then hands the slot
+ * on by storing the next sequence number. After the
+ * consumer is done the slot is free for pos + capacity.
+ *****************************************************/
+template <typename T, typename A = std::allocator<T>>
+class mpmc_queue
+{
+   friend class ::TestMpmcQueue; // give unit tests access to the privates
+
+   // a slot in the ring: the sequence number and room for one T
+   struct Cell
+   {
+      std::atomic<size_t> seq;
+      alignas(T) unsigned char storage[sizeof(T)];
+
+      T * pValue() { return reinterpret_cast<T *>(storage); }
+   };
+
+public:
+
+   //
+   // Construct
+   //
+   mpmc_queue(size_t numCapacity, const A & a = A());
+   mpmc_queue(const mpmc_queue &) = delete;
+   mpmc_queue & operator = (const mpmc_queue &) = delete;
+   ~mpmc_queue();
+
+   //
+   // Insert. try_ returns false (or the number pushed) rather than
+   // waiting for room; the rest wait until the ring has room
+   //
+   bool try_push_back(const T & t) { return tryPush(t);            }
+   bool try_push_back(T && t)      { return tryPush(std::move(t)); }
+   void push_back(const T & t)     { while (!tryPush(t))            backoff(); }
+   void push_back(T && t)          { while (!tryPush(std::move(t))) backoff(); }
+   template <class Iterator>
+   size_t try_push_back(Iterator first, Iterator last);
+   template <class Iterator>
+   void push_back(Iterator first, Iterator last);
+
+   //
+   // Remove. try_ returns false (or the number popped) rather than
+   // waiting for an element; the rest wait until there is one
+   //
+   bool try_pop_front(T & t);
+   void pop_front(T & t)           { while (!try_pop_front(t)) backoff(); }
+   template <class Iterator>
+   size_t try_pop_front(Iterator out, size_t num);
+   template <class Iterator>
+   void pop_front(Iterator out, size_t num);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size() const
+   {
+      size_t iT = iTail.load(std::memory_order_acquire);
+      size_t iH = iHead.load(std::memory_order_acquire);
+      return iT > iH ? iT - iH : 0;
+   }
+   bool   empty()    const { return size() == 0; }
+   size_t capacity() const { return numCapacity; }
+
+private:
+
+   template <class U>
+   bool tryPush(U && u);
+
+   // claim up to num positions starting at the position in index,
+   // where every slot's sequence is the position plus offset
+   size_t claim(std::atomic<size_t> & index, size_t offset, size_t num, size_t & pos);
+
+   // wait a moment for another thread to make progress
+   static void backoff() { std::this_thread::yield(); }
+
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Cell> CellAlloc;
+
+   CellAlloc alloc;                 // use allocator for memory allocation
+   Cell * cells;                    // the ring itself
+   size_t numCapacity;              // number of slots, a power of two
+   size_t mask;                     // numCapacity - 1
+
+   alignas(CACHE_LINE) std::atomic<size_t> iTail;   // next position to push
+   alignas(CACHE_LINE) std::atomic<size_t> iHead;   // next position to pop
+};
+
+/*****************************************
+ * MPMC QUEUE :: CONSTRUCTOR
+ * Round up to a power of two and mark every
+ * slot free for the first lap. It takes at least
+ * two slots: with one, "full for pos" and "free
+ * for pos + 1" would be the same sequence number
+ ****************************************/
+template <typename T, typename A>
+mpmc_queue <T, A> ::mpmc_queue(size_t numCapacity, const A & a) : alloc(a)
+{
+   this->numCapacity = 2;
+   while (this->numCapacity < numCapacity)
+      this->numCapacity *= 2;
+   mask = this->numCapacity - 1;
+
+   cells = alloc.allocate(this->numCapacity);
+   for (size_t i = 0; i < this->numCapacity; i++)
+      new ((void*)(&cells[i].seq)) std::atomic<size_t>(i);
+
+   iTail.store(0, std::memory_order_relaxed);
+   iHead.store(0, std::memory_order_relaxed);
+}
+
+/*****************************************
+ * MPMC QUEUE :: DESTRUCTOR
+ * Destroy whatever is left. No other thread
+ * may be using the queue by now
+ ****************************************/
+template <typename T, typename A>
+mpmc_queue <T, A> :: ~mpmc_queue()
+{
+   size_t iEnd = iTail.load(std::memory_order_relaxed);
+   for (size_t i = iHead.load(std::memory_order_relaxed); i != iEnd; i++)
+      cells[i & mask].pValue()->~T();
+   alloc.deallocate(cells, numCapacity);
+}
+
+/*****************************************
+ * MPMC QUEUE :: CLAIM
+ * Find how many slots from the current position
+ * are ready, then take them with one CAS. Return
+ * the number claimed, with the first in pos
+ ****************************************/
+template <typename T, typename A>
+size_t mpmc_queue <T, A> ::claim(std::atomic<size_t> & index, size_t offset,
+                                 size_t num, size_t & pos)
+{
+   pos = index.load(std::memory_order_relaxed);
+   for (;;)
+   {
+      // count the ready slots
+      size_t numReady = 0;
+      while (numReady < num && numReady < numCapacity)
+      {
+         size_t seq = cells[(pos + numReady) & mask].seq.load(std::memory_order_acquire);
+         if (seq != pos + numReady + offset)
+            break;
+         numReady++;
+      }
+
+      // nothing ready: either another thread beat us, or we are done
+      if (numReady == 0)
+      {
+         size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+         size_t posNow = index.load(std::memory_order_relaxed);
+         if ((std::ptrdiff_t)(seq - (pos + offset)) < 0 && posNow == pos)
+            return 0;              // full (or empty)
+         pos = posNow;
+         continue;
+      }
+
+      // take them. On failure pos holds the new position
+      if (index.compare_exchange_weak(pos, pos + numReady, std::memory_order_relaxed))
+         return numReady;
+   }
+}
+
+/*****************************************
+ * MPMC QUEUE :: TRY PUSH
+ * Claim one free slot and fill it
+ ****************************************/
+template <typename T, typename A>
+template <class U>
+bool mpmc_queue <T, A> ::tryPush(U && u)
+{
+   size_t pos;
+   if (claim(iTail, 0, 1, pos) == 0)
+      return false;
+
+   Cell & cell = cells[pos & mask];
+   new ((void*)cell.pValue()) T(std::forward<U>(u));
+   cell.seq.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+/*****************************************
+ * MPMC QUEUE :: TRY POP FRONT
+ * Claim one full slot and empty it
+ ****************************************/
+template <typename T, typename A>
+bool mpmc_queue <T, A> ::try_pop_front(T & t)
+{
+   size_t pos;
+   if (claim(iHead, 1, 1, pos) == 0)
+      return false;
+
+   Cell & cell = cells[pos & mask];
+   t = std::move(*cell.pValue());
+   cell.pValue()->~T();
+   cell.seq.store(pos + numCapacity, std::memory_order_release);
+   return true;
+}
+
+/*****************************************
+ * MPMC QUEUE :: TRY PUSH BACK - batch
+ * Claim as many free slots as [first, last)
+ * needs and we can get in one CAS, then fill
+ * them. Return the number pushed
+ ****************************************/
+template <typename T, typename A>
+template <class Iterator>
+size_t mpmc_queue <T, A> ::try_push_back(Iterator first, Iterator last)
+{
+   size_t numWant = 0;
+   for (Iterator it = first; it != last; ++it)
+      numWant++;
+   if (numWant == 0)
+      return 0;
+
+   size_t pos;
+   size_t num = claim(iTail, 0, numWant, pos);
+   for (size_t i = 0; i < num; i++, ++first)
+   {
+      Cell & cell = cells[(pos + i) & mask];
+      new ((void*)cell.pValue()) T(*first);
+      cell.seq.store(pos + i + 1, std::memory_order_release);
+   }
+   return num;
+}
+
+/*****************************************
+ * MPMC QUEUE :: PUSH BACK - batch
+ * Push all of [first, last), waiting for room
+ ****************************************/
+template <typename T, typename A>
+template <class Iterator>
+void mpmc_queue <T, A> ::push_back(Iterator first, Iterator last)
+{
+   while (first != last)
+   {
+      size_t num = try_push_back(first, last);
+      if (num == 0)
+         backoff();
+      for (; num > 0; num--)
+         ++first;
+   }
+}
+
+/*****************************************
+ * MPMC QUEUE :: TRY POP FRONT - batch
+ * Claim up to num full slots in one CAS and
+ * move them to out. Return the number popped
+ ****************************************/
+template <typename T, typename A>
+template <class Iterator>
+size_t mpmc_queue <T, A> ::try_pop_front(Iterator out, size_t num)
+{
+   if (num == 0)
+      return 0;
+
+   size_t pos;
+   num = claim(iHead, 1, num, pos);
+   for (size_t i = 0; i < num; i++, ++out)
+   {
+      Cell & cell = cells[(pos + i) & mask];
+      *out = std::move(*cell.pValue());
+      cell.pValue()->~T();
+      cell.seq.store(pos + i + numCapacity, std::memory_order_release);
+   }
+   return num;
+}
+
+/*****************************************
+ * MPMC QUEUE :: POP FRONT - batch
+ * Pop exactly num elements to out, waiting
+ * for them as needed
+ ****************************************/
+template <typename T, typename A>
+template <class Iterator>
+void mpmc_queue <T, A> ::pop_front(Iterator out, size_t num)
+{
+   while (num > 0)
+   {
+      size_t numGot = try_pop_front(out, num);
+      if (numGot == 0)
+         backoff();
+      num -= numGot;
+      for (; numGot > 0; numGot--)
+         ++out;
+   }
+}
+
+} // namespace custom
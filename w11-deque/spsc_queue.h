@@ -0,0 +1,225 @@
+/***********************************************************************
+ * Header:
+ *    SPSC QUEUE
+ * Summary:
+ *    A bounded, lock-free queue for handing elements from exactly
+ *    one producer thread to exactly one consumer thread
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        spsc_queue            : A single-producer single-consumer ring
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for size_t
+#include <memory>   // for std::allocator
+#include <new>      // for placement new
+#include <utility>  // for std::move
+
+class TestSpscQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+// the size of a cache line, so the two ends never share one
+static const size_t CACHE_LINE = 64;
+
+/******************************************************
+ * SPSC QUEUE
+ * A ring of numCapacity slots (a power of two). The
+ * producer owns iTail and only ever calls push_back,
+ * the consumer owns iHead and only ever calls
+ * pop_front. The indices only grow; the slot is the
+ * index masked by the capacity. Each end keeps a
+ * cached copy of the other end's index, so it only
+ * reads the shared one when the cache says the ring
+ * is full (or empty).
+ *****************************************************/
+template <typename T, typename A = std::allocator<T>>
+class spsc_queue
+{
+   friend class ::TestSpscQueue; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+   spsc_queue(size_t numCapacity, const A & a = A()) : alloc(a)
+   {
+      // round the capacity up to a power of two
+      this->numCapacity = 1;
+      while (this->numCapacity < numCapacity)
+         this->numCapacity *= 2;
+      mask = this->numCapacity - 1;
+      data = alloc.allocate(this->numCapacity);
+
+      iHead = 0;
+      iTail = 0;
+      iHeadCache = 0;
+      iTailCache = 0;
+   }
+   spsc_queue(const spsc_queue &) = delete;
+   spsc_queue & operator = (const spsc_queue &) = delete;
+   ~spsc_queue()
+   {
+      size_t iEnd = iTail.load(std::memory_order_relaxed);
+      for (size_t i = iHead.load(std::memory_order_relaxed); i != iEnd; i++)
+         alloc.destroy(&data[i & mask]);
+      alloc.deallocate(data, numCapacity);
+   }
+
+   //
+   // Insert: producer thread only. False when full
+   //
+   bool push_back(const T & t)
+   {
+      size_t i = iTail.load(std::memory_order_relaxed);
+      if (!roomFor(i, 1))
+         return false;
+      new ((void*)(&data[i & mask])) T(t);
+      iTail.store(i + 1, std::memory_order_release);
+      return true;
+   }
+   bool push_back(T && t)
+   {
+      size_t i = iTail.load(std::memory_order_relaxed);
+      if (!roomFor(i, 1))
+         return false;
+      new ((void*)(&data[i & mask])) T(std::move(t));
+      iTail.store(i + 1, std::memory_order_release);
+      return true;
+   }
+   template <class Iterator>
+   size_t push_back(Iterator first, Iterator last);
+
+   //
+   // Remove: consumer thread only. False when empty
+   //
+   bool pop_front(T & t)
+   {
+      size_t i = iHead.load(std::memory_order_relaxed);
+      if (!itemsFor(i, 1))
+         return false;
+      t = std::move(data[i & mask]);
+      alloc.destroy(&data[i & mask]);
+      iHead.store(i + 1, std::memory_order_release);
+      return true;
+   }
+   template <class Iterator>
+   size_t pop_front(Iterator out, size_t num);
+
+   //
+   // Status. Exact only when the other thread is idle
+   //
+   size_t size() const
+   {
+      return iTail.load(std::memory_order_acquire) - iHead.load(std::memory_order_acquire);
+   }
+   bool   empty()    const { return size() == 0; }
+   size_t capacity() const { return numCapacity; }
+
+private:
+
+   // producer: are there num free slots past index i?
+   bool roomFor(size_t i, size_t num)
+   {
+      if (i + num - iHeadCache <= numCapacity)
+         return true;
+      iHeadCache = iHead.load(std::memory_order_acquire);
+      return i + num - iHeadCache <= numCapacity;
+   }
+
+   // consumer: are there num elements from index i on?
+   bool itemsFor(size_t i, size_t num)
+   {
+      if (iTailCache - i >= num)
+         return true;
+      iTailCache = iTail.load(std::memory_order_acquire);
+      return iTailCache - i >= num;
+   }
+
+   // read only after construction, shared by both threads
+   alignas(CACHE_LINE) A alloc;     // use allocator for memory allocation
+   T * data;                        // the ring itself
+   size_t numCapacity;              // number of slots, a power of two
+   size_t mask;                     // numCapacity - 1
+
+   // written by the consumer
+   alignas(CACHE_LINE) std::atomic<size_t> iHead;   // next element to pop
+   size_t iTailCache;                               // last iTail the consumer saw
+
+   // written by the producer
+   alignas(CACHE_LINE) std::atomic<size_t> iTail;   // next slot to fill
+   size_t iHeadCache;                               // last iHead the producer saw
+};
+
+/*****************************************
+ * SPSC QUEUE :: PUSH BACK - batch
+ * Copy as many of [first, last) as fit, then
+ * publish them all with a single store. The
+ * head is read once so the batch fills all the
+ * room the consumer has freed so far.
+ * Return the number pushed.
+ ****************************************/
+template <typename T, typename A>
+template <class Iterator>
+size_t spsc_queue <T, A> ::push_back(Iterator first, Iterator last)
+{
+   size_t i = iTail.load(std::memory_order_relaxed);
+
+   // how much room is there?
+   iHeadCache = iHead.load(std::memory_order_acquire);
+   if (i - iHeadCache == numCapacity)
+      return 0;
+   size_t numRoom = numCapacity - (i - iHeadCache);
+
+   // fill the slots
+   size_t num = 0;
+   for (; first != last && num < numRoom; ++first, ++num)
+      new ((void*)(&data[(i + num) & mask])) T(*first);
+
+   iTail.store(i + num, std::memory_order_release);
+   return num;
+}
+
+/*****************************************
+ * SPSC QUEUE :: POP FRONT - batch
+ * Move up to num elements to out, then release
+ * their slots with a single store. Return the
+ * number popped.
+ ****************************************/
+template <typename T, typename A>
+template <class Iterator>
+size_t spsc_queue <T, A> ::pop_front(Iterator out, size_t num)
+{
+   size_t i = iHead.load(std::memory_order_relaxed);
+
+   // how many are waiting?
+   if (!itemsFor(i, 1))
+      return 0;
+   size_t numReady = iTailCache - i;
+   if (num > numReady)
+      num = numReady;
+
+   // empty the slots
+   for (size_t n = 0; n < num; n++, ++out)
+   {
+      *out = std::move(data[(i + n) & mask]);
+      alloc.destroy(&data[(i + n) & mask]);
+   }
+
+   iHead.store(i + num, std::memory_order_release);
+   return num;
+}
+
+} // namespace custom
@@ -13,6 +13,10 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testDeque.h"       // for the deque unit tests
+#include "testSpscQueue.h"   // for the spsc queue unit tests
+#include "testMpmcQueue.h"   // for the mpmc queue unit tests
+#include "testWsDeque.h"     // for the work-stealing deque unit tests
+#include "testWsPool.h"      // for the work-stealing pool unit tests
 #include "testSpy.h"         // for the spy unit tests
 int Spy::counters[] = {};
 
@@ -26,6 +30,10 @@ int main()
    // unit tests
    TestSpy().run();
    TestDeque().run();
+   TestSpscQueue().run();
+   TestMpmcQueue().run();
+   TestWsDeque().run();
+   TestWsPool().run();
 #endif // DEBUG
    
    return 0;
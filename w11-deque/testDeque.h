@@ -19,7 +19,33 @@
 #include <memory>
 #include "spy.h"
 
+#include <algorithm>
 #include <deque>
+#include <vector>
+
+/*************************************************************
+ * SPY ALLOCATOR
+ * An allocator that counts blocks with the Spy ALLOC and
+ * DELETE counters, so we can see when the deque goes back
+ * to the heap
+ *************************************************************/
+template <typename T>
+struct SpyAllocator : public std::allocator<T>
+{
+   template <typename U>
+   struct rebind { typedef SpyAllocator<U> other; };
+
+   T * allocate(size_t num)
+   {
+      Spy::counters[ALLOC]++;
+      return std::allocator<T>::allocate(num);
+   }
+   void deallocate(T * p, size_t num)
+   {
+      Spy::counters[DELETE]++;
+      std::allocator<T>::deallocate(p, num);
+   }
+};
 
 class TestDeque : public UnitTest
 {
@@ -35,17 +61,19 @@ public:
       test_icFromID_3x3();
       test_iaFromID_4x1();
       test_iaFromID_3x3();
-      //test_realloc_emptyToOne();
-      //test_realloc_oneToTwo();
-      //test_realloc_shift();
-      //test_realloc_wrapBetweenBlocks();
-      //test_realloc_complex();
+      test_ibFromID_powerOfTwo();
+      test_icFromID_powerOfTwo();
+      test_realloc_emptyToOne();
+      test_realloc_oneToTwo();
+      test_realloc_shift();
+      test_realloc_wrapBetweenBlocks();
+      test_realloc_complex();
 
       // Construct
       test_construct_default();
-      //test_constructCopy_empty();
-      //test_constructCopy_standard();
-      //test_constructCopy_wrapped();
+      test_constructCopy_empty();
+      test_constructCopy_standard();
+      test_constructCopy_wrapped();
       
       // Destruct
       test_destruct_default();
@@ -59,8 +87,8 @@ public:
       test_assign_emptyToEmpty();
       test_assign_emptyToStandard();
       test_assign_standardToStandard();
-      // test_assign_standardToEmpty();
-      // test_assign_wrapped();
+      test_assign_standardToEmpty();
+      test_assign_wrapped();
 
       // Iterator
       test_iterator_begin_empty();
@@ -76,30 +104,30 @@ public:
       // Access
       test_back_readStandard();
       test_back_readWrapped();
-      //test_back_readReadOnly(); // need copy constructor
+      test_back_readReadOnly();
       test_back_writeStandard();
       test_back_writeWrapped();
       test_front_readStandard();
       test_front_writeStandard();
-      //test_front_readReadOnly(); // need copy constructor
+      test_front_readReadOnly();
       test_subscript_readStandard();
       test_subscript_readWrapped();
-      //test_subscript_readReadOnly(); // need copy constructor
+      test_subscript_readReadOnly();
       test_subscript_writeStandard();
       test_subscript_writeWrapped();
 
       // Insert
-      //test_pushback_empty();
+      test_pushback_empty();
       test_pushback_roomNoWrap();
-      //test_pushback_newBlock();
-      //test_pushback_wrap();
-      //test_pushback_complex();
-      //test_pushfront_empty();
-      //test_pushfront_roomNoWrap();
-      //test_pushfront_newBlock();
-      //test_pushfront_wrap();
-      //test_pushfront_complex();
-      //test_pushfront_bigWrap();
+      test_pushback_newBlock();
+      test_pushback_wrap();
+      test_pushback_complex();
+      test_pushfront_empty();
+      test_pushfront_roomNoWrap();
+      test_pushfront_newBlock();
+      test_pushfront_wrap();
+      test_pushfront_complex();
+      test_pushfront_bigWrap();
 
       // Remove
       test_clear_empty();
@@ -121,6 +149,29 @@ public:
       test_empty_empty();
       test_empty_standard();
 
+      // Power of two blocks
+      test_smallBlocks_pushPopBoth();
+
+      // Spare blocks
+      test_spare_fifoSteadyState();
+      test_spare_limitZero();
+      test_spare_limitKeepsSome();
+      test_spare_limitShrink();
+
+      // Bulk insert and erase
+      test_append_trivial();
+      test_append_copy();
+      test_prepend_wrap();
+      test_eraseFront_freesBlocks();
+      test_eraseBack_destructors();
+      test_bulk_matchesStd();
+
+      // Random access and segments
+      test_iterator_cacheWithinBlock();
+      test_iterator_randomAccess();
+      test_iterator_sort();
+      test_segments_wrapped();
+      test_segments_algorithms();
 
       report("Deque");
    }
@@ -140,9 +191,8 @@ public:
       //        +----+----+----+----+
       //        | 0  | 1  | 2  | 3  |
       //        +----+----+----+----+     
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 1> d;
       d.numBlocks = 4;
-      d.numCells = 1;
       d.iaFront = 2;
       // exercise
       int ib0 = d.ibFromID(0);
@@ -169,9 +219,8 @@ public:
       //                      +----+----+----+
       //                      | 0  | 1  | 2  |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 3;
-      d.numCells = 3;
       d.iaFront = 4;
       // exercise
       int ib0 = d.ibFromID(0);
@@ -208,9 +257,8 @@ public:
       //        +----+----+----+----+
       //        | 0  | 1  | 2  | 3  |
       //        +----+----+----+----+     
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 1> d;
       d.numBlocks = 4;
-      d.numCells = 1;
       d.iaFront = 2;
       // exercise
       int ic0 = d.icFromID(0);
@@ -237,9 +285,8 @@ public:
       //                      +----+----+----+
       //                      | 0  | 1  | 2  |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 3;
-      d.numCells = 3;
       d.iaFront = 4;
       // exercise
       int ic0 = d.icFromID(0);
@@ -276,9 +323,8 @@ public:
       //        +----+----+----+----+
       //        | 0  | 1  | 2  | 3  |
       //        +----+----+----+----+     
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 1> d;
       d.numBlocks = 4;
-      d.numCells = 1;
       d.iaFront = 2;
       // exercise
       int ia0 = d.iaFromID(0);
@@ -305,9 +351,8 @@ public:
       //                      +----+----+----+
       //                      | 0  | 1  | 2  |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 3;
-      d.numCells = 3;
       d.iaFront = 4;
       // exercise
       int ia0 = d.iaFromID(0);
@@ -332,6 +377,55 @@ public:
       // teardown
       teardownStandardFixture(d);
    }
+
+   // Block from Deque with the default 16 cells and 4 blocks, wrapped
+   void test_ibFromID_powerOfTwo()
+   {  // setup
+      //                                      iaFront
+      //    +--------+  +--------+  +--------+  +--------+
+      //    | 0..15  |  | 16..31 |  | 32..47 |  | 48..63 |
+      //    +--------+  +--------+  +--------+  +--------+
+      custom::deque<Spy> d;
+      d.numBlocks = 4;
+      d.iaFront = 60;
+      // exercise
+      int ib0  = d.ibFromID(0);
+      int ib3  = d.ibFromID(3);
+      int ib4  = d.ibFromID(4);
+      int ib20 = d.ibFromID(20);
+      int ib63 = d.ibFromID(63);
+      // verify
+      assertUnit(d.numCells == 16);
+      assertUnit(ib0  == 3);
+      assertUnit(ib3  == 3);
+      assertUnit(ib4  == 0);
+      assertUnit(ib20 == 1);
+      assertUnit(ib63 == 3);
+      // teardown
+      d.numBlocks = 0;
+   }
+
+   // Cell from Deque with the default 16 cells and 4 blocks, wrapped
+   void test_icFromID_powerOfTwo()
+   {  // setup
+      custom::deque<Spy> d;
+      d.numBlocks = 4;
+      d.iaFront = 60;
+      // exercise
+      int ic0  = d.icFromID(0);
+      int ic3  = d.icFromID(3);
+      int ic4  = d.icFromID(4);
+      int ic20 = d.icFromID(20);
+      int ic63 = d.icFromID(63);
+      // verify
+      assertUnit(ic0  == 12);
+      assertUnit(ic3  == 15);
+      assertUnit(ic4  == 0);
+      assertUnit(ic20 == 0);
+      assertUnit(ic63 == 11);
+      // teardown
+      d.numBlocks = 0;
+   }
    
    /***************************************
     * INDEX TRANSLATORS
@@ -340,8 +434,7 @@ public:
    // no blocks to one
    void test_realloc_emptyToOne()
    {  // setup
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       Spy::reset();
       // exercise
       d.reallocate(1);
@@ -380,8 +473,7 @@ public:
       //         +----+
       //         |    |
       //         +----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 1;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -437,8 +529,7 @@ public:
       //    +----+----+
       //    | // |    |
       //    +----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 3;
       d.numBlocks = 2;
       d.data = new Spy * [2];
@@ -504,8 +595,7 @@ public:
       //       +----+----+----+----+
       //       |    | // | // |    |
       //       +----+----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 2;
+      custom::deque <Spy, std::allocator<Spy>, 2> d;
       d.numElements = 3;
       d.numBlocks = 4;
       d.data = new Spy * [4];
@@ -577,8 +667,7 @@ public:
       //                      +----+----+----+
       //                      |    |    |    |
       //                      +----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 8;
       d.numBlocks = 3;
       d.data = new Spy * [3];
@@ -659,9 +748,8 @@ public:
    void test_construct_default()
    {  // setup
       std::allocator<custom::deque<Spy>> alloc;
-      custom::deque<Spy> d;
+      custom::deque <Spy> d;
       d.iaFront = 66;
-      d.numCells = 77;
       d.numBlocks = 88;
       d.numElements = 99;
       d.data = (Spy **)0xBAADF00D;
@@ -717,7 +805,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -770,7 +858,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -828,7 +916,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque <Spy, std::allocator<Spy>, 3> dSrc;
       setupStandardFixture(dSrc);
       Spy::reset();
       // exercise
@@ -879,8 +967,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> dSrc;
-      dSrc.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> dSrc;
       dSrc.numElements = 3;
       dSrc.numBlocks = 7;
       dSrc.data = new Spy * [7];
@@ -942,7 +1029,6 @@ public:
          custom::deque <Spy> d;
          d.iaFront = 0;
          d.numBlocks = 0;
-         d.numCells = 16;
          d.numElements = 0;
          d.data = nullptr;
          Spy::reset();
@@ -971,10 +1057,9 @@ public:
       //          +----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, std::allocator<Spy>, 7> d;
          d.iaFront = 0;
          d.numBlocks = 1;
-         d.numCells = 7;
          d.numElements = 0;
          d.data = new Spy * [1];
          d.data[0] = alloc.allocate(7);
@@ -1004,10 +1089,9 @@ public:
       //          +----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, std::allocator<Spy>, 7> d;
          d.iaFront = 0;
          d.numBlocks = 1;
-         d.numCells = 7;
          d.numElements = 7;
          d.data = new Spy * [1];
          d.data[0] = alloc.allocate(7);
@@ -1044,10 +1128,9 @@ public:
       //          +----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, std::allocator<Spy>, 7> d;
          d.iaFront = 2;
          d.numBlocks = 1;
-         d.numCells = 7;
          d.numElements = 4;
          d.data = new Spy * [1];
          d.data[0] = alloc.allocate(7);
@@ -1080,10 +1163,9 @@ public:
       //          +----+----+----+----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, std::allocator<Spy>, 3> d;
          d.iaFront = 3;
          d.numBlocks = 4;
-         d.numCells = 3;
          d.numElements = 6;
          d.data = new Spy * [4];
          d.data[0] = nullptr;
@@ -1121,7 +1203,7 @@ public:
       //          | // |    |    | // |
       //          +----+----+----+----+
       {
-         custom::deque<Spy> d;
+         custom::deque <Spy, std::allocator<Spy>, 3> d;
          setupStandardFixture(d);
          Spy::reset();
       }  // exercise
@@ -1173,9 +1255,9 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque <Spy, std::allocator<Spy>, 3> dSrc;
       setupStandardFixture(dSrc);
-      custom::deque<Spy> dDes;
+      custom::deque <Spy, std::allocator<Spy>, 3> dDes;
       setupStandardFixture(dDes);
       Spy::reset();
       // exercise
@@ -1208,7 +1290,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque <Spy, std::allocator<Spy>, 3> dSrc;
       setupStandardFixture(dSrc);
       custom::deque<Spy> dDes;
       Spy::reset();
@@ -1261,7 +1343,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dDes;
+      custom::deque <Spy, std::allocator<Spy>, 3> dDes;
       setupStandardFixture(dDes);
       Spy::reset();
       // exercise
@@ -1297,8 +1379,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> dSrc;
-      dSrc.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> dSrc;
       dSrc.numElements = 3;
       dSrc.numBlocks = 7;
       dSrc.data = new Spy * [7];
@@ -1386,7 +1467,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -1427,8 +1508,7 @@ public:
    // add an element when the deque is empty
    void test_pushback_empty()
    {  // setup
-      custom::deque<Spy> d;
-      d.numCells = 5;
+      custom::deque <Spy, std::allocator<Spy>, 5> d;
       Spy s(99);
       Spy::reset();
       // exercise
@@ -1473,7 +1553,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -1525,7 +1605,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       new((void*)(&(d.data[2][2]))) Spy(79);
       d.numElements++;
@@ -1589,8 +1669,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       d.numElements = 2;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -1653,8 +1732,7 @@ public:
       //                      +----+----+----+
       //                      |    |    |    |
       //                      +----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 8;
       d.numBlocks = 3;
       d.data = new Spy * [3];
@@ -1739,8 +1817,7 @@ public:
     // add an element when the deque is empty
    void test_pushfront_empty()
    {  // setup
-      custom::deque<Spy> d;
-      d.numCells = 5;
+      custom::deque <Spy, std::allocator<Spy>, 5> d;
       Spy s(99);
       Spy::reset();
       // exercise
@@ -1786,7 +1863,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -1841,7 +1918,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       new((void*)(&(d.data[1][0]))) Spy(28);
       d.iaFront--;
@@ -1910,8 +1987,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       d.numElements = 2;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -1977,8 +2053,7 @@ public:
       //                      +----+----+----+
       //                      |    |    |    |
       //                      +----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 8;
       d.numBlocks = 3;
       d.data = new Spy * [3];
@@ -2068,8 +2143,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // | // |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 2;
       d.numBlocks = 7;
       d.data = new Spy * [7];
@@ -2151,7 +2225,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -2205,8 +2279,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       d.numElements = 3;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -2267,8 +2340,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       d.numElements = 1;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -2314,7 +2386,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       d.alloc.destroy(&d.data[1][1]);
       d.iaFront++;
@@ -2373,8 +2445,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 3;
       d.numBlocks = 7;
       d.data = new Spy * [7];
@@ -2451,7 +2522,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -2503,8 +2574,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       d.numElements = 2;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -2563,8 +2633,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
-      d.numCells = 4;
+      custom::deque <Spy, std::allocator<Spy>, 4> d;
       d.numElements = 1;
       d.numBlocks = 1;
       d.data = new Spy * [1];
@@ -2610,7 +2679,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       d.alloc.destroy(&d.data[2][1]);
       d.numElements--;
@@ -2668,8 +2737,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> d;
-      d.numCells = 3;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numElements = 3;
       d.numBlocks = 7;
       d.data = new Spy * [7];
@@ -2747,7 +2815,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -2780,9 +2848,8 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 4;
-      d.numCells = 3;
       d.numElements = 4;
       d.iaFront = 10;
       d.data = new Spy * [d.numBlocks];
@@ -2856,7 +2923,6 @@ public:
       //   +----+
       custom::deque<Spy> d;
       d.numBlocks = 1;
-      d.numCells = 16;
       d.numElements = 3;
       d.iaFront = 0;
       d.data = new Spy * [1];
@@ -2918,7 +2984,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -2968,9 +3034,8 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 4;
-      d.numCells = 3;
       d.numElements = 4;
       d.iaFront = 10;
       d.data = new Spy * [d.numBlocks];
@@ -3047,7 +3112,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -3080,7 +3145,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -3131,7 +3196,6 @@ public:
       //   +----+
       custom::deque<Spy> d;
       d.numBlocks = 1;
-      d.numCells = 16;
       d.numElements = 3;
       d.iaFront = 0;
       d.data = new Spy * [1];
@@ -3197,7 +3261,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s0(99);
       Spy s1(99);
@@ -3246,9 +3310,8 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 4;
-      d.numCells = 3;
       d.numElements = 4;
       d.iaFront = 10;
       d.data = new Spy * [d.numBlocks];
@@ -3327,7 +3390,6 @@ public:
       //   +----+
       custom::deque<Spy> d;
       d.numBlocks = 1;
-      d.numCells = 16;
       d.numElements = 3;
       d.iaFront = 0;
       d.data = new Spy * [1];
@@ -3388,7 +3450,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy s0(10);
       Spy s1(11);
@@ -3454,9 +3516,8 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       d.numBlocks = 4;
-      d.numCells = 3;
       d.numElements = 4;
       d.iaFront = 10;
       d.data = new Spy * [d.numBlocks];
@@ -3557,7 +3618,7 @@ public:
    // test the iterator at the beginning of the standard fixture
    void test_iterator_begin_standard()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
       //    +----+----+----+  +----+----+----+
@@ -3565,7 +3626,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -3600,7 +3661,7 @@ public:
    // test the iterator at the end of the standard fixture
    void test_iterator_end_standard()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
       //    +----+----+----+  +----+----+----+
@@ -3608,7 +3669,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -3643,7 +3704,7 @@ public:
    // test the iterator to increment from the middle of the standard fixture
    void test_iterator_increment_standardMiddle()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //                it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3652,7 +3713,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 1;
@@ -3689,7 +3750,7 @@ public:
    // the the iterator's dereference operator to access an item from the list
    void test_iterator_dereference_read()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //                it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3698,7 +3759,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 1;
@@ -3737,7 +3798,7 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_dereference_update()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //                it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3746,7 +3807,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 1;
@@ -3794,7 +3855,7 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_add_withinBlock()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //           it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3803,7 +3864,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 0;
@@ -3841,7 +3902,7 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_add_betweenBlocks()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it;
       //           it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3850,7 +3911,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 0;
@@ -3888,8 +3949,8 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_difference_standard()
    {  // setup
-      custom::deque<Spy>::iterator it1;
-      custom::deque<Spy>::iterator it2;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it1;
+      custom::deque <Spy, std::allocator<Spy>, 3>::iterator it2;
       //           it1          it2
       // id        0    1       2     3
       //    +----+----+----+  +----+----+----+
@@ -3899,7 +3960,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque <Spy, std::allocator<Spy>, 3> d;
       setupStandardFixture(d);
       it1.d = &d;
       it1.id = 0;
@@ -3927,6 +3988,428 @@ public:
    }
 
 
+   /***************************************
+    * POWER OF TWO BLOCKS
+    ***************************************/
+
+   // push and pop at both ends of a deque with 4-cell blocks
+   void test_smallBlocks_pushPopBoth()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      std::deque<int> dStd;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         if (i % 3 == 0)
+         {
+            d.push_front(i);
+            dStd.push_front(i);
+         }
+         else
+         {
+            d.push_back(i);
+            dStd.push_back(i);
+         }
+         if (i % 7 == 0 && !dStd.empty())
+         {
+            d.pop_back();
+            dStd.pop_back();
+         }
+         if (i % 11 == 0 && !dStd.empty())
+         {
+            d.pop_front();
+            dStd.pop_front();
+         }
+      }
+      // verify
+      assertUnit(d.numCells == 4);
+      assertUnit(d.size() == dStd.size());
+      bool same = (d.size() == dStd.size());
+      for (int id = 0; same && id < (int)d.size(); id++)
+         same = (d[id] == dStd[id]);
+      assertUnit(same);
+      assertUnit(d.front() == dStd.front());
+      assertUnit(d.back() == dStd.back());
+   }  // teardown
+
+   /***************************************
+    * SPARE BLOCKS
+    ***************************************/
+
+   // a queue crossing block boundaries settles down to no allocations
+   void test_spare_fifoSteadyState()
+   {  // setup
+      custom::deque<int, SpyAllocator<int>, 4> d;
+      for (int i = 0; i < 9; i++)
+         d.push_back(i);
+      for (int i = 0; i < 16; i++)
+      {
+         d.push_back(i);
+         d.pop_front();
+      }
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         d.push_back(i);
+         d.pop_front();
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(d.size() == 9);
+      assertUnit(d.front() == 991);
+      assertUnit(d.back() == 999);
+   }  // teardown
+
+   // with no spare blocks, the same queue allocates every block
+   void test_spare_limitZero()
+   {  // setup
+      custom::deque<int, SpyAllocator<int>, 4> d;
+      d.spare_limit(0);
+      for (int i = 0; i < 9; i++)
+         d.push_back(i);
+      for (int i = 0; i < 16; i++)
+      {
+         d.push_back(i);
+         d.pop_front();
+      }
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         d.push_back(i);
+         d.pop_front();
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == 250);    // one block every 4 pushes
+      assertUnit(Spy::numDelete() == 250);   // one block every 4 pops
+      assertUnit(d.spare_limit() == 0);
+      assertUnit(d.numSpare == 0);
+   }  // teardown
+
+   // emptying the deque keeps no more than the limit
+   void test_spare_limitKeepsSome()
+   {  // setup
+      custom::deque<int, SpyAllocator<int>, 4> d;
+      d.spare_limit(3);
+      for (int i = 0; i < 32; i++)
+         d.push_back(i);
+      Spy::reset();
+      // exercise
+      while (!d.empty())
+         d.pop_back();
+      // verify
+      assertUnit(Spy::numDelete() == 5);     // 8 blocks, 3 kept
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(d.numSpare == 3);
+      // exercise
+      Spy::reset();
+      for (int i = 0; i < 12; i++)
+         d.push_front(i);
+      // verify
+      assertUnit(Spy::numAlloc() == 0);      // 3 spare blocks reused
+      assertUnit(d.numSpare == 0);
+   }  // teardown
+
+   // lowering the limit frees the extra spare blocks
+   void test_spare_limitShrink()
+   {  // setup
+      custom::deque<int, SpyAllocator<int>, 4> d;
+      d.spare_limit(4);
+      for (int i = 0; i < 16; i++)
+         d.push_back(i);
+      d.clear();
+      Spy::reset();
+      // exercise
+      d.spare_limit(1);
+      // verify
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(d.numSpare == 1);
+      assertUnit(d.spare_limit() == 1);
+   }  // teardown
+
+   /***************************************
+    * BULK INSERT AND ERASE
+    ***************************************/
+
+   // append grows the array of blocks once, then fills whole blocks
+   void test_append_trivial()
+   {  // setup
+      custom::deque<int, SpyAllocator<int>, 4> d;
+      d.push_back(99);
+      int a[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+      Spy::reset();
+      // exercise
+      d.append(a, a + 10);
+      // verify
+      assertUnit(d.size() == 11);
+      assertUnit(d.numBlocks == 4);
+      assertUnit(Spy::numAlloc() == 2);      // 11 elements in 3 blocks
+      assertUnit(d.front() == 99);
+      assertUnit(d[1] == 0);
+      assertUnit(d[4] == 3);
+      assertUnit(d[5] == 4);
+      assertUnit(d.back() == 9);
+   }  // teardown
+
+   // append copies each element that is not trivially copyable
+   void test_append_copy()
+   {  // setup
+      custom::deque<Spy> d;
+      std::vector<Spy> v;
+      for (int i = 0; i < 20; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      d.append(v.begin(), v.end());
+      // verify
+      assertUnit(Spy::numCopy() == 20);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(d.size() == 20);
+      assertUnit(d.front() == Spy(0));
+      assertUnit(d[16] == Spy(16));
+      assertUnit(d.back() == Spy(19));
+   }  // teardown
+
+   // prepend keeps the order of the range and wraps the front
+   void test_prepend_wrap()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      d.push_back(1);
+      d.push_back(2);
+      int a[7] = { 3, 4, 5, 6, 7, 8, 9 };
+      // exercise
+      d.prepend(a, a + 7);
+      // verify
+      assertUnit(d.size() == 9);
+      assertUnit(d.front() == 3);
+      assertUnit(d[6] == 9);
+      assertUnit(d[7] == 1);
+      assertUnit(d.back() == 2);
+      assertUnit(d.iaFront == (int)(d.numBlocks * 4 - 7));
+   }  // teardown
+
+   // erase_front frees the blocks it empties
+   void test_eraseFront_freesBlocks()
+   {  // setup
+      custom::deque<int, SpyAllocator<int>, 4> d;
+      d.spare_limit(0);
+      for (int i = 0; i < 16; i++)
+         d.push_back(i);
+      Spy::reset();
+      // exercise
+      d.erase_front(9);
+      // verify
+      assertUnit(Spy::numDelete() == 2);
+      assertUnit(d.size() == 7);
+      assertUnit(d.iaFront == 9);
+      assertUnit(d.data[0] == nullptr);
+      assertUnit(d.data[1] == nullptr);
+      assertUnit(d.data[2] != nullptr);
+      assertUnit(d.front() == 9);
+      assertUnit(d.back() == 15);
+   }  // teardown
+
+   // erase_back destroys each element that has a destructor
+   void test_eraseBack_destructors()
+   {  // setup
+      custom::deque<Spy> d;
+      for (int i = 0; i < 20; i++)
+         d.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      d.erase_back(17);
+      // verify
+      assertUnit(Spy::numDestructor() == 17);
+      assertUnit(Spy::numDelete() == 17);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(d.size() == 3);
+      assertUnit(d.back() == Spy(2));
+   }  // teardown
+
+   // runs of bulk operations at both ends agree with std::deque
+   void test_bulk_matchesStd()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      std::deque<int> dStd;
+      int a[13];
+      for (int i = 0; i < 13; i++)
+         a[i] = i * 10;
+      // exercise
+      for (int i = 0; i < 60; i++)
+      {
+         size_t num = (size_t)(i % 13);
+         if (i % 2)
+         {
+            d.append(a, a + num);
+            dStd.insert(dStd.end(), a, a + num);
+         }
+         else
+         {
+            d.prepend(a, a + num);
+            dStd.insert(dStd.begin(), a, a + num);
+         }
+         if (i % 5 == 0)
+         {
+            size_t numErase = dStd.size() / 3;
+            d.erase_front(numErase);
+            dStd.erase(dStd.begin(), dStd.begin() + numErase);
+         }
+         if (i % 7 == 0)
+         {
+            size_t numErase = dStd.size() / 2;
+            d.erase_back(numErase);
+            dStd.erase(dStd.end() - numErase, dStd.end());
+         }
+      }
+      // verify
+      bool same = (d.size() == dStd.size());
+      for (int id = 0; same && id < (int)d.size(); id++)
+         same = (d[id] == dStd[id]);
+      assertUnit(same);
+      d.erase_back(d.size());
+      assertUnit(d.empty());
+   }  // teardown
+
+   /***************************************
+    * RANDOM ACCESS AND SEGMENTS
+    ***************************************/
+
+   // the iterator walks a block by pointer and looks up the next one
+   void test_iterator_cacheWithinBlock()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      auto it = d.begin();
+      // exercise
+      int first = *it;
+      ++it;
+      ++it;
+      ++it;
+      // verify
+      assertUnit(first == 0);
+      assertUnit(it.pCell == &d.data[0][3]);
+      assertUnit(it.pFirst == d.data[0]);
+      assertUnit(*it == 3);
+      // exercise
+      ++it;
+      // verify
+      assertUnit(it.pCell == nullptr);
+      assertUnit(*it == 4);
+      assertUnit(it.pFirst == d.data[1]);
+      // exercise
+      --it;
+      // verify
+      assertUnit(it.pCell == nullptr);
+      assertUnit(*it == 3);
+   }  // teardown
+
+   // jumps, subscripts, and comparisons across blocks
+   void test_iterator_randomAccess()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      for (int i = 5; i < 12; i++)
+         d.push_back(i);
+      for (int i = 4; i >= 0; i--)
+         d.push_front(i);
+      auto itBegin = d.begin();
+      auto itEnd = d.end();
+      // exercise
+      auto it = itBegin + 7;
+      auto itBack = itEnd - 1;
+      // verify
+      assertUnit(*it == 7);
+      assertUnit(it[2] == 9);
+      assertUnit(it[-7] == 0);
+      assertUnit(*itBack == 11);
+      assertUnit(itEnd - it == 5);
+      assertUnit(itBegin < it);
+      assertUnit(it <= it);
+      assertUnit(itEnd > itBack);
+      assertUnit(*(2 + itBegin) == 2);
+      it -= 6;
+      assertUnit(*it == 1);
+   }  // teardown
+
+   // a random-access iterator is enough for std::sort
+   void test_iterator_sort()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      for (int i = 0; i < 50; i++)
+         if (i % 2)
+            d.push_back((i * 37) % 50);
+         else
+            d.push_front((i * 37) % 50);
+      // exercise
+      std::sort(d.begin(), d.end());
+      // verify
+      bool sorted = true;
+      for (int id = 0; id < 50; id++)
+         sorted = sorted && d[id] == id;
+      assertUnit(sorted);
+   }  // teardown
+
+   // a wrapped deque comes out one run per block
+   void test_segments_wrapped()
+   {  // setup
+      //                                     iaFront = 6
+      //   +----+----+----+----+  +----+----+----+----+
+      //   |  2 |  3 |  4 |  5 |  |    |    |  0 |  1 |
+      //   +----+----+----+----+  +----+----+----+----+
+      custom::deque<int, std::allocator<int>, 4> d;
+      for (int i = 2; i < 6; i++)
+         d.push_back(i);
+      d.push_front(1);
+      d.push_front(0);
+      std::vector<int> sizes;
+      std::vector<int> values;
+      // exercise
+      d.begin().for_each_segment(d.end(), [&](int * p, int * pEnd)
+      {
+         sizes.push_back((int)(pEnd - p));
+         for (; p != pEnd; ++p)
+            values.push_back(*p);
+      });
+      // verify
+      assertUnit(sizes.size() == 2);
+      if (sizes.size() == 2)
+      {
+         assertUnit(sizes[0] == 2);
+         assertUnit(sizes[1] == 4);
+      }
+      assertUnit(values == std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+   }  // teardown
+
+   // for_each, copy, and accumulate agree with the element loops
+   void test_segments_algorithms()
+   {  // setup
+      custom::deque<int, std::allocator<int>, 4> d;
+      for (int i = 1; i <= 30; i++)
+         if (i % 3)
+            d.push_back(i);
+         else
+            d.push_front(i);
+      std::vector<int> expected;
+      for (auto it = d.begin(); it != d.end(); ++it)
+         expected.push_back(*it);
+      std::vector<int> copied(30);
+      int count = 0;
+      // exercise
+      long sum = custom::accumulate(d.begin() + 1, d.end(), 0L);
+      custom::copy(d.begin(), d.end(), copied.begin());
+      custom::for_each(d.begin(), d.end(), [&count](int & x) { x *= 2; count++; });
+      // verify
+      assertUnit(sum == 465 - expected[0]);
+      assertUnit(copied == expected);
+      assertUnit(count == 30);
+      assertUnit(d.front() == 2 * expected[0]);
+      assertUnit(d.back() == 2 * expected[29]);
+   }  // teardown
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *    [31, 49, 55, 67]
@@ -3944,10 +4427,9 @@ public:
     *    numCell     = 3
     *    numBlock    = 4
     *************************************************************/
-   void setupStandardFixture(custom::deque<Spy>& d)
+   void setupStandardFixture(custom::deque<Spy, std::allocator<Spy>, 3>& d)
    {
       d.numBlocks   = 4;
-      d.numCells    = 3;
       d.numElements = 4;
       d.iaFront     = 4;
       d.data = new Spy * [d.numBlocks];
@@ -3966,7 +4448,8 @@ public:
    /*************************************************************
     * VERIFY EMPTY FIXTURE
     *************************************************************/
-   void assertEmptyFixtureParameters(const custom::deque<Spy>& d, int line, const char* function)
+   template <size_t N>
+   void assertEmptyFixtureParameters(const custom::deque<Spy, std::allocator<Spy>, N>& d, int line, const char* function)
    {
       assertIndirect(d.numBlocks == 0);
       assertIndirect(d.numCells == 16);
@@ -3992,7 +4475,8 @@ public:
     *    numCell     = 3
     *    numBlock    = 4
     *************************************************************/
-   void assertStandardFixtureParameters(const custom::deque<Spy>& d, int line, const char* function)
+   template <size_t N>
+   void assertStandardFixtureParameters(const custom::deque<Spy, std::allocator<Spy>, N>& d, int line, const char* function)
    {
       assertIndirect(d.numBlocks == 4);
       assertIndirect(d.numCells == 3);
@@ -4026,7 +4510,8 @@ public:
     *    |    |    |    |    |
     *    +----+----+----+----+
     *************************************************************/
-   void teardownStandardFixture(custom::deque<Spy>& d)
+   template <size_t N>
+   void teardownStandardFixture(custom::deque<Spy, std::allocator<Spy>, N>& d)
    {
       if (d.data)
       {
@@ -4054,7 +4539,6 @@ public:
       d.data = nullptr;
       d.numBlocks = 0;
       d.numElements = 0;
-      d.numCells = 0;
    }
 
 };
@@ -0,0 +1,313 @@
+/***********************************************************************
+ * Header:
+ *    TEST MPMC QUEUE
+ * Summary:
+ *    Unit tests for the multi-producer multi-consumer queue
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mpmc_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <thread>
+#include <vector>
+
+class TestMpmcQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_roundUp();
+      test_construct_sequence();
+      test_destruct_standard();
+
+      // Insert
+      test_push_empty();
+      test_push_full();
+      test_pushBatch_partial();
+
+      // Remove
+      test_pop_empty();
+      test_pop_standard();
+      test_popBatch_wrapped();
+
+      // Threads
+      test_threads_everyOnce();
+      test_threads_batch();
+
+      report("MpmcQueue");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // the capacity rounds up to a power of two, never below two
+   void test_construct_roundUp()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::mpmc_queue<Spy> q5(5);
+      custom::mpmc_queue<Spy> q1(1);
+      // verify
+      assertUnit(q5.capacity() == 8);
+      assertUnit(q5.mask == 7);
+      assertUnit(q1.capacity() == 2);
+      assertUnit(q5.empty());
+      assertUnit(q5.iHead == 0);
+      assertUnit(q5.iTail == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // every slot starts free for the first lap
+   void test_construct_sequence()
+   {  // exercise
+      custom::mpmc_queue<int> q(4);
+      // verify
+      assertUnit(q.cells[0].seq == 0);
+      assertUnit(q.cells[1].seq == 1);
+      assertUnit(q.cells[2].seq == 2);
+      assertUnit(q.cells[3].seq == 3);
+   }  // teardown
+
+   // the destructor destroys what is still in the queue
+   void test_destruct_standard()
+   {  // setup
+      {
+         custom::mpmc_queue<Spy> q(4);
+         q.push_back(Spy(26));
+         q.push_back(Spy(49));
+         Spy::reset();
+      }  // exercise
+      // verify
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numDelete() == 2);
+   }
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // push into an empty queue marks the slot full
+   void test_push_empty()
+   {  // setup
+      custom::mpmc_queue<Spy> q(4);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      bool pushed = q.try_push_back(s);
+      // verify
+      assertUnit(pushed);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(q.size() == 1);
+      assertUnit(q.cells[0].seq == 1);
+      assertUnit(*q.cells[0].pValue() == Spy(99));
+   }  // teardown
+
+   // push into a full queue fails without touching the element
+   void test_push_full()
+   {  // setup
+      custom::mpmc_queue<Spy> q(2);
+      q.push_back(Spy(11));
+      q.push_back(Spy(28));
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      bool pushed = q.try_push_back(s);
+      // verify
+      assertUnit(!pushed);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(q.size() == 2);
+      assertUnit(q.iTail == 2);
+   }  // teardown
+
+   // a batch push claims as many slots as are free
+   void test_pushBatch_partial()
+   {  // setup
+      custom::mpmc_queue<int> q(4);
+      q.push_back(1);
+      std::vector<int> v = { 2, 3, 4, 5, 6 };
+      // exercise
+      size_t num = q.try_push_back(v.begin(), v.end());
+      // verify
+      assertUnit(num == 3);
+      assertUnit(q.size() == 4);
+      assertUnit(q.iTail == 4);
+      assertUnit(*q.cells[1].pValue() == 2);
+      assertUnit(*q.cells[3].pValue() == 4);
+      assertUnit(q.cells[3].seq == 4);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop from an empty queue fails
+   void test_pop_empty()
+   {  // setup
+      custom::mpmc_queue<Spy> q(4);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      bool popped = q.try_pop_front(s);
+      // verify
+      assertUnit(!popped);
+      assertUnit(s == Spy(99));
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(q.iHead == 0);
+   }  // teardown
+
+   // pop hands back the front element and frees the slot for the next lap
+   void test_pop_standard()
+   {  // setup
+      custom::mpmc_queue<Spy> q(4);
+      q.push_back(Spy(26));
+      q.push_back(Spy(49));
+      Spy s;
+      Spy::reset();
+      // exercise
+      bool popped = q.try_pop_front(s);
+      // verify
+      assertUnit(popped);
+      assertUnit(Spy::numAssignMove() == 1);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(s == Spy(26));
+      assertUnit(q.size() == 1);
+      assertUnit(q.iHead == 1);
+      assertUnit(q.cells[0].seq == 4);
+   }  // teardown
+
+   // a batch pop across the end of the ring
+   void test_popBatch_wrapped()
+   {  // setup
+      //           iHead=6
+      //   +----+----+----+----+
+      //   | 7  | 8  | 5  | 6  |
+      //   +----+----+----+----+
+      //          iTail=10
+      custom::mpmc_queue<int> q(4);
+      int discard[4];
+      for (int i = 1; i <= 4; i++)
+         q.push_back(i);
+      q.pop_front(discard, 4);
+      for (int i = 5; i <= 6; i++)
+         q.push_back(i);
+      q.pop_front(discard, 2);
+      for (int i = 5; i <= 8; i++)
+         q.push_back(i);
+      int out[8] = {};
+      // exercise
+      size_t num = q.try_pop_front(out, 8);
+      // verify
+      assertUnit(num == 4);
+      assertUnit(out[0] == 5);
+      assertUnit(out[1] == 6);
+      assertUnit(out[2] == 7);
+      assertUnit(out[3] == 8);
+      assertUnit(q.empty());
+      assertUnit(q.iHead == 10);
+      assertUnit(q.try_pop_front(out, 8) == 0);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // four producers and four consumers: every value arrives exactly once
+   void test_threads_everyOnce()
+   {  // setup
+      custom::mpmc_queue<int> q(64);
+      const int numThreads = 4;
+      const int numEach = 20000;
+      std::vector<int> seen(numThreads * numEach, 0);
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&q, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+               q.push_back(t * numEach + i);
+         }));
+      std::vector<std::vector<int>> got(numThreads);
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&q, &got, t, numEach]()
+         {
+            int value;
+            for (int i = 0; i < numEach; i++)
+            {
+               q.pop_front(value);
+               got[t].push_back(value);
+            }
+         }));
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      for (auto & values : got)
+         for (int value : values)
+            seen[value]++;
+      bool everyOnce = true;
+      for (int count : seen)
+         everyOnce = everyOnce && count == 1;
+      assertUnit(everyOnce);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // batches from two producers keep each producer's order
+   void test_threads_batch()
+   {  // setup
+      custom::mpmc_queue<int> q(32);
+      const int numEach = 50000;
+      // exercise
+      auto produce = [&q, numEach](int sign)
+      {
+         std::vector<int> batch(8);
+         for (int i = 1; i <= numEach; i += 8)
+         {
+            for (int j = 0; j < 8; j++)
+               batch[j] = sign * (i + j);
+            q.push_back(batch.begin(), batch.end());
+         }
+      };
+      std::thread plus(produce, 1);
+      std::thread minus(produce, -1);
+      int lastPlus = 0;
+      int lastMinus = 0;
+      bool inOrder = true;
+      int buffer[16];
+      for (int numGot = 0; numGot < 2 * numEach; )
+      {
+         size_t got = q.try_pop_front(buffer, 16);
+         if (got == 0)
+            std::this_thread::yield();
+         for (size_t i = 0; i < got; i++)
+            if (buffer[i] > 0)
+               inOrder = inOrder && buffer[i] == ++lastPlus;
+            else
+               inOrder = inOrder && -buffer[i] == ++lastMinus;
+         numGot += (int)got;
+      }
+      plus.join();
+      minus.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(lastPlus == numEach);
+      assertUnit(lastMinus == numEach);
+      assertUnit(q.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,262 @@
+/***********************************************************************
+ * Header:
+ *    TEST SPSC QUEUE
+ * Summary:
+ *    Unit tests for the single-producer single-consumer queue
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "spsc_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <thread>
+#include <vector>
+
+class TestSpscQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_roundUp();
+      test_destruct_standard();
+
+      // Insert
+      test_push_empty();
+      test_push_full();
+      test_pushBatch_partial();
+      test_pushBatch_staleCache();
+
+      // Remove
+      test_pop_empty();
+      test_pop_standard();
+      test_popBatch_wrapped();
+
+      // Threads
+      test_threads_inOrder();
+
+      report("SpscQueue");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // the capacity rounds up to a power of two
+   void test_construct_roundUp()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::spsc_queue<Spy> q(5);
+      // verify
+      assertUnit(q.capacity() == 8);
+      assertUnit(q.mask == 7);
+      assertUnit(q.empty());
+      assertUnit(q.iHead == 0);
+      assertUnit(q.iTail == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // the destructor destroys what is still in the queue
+   void test_destruct_standard()
+   {  // setup
+      {
+         custom::spsc_queue<Spy> q(4);
+         q.push_back(Spy(26));
+         q.push_back(Spy(49));
+         Spy::reset();
+      }  // exercise
+      // verify
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numDelete() == 2);
+   }
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // push into an empty queue
+   void test_push_empty()
+   {  // setup
+      custom::spsc_queue<Spy> q(4);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      bool pushed = q.push_back(s);
+      // verify
+      assertUnit(pushed);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(q.size() == 1);
+      assertUnit(q.data[0] == Spy(99));
+   }  // teardown
+
+   // push into a full queue fails without touching the element
+   void test_push_full()
+   {  // setup
+      custom::spsc_queue<Spy> q(2);
+      q.push_back(Spy(11));
+      q.push_back(Spy(28));
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      bool pushed = q.push_back(s);
+      // verify
+      assertUnit(!pushed);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(q.size() == 2);
+   }  // teardown
+
+   // a batch push stops when the ring fills
+   void test_pushBatch_partial()
+   {  // setup
+      custom::spsc_queue<int> q(4);
+      q.push_back(1);
+      std::vector<int> v = { 2, 3, 4, 5, 6 };
+      // exercise
+      size_t num = q.push_back(v.begin(), v.end());
+      // verify
+      assertUnit(num == 3);
+      assertUnit(q.size() == 4);
+      assertUnit(q.iTail == 4);
+      assertUnit(q.data[1] == 2);
+      assertUnit(q.data[3] == 4);
+   }  // teardown
+
+   // a batch push fills the room freed since the head was last cached
+   void test_pushBatch_staleCache()
+   {  // setup
+      custom::spsc_queue<int> q(4);
+      q.push_back(1);
+      q.push_back(2);
+      int value;
+      q.pop_front(value);
+      q.pop_front(value);
+      assertUnit(q.iHeadCache == 0);
+      std::vector<int> v = { 3, 4, 5, 6, 7 };
+      // exercise
+      size_t num = q.push_back(v.begin(), v.end());
+      // verify
+      assertUnit(num == 4);
+      assertUnit(q.size() == 4);
+      assertUnit(q.iTail == 6);
+      assertUnit(q.iHeadCache == 2);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop from an empty queue fails
+   void test_pop_empty()
+   {  // setup
+      custom::spsc_queue<Spy> q(4);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      bool popped = q.pop_front(s);
+      // verify
+      assertUnit(!popped);
+      assertUnit(s == Spy(99));
+      assertUnit(Spy::numAssignMove() == 0);
+   }  // teardown
+
+   // pop hands back the front element
+   void test_pop_standard()
+   {  // setup
+      custom::spsc_queue<Spy> q(4);
+      q.push_back(Spy(26));
+      q.push_back(Spy(49));
+      Spy s;
+      Spy::reset();
+      // exercise
+      bool popped = q.pop_front(s);
+      // verify
+      assertUnit(popped);
+      assertUnit(Spy::numAssignMove() == 1);
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(s == Spy(26));
+      assertUnit(q.size() == 1);
+      assertUnit(q.iHead == 1);
+   }  // teardown
+
+   // a batch pop across the end of the ring
+   void test_popBatch_wrapped()
+   {  // setup
+      //           iHead=6
+      //   +----+----+----+----+
+      //   | 7  | 8  | 5  | 6  |
+      //   +----+----+----+----+
+      //          iTail=10
+      custom::spsc_queue<int> q(4);
+      int discard[4];
+      for (int i = 1; i <= 4; i++)
+         q.push_back(i);
+      q.pop_front(discard, 4);
+      for (int i = 5; i <= 6; i++)
+         q.push_back(i);
+      q.pop_front(discard, 2);
+      for (int i = 5; i <= 8; i++)
+         q.push_back(i);
+      q.pop_front(discard, 0);
+      int out[8] = {};
+      // exercise
+      size_t num = q.pop_front(out, 8);
+      // verify
+      assertUnit(num == 4);
+      assertUnit(out[0] == 5);
+      assertUnit(out[1] == 6);
+      assertUnit(out[2] == 7);
+      assertUnit(out[3] == 8);
+      assertUnit(q.empty());
+      assertUnit(q.iHead == 10);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // everything the producer sends arrives in order
+   void test_threads_inOrder()
+   {  // setup
+      custom::spsc_queue<int> q(64);
+      const int num = 200000;
+      // exercise
+      std::thread producer([&q, num]()
+      {
+         for (int i = 0; i < num; )
+            if (q.push_back(i))
+               i++;
+            else
+               std::this_thread::yield();
+      });
+      bool inOrder = true;
+      int buffer[16];
+      for (int expected = 0; expected < num; )
+      {
+         size_t got = q.pop_front(buffer, 16);
+         if (got == 0)
+            std::this_thread::yield();
+         for (size_t i = 0; i < got; i++)
+            inOrder = inOrder && (buffer[i] == expected++);
+      }
+      producer.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(q.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,231 @@
+/***********************************************************************
+ * Header:
+ *    TEST WS DEQUE
+ * Summary:
+ *    Unit tests for the work-stealing deque
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "ws_deque.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestWsDeque : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_roundUp();
+
+      // Owner
+      test_push_standard();
+      test_push_grow();
+      test_popBack_empty();
+      test_popBack_lifo();
+
+      // Thieves
+      test_steal_empty();
+      test_steal_fifo();
+      test_steal_lastOne();
+
+      // Threads
+      test_threads_everyOnce();
+
+      report("WsDeque");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // the capacity rounds up to a power of two
+   void test_construct_roundUp()
+   {  // exercise
+      custom::ws_deque<int> d(5);
+      // verify
+      assertUnit(d.capacity() == 8);
+      assertUnit(d.empty());
+      assertUnit(d.top == 0);
+      assertUnit(d.bottom == 0);
+      assertUnit(d.buffer.load()->pPrev == nullptr);
+   }  // teardown
+
+   /***************************************
+    * OWNER
+    ***************************************/
+
+   // push puts the value at bottom and moves bottom
+   void test_push_standard()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      // exercise
+      d.push_back(26);
+      d.push_back(49);
+      // verify
+      assertUnit(d.size() == 2);
+      assertUnit(d.bottom == 2);
+      assertUnit(d.top == 0);
+      assertUnit(d.buffer.load()->get(0) == 26);
+      assertUnit(d.buffer.load()->get(1) == 49);
+   }  // teardown
+
+   // pushing into a full buffer doubles it and keeps the old one
+   void test_push_grow()
+   {  // setup
+      custom::ws_deque<int> d(2);
+      d.push_back(1);
+      d.push_back(2);
+      auto pOld = d.buffer.load();
+      // exercise
+      d.push_back(3);
+      // verify
+      assertUnit(d.capacity() == 4);
+      assertUnit(d.buffer.load()->pPrev == pOld);
+      assertUnit(d.size() == 3);
+      assertUnit(d.buffer.load()->get(0) == 1);
+      assertUnit(d.buffer.load()->get(2) == 3);
+   }  // teardown
+
+   // pop from an empty deque fails and leaves bottom alone
+   void test_popBack_empty()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      int value = 99;
+      // exercise
+      bool popped = d.pop_back(value);
+      // verify
+      assertUnit(!popped);
+      assertUnit(value == 99);
+      assertUnit(d.bottom == 0);
+      assertUnit(d.top == 0);
+   }  // teardown
+
+   // the owner gets the newest first
+   void test_popBack_lifo()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      for (int i = 1; i <= 6; i++)
+         d.push_back(i);
+      int a = 0;
+      int b = 0;
+      // exercise
+      d.pop_back(a);
+      d.pop_back(b);
+      // verify
+      assertUnit(a == 6);
+      assertUnit(b == 5);
+      assertUnit(d.size() == 4);
+   }  // teardown
+
+   /***************************************
+    * THIEVES
+    ***************************************/
+
+   // steal from an empty deque fails
+   void test_steal_empty()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      int value = 99;
+      // exercise
+      bool stolen = d.steal_front(value);
+      // verify
+      assertUnit(!stolen);
+      assertUnit(value == 99);
+      assertUnit(d.top == 0);
+   }  // teardown
+
+   // thieves get the oldest first
+   void test_steal_fifo()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      for (int i = 1; i <= 3; i++)
+         d.push_back(i);
+      int a = 0;
+      int b = 0;
+      // exercise
+      d.steal_front(a);
+      d.steal_front(b);
+      // verify
+      assertUnit(a == 1);
+      assertUnit(b == 2);
+      assertUnit(d.top == 2);
+      assertUnit(d.size() == 1);
+   }  // teardown
+
+   // once a thief takes the last one the owner finds nothing
+   void test_steal_lastOne()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      d.push_back(26);
+      int stolen = 0;
+      int popped = 0;
+      // exercise
+      bool gotSteal = d.steal_front(stolen);
+      bool gotPop = d.pop_back(popped);
+      // verify
+      assertUnit(gotSteal);
+      assertUnit(!gotPop);
+      assertUnit(stolen == 26);
+      assertUnit(d.empty());
+      assertUnit(d.bottom == 1);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // an owner pushing and popping while three thieves steal:
+   // every value is taken exactly once
+   void test_threads_everyOnce()
+   {  // setup
+      custom::ws_deque<int> d(4);
+      const int num = 100000;
+      std::vector<std::atomic<int>> seen(num);
+      for (auto & count : seen)
+         count = 0;
+      std::atomic<bool> done(false);
+      std::vector<std::thread> thieves;
+      // exercise
+      for (int t = 0; t < 3; t++)
+         thieves.push_back(std::thread([&]()
+         {
+            int value;
+            while (!done.load())
+               if (d.steal_front(value))
+                  seen[value]++;
+               else
+                  std::this_thread::yield();
+         }));
+      int value;
+      for (int i = 0; i < num; i++)
+      {
+         d.push_back(i);
+         if (i % 3 == 0 && d.pop_back(value))
+            seen[value]++;
+      }
+      while (d.pop_back(value))
+         seen[value]++;
+      done = true;
+      for (auto & thief : thieves)
+         thief.join();
+      // verify
+      bool everyOnce = true;
+      for (auto & count : seen)
+         everyOnce = everyOnce && count == 1;
+      assertUnit(everyOnce);
+      assertUnit(d.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,156 @@
+/***********************************************************************
+ * Header:
+ *    TEST WS POOL
+ * Summary:
+ *    Unit tests for the work-stealing thread pool
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "ws_pool.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+class TestWsPool : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_standard();
+
+      // Fork and join
+      test_spawn_outside();
+      test_spawn_nested();
+      test_spawn_throws();
+
+      // Idle
+      test_idle_sleeps();
+
+      report("WsPool");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // one deque per worker, and the caller is not a worker
+   void test_construct_standard()
+   {  // exercise
+      custom::ws_pool pool(3);
+      // verify
+      assertUnit(pool.size() == 3);
+      assertUnit(pool.workers.size() == 3);
+      assertUnit(pool.iSelf() == 3);
+      assertUnit(pool.inbox.empty());
+   }  // teardown
+
+   /***************************************
+    * FORK AND JOIN
+    ***************************************/
+
+   // tasks spawned from outside the pool all run before wait returns
+   void test_spawn_outside()
+   {  // setup
+      custom::ws_pool pool(2);
+      custom::task_group group;
+      std::atomic<int> sum(0);
+      // exercise
+      for (int i = 1; i <= 100; i++)
+         pool.spawn(group, [&sum, i]() { sum += i; });
+      pool.wait(group);
+      // verify
+      assertUnit(group.done());
+      assertUnit(sum == 5050);
+   }  // teardown
+
+   // a task that spawns and waits on its own children
+   void test_spawn_nested()
+   {  // setup
+      custom::ws_pool pool(4);
+      custom::task_group group;
+      long result = 0;
+      // exercise
+      pool.spawn(group, [&]() { result = fib(pool, 18); });
+      pool.wait(group);
+      // verify
+      assertUnit(result == 2584);
+   }  // teardown
+
+   // a throw reaches wait, and every other task still runs
+   void test_spawn_throws()
+   {  // setup
+      custom::ws_pool pool(2);
+      custom::task_group group;
+      std::atomic<int> sum(0);
+      bool isThrown = false;
+      // exercise
+      for (int i = 1; i <= 10; i++)
+         pool.spawn(group, [&sum, i]()
+         {
+            sum += i;
+            if (i == 5)
+               throw std::runtime_error("five");
+         });
+      try
+      {
+         pool.wait(group);
+      }
+      catch (const std::runtime_error & e)
+      {
+         isThrown = (std::string(e.what()) == "five");
+      }
+      // verify
+      assertUnit(isThrown);
+      assertUnit(group.done());
+      assertUnit(sum == 55);
+      assertUnit(!group.isFailed);
+      assertUnit(group.pException == nullptr);
+   }  // teardown
+
+   /***************************************
+    * IDLE
+    ***************************************/
+
+   // workers with nothing to do go to sleep, and a spawn wakes one
+   void test_idle_sleeps()
+   {  // setup
+      custom::ws_pool pool(2);
+      for (int n = 0; n < 1000 && pool.numIdle < 2; n++)
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      assertUnit(pool.numIdle == 2);
+      custom::task_group group;
+      std::atomic<int> sum(0);
+      // exercise
+      pool.spawn(group, [&sum]() { sum += 1; });
+      pool.wait(group);
+      // verify
+      assertUnit(sum == 1);
+      assertUnit(group.done());
+   }  // teardown
+
+   // fork one half, do the other, join
+   static long fib(custom::ws_pool & pool, int n)
+   {
+      if (n < 2)
+         return n;
+      long a = 0;
+      custom::task_group children;
+      pool.spawn(children, [&]() { a = fib(pool, n - 1); });
+      long b = fib(pool, n - 2);
+      pool.wait(children);
+      return a + b;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Header:
+ *    WORK-STEALING DEQUE
+ * Summary:
+ *    The Chase-Lev deque: one owner thread pushes and pops at the back
+ *    while any number of thief threads steal from the front
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        ws_deque              : A growable work-stealing deque
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t, ptrdiff_t
+#include <type_traits> // for std::is_trivially_copyable
+#include "spsc_queue.h"   // for CACHE_LINE
+
+class TestWsDeque;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/******************************************************
+ * WS DEQUE
+ * A circular buffer indexed by two counters that only
+ * grow: top (the front, where thieves steal) and bottom
+ * (the back, where the owner works). The owner doubles
+ * the buffer when it fills. A thief may still be reading
+ * the old buffer, so old buffers are kept until the
+ * deque is destroyed. The orderings follow Le, Pop,
+ * Cohen and Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ *
+ * Thieves read slots that the owner may be writing, so
+ * the slots are atomics and T must be trivially copyable:
+ * in practice a pointer to a task.
+ *****************************************************/
+template <typename T>
+class ws_deque
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "ws_deque holds trivially copyable values such as task pointers");
+
+   friend class ::TestWsDeque; // give unit tests access to the privates
+
+   // one circular buffer. Old ones stay on a list through pPrev
+   struct Buffer
+   {
+      Buffer(size_t numCapacity, Buffer * pPrev) :
+         numCapacity(numCapacity), mask(numCapacity - 1),
+         slots(new std::atomic<T>[numCapacity]), pPrev(pPrev) {}
+      ~Buffer() { delete[] slots; }
+
+      T    get(ptrdiff_t i) const     { return slots[i & mask].load(std::memory_order_relaxed); }
+      void put(ptrdiff_t i, T t)      { slots[i & mask].store(t, std::memory_order_relaxed); }
+
+      size_t numCapacity;          // a power of two
+      size_t mask;                 // numCapacity - 1
+      std::atomic<T> * slots;
+      Buffer * pPrev;              // the buffer this one replaced
+   };
+
+public:
+
+   //
+   // Construct
+   //
+   ws_deque(size_t numCapacity = 64);
+   ws_deque(const ws_deque &) = delete;
+   ws_deque & operator = (const ws_deque &) = delete;
+   ~ws_deque();
+
+   //
+   // Owner only
+   //
+   void push_back(T t);
+   bool pop_back(T & t);
+
+   //
+   // Any thread. False when empty or when another thread
+   // took the element first
+   //
+   bool steal_front(T & t);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size() const
+   {
+      ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+      ptrdiff_t t = top.load(std::memory_order_relaxed);
+      return b > t ? (size_t)(b - t) : 0;
+   }
+   bool   empty()    const { return size() == 0; }
+   size_t capacity() const { return buffer.load(std::memory_order_relaxed)->numCapacity; }
+
+private:
+
+   Buffer * grow(Buffer * pOld, ptrdiff_t t, ptrdiff_t b);
+
+   alignas(CACHE_LINE) std::atomic<ptrdiff_t> top;       // next to steal
+   alignas(CACHE_LINE) std::atomic<ptrdiff_t> bottom;    // next free slot at the back
+   std::atomic<Buffer *> buffer;                         // the current buffer
+};
+
+/*****************************************
+ * WS DEQUE :: CONSTRUCTOR
+ ****************************************/
+template <typename T>
+ws_deque <T> ::ws_deque(size_t numCapacity)
+{
+   size_t num = 2;
+   while (num < numCapacity)
+      num *= 2;
+   top.store(0, std::memory_order_relaxed);
+   bottom.store(0, std::memory_order_relaxed);
+   buffer.store(new Buffer(num, nullptr), std::memory_order_relaxed);
+}
+
+/*****************************************
+ * WS DEQUE :: DESTRUCTOR
+ * Free the current buffer and every one it replaced
+ ****************************************/
+template <typename T>
+ws_deque <T> :: ~ws_deque()
+{
+   Buffer * p = buffer.load(std::memory_order_relaxed);
+   while (p)
+   {
+      Buffer * pPrev = p->pPrev;
+      delete p;
+      p = pPrev;
+   }
+}
+
+/*****************************************
+ * WS DEQUE :: GROW
+ * Copy [t, b) into a buffer twice the size and
+ * publish it. Only the owner calls this
+ ****************************************/
+template <typename T>
+typename ws_deque <T> ::Buffer * ws_deque <T> ::grow(Buffer * pOld, ptrdiff_t t, ptrdiff_t b)
+{
+   Buffer * pNew = new Buffer(pOld->numCapacity * 2, pOld);
+   for (ptrdiff_t i = t; i < b; i++)
+      pNew->put(i, pOld->get(i));
+   buffer.store(pNew, std::memory_order_release);
+   return pNew;
+}
+
+/*****************************************
+ * WS DEQUE :: PUSH BACK
+ * Write the slot, then make it visible by
+ * moving bottom. The paper uses a release fence
+ * and a relaxed store; a release store is the
+ * same on x86 and is one thread sanitizers follow
+ ****************************************/
+template <typename T>
+void ws_deque <T> ::push_back(T t)
+{
+   ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+   ptrdiff_t tp = top.load(std::memory_order_acquire);
+   Buffer * p = buffer.load(std::memory_order_relaxed);
+
+   if (b - tp > (ptrdiff_t)p->numCapacity - 1)
+      p = grow(p, tp, b);
+
+   p->put(b, t);
+   bottom.store(b + 1, std::memory_order_release);
+}
+
+/*****************************************
+ * WS DEQUE :: POP BACK
+ * Reserve the last slot by moving bottom down.
+ * When it is also the only one, race the
+ * thieves for it on top
+ ****************************************/
+template <typename T>
+bool ws_deque <T> ::pop_back(T & t)
+{
+   ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+   Buffer * p = buffer.load(std::memory_order_relaxed);
+   bottom.store(b, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   ptrdiff_t tp = top.load(std::memory_order_relaxed);
+
+   // empty: put bottom back
+   if (tp > b)
+   {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+   }
+
+   t = p->get(b);
+   if (tp < b)
+      return true;
+
+   // the last element: whoever moves top gets it
+   bool won = top.compare_exchange_strong(tp, tp + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed);
+   bottom.store(b + 1, std::memory_order_relaxed);
+   return won;
+}
+
+/*****************************************
+ * WS DEQUE :: STEAL FRONT
+ * Read the front slot, then claim it by
+ * moving top
+ ****************************************/
+template <typename T>
+bool ws_deque <T> ::steal_front(T & t)
+{
+   ptrdiff_t tp = top.load(std::memory_order_acquire);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   ptrdiff_t b = bottom.load(std::memory_order_acquire);
+   if (tp >= b)
+      return false;
+
+   Buffer * p = buffer.load(std::memory_order_acquire);
+   T value = p->get(tp);
+   if (!top.compare_exchange_strong(tp, tp + 1,
+                                    std::memory_order_seq_cst,
+                                    std::memory_order_relaxed))
+      return false;
+   t = value;
+   return true;
+}
+
+} // namespace custom
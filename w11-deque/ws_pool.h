@@ -0,0 +1,336 @@
+/***********************************************************************
+ * Header:
+ *    WORK-STEALING POOL
+ * Summary:
+ *    A fork/join thread pool. Every worker runs the tasks on its own
+ *    ws_deque and steals from the others when it runs dry
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        task_group            : A set of tasks to wait on together
+ *        ws_pool               : The workers and their deques
+ * Author
+ *    Daniel Malasky, Calvin Bullock
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstdint>     // for uint64_t
+#include <exception>   // for std::exception_ptr
+#include <functional>  // for std::function
+#include <mutex>       // for std::mutex
+#include <thread>      // for std::thread
+#include <utility>     // for std::forward
+#include <vector>      // for std::vector
+#include "ws_deque.h"
+#include "mpmc_queue.h"
+
+class TestWsPool;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/******************************************************
+ * TASK GROUP
+ * Counts the tasks spawned into it that have not
+ * finished yet, and keeps the first exception one
+ * of them threw for wait() to rethrow
+ *****************************************************/
+class task_group
+{
+   friend class ws_pool;
+   friend class ::TestWsPool; // give unit tests access to the privates
+public:
+   task_group() : numPending(0), isFailed(false) {}
+   task_group(const task_group &) = delete;
+   task_group & operator = (const task_group &) = delete;
+
+   bool done() const { return numPending.load(std::memory_order_acquire) == 0; }
+
+private:
+   // only the first task to throw writes pException
+   void fail(std::exception_ptr p)
+   {
+      if (!isFailed.exchange(true, std::memory_order_relaxed))
+         pException = p;
+   }
+
+   std::atomic<size_t> numPending;
+   std::atomic<bool> isFailed;
+   std::exception_ptr pException;
+};
+
+/******************************************************
+ * WS POOL
+ * spawn() from a worker pushes onto that worker's own
+ * deque, so a recursive task keeps its children close
+ * and thieves take the oldest (largest) pieces. spawn()
+ * from any other thread goes through a shared queue.
+ * wait() runs tasks until the group is done, so a task
+ * may wait on its own children. A thread with nothing
+ * to run spins a few times, then sleeps until a spawn,
+ * a finished group or the destructor wakes it.
+ *****************************************************/
+class ws_pool
+{
+   friend class ::TestWsPool; // give unit tests access to the privates
+
+   struct Task
+   {
+      std::function<void()> work;
+      task_group * pGroup;
+   };
+
+   struct Worker
+   {
+      ws_deque<Task *> tasks;
+      std::thread thread;
+   };
+
+public:
+
+   //
+   // Construct
+   //
+   ws_pool(size_t numThreads = std::thread::hardware_concurrency());
+   ws_pool(const ws_pool &) = delete;
+   ws_pool & operator = (const ws_pool &) = delete;
+   ~ws_pool();
+
+   //
+   // Fork and join
+   //
+   template <class F>
+   void spawn(task_group & group, F && f);
+   void wait(task_group & group);
+
+   size_t size() const { return workers.size(); }
+
+private:
+
+   void work(size_t iWorker);
+   bool runOne(size_t iWorker);
+   Task * find(size_t iWorker);
+   void idle(size_t iWorker, const task_group * pGroup);
+   void wake(bool all);
+
+   // the worker the calling thread is, in this pool, or size() if none
+   size_t iSelf() const
+   {
+      return pSelfPool == this ? iSelfWorker : workers.size();
+   }
+
+   std::vector<Worker *> workers;
+   mpmc_queue<Task *> inbox;        // tasks spawned from outside the pool
+   std::atomic<bool> stopping;
+
+   // parking for idle threads
+   static const int NUM_SPINS = 64;   // failed tries before sleeping
+   std::atomic<uint64_t> generation;  // bumped by anything worth waking for
+   std::atomic<size_t> numIdle;       // threads asleep or about to be
+   std::mutex mutexIdle;
+   std::condition_variable cvIdle;
+
+   static thread_local const ws_pool * pSelfPool;
+   static thread_local size_t iSelfWorker;
+};
+
+inline thread_local const ws_pool * ws_pool::pSelfPool = nullptr;
+inline thread_local size_t ws_pool::iSelfWorker = 0;
+
+/*****************************************
+ * WS POOL :: CONSTRUCTOR
+ * Make every deque before any worker starts
+ * looking at them
+ ****************************************/
+inline ws_pool::ws_pool(size_t numThreads) :
+   inbox(1024), stopping(false), generation(0), numIdle(0)
+{
+   if (numThreads == 0)
+      numThreads = 1;
+   for (size_t i = 0; i < numThreads; i++)
+      workers.push_back(new Worker);
+   for (size_t i = 0; i < numThreads; i++)
+      workers[i]->thread = std::thread(&ws_pool::work, this, i);
+}
+
+/*****************************************
+ * WS POOL :: DESTRUCTOR
+ * Stop the workers, waking any that sleep.
+ * Spawned tasks should have been waited on by now
+ ****************************************/
+inline ws_pool :: ~ws_pool()
+{
+   stopping.store(true, std::memory_order_seq_cst);
+   wake(true /*all*/);
+   for (Worker * pWorker : workers)
+      pWorker->thread.join();
+   for (Worker * pWorker : workers)
+      delete pWorker;
+}
+
+/*****************************************
+ * WS POOL :: SPAWN
+ * Queue f to run as part of group
+ ****************************************/
+template <class F>
+void ws_pool::spawn(task_group & group, F && f)
+{
+   group.numPending.fetch_add(1, std::memory_order_relaxed);
+   Task * pTask = new Task{ std::function<void()>(std::forward<F>(f)), &group };
+
+   size_t i = iSelf();
+   if (i < workers.size())
+      workers[i]->tasks.push_back(pTask);
+   else
+      inbox.push_back(pTask);
+   wake(false /*all*/);
+}
+
+/*****************************************
+ * WS POOL :: WAIT
+ * Run tasks until everything in group is done,
+ * then rethrow the first exception a task threw
+ ****************************************/
+inline void ws_pool::wait(task_group & group)
+{
+   size_t i = iSelf();
+   while (!group.done())
+      if (!runOne(i))
+         idle(i, &group);
+
+   if (group.isFailed.load(std::memory_order_relaxed))
+   {
+      std::exception_ptr p = group.pException;
+      group.pException = nullptr;
+      group.isFailed.store(false, std::memory_order_relaxed);
+      std::rethrow_exception(p);
+   }
+}
+
+/*****************************************
+ * WS POOL :: FIND
+ * Our own newest task first, then the shared
+ * queue, then the oldest task of another worker
+ ****************************************/
+inline ws_pool::Task * ws_pool::find(size_t iWorker)
+{
+   Task * pTask = nullptr;
+   if (iWorker < workers.size() && workers[iWorker]->tasks.pop_back(pTask))
+      return pTask;
+   if (inbox.try_pop_front(pTask))
+      return pTask;
+
+   size_t num = workers.size();
+   size_t iStart = (iWorker + 1) % num;
+   for (size_t n = 0; n < num; n++)
+   {
+      size_t iVictim = (iStart + n) % num;
+      if (iVictim != iWorker && workers[iVictim]->tasks.steal_front(pTask))
+         return pTask;
+   }
+   return nullptr;
+}
+
+/*****************************************
+ * WS POOL :: RUN ONE
+ * Find a task and run it. False if there was none.
+ * A throw is kept in the task's group, and the task
+ * counts as finished either way
+ ****************************************/
+inline bool ws_pool::runOne(size_t iWorker)
+{
+   Task * pTask = find(iWorker);
+   if (!pTask)
+      return false;
+
+   task_group * pGroup = pTask->pGroup;
+   try
+   {
+      pTask->work();
+   }
+   catch (...)
+   {
+      pGroup->fail(std::current_exception());
+   }
+   delete pTask;
+
+   // the last task of a group wakes whoever sleeps in wait()
+   if (pGroup->numPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      wake(true /*all*/);
+   return true;
+}
+
+/*****************************************
+ * WS POOL :: IDLE
+ * Nothing to run: try again a few times, then
+ * sleep until the generation moves, the pool
+ * stops, or pGroup (if any) is done
+ ****************************************/
+inline void ws_pool::idle(size_t iWorker, const task_group * pGroup)
+{
+   for (int n = 0; n < NUM_SPINS; n++)
+   {
+      std::this_thread::yield();
+      if (stopping.load(std::memory_order_acquire) || (pGroup && pGroup->done()))
+         return;
+      if (runOne(iWorker))
+         return;
+   }
+
+   // anything spawned before this read is found by the last look below
+   uint64_t seen = generation.load(std::memory_order_seq_cst);
+   if (runOne(iWorker))
+      return;
+
+   std::unique_lock<std::mutex> lock(mutexIdle);
+   numIdle.fetch_add(1, std::memory_order_seq_cst);
+   cvIdle.wait(lock, [&]()
+   {
+      return generation.load(std::memory_order_seq_cst) != seen ||
+             stopping.load(std::memory_order_acquire) ||
+             (pGroup && pGroup->done());
+   });
+   numIdle.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/*****************************************
+ * WS POOL :: WAKE
+ * Move the generation, and if anyone may be
+ * asleep, notify them under the lock so none
+ * is between checking and sleeping
+ ****************************************/
+inline void ws_pool::wake(bool all)
+{
+   generation.fetch_add(1, std::memory_order_seq_cst);
+   if (numIdle.load(std::memory_order_seq_cst) == 0)
+      return;
+
+   std::lock_guard<std::mutex> lock(mutexIdle);
+   if (all)
+      cvIdle.notify_all();
+   else
+      cvIdle.notify_one();
+}
+
+/*****************************************
+ * WS POOL :: WORK
+ * The body of every worker thread
+ ****************************************/
+inline void ws_pool::work(size_t iWorker)
+{
+   pSelfPool = this;
+   iSelfWorker = iWorker;
+   while (!stopping.load(std::memory_order_acquire))
+      if (!runOne(iWorker))
+         idle(iWorker, nullptr);
+}
+
+} // namespace custom
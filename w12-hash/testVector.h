@@ -100,6 +100,8 @@ public:
       test_reserve_fourTen();
       test_reserve_standardZero();
       test_reserve_standardTen();
+      test_reserve_relocateInts();
+      test_reserve_relocateUniquePtr();
 
       // Remove
       test_popback_empty();
@@ -967,6 +969,52 @@ public:
       teardownStandardFixture(v);
    }
    
+   // ints are relocated with memcpy and keep their values
+   void test_reserve_relocateInts()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      v.push_back(89);
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(custom::is_trivially_relocatable<int>::value);
+      assertUnit(!custom::is_trivially_relocatable<Spy>::value);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   // a unique_ptr is relocated without a move or a destructor, so
+   // each pointer is in the new buffer and freed exactly once
+   void test_reserve_relocateUniquePtr()
+   {  // setup
+      custom::vector<std::unique_ptr<Spy>> v;
+      v.push_back(std::unique_ptr<Spy>(new Spy(26)));
+      v.push_back(std::unique_ptr<Spy>(new Spy(49)));
+      Spy * p0 = v.data[0].get();
+      Spy * p1 = v.data[1].get();
+      Spy::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(custom::is_trivially_relocatable<std::unique_ptr<Spy>>::value);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.data[0].get() == p0);
+      assertUnit(v.data[1].get() == p1);
+      assertUnit(*v.data[1] == Spy(49));
+   }  // teardown
+
    // shrink an empty fixture
    void test_shrink_empty()
    {  // setup
@@ -22,6 +22,8 @@
 #include <cassert>  // because I am paranoid
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
+#include <cstring>  // for memcpy
+#include <type_traits> // for std::is_trivially_copyable
 
 #include <iostream> // TESTING
 
@@ -33,6 +35,22 @@ class TestHash;
 namespace custom
 {
 
+   /*****************************************
+    * IS TRIVIALLY RELOCATABLE
+    * Can a T be moved to new memory with memcpy, the
+    * old bytes then forgotten without a destructor?
+    * Anything trivially copyable can. Specialize this
+    * for types that only own through a pointer.
+    ****************************************/
+   template <typename T>
+   struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+   // a unique_ptr is just its pointer (and its deleter)
+   template <typename T, typename D>
+   struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+   template <typename T>
+   struct is_trivially_relocatable<std::default_delete<T>> : std::true_type {};
+
    /*****************************************
     * VECTOR
     * Just like the std :: vector <T> class
@@ -430,20 +448,24 @@ namespace custom
       // allocate new array
       T* newData = alloc.allocate(newCapacity);
 
-      // copy data from old array
-      for (auto i = 0; i < numElements; i++)
-         new ((void*)(newData + i)) T(std::move(data[i]));
-
-      // delete the old and assign the new
-      if (nullptr != data)
+      // copy data from old array: one memcpy when we may
+      if (is_trivially_relocatable<T>::value)
+      {
+         if (numElements > 0)
+            std::memcpy((void*)newData, (const void*)data, numElements * sizeof(T));
+      }
+      else
       {
          for (size_t i = 0; i < numElements; i++)
-         {
+            new ((void*)(newData + i)) T(std::move(data[i]));
+         for (size_t i = 0; i < numElements; i++)
             alloc.destroy(&data[i]);
-         }
-         alloc.deallocate(data, numCapacity);
       }
 
+      // delete the old and assign the new
+      if (nullptr != data)
+         alloc.deallocate(data, numCapacity);
+
       data = newData;
       numCapacity = newCapacity;
    }